@@ -0,0 +1,501 @@
+/*
+*	Title:	Final Project / Benchmark.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Google Benchmark suite for the CPU-side hot paths of Source.cpp.
+*	Needs no GL context, so it runs on any build machine. Build it as its own
+*	executable from this file plus Input.cpp, Camera.cpp, Geometry.cpp,
+*	MeshGenerator.cpp, TransformHierarchy.cpp, ModelImport.cpp, Picking.cpp, FrameArena.cpp, JpegDecode.cpp, MipBuilder.cpp, TextureCompress.cpp and TaskScheduler.cpp, linked against benchmark and SOIL2, and run it from the
+*	folder holding the .jpg textures.
+*
+*	Results are written as JSON to benchmark_results.json unless a
+*	--benchmark_out argument says otherwise.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+//GLM OpenMath Header
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+// Soil2 header file
+#include "SOIL2/SOIL2.h"
+
+#include "Input.h"
+#include "Camera.h"
+#include "Geometry.h"
+#include "MeshGenerator.h"
+#include "TransformHierarchy.h"
+#include "ModelImport.h"
+#include "Picking.h"
+#include "JpegDecode.h"
+#include "MipBuilder.h"
+#include "TextureCompress.h"
+#include "TaskScheduler.h"
+
+using namespace std; // standard namespace
+
+// Synthetic scene sizes, in tables
+#define SCENE_MIN 1
+#define SCENE_MAX (1 << 16)
+
+
+// Table transforms laid out on a square grid, as a synthetic scene of tableCount tables
+static vector<glm::mat4> USceneTransforms(int tableCount) {
+
+	vector<glm::mat4> transforms;
+	int side = (int)ceil(sqrt((double)tableCount));
+	for (int i = 0; i < tableCount; i++) {
+		glm::mat4 model(1.0f);
+		model = glm::translate(model, glm::vec3((i % side) * 3.0f, 0.0f, (i / side) * 3.0f));
+		model = glm::scale(model, glm::vec3(2.0f));
+		transforms.push_back(model);
+	}
+	return transforms;
+
+}
+
+
+// Model, view and projection for every object, built the way URenderGraphics builds them
+static void BM_MatrixConstruction(benchmark::State& state) {
+
+	int tableCount = (int)state.range(0);
+	vector<glm::vec3> positions(tableCount);
+	for (int i = 0; i < tableCount; i++) {
+		positions[i] = glm::vec3((float)i, 0.0f, (float)(i % 7));
+	}
+	glm::vec3 cameraPosition(0.0f, -1.5f, -6.0f);
+	glm::vec3 front = UCameraFront(0.3f, 0.2f);
+	glm::vec3 objectScale(2.0f);
+	vector<glm::mat4> mvp(tableCount);
+
+	for (auto _ : state) {
+		glm::mat4 view = glm::lookAt(cameraPosition - front, cameraPosition, glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 projection = glm::perspective(45.0f, 800.0f / 600.0f, 0.1f, 100.0f);
+		glm::mat4 viewProjection = projection * view;
+		for (int i = 0; i < tableCount; i++) {
+			glm::mat4 model(1.0f);
+			model = glm::translate(model, positions[i]);
+			model = glm::scale(model, objectScale);
+			mvp[i] = viewProjection * model;
+		}
+		benchmark::DoNotOptimize(mvp.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * tableCount);
+
+}
+BENCHMARK(BM_MatrixConstruction)->RangeMultiplier(8)->Range(SCENE_MIN, SCENE_MAX);
+
+
+// The cos/sin front vector UMouseMove used to rebuild on every motion event
+static void BM_FrontVector(benchmark::State& state) {
+
+	float yaw = 0.0f;
+	float pitch = 0.0f;
+	for (auto _ : state) {
+		yaw += 0.005f;
+		pitch += 0.0025f;
+		glm::vec3 front = UCameraFront(yaw, pitch);
+		benchmark::DoNotOptimize(front);
+	}
+	state.SetItemsProcessed(state.iterations());
+
+}
+BENCHMARK(BM_FrontVector);
+
+
+// One frame of mouse input: queue events, coalesce them and advance the camera
+static void BM_InputFrame(benchmark::State& state) {
+
+	int eventsPerFrame = (int)state.range(0);
+	CameraSimulation camera;
+	CameraState start = { glm::vec3(0.0f, -1.5f, -6.0f), 0.0f, 0.0f };
+	UCameraInit(camera, start);
+
+	// Hold ALT + left so every move is an orbit
+	InputEvent press = { INPUT_MOUSE_BUTTON, 400, 300, 0, 0, 0, 4, 0.0 };
+	UQueueInput(press);
+	UCoalesceInput();
+
+	int x = 400;
+	for (auto _ : state) {
+		for (int i = 0; i < eventsPerFrame; i++) {
+			InputEvent move = { INPUT_MOUSE_MOVE, x++ % 800, 300 + (i & 7), 0, 0, 0, 4, 0.0 };
+			UQueueInput(move);
+		}
+		FrameInput input = UCoalesceInput();
+		UCameraApplyInput(camera, input, 0.005f);
+		UCameraAdvance(camera, 1.0 / 60.0, 3.0f);
+		CameraState view = UCameraInterpolate(camera);
+		glm::vec3 front = UCameraFront(view.yaw, view.pitch);
+		benchmark::DoNotOptimize(front);
+	}
+	state.SetItemsProcessed(state.iterations() * eventsPerFrame);
+
+}
+BENCHMARK(BM_InputFrame)->RangeMultiplier(4)->Range(1, 1024);
+
+
+// Vertex and index preparation for UCreateBuffers, scaled to a scene of N tables
+static void BM_VertexPreparation(benchmark::State& state) {
+
+	int tableCount = (int)state.range(0);
+	vector<glm::mat4> transforms = USceneTransforms(tableCount);
+	size_t bytes = 0;
+
+	for (auto _ : state) {
+		Mesh legs;
+		Mesh top;
+		UBuildTableLegs(legs);
+		UBuildTableTop(top);
+
+		Mesh scene;
+		for (int i = 0; i < tableCount; i++) {
+			UAppendMesh(scene, legs, transforms[i]);
+			UAppendMesh(scene, top, transforms[i]);
+		}
+		bytes = scene.vertices.size() * sizeof(float) + scene.indices.size() * sizeof(unsigned int);
+		benchmark::DoNotOptimize(scene.vertices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * tableCount);
+	state.SetBytesProcessed(state.iterations() * bytes);
+
+}
+BENCHMARK(BM_VertexPreparation)->RangeMultiplier(8)->Range(SCENE_MIN, SCENE_MAX)->Unit(benchmark::kMicrosecond);
+
+
+// Procedural stress rooms of N x N bevelled tables, items are triangles
+static void BM_GenerateRoom(benchmark::State& state) {
+
+	RoomParams room = { (int)state.range(0), (int)state.range(0), 3.0f };
+	TableParams table = UDefaultTableParams();
+	table.bevel = 0.02f;
+	table.subdivision = 4;
+	size_t triangles = 0;
+
+	for (auto _ : state) {
+		Mesh legs;
+		Mesh top;
+		UGenerateRoom(room, table, legs, top);
+		triangles = (legs.indices.size() + top.indices.size()) / 3;
+		benchmark::DoNotOptimize(legs.vertices.data());
+		benchmark::DoNotOptimize(top.vertices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * triangles);
+	state.counters["triangles"] = (double)triangles;
+
+}
+BENCHMARK(BM_GenerateRoom)->RangeMultiplier(2)->Range(4, 64)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+// JPEG decode as UGenerateTexture does it, from memory so disk speed does not count
+static void BM_TextureDecode(benchmark::State& state, const char* fileName) {
+
+	ifstream file(fileName, ios::binary);
+	vector<unsigned char> jpeg((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	if (jpeg.empty()) {
+		state.SkipWithError("texture file not found, run from the folder holding the textures");
+		return;
+	}
+
+	int width = 0;
+	int height = 0;
+	for (auto _ : state) {
+		unsigned char* image = SOIL_load_image_from_memory(jpeg.data(), (int)jpeg.size(), &width, &height, 0, SOIL_LOAD_RGB);
+		benchmark::DoNotOptimize(image);
+		SOIL_free_image_data(image);
+	}
+
+	// Throughput in decoded bytes
+	state.SetBytesProcessed(state.iterations() * (int64_t)width * height * 3);
+	state.counters["compressed_kb"] = jpeg.size() / 1024.0;
+
+}
+BENCHMARK_CAPTURE(BM_TextureDecode, TableTop, "TableTop.jpg")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TextureDecode, TableLeg, "TableLeg.jpg")->Unit(benchmark::kMillisecond);
+
+
+// The texture streamer's JPEG decoder at 1 / (1 << scale shift) size. Throughput counts the full
+// size RGB bytes like BM_TextureDecode, so the rows compare directly with SOIL2 and with each other.
+static void BM_JpegDecode(benchmark::State& state, const char* fileName) {
+
+	ifstream file(fileName, ios::binary);
+	vector<unsigned char> jpeg((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	int fullWidth = 0;
+	int fullHeight = 0;
+	if (!UJpegSize(jpeg.data(), jpeg.size(), fullWidth, fullHeight)) {
+		state.SkipWithError("texture file not found, run from the folder holding the textures");
+		return;
+	}
+
+	int shift = (int)state.range(0);
+	vector<unsigned char> rgba;
+	int width = 0;
+	int height = 0;
+	for (auto _ : state) {
+		bool decoded = UJpegDecode(jpeg.data(), jpeg.size(), shift, rgba, width, height);
+		benchmark::DoNotOptimize(decoded);
+		benchmark::DoNotOptimize(rgba.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * (int64_t)fullWidth * fullHeight * 3);
+	state.counters["output_px"] = (double)width * height;
+
+}
+BENCHMARK_CAPTURE(BM_JpegDecode, TableTop, "TableTop.jpg")->DenseRange(0, JPEG_MAX_SCALE_SHIFT)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JpegDecode, TableLeg, "TableLeg.jpg")->DenseRange(0, JPEG_MAX_SCALE_SHIFT)->Unit(benchmark::kMillisecond);
+
+
+// Gamma-correct mip chain of the two-layer material array, as the texture streamer builds it
+static void BM_BuildMips(benchmark::State& state) {
+
+	const char* files[] = { "TableLeg.jpg", "TableTop.jpg" };
+	vector<unsigned char> level;
+	int width = 0;
+	int height = 0;
+	for (int i = 0; i < 2; i++) {
+		ifstream file(files[i], ios::binary);
+		vector<unsigned char> jpeg((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+		vector<unsigned char> rgba;
+		if (!UJpegDecode(jpeg.data(), jpeg.size(), 0, rgba, width, height) || (!level.empty() && rgba.size() != level.size())) {
+			state.SkipWithError("texture file not found, run from the folder holding the textures");
+			return;
+		}
+		level.insert(level.end(), rgba.begin(), rgba.end());
+	}
+
+	int count = 1 + (int)floor(log2((double)max(width, height)));
+	vector<vector<unsigned char> > mips;
+	for (auto _ : state) {
+		UBuildMips(level.data(), width, height, 2, count, mips);
+		benchmark::DoNotOptimize(mips.data());
+	}
+	state.SetBytesProcessed(state.iterations() * (int64_t)level.size());
+
+}
+BENCHMARK(BM_BuildMips)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+// Block compression of one full size table texture, with the PSNR the encoder reached
+static void BM_CompressTexture(benchmark::State& state, TextureCodec codec) {
+
+	ifstream file("TableLeg.jpg", ios::binary);
+	vector<unsigned char> jpeg((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	vector<unsigned char> rgba;
+	int width = 0;
+	int height = 0;
+	if (!UJpegDecode(jpeg.data(), jpeg.size(), 0, rgba, width, height)) {
+		state.SkipWithError("texture file not found, run from the folder holding the textures");
+		return;
+	}
+
+	vector<unsigned char> blocks;
+	double error = 0.0;
+	for (auto _ : state) {
+		error = UCompressLayer(codec, rgba.data(), width, height, blocks);
+		benchmark::DoNotOptimize(blocks.data());
+	}
+	state.SetBytesProcessed(state.iterations() * (int64_t)rgba.size());
+	state.counters["psnr_db"] = UPsnr(error, (double)width * height * UCodecChannels(codec));
+	state.counters["ratio"] = (double)rgba.size() / blocks.size();
+
+}
+BENCHMARK_CAPTURE(BM_CompressTexture, BC1, CODEC_BC1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_CompressTexture, BC7, CODEC_BC7)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+// One table moved per frame in a room of tableCount tables, against the whole room moving
+static void BM_TransformUpdate(benchmark::State& state, bool moveRoom) {
+
+	int tableCount = (int)state.range(0);
+	vector<glm::mat4> transforms = USceneTransforms(tableCount);
+	TransformHierarchy hierarchy;
+	TransformNode room = UTransformAdd(hierarchy, TRANSFORM_NO_PARENT, glm::mat4(1.0f));
+	vector<TransformNode> tables;
+	for (int i = 0; i < tableCount; i++) {
+		tables.push_back(UTransformAdd(hierarchy, room, transforms[i]));
+	}
+	UTransformUpdate(hierarchy);
+
+	int frame = 0;
+	for (auto _ : state) {
+		glm::mat4 offset = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.01f * (frame % 8), 0.0f));
+		if (moveRoom) {
+			UTransformSetLocal(hierarchy, room, offset);
+		}
+		else {
+			int table = frame % tableCount;
+			UTransformSetLocal(hierarchy, tables[table], offset * transforms[table]);
+		}
+		benchmark::DoNotOptimize(UTransformUpdate(hierarchy));
+		frame++;
+	}
+	state.SetItemsProcessed(state.iterations());
+
+}
+BENCHMARK_CAPTURE(BM_TransformUpdate, OneTable, false)->RangeMultiplier(8)->Range(SCENE_MIN, SCENE_MAX);
+BENCHMARK_CAPTURE(BM_TransformUpdate, WholeRoom, true)->RangeMultiplier(8)->Range(SCENE_MIN, SCENE_MAX)->Unit(benchmark::kMicrosecond);
+
+
+// OBJ text for an N x N grid of quads with positions, texture coordinates and one shared normal
+static string UGridObj(int side) {
+
+	string text;
+	char line[96];
+	for (int i = 0; i <= side; i++) {
+		for (int j = 0; j <= side; j++) {
+			snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\n", i * 0.01f, 0.0f, j * 0.01f, (float)i / side, (float)j / side);
+			text += line;
+		}
+	}
+	text += "vn 0 1 0\n";
+	for (int i = 0; i < side; i++) {
+		for (int j = 0; j < side; j++) {
+			int a = i * (side + 1) + j + 1;
+			int c = a + side + 1;
+			snprintf(line, sizeof(line), "f %d/%d/1 %d/%d/1 %d/%d/1 %d/%d/1\n", a, a, c, c, c + 1, c + 1, a + 1, a + 1);
+			text += line;
+		}
+	}
+	return text;
+
+}
+
+
+// OBJ import from memory, so only parsing and deduplication count
+static void BM_ImportObj(benchmark::State& state) {
+
+	string text = UGridObj((int)state.range(0));
+	size_t triangles = 0;
+	for (auto _ : state) {
+		Mesh mesh;
+		UImportObj(text.data(), text.size(), mesh);
+		triangles = mesh.indices.size() / 3;
+		benchmark::DoNotOptimize(mesh.vertices.data());
+	}
+	state.SetBytesProcessed(state.iterations() * (int64_t)text.size());
+	state.counters["triangles"] = (double)triangles;
+
+}
+BENCHMARK(BM_ImportObj)->RangeMultiplier(4)->Range(16, 1024)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+// Rays from above into a baked N x N room of bevelled tables, items are rays
+static void BM_PickRay(benchmark::State& state) {
+
+	RoomParams room = { (int)state.range(0), (int)state.range(0), 3.0f };
+	TableParams table = UDefaultTableParams();
+	table.bevel = 0.02f;
+	table.subdivision = 4;
+	Mesh legs;
+	Mesh top;
+	UGenerateRoom(room, table, legs, top);
+	UAppendMesh(legs, top, glm::mat4(1.0f));
+	PickBvh bvh;
+	UBvhBuild(legs, bvh);
+
+	// A fixed spread of rays from a camera above the room, aimed at points inside it
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+	UMeshBounds(legs, boundsMin, boundsMax);
+	glm::vec3 eye = (boundsMin + boundsMax) * 0.5f + glm::vec3(0.0f, 10.0f, 0.0f);
+	vector<glm::vec3> directions(1024);
+	unsigned int seed = 1;
+	for (size_t i = 0; i < directions.size(); i++) {
+		glm::vec3 t;
+		for (int axis = 0; axis < 3; axis++) {
+			seed = seed * 1664525u + 1013904223u;
+			t[axis] = (seed >> 8) / 16777216.0f;
+		}
+		directions[i] = glm::normalize(boundsMin + (boundsMax - boundsMin) * t - eye);
+	}
+
+	size_t ray = 0;
+	int hits = 0;
+	for (auto _ : state) {
+		PickHit hit;
+		hit.distance = INFINITY;
+		hits += UBvhIntersect(bvh, eye, directions[ray++ & (directions.size() - 1)], hit);
+	}
+	benchmark::DoNotOptimize(hits);
+	state.SetItemsProcessed(state.iterations());
+	state.counters["triangles"] = (double)bvh.triangleCount;
+
+}
+BENCHMARK(BM_PickRay)->RangeMultiplier(2)->Range(4, 32);
+
+
+// Parallel-for over the world positions of a room of tables, as the per-frame texture need pass
+// runs it, against the same loop on one thread. Shows where slicing starts to pay for its tasks.
+static void BM_ParallelFor(benchmark::State& state, bool parallel) {
+
+	vector<glm::mat4> transforms = USceneTransforms((int)state.range(0));
+	glm::vec3 eye(10.0f, 2.0f, -5.0f);
+	vector<float> distances(transforms.size());
+	auto work = [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; i++) {
+			distances[i] = glm::length(glm::vec3(transforms[i][3]) - eye);
+		}
+	};
+
+	for (auto _ : state) {
+		if (parallel) {
+			UTaskParallelFor(transforms.size(), 1, work);
+		}
+		else {
+			work(0, transforms.size());
+		}
+		benchmark::DoNotOptimize(distances.data());
+	}
+	state.SetItemsProcessed(state.iterations() * transforms.size());
+	state.counters["threads"] = (double)UTaskThreadCount();
+
+}
+BENCHMARK_CAPTURE(BM_ParallelFor, Serial, false)->RangeMultiplier(8)->Range(SCENE_MIN, SCENE_MAX)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ParallelFor, Tasks, true)->RangeMultiplier(8)->Range(SCENE_MIN, SCENE_MAX)->UseRealTime();
+
+
+// Same as BENCHMARK_MAIN, but writes JSON by default for tracking results over time
+int main(int argc, char* argv[]) {
+
+	vector<char*> args(argv, argv + argc);
+	bool hasOutput = false;
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--benchmark_out=", 16) == 0) {
+			hasOutput = true;
+		}
+	}
+
+	static char outArg[] = "--benchmark_out=benchmark_results.json";
+	static char formatArg[] = "--benchmark_out_format=json";
+	if (!hasOutput) {
+		args.push_back(outArg);
+		args.push_back(formatArg);
+	}
+
+	// Every parallel path runs on the task threads, one per core
+	TaskOptions taskOptions = { 0 };
+	UTaskInit(taskOptions);
+
+	int count = (int)args.size();
+	benchmark::Initialize(&count, args.data());
+	if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+		return 1;
+	}
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	UTaskShutdown();
+	return 0;
+
+}
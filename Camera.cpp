@@ -0,0 +1,87 @@
+/*
+*	Title:	Final Project / Camera.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Fixed-timestep camera simulation.
+*/
+
+#include <cmath>
+
+#include "Camera.h"
+
+using namespace std; // standard namespace
+
+
+glm::vec3 UCameraFront(float yaw, float pitch) {
+
+	glm::vec3 front;
+	front.x = 10.0f * cos(yaw);
+	front.y = 10.0f * sin(pitch);
+	front.z = sin(yaw) * cos(pitch) * 10.0f;
+	return front;
+
+}
+
+
+void UCameraInit(CameraSimulation& camera, const CameraState& state) {
+
+	camera.previous = state;
+	camera.current = state;
+	camera.targetYaw = state.yaw;
+	camera.targetPitch = state.pitch;
+	camera.zoomDirection = 0;
+	camera.accumulator = 0.0;
+
+}
+
+
+void UCameraApplyInput(CameraSimulation& camera, const FrameInput& input, float sensitivity) {
+
+	// Orbit offsets are distances, so the sum over the frame is the same however often the mouse reported
+	camera.targetYaw += input.orbitX * sensitivity;
+	camera.targetPitch += input.orbitY * sensitivity;
+
+	// Zoom is a rate, held for as long as this frame's input lasts
+	camera.zoomDirection = input.zoomDirection;
+
+}
+
+
+void UCameraAdvance(CameraSimulation& camera, double frameSeconds, float speed) {
+
+	const float dt = (float)CAMERA_TIMESTEP;
+	int steps = 0;
+
+	camera.accumulator += frameSeconds;
+	while (camera.accumulator >= CAMERA_TIMESTEP) {
+		camera.previous = camera.current;
+
+		camera.current.yaw = camera.targetYaw;
+		camera.current.pitch = camera.targetPitch;
+		if (camera.zoomDirection != 0) {
+			glm::vec3 front = UCameraFront(camera.current.yaw, camera.current.pitch);
+			camera.current.position += (float)camera.zoomDirection * speed * dt * front;
+		}
+
+		camera.accumulator -= CAMERA_TIMESTEP;
+
+		// Drop time we cannot catch up on rather than spiralling after a long stall
+		if (++steps == CAMERA_MAX_STEPS) {
+			camera.accumulator = fmod(camera.accumulator, CAMERA_TIMESTEP);
+			break;
+		}
+	}
+
+}
+
+
+CameraState UCameraInterpolate(const CameraSimulation& camera) {
+
+	float alpha = (float)(camera.accumulator / CAMERA_TIMESTEP);
+	CameraState state;
+	state.position = camera.previous.position + (camera.current.position - camera.previous.position) * alpha;
+	state.yaw = camera.previous.yaw + (camera.current.yaw - camera.previous.yaw) * alpha;
+	state.pitch = camera.previous.pitch + (camera.current.pitch - camera.previous.pitch) * alpha;
+	return state;
+
+}
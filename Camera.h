@@ -0,0 +1,48 @@
+/*
+*	Title:	Final Project / Camera.h
+*	Date:	October 19, 2026
+*
+*	Description: Fixed-timestep orbit/zoom camera. Input is applied once per
+*	frame, the camera advances in CAMERA_TIMESTEP steps and the rendered view
+*	is interpolated between the last two simulation states.
+*/
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Input.h"
+
+#define CAMERA_TIMESTEP (1.0 / 120.0)	// simulation step in seconds
+#define CAMERA_MAX_STEPS 8				// steps per frame before the clock is allowed to fall behind
+
+// Position and orientation at one simulation step
+struct CameraState {
+	glm::vec3 position;
+	float yaw;
+	float pitch;
+};
+
+struct CameraSimulation {
+	CameraState previous;		// state one step ago, for interpolation
+	CameraState current;		// latest simulated state
+	float targetYaw;			// orientation the mouse has asked for
+	float targetPitch;
+	int zoomDirection;			// zoom input held for the current frame
+	double accumulator;			// unsimulated time in seconds
+};
+
+// Front vector for a yaw and pitch, scaled by 10 as the camera has always used
+glm::vec3 UCameraFront(float yaw, float pitch);
+
+// Starts the simulation at rest in the given state
+void UCameraInit(CameraSimulation& camera, const CameraState& state);
+
+// Folds one frame of input into the simulation's targets
+void UCameraApplyInput(CameraSimulation& camera, const FrameInput& input, float sensitivity);
+
+// Runs as many fixed steps as frameSeconds covers, moving speed front-lengths per second while zooming
+void UCameraAdvance(CameraSimulation& camera, double frameSeconds, float speed);
+
+// State to render, blended between the last two steps by the leftover time
+CameraState UCameraInterpolate(const CameraSimulation& camera);
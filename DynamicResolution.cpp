@@ -0,0 +1,179 @@
+/*
+*	Title:	Final Project / DynamicResolution.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Dynamic resolution controller. Frame time is smoothed, and
+*	since render cost follows pixel count, the per axis scale moves by a
+*	damped square root of target / measured, at most RESOLUTION_MAX_STEP per
+*	frame and not at all inside RESOLUTION_DEADBAND of the target.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <GL/glew.h>
+
+#include "DynamicResolution.h"
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+#define RESOLUTION_SMOOTHING 0.1	// weight of the newest frame time
+#define RESOLUTION_GAIN 0.5			// fraction of the error corrected per frame
+#define RESOLUTION_MAX_STEP 0.05	// largest scale change per frame
+#define RESOLUTION_DEADBAND 0.05	// frame time error left alone
+#define RESOLUTION_QUERIES 3		// timer queries in flight
+#define RESOLUTION_OUTLIER 10.0		// frame times are capped at this many targets
+
+static ResolutionOptions resolutionOptions;
+static float scale = 1.0f;
+static double smoothedMs = 0.0;
+
+// Frame timing, GPU timer queries read back a few frames late or the CPU clock
+static bool gpuTiming = false;
+static GLuint timerQueries[RESOLUTION_QUERIES];
+static bool queryPending[RESOLUTION_QUERIES];
+static int queryIndex = 0;
+static chrono::steady_clock::time_point lastBegin;
+static bool haveLastBegin = false;
+
+
+bool UParseResolutionOptions(int argc, char* argv[], ResolutionOptions& options) {
+
+	options.targetMs = 1000.0 / 60.0;
+	options.minScale = 0.5f;
+	options.maxScale = 1.0f;
+	options.fixedScale = 0.0f;
+
+	const char* flags[] = { "--target-ms", "--min-scale", "--fixed-scale" };
+	const int flagCount = sizeof(flags) / sizeof(flags[0]);
+
+	for (int i = 1; i < argc; i++) {
+		int flag = 0;
+		while (flag < flagCount && strcmp(argv[i], flags[flag]) != 0) {
+			flag++;
+		}
+		if (flag == flagCount) {
+			continue; // not ours
+		}
+		if (i + 1 >= argc) {
+			std::cerr << argv[i] << " needs a value\n";
+			return false;
+		}
+
+		const char* value = argv[++i];
+		switch (flag) {
+		case 0: options.targetMs = max(1.0, atof(value)); break;
+		case 1: options.minScale = min(max((float)atof(value), 0.1f), 1.0f); break;
+		case 2: options.fixedScale = min(max((float)atof(value), 0.1f), 1.0f); break;
+		}
+	}
+	return true;
+
+}
+
+
+void UResolutionInit(const ResolutionOptions& options) {
+
+	resolutionOptions = options;
+	scale = options.fixedScale > 0.0f ? options.fixedScale : options.maxScale;
+
+	gpuTiming = (GLEW_ARB_timer_query != 0);
+	if (gpuTiming) {
+		glGenQueries(RESOLUTION_QUERIES, timerQueries);
+		for (int i = 0; i < RESOLUTION_QUERIES; i++) {
+			queryPending[i] = false;
+		}
+	}
+
+}
+
+
+// Moves the scale toward the size that renders in the target time
+static void UUpdateScale(double frameMs) {
+
+	if (resolutionOptions.fixedScale > 0.0f || frameMs <= 0.0) {
+		return;
+	}
+
+	// One stalled or misreported frame should not swing the whole average
+	frameMs = min(frameMs, RESOLUTION_OUTLIER * resolutionOptions.targetMs);
+	smoothedMs = (smoothedMs <= 0.0) ? frameMs : smoothedMs + RESOLUTION_SMOOTHING * (frameMs - smoothedMs);
+
+	double ratio = resolutionOptions.targetMs / smoothedMs;
+	if (fabs(ratio - 1.0) < RESOLUTION_DEADBAND) {
+		return;
+	}
+
+	// Cost follows pixel count, so the per axis scale goes with the square root of the ratio
+	double step = pow(ratio, 0.5 * RESOLUTION_GAIN);
+	step = min(max(step, 1.0 - RESOLUTION_MAX_STEP), 1.0 + RESOLUTION_MAX_STEP);
+	scale = min(max((float)(scale * step), resolutionOptions.minScale), resolutionOptions.maxScale);
+
+}
+
+
+// Reads back the oldest finished timer query, or times the frame on the CPU clock
+static double UMeasureFrameMs(void) {
+
+	if (!gpuTiming) {
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		double ms = haveLastBegin ? chrono::duration<double, milli>(now - lastBegin).count() : 0.0;
+		lastBegin = now;
+		haveLastBegin = true;
+		return ms;
+	}
+
+	// The slot about to be reused holds the query from RESOLUTION_QUERIES frames ago,
+	// reading it only waits when the GPU is further behind than that
+	double ms = 0.0;
+	if (queryPending[queryIndex]) {
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(timerQueries[queryIndex], GL_QUERY_RESULT, &elapsed);
+		ms = elapsed / 1.0e6;
+		queryPending[queryIndex] = false;
+	}
+	return ms;
+
+}
+
+
+void UResolutionBegin(void) {
+
+	UUpdateScale(UMeasureFrameMs());
+	if (gpuTiming) {
+		glBeginQuery(GL_TIME_ELAPSED, timerQueries[queryIndex]);
+	}
+
+}
+
+
+void UResolutionEnd(void) {
+
+	if (gpuTiming) {
+		glEndQuery(GL_TIME_ELAPSED);
+		queryPending[queryIndex] = true;
+		queryIndex = (queryIndex + 1) % RESOLUTION_QUERIES;
+	}
+
+}
+
+
+float UResolutionScale(void) {
+
+	return scale;
+
+}
+
+
+void UResolutionShutdown(void) {
+
+	if (gpuTiming) {
+		glDeleteQueries(RESOLUTION_QUERIES, timerQueries);
+		gpuTiming = false;
+	}
+
+}
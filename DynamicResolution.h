@@ -0,0 +1,41 @@
+/*
+*	Title:	Final Project / DynamicResolution.h
+*	Date:	October 19, 2026
+*
+*	Description: Picks the fraction of the window size the scene renders at.
+*	A feedback controller moves the fraction each frame to hold a target
+*	frame time, measured on the GPU with timer queries where available and on
+*	the CPU clock otherwise. The offscreen targets and the upscale to the
+*	window belong to the post-processing chain (see PostProcess.h).
+*
+*	Command line:
+*		--target-ms <ms>			frame time to hold, default 16.7
+*		--min-scale <fraction>		lowest render scale per axis, default 0.5
+*		--fixed-scale <fraction>	disable the controller and render at this scale
+*/
+
+#pragma once
+
+struct ResolutionOptions {
+	double targetMs;
+	float minScale;
+	float maxScale;
+	float fixedScale;		// 0 lets the controller pick
+};
+
+// Reads the resolution options out of the command line, returns false on a malformed argument
+bool UParseResolutionOptions(int argc, char* argv[], ResolutionOptions& options);
+
+// Creates the timer queries, call once the GL context exists
+void UResolutionInit(const ResolutionOptions& options);
+
+// Updates the controller from the last measured frame and starts timing this one
+void UResolutionBegin(void);
+
+// Stops timing the frame, call after the frame's last pass
+void UResolutionEnd(void);
+
+// Current render scale per axis
+float UResolutionScale(void);
+
+void UResolutionShutdown(void);
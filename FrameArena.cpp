@@ -0,0 +1,240 @@
+/*
+*	Title:	Final Project / FrameArena.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Frame arena. Each thread's sub-arena is created on its first
+*	allocation and registered so the stats can see it, its halves notice a
+*	new frame by comparing the frame they were last rewound for with the
+*	global frame counter, so only the render thread has to know about frames.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+#include "FrameArena.h"
+
+using namespace std; // standard namespace
+
+// First block of every half, later blocks double
+#define ARENA_BLOCK_BYTES (64 * 1024)
+
+struct ArenaBlock {
+	char* data;
+	size_t size;
+	size_t used;
+};
+
+struct ArenaHalf {
+	vector<ArenaBlock> blocks;	// the last one is being filled
+	long long frame;			// frame the half was last rewound for
+	size_t used;				// bytes handed out since the rewind, over all blocks
+	size_t lastOffset;			// offset of the latest allocation in the last block
+};
+
+struct ThreadArena {
+	ThreadArena(void);
+	~ThreadArena(void);
+
+	ArenaHalf halves[2];
+	atomic<size_t> highWater;
+	atomic<size_t> reserved;
+};
+
+static atomic<long long> arenaFrame(0);
+static atomic<long long> heapBlocks(0);
+static atomic<long long> lastGrowthFrame(-1);
+static long long frameStartBlocks = 0;		// heapBlocks when the current frame began
+static int lastFrameHeapBlocks = 0;
+
+// Live sub-arenas, and what the ones of finished threads left behind
+static mutex registryMutex;
+static vector<ThreadArena*> arenas;
+static int retiredThreads = 0;
+static size_t retiredHighWater = 0;
+
+
+static ArenaBlock UNewBlock(size_t size) {
+
+	ArenaBlock block;
+	block.data = static_cast<char*>(malloc(size));
+	if (block.data == 0) {
+		std::cerr << "Frame arena: out of memory for a " << size << " byte block\n";
+		exit(EXIT_FAILURE);
+	}
+	block.size = size;
+	block.used = 0;
+	heapBlocks++;
+	lastGrowthFrame = arenaFrame.load();
+	return block;
+
+}
+
+
+ThreadArena::ThreadArena(void) : highWater(0), reserved(0) {
+
+	for (int h = 0; h < 2; h++) {
+		halves[h].frame = -1;
+		halves[h].used = 0;
+		halves[h].lastOffset = 0;
+	}
+	lock_guard<mutex> lock(registryMutex);
+	arenas.push_back(this);
+
+}
+
+
+ThreadArena::~ThreadArena(void) {
+
+	{
+		lock_guard<mutex> lock(registryMutex);
+		arenas.erase(find(arenas.begin(), arenas.end(), this));
+		retiredThreads++;
+		retiredHighWater += highWater;
+	}
+	for (int h = 0; h < 2; h++) {
+		for (size_t b = 0; b < halves[h].blocks.size(); b++) {
+			free(halves[h].blocks[b].data);
+		}
+	}
+
+}
+
+
+// Rewinds a half for frame, folding a run of blocks into one as large as all of them
+static void URewind(ArenaHalf& half, long long frame) {
+
+	half.frame = frame;
+	half.used = 0;
+	half.lastOffset = 0;
+	if (half.blocks.size() > 1) {
+		size_t total = 0;
+		for (size_t b = 0; b < half.blocks.size(); b++) {
+			total += half.blocks[b].size;
+			free(half.blocks[b].data);
+		}
+		half.blocks.clear();
+		half.blocks.push_back(UNewBlock(total));
+	}
+	for (size_t b = 0; b < half.blocks.size(); b++) {
+		half.blocks[b].used = 0;
+	}
+
+}
+
+
+// The calling thread's half for the current frame
+static ArenaHalf& UCurrentHalf(ThreadArena*& arena) {
+
+	static thread_local ThreadArena threadArena;
+	arena = &threadArena;
+	long long frame = arenaFrame.load(memory_order_relaxed);
+	ArenaHalf& half = threadArena.halves[frame & 1];
+	if (half.frame != frame) {
+		URewind(half, frame);
+	}
+	return half;
+
+}
+
+
+void UArenaBeginFrame(void) {
+
+	long long blocks = heapBlocks.load();
+	lastFrameHeapBlocks = (int)(blocks - frameStartBlocks);
+	frameStartBlocks = blocks;
+	arenaFrame++;
+
+}
+
+
+void* UArenaAlloc(size_t bytes, size_t align) {
+
+	ThreadArena* arena;
+	ArenaHalf& half = UCurrentHalf(arena);
+
+	// Aligns the address rather than the offset, so alignments past malloc's still hold
+	ArenaBlock* block = half.blocks.empty() ? 0 : &half.blocks.back();
+	size_t offset = 0;
+	if (block != 0) {
+		uintptr_t start = (uintptr_t)block->data;
+		offset = (size_t)(((start + block->used + align - 1) & ~(uintptr_t)(align - 1)) - start);
+	}
+	if (block == 0 || offset + bytes > block->size) {
+		size_t size = block == 0 ? ARENA_BLOCK_BYTES : block->size * 2;
+		size = max(size, bytes + align);
+		half.blocks.push_back(UNewBlock(size));
+		arena->reserved += size;
+		block = &half.blocks.back();
+		uintptr_t start = (uintptr_t)block->data;
+		offset = (size_t)(((start + align - 1) & ~(uintptr_t)(align - 1)) - start);
+	}
+
+	half.used += offset + bytes - block->used;
+	block->used = offset + bytes;
+	half.lastOffset = offset;
+	if (half.used > arena->highWater) {
+		arena->highWater = half.used;
+	}
+	return block->data + offset;
+
+}
+
+
+void UArenaFree(void* memory, size_t bytes) {
+
+	if (memory == 0) {
+		return;
+	}
+	ThreadArena* arena;
+	ArenaHalf& half = UCurrentHalf(arena);
+	if (half.blocks.empty()) {
+		return;
+	}
+	ArenaBlock& block = half.blocks.back();
+	if (block.data + half.lastOffset == memory && half.lastOffset + bytes == block.used) {
+		half.used -= bytes;
+		block.used = half.lastOffset;
+	}
+
+}
+
+
+ArenaStats UArenaStats(void) {
+
+	ArenaStats stats = {};
+	stats.frames = arenaFrame.load();
+	stats.heapBlocks = heapBlocks.load();
+	stats.lastFrameHeapBlocks = lastFrameHeapBlocks;
+	stats.lastGrowthFrame = lastGrowthFrame.load();
+
+	lock_guard<mutex> lock(registryMutex);
+	stats.threads = (int)arenas.size() + retiredThreads;
+	stats.highWater = retiredHighWater;
+	for (size_t i = 0; i < arenas.size(); i++) {
+		stats.highWater += arenas[i]->highWater;
+		stats.reserved += arenas[i]->reserved;
+	}
+	return stats;
+
+}
+
+
+void UArenaPrintStats(void) {
+
+	ArenaStats stats = UArenaStats();
+	if (stats.threads == 0) {
+		return;
+	}
+	ostringstream report;
+	report << fixed << setprecision(1) << "Frame arena: " << stats.highWater / 1024.0 << " KB high water over "
+		<< stats.threads << (stats.threads == 1 ? " thread, " : " threads, ") << stats.reserved / 1024.0 << " KB reserved, "
+		<< stats.heapBlocks << " heap blocks, last taken in frame " << stats.lastGrowthFrame << " of " << stats.frames << "\n";
+	std::cout << report.str();
+
+}
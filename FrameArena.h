@@ -0,0 +1,81 @@
+/*
+*	Title:	Final Project / FrameArena.h
+*	Date:	October 19, 2026
+*
+*	Description: Per-frame bump allocator for transient data such as visible
+*	lists, sort keys and staging copies. Every thread allocates from its own
+*	sub-arena, so worker threads never contend, and each sub-arena has two
+*	halves used on alternate frames: memory handed out while frame N is built
+*	stays valid through frame N + 1 and is reused by frame N + 2. Nothing is
+*	freed one allocation at a time, a half is simply rewound when its turn
+*	comes again. A half that outgrew its block is folded into one block large
+*	enough for its high water mark, so after a few frames the arena stops
+*	touching the heap. A half is rewound by its own thread on that thread's
+*	first allocation in a new frame, so a worker that allocates once per job
+*	keeps its memory for as long as the job runs.
+*
+*	FrameAllocator and FrameVector let standard containers live in the arena,
+*	reserve up front since a growing container leaves its old storage behind
+*	until the half rewinds.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+struct ArenaStats {
+	long long frames;			// frames begun
+	int threads;				// threads that have allocated from the arena
+	size_t highWater;			// most bytes one frame used, summed over threads
+	size_t reserved;			// bytes held in blocks
+	long long heapBlocks;		// blocks ever taken from the heap
+	int lastFrameHeapBlocks;	// of those, taken while the last complete frame was built
+	long long lastGrowthFrame;	// last frame that needed a new block, -1 if none did
+};
+
+// Starts a frame on the calling thread's clock, the half used two frames ago is rewound on next use.
+// Call once per frame from the render thread.
+void UArenaBeginFrame(void);
+
+// Bytes from the calling thread's current half, valid until the end of the next frame.
+// align must be a power of two.
+void* UArenaAlloc(size_t bytes, size_t align = alignof(std::max_align_t));
+
+// Gives the bytes back when they are the calling thread's latest allocation, otherwise does nothing
+void UArenaFree(void* memory, size_t bytes);
+
+ArenaStats UArenaStats(void);
+
+// Prints the high water mark, reserved bytes and when the arena last grew
+void UArenaPrintStats(void);
+
+// Standard allocator over the frame arena
+template <class T>
+struct FrameAllocator {
+
+	typedef T value_type;
+
+	FrameAllocator(void) {}
+
+	template <class U>
+	FrameAllocator(const FrameAllocator<U>&) {}
+
+	T* allocate(size_t count) {
+		return static_cast<T*>(UArenaAlloc(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* memory, size_t count) {
+		UArenaFree(memory, count * sizeof(T));
+	}
+
+};
+
+template <class T, class U>
+bool operator==(const FrameAllocator<T>&, const FrameAllocator<U>&) { return true; }
+
+template <class T, class U>
+bool operator!=(const FrameAllocator<T>&, const FrameAllocator<U>&) { return false; }
+
+template <class T>
+using FrameVector = std::vector<T, FrameAllocator<T> >;
@@ -0,0 +1,632 @@
+/*
+*	Title:	Final Project / FrameCapture.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Pixel buffer ring and encoder threads. Slots are used in
+*	order, so the oldest read is always the next one to collect; collecting
+*	stops at the first fence that has not signalled. A slot is free again
+*	once its fence has been collected and, when persistently mapped, once the
+*	encoder reading it has finished. Video frames carry their number and each
+*	encoder waits for its turn before appending to the file.
+*/
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <GL/glew.h>
+
+// Soil2 header file
+#include "SOIL2/SOIL2.h"
+
+#include "FrameArena.h"
+#include "FrameCapture.h"
+#include "GlState.h"
+#include "GpuResources.h"
+#include "Input.h"
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+#define CAPTURE_MAX_RING 16
+#define CAPTURE_MAX_THREADS 8
+#define CAPTURE_WAIT_NS 1000000000ull		// longest wait on one fence, 1 s
+
+enum CaptureFormat {
+	CAPTURE_PNG,
+	CAPTURE_Y4M,
+	CAPTURE_RAW
+};
+
+struct CaptureSlot {
+	GLuint buffer;
+	GLsync fence;
+	unsigned char* mapped;		// persistent mapping, NULL when frames are copied out
+	bool inFlight;				// read issued, fence not collected yet
+	bool encoding;				// an encoder is reading the mapping, guarded by captureMutex
+	int frame;
+};
+
+struct CaptureJob {
+	int frame;
+	int width;
+	int height;
+	int slot;					// persistently mapped slot to read, -1 when pixels holds a copy
+	bool dropped;				// the read timed out, nothing to write but the frame's turn
+	vector<unsigned char> pixels;
+};
+
+static CaptureOptions captureOptions;
+static CaptureFormat captureFormat = CAPTURE_PNG;
+static string framePattern;			// printf pattern for PNG sequences
+static bool capturing = false;
+static bool stopped = false;		// frame limit reached, or the window resized under a video
+static bool persistent = false;
+static vector<CaptureSlot> slots;
+static int nextSlot = 0;			// where the next read goes, and the oldest read in flight
+static int ringWidth = 0;
+static int ringHeight = 0;
+static CaptureStats stats;
+static FILE* video = NULL;
+
+// Encoder threads and what they share with the GL thread
+static vector<thread> encoders;
+static mutex captureMutex;
+static condition_variable jobReady;
+static condition_variable jobDone;	// a slot was released, a copy recycled or a video frame written
+static deque<CaptureJob> jobs;
+static bool stopping = false;
+static int nextWrite = 0;			// next video frame to append
+static vector<vector<unsigned char> > spareCopies;
+static bool writeFailed = false;
+
+
+// A printf pattern is accepted only with a single integer conversion, e.g. %05d
+static bool UValidPattern(const string& path) {
+
+	size_t percent = path.find('%');
+	if (percent == string::npos) {
+		return false;
+	}
+	size_t i = percent + 1;
+	while (i < path.size() && path[i] >= '0' && path[i] <= '9') {
+		i++;
+	}
+	return i < path.size() && path[i] == 'd' && path.find('%', i) == string::npos;
+
+}
+
+
+bool UParseCaptureOptions(int argc, char* argv[], CaptureOptions& options) {
+
+	options.path.clear();
+	options.frameLimit = 0;
+	options.fps = 60;
+	options.ringSize = 4;
+	options.threads = 0;
+
+	const char* flags[] = { "--capture", "--capture-frames", "--capture-fps", "--capture-ring", "--capture-threads" };
+	const int flagCount = sizeof(flags) / sizeof(flags[0]);
+
+	for (int i = 1; i < argc; i++) {
+		int flag = 0;
+		while (flag < flagCount && strcmp(argv[i], flags[flag]) != 0) {
+			flag++;
+		}
+		if (flag == flagCount) {
+			continue; // not ours
+		}
+		if (i + 1 >= argc) {
+			std::cerr << argv[i] << " needs a value\n";
+			return false;
+		}
+
+		const char* value = argv[++i];
+		switch (flag) {
+		case 0: options.path = value; break;
+		case 1: options.frameLimit = max(0, atoi(value)); break;
+		case 2: options.fps = max(1, atoi(value)); break;
+		case 3: options.ringSize = min(max(atoi(value), 2), CAPTURE_MAX_RING); break;
+		case 4: options.threads = min(max(atoi(value), 1), CAPTURE_MAX_THREADS); break;
+		}
+	}
+
+	if (options.path.find('%') != string::npos && !UValidPattern(options.path)) {
+		std::cerr << "--capture pattern " << options.path << " needs exactly one integer conversion such as %05d\n";
+		return false;
+	}
+	return true;
+
+}
+
+
+// Copies a bottom-up RGBA frame into top-down RGB
+static void UFlipToRgb(const unsigned char* rgba, int width, int height, unsigned char* rgb) {
+
+	for (int y = 0; y < height; y++) {
+		const unsigned char* in = rgba + (size_t)(height - 1 - y) * width * 4;
+		unsigned char* out = rgb + (size_t)y * width * 3;
+		for (int x = 0; x < width; x++, in += 4, out += 3) {
+			out[0] = in[0];
+			out[1] = in[1];
+			out[2] = in[2];
+		}
+	}
+
+}
+
+
+// Full range BT.601 planes for C420jpeg, chroma is the average of each 2 x 2 block
+static void UFlipToYuv420(const unsigned char* rgba, int width, int height, unsigned char* yuv) {
+
+	int chromaWidth = (width + 1) / 2;
+	int chromaHeight = (height + 1) / 2;
+	unsigned char* lumaPlane = yuv;
+	unsigned char* uPlane = yuv + (size_t)width * height;
+	unsigned char* vPlane = uPlane + (size_t)chromaWidth * chromaHeight;
+
+	for (int cy = 0; cy < chromaHeight; cy++) {
+		for (int cx = 0; cx < chromaWidth; cx++) {
+			int sumR = 0;
+			int sumG = 0;
+			int sumB = 0;
+			int samples = 0;
+			for (int dy = 0; dy < 2; dy++) {
+				int y = cy * 2 + dy;
+				if (y >= height) {
+					continue;
+				}
+				const unsigned char* row = rgba + (size_t)(height - 1 - y) * width * 4;
+				for (int dx = 0; dx < 2; dx++) {
+					int x = cx * 2 + dx;
+					if (x >= width) {
+						continue;
+					}
+					const unsigned char* p = row + x * 4;
+					lumaPlane[(size_t)y * width + x] = (unsigned char)((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+					sumR += p[0];
+					sumG += p[1];
+					sumB += p[2];
+					samples++;
+				}
+			}
+			// The 128 offset is added before the shift, which keeps it off negative numbers
+			int u = ((-43 * sumR - 85 * sumG + 128 * sumB) / samples + 128 + (128 << 8)) >> 8;
+			int v = ((128 * sumR - 107 * sumG - 21 * sumB) / samples + 128 + (128 << 8)) >> 8;
+			uPlane[(size_t)cy * chromaWidth + cx] = (unsigned char)min(max(u, 0), 255);
+			vPlane[(size_t)cy * chromaWidth + cx] = (unsigned char)min(max(v, 0), 255);
+		}
+	}
+
+}
+
+
+static void UEncodeFrame(const CaptureJob& job, const unsigned char* rgba) {
+
+	// Comes from this encoder thread's own sub-arena, which only this thread rewinds
+	FrameVector<unsigned char> encoded;
+	bool ok = true;
+	if (captureFormat == CAPTURE_PNG) {
+		encoded.resize((size_t)job.width * job.height * 3);
+		UFlipToRgb(rgba, job.width, job.height, encoded.data());
+		char fileName[1024];
+		snprintf(fileName, sizeof(fileName), framePattern.c_str(), job.frame);
+		ok = SOIL_save_image(fileName, SOIL_SAVE_TYPE_PNG, job.width, job.height, 3, encoded.data()) != 0;
+	}
+	else {
+		if (captureFormat == CAPTURE_Y4M) {
+			size_t chroma = (size_t)((job.width + 1) / 2) * ((job.height + 1) / 2);
+			encoded.resize((size_t)job.width * job.height + 2 * chroma);
+			UFlipToYuv420(rgba, job.width, job.height, encoded.data());
+		}
+		else {
+			encoded.resize((size_t)job.width * job.height * 3);
+			UFlipToRgb(rgba, job.width, job.height, encoded.data());
+		}
+
+		// Conversion runs in parallel, appending waits for this frame's turn
+		{
+			unique_lock<mutex> lock(captureMutex);
+			jobDone.wait(lock, [&] { return nextWrite == job.frame; });
+		}
+		if (captureFormat == CAPTURE_Y4M) {
+			ok = fputs("FRAME\n", video) >= 0;
+		}
+		ok = ok && fwrite(encoded.data(), 1, encoded.size(), video) == encoded.size();
+		{
+			lock_guard<mutex> lock(captureMutex);
+			nextWrite++;
+		}
+		jobDone.notify_all();
+	}
+
+	lock_guard<mutex> lock(captureMutex);
+	if (ok) {
+		stats.written++;
+	}
+	else if (!writeFailed) {
+		writeFailed = true;
+		std::cerr << "Capture could not write frame " << job.frame << " to " << captureOptions.path << "\n";
+	}
+
+}
+
+
+static void UCaptureWorker(void) {
+
+	for (;;) {
+		CaptureJob job;
+		{
+			unique_lock<mutex> lock(captureMutex);
+			jobReady.wait(lock, [] { return stopping || !jobs.empty(); });
+			if (jobs.empty()) {
+				return; // stopping, and every frame is done
+			}
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+
+		// The slot stays reserved until this is done, so its mapping is not written meanwhile. A
+		// dropped frame of a video still takes its turn, so the frames after it get theirs.
+		if (!job.dropped) {
+			UEncodeFrame(job, (job.slot >= 0) ? slots[job.slot].mapped : job.pixels.data());
+		}
+		else if (captureFormat != CAPTURE_PNG) {
+			unique_lock<mutex> lock(captureMutex);
+			jobDone.wait(lock, [&] { return nextWrite == job.frame; });
+			nextWrite++;
+		}
+		{
+			lock_guard<mutex> lock(captureMutex);
+			if (job.slot >= 0) {
+				slots[job.slot].encoding = false;
+			}
+			else if (!job.dropped) {
+				spareCopies.push_back(std::move(job.pixels));
+			}
+		}
+		jobDone.notify_all();
+	}
+
+}
+
+
+// Hands the frame in a signalled slot to the encoders
+static void UHandOff(int index) {
+
+	CaptureSlot& slot = slots[index];
+	glDeleteSync(slot.fence);
+	slot.fence = 0;
+	slot.inFlight = false;
+
+	CaptureJob job;
+	job.frame = slot.frame;
+	job.width = ringWidth;
+	job.height = ringHeight;
+	job.slot = persistent ? index : -1;
+	job.dropped = false;
+	size_t bytes = (size_t)ringWidth * ringHeight * 4;
+
+	unique_lock<mutex> lock(captureMutex);
+	if (persistent) {
+		slot.encoding = true;
+	}
+	else {
+		// Copies are bounded too, the encoders falling behind must not grow memory without limit
+		if (jobs.size() >= slots.size() * 2) {
+			stats.stalls++;
+			jobDone.wait(lock, [] { return jobs.size() < slots.size() * 2; });
+		}
+		if (!spareCopies.empty()) {
+			job.pixels = std::move(spareCopies.back());
+			spareCopies.pop_back();
+		}
+		lock.unlock();
+
+		job.pixels.resize(bytes);
+		UStateBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+		const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+		if (pixels) {
+			memcpy(job.pixels.data(), pixels, bytes);
+		}
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		UStateBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		lock.lock();
+	}
+	jobs.push_back(std::move(job));
+	lock.unlock();
+	jobReady.notify_one();
+
+}
+
+
+// Gives up on the frame in a slot whose read did not finish within the wait. Its number still goes
+// to the encoders, so a video does not wait for it forever.
+static void UDropFrame(int index) {
+
+	CaptureSlot& slot = slots[index];
+	glDeleteSync(slot.fence);
+	slot.fence = 0;
+	slot.inFlight = false;
+
+	CaptureJob job;
+	job.frame = slot.frame;
+	job.width = ringWidth;
+	job.height = ringHeight;
+	job.slot = -1;
+	job.dropped = true;
+	{
+		lock_guard<mutex> lock(captureMutex);
+		stats.dropped++;
+		jobs.push_back(std::move(job));
+	}
+	jobReady.notify_one();
+
+}
+
+
+// Collects signalled reads oldest first, waiting for the oldest one when asked to. A read that
+// does not finish within that wait is dropped, so the slot is always free afterwards.
+static void UCollectFrames(bool waitOldest) {
+
+	for (size_t n = 0; n < slots.size(); n++) {
+		int index = (nextSlot + (int)n) % (int)slots.size();
+		if (!slots[index].inFlight) {
+			continue;
+		}
+		GLenum status = waitOldest ? glClientWaitSync(slots[index].fence, GL_SYNC_FLUSH_COMMANDS_BIT, CAPTURE_WAIT_NS)
+			: glClientWaitSync(slots[index].fence, 0, 0);
+		if (status == GL_TIMEOUT_EXPIRED && !waitOldest) {
+			return; // later reads cannot be done before this one
+		}
+		if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+			UDropFrame(index);
+		}
+		else {
+			UHandOff(index);
+		}
+		waitOldest = false;
+	}
+
+}
+
+
+// Waits for every read and every encoder using a mapping, then frees the ring
+static void UReleaseRing(void) {
+
+	if (slots.empty()) {
+		return;
+	}
+	for (size_t n = 0; n < slots.size(); n++) {
+		UCollectFrames(true);
+	}
+	{
+		unique_lock<mutex> lock(captureMutex);
+		jobDone.wait(lock, [] {
+			for (size_t i = 0; i < slots.size(); i++) {
+				if (slots[i].encoding) {
+					return false;
+				}
+			}
+			return true;
+		});
+	}
+	for (size_t i = 0; i < slots.size(); i++) {
+		if (slots[i].mapped) {
+			UStateBindBuffer(GL_PIXEL_PACK_BUFFER, slots[i].buffer);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		UGpuDeleteBuffer(slots[i].buffer);
+	}
+	UStateBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	slots.clear();
+	nextSlot = 0;
+
+}
+
+
+// (Re)creates the ring for frames of width x height
+static void UCreateRing(int width, int height) {
+
+	UReleaseRing();
+	ringWidth = width;
+	ringHeight = height;
+	GLsizeiptr bytes = (GLsizeiptr)width * height * 4;
+
+	slots.resize(captureOptions.ringSize);
+	for (size_t i = 0; i < slots.size(); i++) {
+		CaptureSlot& slot = slots[i];
+		slot.buffer = UGpuGenBuffer("capturePBO");
+		slot.fence = 0;
+		slot.mapped = NULL;
+		slot.inFlight = false;
+		slot.encoding = false;
+		slot.frame = -1;
+		UStateBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+		if (persistent) {
+			GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			UGpuBufferStorage(GL_PIXEL_PACK_BUFFER, slot.buffer, bytes, NULL, flags);
+			slot.mapped = (unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, flags);
+		}
+		else {
+			UGpuBufferData(GL_PIXEL_PACK_BUFFER, slot.buffer, bytes, NULL, GL_STREAM_READ);
+		}
+	}
+	UStateBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+}
+
+
+void UCaptureInit(const CaptureOptions& options) {
+
+	captureOptions = options;
+	memset(&stats, 0, sizeof(stats));
+	if (options.path.empty()) {
+		return;
+	}
+	if (!GLEW_ARB_sync) {
+		std::cerr << "Frame capture needs fence sync, --capture ignored\n";
+		return;
+	}
+
+	string extension = options.path.substr(options.path.find_last_of('.') + 1);
+	transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	captureFormat = (extension == "y4m") ? CAPTURE_Y4M : (extension == "raw") ? CAPTURE_RAW : CAPTURE_PNG;
+	if (captureFormat == CAPTURE_PNG) {
+		framePattern = options.path;
+		if (framePattern.find('%') == string::npos) {
+			size_t dot = framePattern.find_last_of('.');
+			framePattern.insert((dot == string::npos) ? framePattern.size() : dot, "_%05d");
+		}
+	}
+	else {
+		video = fopen(options.path.c_str(), "wb");
+		if (!video) {
+			std::cerr << "Cannot open " << options.path << " for capture\n";
+			return;
+		}
+	}
+
+	persistent = (GLEW_ARB_buffer_storage != 0);
+	int threads = options.threads;
+	if (threads == 0) {
+		threads = min(max((int)thread::hardware_concurrency() - 1, 1), CAPTURE_MAX_THREADS);
+	}
+	stopping = false;
+	nextWrite = 0;
+	for (int i = 0; i < threads; i++) {
+		encoders.push_back(thread(UCaptureWorker));
+	}
+	capturing = true;
+	stopped = false;
+	atexit(UCaptureShutdown);
+
+}
+
+
+void UCaptureFrame(int width, int height) {
+
+	if (!capturing || stopped || width <= 0 || height <= 0) {
+		return;
+	}
+	double start = UElapsedSeconds();
+
+	// A video keeps the size of its first frame
+	if (width != ringWidth || height != ringHeight) {
+		if (video && ringWidth != 0) {
+			std::cerr << "Window resized, video capture stopped after " << stats.frames << " frames\n";
+			stopped = true;
+			return;
+		}
+		UCreateRing(width, height);
+		if (captureFormat == CAPTURE_Y4M) {
+			fprintf(video, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n", width, height, captureOptions.fps);
+		}
+		else if (captureFormat == CAPTURE_RAW) {
+			std::cout << "Capturing raw video, play it with: ffplay -f rawvideo -pixel_format rgb24 -video_size "
+				<< width << "x" << height << " -framerate " << captureOptions.fps << " " << captureOptions.path << "\n";
+		}
+	}
+
+	// Everything that finished since last frame goes to the encoders
+	UCollectFrames(false);
+
+	// Only a ring too short for the GPU or the encoders makes the render thread wait here
+	CaptureSlot& slot = slots[nextSlot];
+	if (slot.inFlight) {
+		stats.stalls++;
+		UCollectFrames(true);
+	}
+	{
+		unique_lock<mutex> lock(captureMutex);
+		if (slot.encoding) {
+			stats.stalls++;
+			jobDone.wait(lock, [&] { return !slot.encoding; });
+		}
+	}
+
+	// Read the finished frame from the back buffer into the slot, the call returns at once
+	GLint readFramebuffer = 0;
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glReadBuffer(GL_BACK);
+	UStateBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+	UStateBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.inFlight = true;
+	slot.frame = stats.frames++;
+	nextSlot = (nextSlot + 1) % (int)slots.size();
+
+	if (captureOptions.frameLimit > 0 && stats.frames >= captureOptions.frameLimit) {
+		stopped = true;
+	}
+	double ms = (UElapsedSeconds() - start) * 1000.0;
+	stats.renderMs += ms;
+	stats.maxFrameMs = max(stats.maxFrameMs, ms);
+
+}
+
+
+CaptureStats UCaptureStats(void) {
+
+	lock_guard<mutex> lock(captureMutex);
+	return stats;
+
+}
+
+
+void UCaptureFinish(void) {
+
+	if (capturing) {
+		UReleaseRing();
+	}
+
+}
+
+
+void UCaptureShutdown(void) {
+
+	if (!capturing) {
+		return;
+	}
+	capturing = false;
+
+	// Every read still in flight is encoded before the threads stop
+	UReleaseRing();
+	{
+		lock_guard<mutex> lock(captureMutex);
+		stopping = true;
+	}
+	jobReady.notify_all();
+	for (size_t i = 0; i < encoders.size(); i++) {
+		encoders[i].join();
+	}
+	encoders.clear();
+	if (video) {
+		fclose(video);
+		video = NULL;
+	}
+
+	ostringstream report;
+	report << fixed << setprecision(3) << "Captured " << stats.written << " of " << stats.frames << " frames to " << captureOptions.path
+		<< (persistent ? " (persistent mapping)" : " (mapped copies)") << ": render thread "
+		<< (stats.frames ? stats.renderMs / stats.frames : 0.0) << " ms per frame, " << stats.maxFrameMs << " ms worst, "
+		<< stats.stalls << " stalls";
+	if (stats.dropped > 0) {
+		report << ", " << stats.dropped << " frames dropped after the GPU took over " << CAPTURE_WAIT_NS / 1000000000ull << " s";
+	}
+	report << "\n";
+	std::cout << report.str();
+
+}
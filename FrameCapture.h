@@ -0,0 +1,64 @@
+/*
+*	Title:	Final Project / FrameCapture.h
+*	Date:	October 19, 2026
+*
+*	Description: Frame capture for reviews and visual regression. Each frame
+*	is read back into the next of a ring of pixel buffer objects and fenced,
+*	and only mapped a few frames later once its fence has signalled, so the
+*	render loop never waits on the GPU. Where buffer storage is available the
+*	ring stays persistently mapped and encoder threads read it in place,
+*	otherwise the GL thread copies each frame out. Encoding runs on
+*	background threads: PNG files are written in any order, video frames are
+*	converted in parallel and written in order.
+*
+*	Command line:
+*		--capture <path>			capture every frame, the extension picks the format:
+*									.png a numbered sequence (printf pattern such as
+*									shots/frame_%05d.png, or a number is appended),
+*									.y4m YUV 4:2:0 video, .raw packed RGB video
+*		--capture-frames <count>	stop after this many frames, default no limit
+*		--capture-fps <rate>		frame rate written to the video header, default 60
+*		--capture-ring <count>		pixel buffers in the ring, default 4
+*		--capture-threads <count>	encoder threads, default one per spare core
+*/
+
+#pragma once
+
+#include <string>
+
+struct CaptureOptions {
+	std::string path;			// empty when not capturing
+	int frameLimit;				// 0 for no limit
+	int fps;
+	int ringSize;
+	int threads;
+};
+
+struct CaptureStats {
+	int frames;					// frames read back
+	int written;				// frames encoded and on disk
+	double renderMs;			// total render thread time spent in UCaptureFrame
+	double maxFrameMs;			// worst single UCaptureFrame
+	int stalls;					// times the render thread had to wait for the GPU or the encoders
+	int dropped;				// frames whose read the GPU did not finish within the wait, skipped
+};
+
+// Reads the capture options out of the command line, returns false on a malformed argument
+bool UParseCaptureOptions(int argc, char* argv[], CaptureOptions& options);
+
+// Creates the pixel buffer ring and the encoder threads, does nothing without --capture
+void UCaptureInit(const CaptureOptions& options);
+
+// Queues a read of the finished frame in the back buffer, call before the swap
+void UCaptureFrame(int width, int height);
+
+CaptureStats UCaptureStats(void);
+
+// Waits for the reads still in flight and the encoders using them, then unmaps and frees the ring.
+// Call while the context is still current.
+void UCaptureFinish(void);
+
+// Stops the encoders once every frame is written and prints the stats, freeing the ring first if
+// UCaptureFinish has not. Safe to call twice, and also run at exit since replays end the process
+// from inside the main loop with the context still current.
+void UCaptureShutdown(void);
@@ -0,0 +1,233 @@
+/*
+*	Title:	Final Project / Geometry.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Hand-built table and light geometry, moved out of UCreateBuffers.
+*/
+
+#include "Geometry.h"
+
+using namespace std; // standard namespace
+
+
+void UBuildTableLegs(Mesh& mesh) {
+
+	static const float legVertices[] = {
+
+		// Position				// Normals				//TexCoords
+		// Left Front Leg		
+		-0.5f, -0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		0.0f, 0.0f,		// vert 0 
+		-0.4f, -0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		1.0f, 0.0f,		// vert 1
+		-0.4f,  0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		1.0f, 1.0f,		// vert 2
+		-0.5f,  0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		0.0f, 1.0f,		// vert 3
+		-0.5f, -0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		1.0f, 0.0f,		// vert 4 
+		-0.5f,  0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		1.0f, 1.0f,		// vert 5
+		-0.4f, -0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		0.0f, 0.0f,		// vert 6
+		-0.4f,	0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		0.0f, 1.0f,		// vert 7
+
+		 // Right Front Leg
+		 0.4f, -0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		0.0f, 0.0f,		// vert 8 
+		 0.5f, -0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		1.0f, 0.0f,		// vert 9
+		 0.5f,  0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		1.0f, 1.0f,		// vert 10
+		 0.4f,  0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		0.0f, 1.0f,		// vert 11
+		 0.4f, -0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		1.0f, 0.0f,		// vert 12
+		 0.4f,  0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		1.0f, 1.0f,		// vert 13
+		 0.5f, -0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		0.0f, 0.0f,		// vert 14
+		 0.5f,  0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		0.0f, 1.0f,		// vert 15
+
+		 // Right Back Leg
+		 0.4f, -0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		0.0f, 0.0f,		// vert 16
+		 0.5f, -0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		1.0f, 0.0f,		// vert 17
+		 0.5f,  0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		1.0f, 1.0f,		// vert 18
+		 0.4f,  0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		0.0f, 1.0f,		// vert 19
+		 0.4f, -0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		1.0f, 0.0f,		// vert 20
+		 0.4f,  0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		1.0f, 1.0f,		// vert 21
+		 0.5f, -0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		0.0f, 0.0f,		// vert 22
+		 0.5f,  0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		0.0f, 1.0f,		// vert 23
+
+		// Left Back Leg
+		-0.5f, -0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		0.0f, 0.0f,		// vert 24
+		-0.4f, -0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		1.0f, 0.0f,		// vert 25
+		-0.4f,  0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		1.0f, 1.0f,		// vert 26
+		-0.5f,  0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		0.0f, 1.0f,		// vert 27
+		-0.5f, -0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		1.0f, 0.0f,		// vert 28
+		-0.5f,  0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		1.0f, 1.0f,		// vert 29
+		-0.4f, -0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		0.0f, 0.0f,		// vert 30
+		-0.4f,  0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		0.0f, 1.0f		// vert 31
+	};
+
+	static const unsigned int legIndicies[]
+	{
+		// Left Front Leg
+		0,1,2,		2,3,0,		3,0,4,		4,5,3,		5,4,6,		6,7,5,
+		6,7,2,		2,1,6,		3,2,7,		7,5,3,		0,1,6,		6,4,0,
+
+		// Right Front Leg
+		8,9,10,		10,11,8,	11,8,12,	12,13,11,	13,12,14,	14,15,13,
+		14,15,10,	10,9,14,	11,10,15,	15,13,11,	8,9,14,		14,12,8,
+
+		// Right Back Leg
+		16,17,18,	18,19,16,	19,16,20,	20,21,19,	21,20,22,	22,23,21,
+		22,23,18,	18,17,22,	19,18,23,	23,21,19,	16,17,22,	22,20,16,
+
+		// Left Back Leg
+		24,25,26,	26,27,24,	27,24,28,	28,29,27,	29,28,30,	30,31,29,
+		30,31,26,	26,25,30,	27,26,31,	31,29,27,	24,25,30,	30,28,24
+
+	};
+
+	mesh.vertices.assign(legVertices, legVertices + sizeof(legVertices) / sizeof(float));
+	mesh.indices.assign(legIndicies, legIndicies + sizeof(legIndicies) / sizeof(unsigned int));
+
+}
+
+
+void UBuildTableTop(Mesh& mesh) {
+
+	static const float topVertices[]
+	{
+
+		// Table Top
+		-0.6f,  0.5f,  0.6f,	0.0f, 1.0f, 1.0f,		0.0f, 0.0f,		// vert 0
+		 0.6f,  0.5f,  0.6f,	0.0f, 1.0f, 1.0f,		1.0f, 0.0f,		// vert 1	
+		 0.6f,  0.6f,  0.6f,	0.0f, 1.0f, 1.0f,		1.0f, 1.0f,		// vert 2	
+		-0.6f,  0.6f,  0.6f,	0.0f, 1.0f, 1.0f,		0.0f, 1.0f,		// vert 3	
+		-0.6f,  0.5f, -0.6f,	0.0f, 1.0f, 1.0f,		1.0f, 0.0f,		// vert 4	
+		-0.6f,  0.6f, -0.6f,	0.0f, 1.0f, 1.0f,		1.0f, 1.0f,		// vert 5	
+		 0.6f,  0.5f, -0.6f,	0.0f, 1.0f, 1.0f,		0.0f, 0.0f,		// vert 6	
+		 0.6f,  0.6f, -0.6f,	0.0f, 1.0f, 1.0f,		0.0f, 1.0f		// vert 7	
+
+	};
+
+	static const unsigned int topIndices[]
+	{
+
+		// Table Top
+		0,1,2,		2,3,0,		3,0,4,		4,5,3,		5,4,6,		6,7,5,
+		6,7,2,		2,1,6,		3,2,7,		7,5,3,		0,1,6,		6,4,0
+
+	};
+
+	mesh.vertices.assign(topVertices, topVertices + sizeof(topVertices) / sizeof(float));
+	mesh.indices.assign(topIndices, topIndices + sizeof(topIndices) / sizeof(unsigned int));
+
+}
+
+
+static Shape UShape(float lowX, float lowY, float lowZ, float highX, float highY, float highZ, unsigned int kind, unsigned int material) {
+
+	Shape shape = { glm::vec3(lowX, lowY, lowZ), kind, glm::vec3(highX, highY, highZ), material };
+	return shape;
+
+}
+
+
+void UBuildTableLegShapes(vector<Shape>& shapes, unsigned int material) {
+
+	// Same legs in the same order as legVertices
+	unsigned int kind = SHAPE_BOX | SHAPE_NORMALS_ENDS << 8;
+	shapes.push_back(UShape(-0.5f, -0.5f,  0.4f,	-0.4f, 0.5f,  0.5f,		kind, material));	// Left Front Leg
+	shapes.push_back(UShape( 0.4f, -0.5f,  0.4f,	 0.5f, 0.5f,  0.5f,		kind, material));	// Right Front Leg
+	shapes.push_back(UShape( 0.4f, -0.5f, -0.5f,	 0.5f, 0.5f, -0.4f,		kind, material));	// Right Back Leg
+	shapes.push_back(UShape(-0.5f, -0.5f, -0.5f,	-0.4f, 0.5f, -0.4f,		kind, material));	// Left Back Leg
+
+}
+
+
+void UBuildTableTopShapes(vector<Shape>& shapes, unsigned int material) {
+
+	shapes.push_back(UShape(-0.6f, 0.5f, -0.6f,		0.6f, 0.6f, 0.6f,		SHAPE_BOX | SHAPE_NORMALS_TILTED << 8, material));
+
+}
+
+
+void UBuildLightCube(vector<float>& vertices) {
+
+	static const float lightV[]
+	{
+		//Position				
+		// Back Face			
+		 0.5f, -0.5f, -0.5f,
+		 0.5f,  0.5f, -0.5f,
+		 0.5f,  0.5f, -0.5f,
+		-0.5f,  0.5f, -0.5f,
+		-0.5f, -0.5f, -0.5f,
+
+		// Front Face
+		-0.5f, -0.5f,  0.5f,
+		 0.5f, -0.5f,  0.5f,
+		 0.5f,  0.5f,  0.5f,
+		 0.5f,  0.5f,  0.5f,
+		-0.5f,  0.5f,  0.5f,
+		-0.5f, -0.5f,  0.5f,
+
+		// Left Face
+		-0.5f,  0.5f,  0.5f,
+		-0.5f,  0.5f, -0.5f,
+		-0.5f, -0.5f, -0.5f,
+		-0.5f, -0.5f, -0.5f,
+		-0.5f, -0.5f,  0.5f,
+		-0.5f,  0.5f,  0.5f,
+
+		// Right Face
+		 0.5f,  0.5f,  0.5f,
+		 0.5f,  0.5f, -0.5f,
+		 0.5f, -0.5f, -0.5f,
+		 0.5f, -0.5f, -0.5f,
+		 0.5f, -0.5f,  0.5f,
+		 0.5f,  0.5f,  0.5f,
+
+		// Bottom Face
+		-0.5f, -0.5f, -0.5f,
+		 0.5f, -0.5f, -0.5f,
+		 0.5f, -0.5f,  0.5f,
+		 0.5f, -0.5f,  0.5f,
+		-0.5f, -0.5f,  0.5f,
+		-0.5f, -0.5f, -0.5f,
+
+		// Top Face	
+		-0.5f,  0.5f, -0.5f,
+		 0.5f,  0.5f, -0.5f,
+		 0.5f,  0.5f,  0.5f,
+		 0.5f,  0.5f,  0.5f,
+		-0.5f,  0.5f,  0.5f,
+		-0.5f,  0.5f, -0.5f
+	
+	};
+
+	vertices.assign(lightV, lightV + sizeof(lightV) / sizeof(float));
+
+}
+
+
+void UAppendMesh(Mesh& destination, const Mesh& source, const glm::mat4& transform) {
+
+	unsigned int baseVertex = (unsigned int)UMeshVertexCount(destination);
+	glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+
+	for (size_t v = 0; v < source.vertices.size(); v += VERTEX_FLOATS) {
+		const float* in = &source.vertices[v];
+		glm::vec4 position = transform * glm::vec4(in[0], in[1], in[2], 1.0f);
+		glm::vec3 normal = normalMatrix * glm::vec3(in[3], in[4], in[5]);
+		float out[VERTEX_FLOATS] = { position.x, position.y, position.z, normal.x, normal.y, normal.z, in[6], in[7] };
+		destination.vertices.insert(destination.vertices.end(), out, out + VERTEX_FLOATS);
+	}
+
+	for (size_t i = 0; i < source.indices.size(); i++) {
+		destination.indices.push_back(baseVertex + source.indices[i]);
+	}
+
+}
+
+
+void UMeshBounds(const Mesh& mesh, glm::vec3& boundsMin, glm::vec3& boundsMax) {
+
+	boundsMin = glm::vec3(0.0f);
+	boundsMax = glm::vec3(0.0f);
+	for (size_t v = 0; v < mesh.vertices.size(); v += VERTEX_FLOATS) {
+		glm::vec3 position(mesh.vertices[v], mesh.vertices[v + 1], mesh.vertices[v + 2]);
+		boundsMin = (v == 0) ? position : glm::min(boundsMin, position);
+		boundsMax = (v == 0) ? position : glm::max(boundsMax, position);
+	}
+
+}
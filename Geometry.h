@@ -0,0 +1,68 @@
+/*
+*	Title:	Final Project / Geometry.h
+*	Date:	October 19, 2026
+*
+*	Description: CPU-side mesh data in the interleaved layout legVAO and topVAO
+*	read, and the same tables as shapes for vertex pulling. Nothing here needs
+*	a GL context.
+*/
+
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Floats per vertex: position (3), normal (3), texture coordinate (2)
+#define VERTEX_FLOATS 8
+
+// Interleaved vertices plus triangle indices
+struct Mesh {
+	std::vector<float> vertices;
+	std::vector<unsigned int> indices;
+};
+
+inline size_t UMeshVertexCount(const Mesh& mesh) {
+	return mesh.vertices.size() / VERTEX_FLOATS;
+}
+
+// The four table legs, 32 vertices
+void UBuildTableLegs(Mesh& mesh);
+
+// The table top slab, 8 vertices
+void UBuildTableTop(Mesh& mesh);
+
+// Kinds of shape vertex pulling draws, see VertexPulling.h
+enum ShapeKind {
+	SHAPE_BOX,
+	SHAPE_PYRAMID				// square base at low.y, apex over its center at high.y
+};
+
+// Normals of a shape's corners. The hand-built meshes give each box corner one normal
+// rather than one per face, and their shapes say which of those they follow.
+enum ShapeNormals {
+	SHAPE_NORMALS_FACE,			// flat, one per face
+	SHAPE_NORMALS_ENDS,			// +Z on the front corners and -Z on the back ones, as the legs
+	SHAPE_NORMALS_TILTED		// (0, 1, 1) on every corner, as the top
+};
+
+// A box or pyramid filling low to high, laid out as the pulling shader reads it (std430)
+struct Shape {
+	glm::vec3 low;
+	unsigned int kind;			// ShapeKind | ShapeNormals << 8
+	glm::vec3 high;
+	unsigned int material;
+};
+
+// The table legs and top as shapes, with the corners, normals and texture coordinates of
+// UBuildTableLegs and UBuildTableTop
+void UBuildTableLegShapes(std::vector<Shape>& shapes, unsigned int material);
+void UBuildTableTopShapes(std::vector<Shape>& shapes, unsigned int material);
+
+// Light marker cube, positions only
+void UBuildLightCube(std::vector<float>& vertices);
+
+// Appends source to destination with positions and normals transformed and indices rebased
+void UAppendMesh(Mesh& destination, const Mesh& source, const glm::mat4& transform);
+
+// Axis-aligned box around every vertex position, both zero for an empty mesh
+void UMeshBounds(const Mesh& mesh, glm::vec3& boundsMin, glm::vec3& boundsMax);
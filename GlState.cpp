@@ -0,0 +1,352 @@
+/*
+*	Title:	Final Project / GlState.cpp
+*	Date:	October 19, 2026
+*
+*	Description: GL state cache. Bindings live in small fixed tables indexed
+*	by target slot, a target the tables do not know is passed straight through
+*	and counted as issued. The element array binding belongs to the vertex
+*	array, so it becomes unknown whenever the vertex array changes.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "GlState.h"
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+// Marks a binding the cache cannot vouch for
+#define STATE_UNKNOWN 0xFFFFFFFFu
+
+#define STATE_TEXTURE_UNITS 32
+#define STATE_INDEXED_BINDINGS 16
+#define STATE_CAPABILITIES 16
+
+static const GLenum bufferTargets[] = {
+	GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER,
+	GL_DRAW_INDIRECT_BUFFER, GL_DISPATCH_INDIRECT_BUFFER, GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER,
+	GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER
+};
+static const GLenum indexedTargets[] = { GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER };
+static const GLenum textureTargets[] = { GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP };
+
+#define BUFFER_TARGETS (sizeof(bufferTargets) / sizeof(bufferTargets[0]))
+#define INDEXED_TARGETS (sizeof(indexedTargets) / sizeof(indexedTargets[0]))
+#define TEXTURE_TARGETS (sizeof(textureTargets) / sizeof(textureTargets[0]))
+
+struct Capability {
+	GLenum name;
+	int enabled;				// -1 unknown
+};
+
+static GLuint program = STATE_UNKNOWN;
+static GLuint vertexArray = STATE_UNKNOWN;
+static GLuint buffers[BUFFER_TARGETS];
+static GLuint indexedBuffers[INDEXED_TARGETS][STATE_INDEXED_BINDINGS];
+static GLuint activeUnit = STATE_UNKNOWN;
+static GLuint textures[STATE_TEXTURE_UNITS][TEXTURE_TARGETS];
+static Capability capabilities[STATE_CAPABILITIES];
+static int capabilityCount = 0;
+static bool initialized = false;
+
+// This frame's counters, and the sums over every ended frame
+static GlStateStats frameStats = {};
+static long long runIssued[STATE_KINDS];
+static long long runElided[STATE_KINDS];
+static int framesEnded = 0;
+
+static const char* kindNames[STATE_KINDS] = { "programs", "vertex arrays", "buffers", "textures", "capabilities" };
+
+
+// Index of target in a slot table, -1 when the cache does not track it
+static int USlot(const GLenum* targets, size_t count, GLenum target) {
+
+	for (size_t i = 0; i < count; i++) {
+		if (targets[i] == target) {
+			return (int)i;
+		}
+	}
+	return -1;
+
+}
+
+
+// Counts a call, true when it has to reach the driver
+static bool UChange(GlStateKind kind, GLuint& current, GLuint value) {
+
+	if (!initialized) {
+		UStateInvalidate();
+	}
+	if (current == value) {
+		frameStats.elided[kind]++;
+		frameStats.totalElided++;
+		return false;
+	}
+	current = value;
+	frameStats.issued[kind]++;
+	frameStats.totalIssued++;
+	return true;
+
+}
+
+
+// Counts a call the cache does not track
+static void UPassThrough(GlStateKind kind) {
+
+	frameStats.issued[kind]++;
+	frameStats.totalIssued++;
+
+}
+
+
+void UStateUseProgram(GLuint name) {
+
+	if (UChange(STATE_PROGRAM, program, name)) {
+		glUseProgram(name);
+	}
+
+}
+
+
+void UStateBindVertexArray(GLuint name) {
+
+	if (UChange(STATE_VERTEX_ARRAY, vertexArray, name)) {
+		glBindVertexArray(name);
+		buffers[USlot(bufferTargets, BUFFER_TARGETS, GL_ELEMENT_ARRAY_BUFFER)] = STATE_UNKNOWN;
+	}
+
+}
+
+
+void UStateBindBuffer(GLenum target, GLuint buffer) {
+
+	int slot = USlot(bufferTargets, BUFFER_TARGETS, target);
+	if (slot < 0) {
+		UPassThrough(STATE_BUFFER);
+		glBindBuffer(target, buffer);
+	}
+	else if (UChange(STATE_BUFFER, buffers[slot], buffer)) {
+		glBindBuffer(target, buffer);
+	}
+
+}
+
+
+void UStateBindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+
+	int slot = USlot(indexedTargets, INDEXED_TARGETS, target);
+	if (slot < 0 || index >= STATE_INDEXED_BINDINGS) {
+		UPassThrough(STATE_BUFFER);
+		glBindBufferBase(target, index, buffer);
+	}
+	else if (UChange(STATE_BUFFER, indexedBuffers[slot][index], buffer)) {
+		glBindBufferBase(target, index, buffer);
+	}
+	else {
+		return;
+	}
+
+	// The plain binding point follows the indexed one
+	int plain = USlot(bufferTargets, BUFFER_TARGETS, target);
+	if (plain >= 0) {
+		buffers[plain] = buffer;
+	}
+
+}
+
+
+void UStateBindTexture(GLuint unit, GLenum target, GLuint texture) {
+
+	int slot = USlot(textureTargets, TEXTURE_TARGETS, target);
+	bool tracked = slot >= 0 && unit < STATE_TEXTURE_UNITS;
+	if (!initialized) {
+		UStateInvalidate();
+	}
+	if (tracked && textures[unit][slot] == texture) {
+		UChange(STATE_TEXTURE, textures[unit][slot], texture);
+		return;
+	}
+
+	// Only a bind that reaches the driver needs its unit active
+	if (activeUnit != unit) {
+		activeUnit = unit;
+		UPassThrough(STATE_TEXTURE);
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+	if (tracked) {
+		UChange(STATE_TEXTURE, textures[unit][slot], texture);
+	}
+	else {
+		UPassThrough(STATE_TEXTURE);
+	}
+	glBindTexture(target, texture);
+
+}
+
+
+// Sets a capability, enabled is 0 or 1
+static void USetCapability(GLenum name, int enabled) {
+
+	if (!initialized) {
+		UStateInvalidate();
+	}
+
+	Capability* capability = 0;
+	for (int i = 0; i < capabilityCount; i++) {
+		if (capabilities[i].name == name) {
+			capability = &capabilities[i];
+			break;
+		}
+	}
+	if (capability == 0 && capabilityCount < STATE_CAPABILITIES) {
+		capability = &capabilities[capabilityCount++];
+		capability->name = name;
+		capability->enabled = -1;
+	}
+
+	if (capability != 0 && capability->enabled == enabled) {
+		frameStats.elided[STATE_CAPABILITY]++;
+		frameStats.totalElided++;
+		return;
+	}
+	if (capability != 0) {
+		capability->enabled = enabled;
+	}
+	UPassThrough(STATE_CAPABILITY);
+	if (enabled) {
+		glEnable(name);
+	}
+	else {
+		glDisable(name);
+	}
+
+}
+
+
+void UStateEnable(GLenum capability) {
+
+	USetCapability(capability, 1);
+
+}
+
+
+void UStateDisable(GLenum capability) {
+
+	USetCapability(capability, 0);
+
+}
+
+
+bool UStateIsEnabled(GLenum name) {
+
+	for (int i = 0; i < capabilityCount; i++) {
+		if (capabilities[i].name == name && capabilities[i].enabled >= 0) {
+			return capabilities[i].enabled == 1;
+		}
+	}
+	return glIsEnabled(name) == GL_TRUE;
+
+}
+
+
+void UStateInvalidate(void) {
+
+	program = STATE_UNKNOWN;
+	vertexArray = STATE_UNKNOWN;
+	activeUnit = STATE_UNKNOWN;
+	for (size_t t = 0; t < BUFFER_TARGETS; t++) {
+		buffers[t] = STATE_UNKNOWN;
+	}
+	for (size_t t = 0; t < INDEXED_TARGETS; t++) {
+		for (int i = 0; i < STATE_INDEXED_BINDINGS; i++) {
+			indexedBuffers[t][i] = STATE_UNKNOWN;
+		}
+	}
+	for (int unit = 0; unit < STATE_TEXTURE_UNITS; unit++) {
+		for (size_t t = 0; t < TEXTURE_TARGETS; t++) {
+			textures[unit][t] = STATE_UNKNOWN;
+		}
+	}
+	for (int i = 0; i < capabilityCount; i++) {
+		capabilities[i].enabled = -1;
+	}
+	initialized = true;
+
+}
+
+
+void UStateForget(GpuResourceType type, GLuint name) {
+
+	if (name == 0 || !initialized) {
+		return;
+	}
+
+	// A deleted program stays current until another replaces it, so only bindings need forgetting
+	if (type == GPU_BUFFER) {
+		for (size_t t = 0; t < BUFFER_TARGETS; t++) {
+			if (buffers[t] == name) {
+				buffers[t] = STATE_UNKNOWN;
+			}
+		}
+		for (size_t t = 0; t < INDEXED_TARGETS; t++) {
+			for (int i = 0; i < STATE_INDEXED_BINDINGS; i++) {
+				if (indexedBuffers[t][i] == name) {
+					indexedBuffers[t][i] = STATE_UNKNOWN;
+				}
+			}
+		}
+	}
+	else if (type == GPU_TEXTURE) {
+		for (int unit = 0; unit < STATE_TEXTURE_UNITS; unit++) {
+			for (size_t t = 0; t < TEXTURE_TARGETS; t++) {
+				if (textures[unit][t] == name) {
+					textures[unit][t] = STATE_UNKNOWN;
+				}
+			}
+		}
+	}
+	else if (type == GPU_VERTEX_ARRAY && vertexArray == name) {
+		vertexArray = STATE_UNKNOWN;
+		buffers[USlot(bufferTargets, BUFFER_TARGETS, GL_ELEMENT_ARRAY_BUFFER)] = STATE_UNKNOWN;
+	}
+
+}
+
+
+GlStateStats UStateFrameStats(void) {
+
+	return frameStats;
+
+}
+
+
+GlStateStats UStateEndFrame(void) {
+
+	GlStateStats ended = frameStats;
+	for (int kind = 0; kind < STATE_KINDS; kind++) {
+		runIssued[kind] += ended.issued[kind];
+		runElided[kind] += ended.elided[kind];
+	}
+	framesEnded++;
+	frameStats = GlStateStats();
+	return ended;
+
+}
+
+
+void UStatePrintStats(void) {
+
+	if (framesEnded == 0) {
+		return;
+	}
+	ostringstream report;
+	report << fixed << setprecision(1);
+	for (int kind = 0; kind < STATE_KINDS; kind++) {
+		report << "GL " << kindNames[kind] << ": " << (double)runIssued[kind] / framesEnded << " issued, "
+			<< (double)runElided[kind] / framesEnded << " elided per frame\n";
+	}
+	std::cout << report.str();
+
+}
@@ -0,0 +1,68 @@
+/*
+*	Title:	Final Project / GlState.h
+*	Date:	October 19, 2026
+*
+*	Description: Cache of the GL binding and enable state the renderer
+*	touches: the program, the vertex array, buffer bindings (plain and
+*	indexed), the texture bound to each target of each unit and the
+*	enable/disable capabilities. A call that would set the value already
+*	current is skipped, and every call is counted as issued or elided per
+*	frame so replays can report how much driver work the renderer asks for.
+*
+*	Everything starts out unknown, so the first call of each kind always
+*	reaches the driver. Code that changes this state behind the cache's back
+*	must call UStateInvalidate afterwards. GL thread only.
+*/
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include "GpuResources.h"
+
+enum GlStateKind {
+	STATE_PROGRAM,
+	STATE_VERTEX_ARRAY,
+	STATE_BUFFER,
+	STATE_TEXTURE,				// binds and the unit switches they need
+	STATE_CAPABILITY,
+	STATE_KINDS
+};
+
+struct GlStateStats {
+	int issued[STATE_KINDS];	// calls that reached the driver
+	int elided[STATE_KINDS];	// calls skipped because the value was already set
+	int totalIssued;
+	int totalElided;
+};
+
+void UStateUseProgram(GLuint program);
+void UStateBindVertexArray(GLuint vertexArray);
+void UStateBindBuffer(GLenum target, GLuint buffer);
+
+// Indexed binding, also leaves buffer on the plain target as glBindBufferBase does
+void UStateBindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+// Binds texture to target on the given unit, switching the active unit only when needed
+void UStateBindTexture(GLuint unit, GLenum target, GLuint texture);
+
+void UStateEnable(GLenum capability);
+void UStateDisable(GLenum capability);
+
+// Whether capability is on, asks the driver only when the cache does not know
+bool UStateIsEnabled(GLenum capability);
+
+// Forgets everything, the next call of each kind reaches the driver
+void UStateInvalidate(void);
+
+// Called by the GpuResources deletion wrappers, deleting a bound object resets its bindings
+void UStateForget(GpuResourceType type, GLuint name);
+
+// Counters of the frame so far
+GlStateStats UStateFrameStats(void);
+
+// Ends the frame, returns its counters and starts the next frame's from zero
+GlStateStats UStateEndFrame(void);
+
+// Prints issued and elided calls per frame by kind, averaged over every ended frame
+void UStatePrintStats(void);
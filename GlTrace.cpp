@@ -0,0 +1,1300 @@
+/*
+*	Title:	Final Project / GlTrace.cpp
+*	Date:	October 19, 2026
+*
+*	Description: GL call recorder. Records are built in memory and written in
+*	large blocks, so tracing costs a copy per call rather than a file write.
+*	Values are stored in the host's byte order at their GL type's size,
+*	pointer sized integers and offsets as 64 bits. Inline data carries its
+*	byte count so the replayer never has to work out a size. The bindings
+*	that decide whether a pointer is an offset and the mapped buffer ranges
+*	are tracked here as the calls go by.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#define GL_TRACE_NO_HOOKS
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+#define TRACE_FLUSH_BYTES (4 << 20)		// records buffered before a write
+
+// A mapped range, written back into the trace when it is unmapped
+struct TraceMapping {
+	void* pointer;
+	long long length;
+	GLbitfield access;
+};
+
+static const char* callNames[TRACE_CALL_COUNT] = {
+	"end",
+	"setup end",
+	"frame end",
+	"glActiveTexture",
+	"glAttachShader",
+	"glBeginQuery",
+	"glBindBuffer",
+	"glBindBufferBase",
+	"glBindFramebuffer",
+	"glBindImageTexture",
+	"glBindTexture",
+	"glBindVertexArray",
+	"glBufferData",
+	"glBufferStorage",
+	"glBufferSubData",
+	"glCheckFramebufferStatus",
+	"glClear",
+	"glClearColor",
+	"glClientWaitSync",
+	"glCompileShader",
+	"glCompressedTexImage3D",
+	"glCreateProgram",
+	"glCreateShader",
+	"glDeleteBuffers",
+	"glDeleteFramebuffers",
+	"glDeleteProgram",
+	"glDeleteQueries",
+	"glDeleteShader",
+	"glDeleteSync",
+	"glDeleteTextures",
+	"glDeleteVertexArrays",
+	"glDetachShader",
+	"glDisable",
+	"glDispatchCompute",
+	"glDrawArrays",
+	"glDrawArraysInstanced",
+	"glDrawElementsIndirect",
+	"glDrawElementsInstanced",
+	"glEnable",
+	"glEnableVertexAttribArray",
+	"glEndQuery",
+	"glFenceSync",
+	"glFinish",
+	"glFramebufferTexture2D",
+	"glGenBuffers",
+	"glGenFramebuffers",
+	"glGenQueries",
+	"glGenTextures",
+	"glGenVertexArrays",
+	"glGetInteger64v",
+	"glGetIntegerv",
+	"glGetProgramInfoLog",
+	"glGetProgramiv",
+	"glGetQueryObjectui64v",
+	"glGetShaderInfoLog",
+	"glGetShaderiv",
+	"glGetUniformBlockIndex",
+	"glGetUniformLocation",
+	"glIsEnabled",
+	"glLinkProgram",
+	"glMapBufferRange",
+	"glMaxShaderCompilerThreadsKHR",
+	"glMemoryBarrier",
+	"glQueryCounter",
+	"glReadBuffer",
+	"glReadPixels",
+	"glScissor",
+	"glShaderSource",
+	"glTexImage2D",
+	"glTexImage3D",
+	"glTexParameteri",
+	"glUniform1f",
+	"glUniform1i",
+	"glUniform1ui",
+	"glUniform1uiv",
+	"glUniform2f",
+	"glUniform2i",
+	"glUniform2iv",
+	"glUniform3f",
+	"glUniform3fv",
+	"glUniformBlockBinding",
+	"glUniformMatrix4fv",
+	"glUnmapBuffer",
+	"glUseProgram",
+	"glVertexAttribDivisor",
+	"glVertexAttribIPointer",
+	"glVertexAttribPointer",
+	"glViewport",
+	"glViewportArrayv"
+};
+
+static TraceOptions options;
+static ofstream traceFile;
+static vector<unsigned char> pending;
+static TraceHeader header;
+static bool tracing = false;
+static long long callsRecorded = 0;
+static long long bytesWritten = 0;
+
+// Bindings that turn a pointer argument into an offset
+static GLuint packBuffer = 0;
+static GLuint unpackBuffer = 0;
+static map<GLenum, TraceMapping> mappings;
+
+
+bool UParseTraceOptions(int argc, char* argv[], TraceOptions& options) {
+
+	options.path.clear();
+	options.frames = 60;
+
+	const char* flags[] = { "--gl-trace", "--gl-trace-frames" };
+	const int flagCount = sizeof(flags) / sizeof(flags[0]);
+
+	for (int i = 1; i < argc; i++) {
+		int flag = 0;
+		while (flag < flagCount && strcmp(argv[i], flags[flag]) != 0) {
+			flag++;
+		}
+		if (flag == flagCount) {
+			continue; // not ours
+		}
+		if (i + 1 >= argc) {
+			std::cerr << argv[i] << " needs a value\n";
+			return false;
+		}
+
+		const char* value = argv[++i];
+		switch (flag) {
+		case 0: options.path = value; break;
+		case 1: options.frames = max(0, atoi(value)); break;
+		}
+	}
+	return true;
+
+}
+
+
+static void UFlush(void) {
+
+	traceFile.write((const char*)pending.data(), pending.size());
+	bytesWritten += pending.size();
+	pending.clear();
+
+}
+
+
+static void UPutBytes(const void* data, size_t size) {
+
+	const unsigned char* bytes = (const unsigned char*)data;
+	pending.insert(pending.end(), bytes, bytes + size);
+
+}
+
+
+template <typename T>
+static void UPut(const T& value) {
+
+	UPutBytes(&value, sizeof(T));
+
+}
+
+
+static void URecordArgs(void) {
+
+}
+
+
+template <typename T, typename... Rest>
+static void URecordArgs(const T& value, const Rest&... rest) {
+
+	UPut(value);
+	URecordArgs(rest...);
+
+}
+
+
+// Starts a record, the call's own data follows with UPut
+template <typename... Args>
+static void URecord(TraceCall call, const Args&... args) {
+
+	if (pending.size() >= TRACE_FLUSH_BYTES) {
+		UFlush();
+	}
+	UPut((unsigned char)call);
+	URecordArgs(args...);
+	callsRecorded++;
+
+}
+
+
+// Pointer and offset arguments are always stored as 64 bits
+static unsigned long long UOffset(const void* pointer) {
+
+	return (unsigned long long)(size_t)pointer;
+
+}
+
+
+// Data the driver reads: inline bytes, an offset into bound when one is bound, or nothing
+static void UPutPointer(const void* data, size_t size, GLuint bound) {
+
+	if (bound != 0) {
+		UPut((unsigned char)TRACE_POINTER_OFFSET);
+		UPut(UOffset(data));
+	}
+	else if (data == NULL) {
+		UPut((unsigned char)TRACE_POINTER_NULL);
+	}
+	else {
+		UPut((unsigned char)TRACE_POINTER_DATA);
+		UPut((unsigned long long)size);
+		UPutBytes(data, size);
+	}
+
+}
+
+
+static void UPutString(const char* text, size_t length) {
+
+	UPut((unsigned int)length);
+	UPutBytes(text, length);
+
+}
+
+
+static void UPutNames(GLsizei n, const GLuint* names) {
+
+	UPut(n);
+	UPutBytes(names, n * sizeof(GLuint));
+
+}
+
+
+void UTraceInit(const TraceOptions& traceOptions, int width, int height) {
+
+	options = traceOptions;
+	if (options.path.empty()) {
+		return;
+	}
+	traceFile.open(options.path.c_str(), ios::binary | ios::trunc);
+	if (!traceFile) {
+		std::cerr << "Could not open GL trace " << options.path << "\n";
+		return;
+	}
+
+	header.magic = TRACE_MAGIC;
+	header.version = TRACE_VERSION;
+	header.width = width;
+	header.height = height;
+	header.frames = 0;
+	UPut(header);
+	pending.reserve(TRACE_FLUSH_BYTES * 2);
+	tracing = true;
+	atexit(UTraceShutdown);
+
+}
+
+
+void UTraceSetupDone(void) {
+
+	if (tracing) {
+		URecord(TRACE_SETUP_END);
+		if (options.frames == 0) {
+			UTraceShutdown();
+		}
+	}
+
+}
+
+
+void UTraceFrame(void) {
+
+	if (tracing) {
+		URecord(TRACE_FRAME);
+		header.frames++;
+		if (header.frames >= options.frames) {
+			UTraceShutdown();
+		}
+	}
+
+}
+
+
+bool UTracing(void) {
+
+	return tracing;
+
+}
+
+
+void UTraceShutdown(void) {
+
+	if (!tracing) {
+		return;
+	}
+	tracing = false;
+	URecord(TRACE_END);
+	UFlush();
+
+	// The frame count goes back into the header
+	traceFile.seekp(0);
+	traceFile.write((const char*)&header, sizeof(header));
+	traceFile.close();
+	ostringstream report;
+	report << fixed << setprecision(1) << "GL trace: " << header.frames << " frames, " << callsRecorded << " calls, "
+		<< bytesWritten / (1024.0 * 1024.0) << " MB written to " << options.path << "\n";
+	std::cout << report.str();
+
+}
+
+
+const char* UTraceCallName(int call) {
+
+	return call >= 0 && call < TRACE_CALL_COUNT ? callNames[call] : "unknown";
+
+}
+
+
+size_t UTracePixelBytes(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type) {
+
+	size_t components = 4;
+	switch (format) {
+	case GL_RED: case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX: components = 1; break;
+	case GL_RG: case GL_RG_INTEGER: case GL_DEPTH_STENCIL: components = 2; break;
+	case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: components = 3; break;
+	}
+
+	size_t texelBytes;
+	switch (type) {
+	case GL_UNSIGNED_BYTE: case GL_BYTE: texelBytes = components; break;
+	case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: texelBytes = components * 2; break;
+	case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT: texelBytes = components * 4; break;
+	case GL_FLOAT_32_UNSIGNED_INT_24_8_REV: texelBytes = 8; break;
+	default: texelBytes = 4; break; // packed types such as GL_UNSIGNED_INT_24_8 hold a texel in 32 bits
+	}
+
+	size_t rowBytes = ((size_t)width * texelBytes + 3) & ~(size_t)3;
+	return rowBytes * height * depth;
+
+}
+
+
+void UTraceActiveTexture(GLenum texture) {
+
+	glActiveTexture(texture);
+	if (tracing) {
+		URecord(TRACE_ACTIVE_TEXTURE, texture);
+	}
+
+}
+
+
+void UTraceAttachShader(GLuint program, GLuint shader) {
+
+	glAttachShader(program, shader);
+	if (tracing) {
+		URecord(TRACE_ATTACH_SHADER, program, shader);
+	}
+
+}
+
+
+void UTraceBeginQuery(GLenum target, GLuint id) {
+
+	glBeginQuery(target, id);
+	if (tracing) {
+		URecord(TRACE_BEGIN_QUERY, target, id);
+	}
+
+}
+
+
+void UTraceBindBuffer(GLenum target, GLuint buffer) {
+
+	glBindBuffer(target, buffer);
+	if (target == GL_PIXEL_PACK_BUFFER) {
+		packBuffer = buffer;
+	}
+	else if (target == GL_PIXEL_UNPACK_BUFFER) {
+		unpackBuffer = buffer;
+	}
+	if (tracing) {
+		URecord(TRACE_BIND_BUFFER, target, buffer);
+	}
+
+}
+
+
+void UTraceBindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+
+	glBindBufferBase(target, index, buffer);
+	if (tracing) {
+		URecord(TRACE_BIND_BUFFER_BASE, target, index, buffer);
+	}
+
+}
+
+
+void UTraceBindFramebuffer(GLenum target, GLuint framebuffer) {
+
+	glBindFramebuffer(target, framebuffer);
+	if (tracing) {
+		URecord(TRACE_BIND_FRAMEBUFFER, target, framebuffer);
+	}
+
+}
+
+
+void UTraceBindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format) {
+
+	glBindImageTexture(unit, texture, level, layered, layer, access, format);
+	if (tracing) {
+		URecord(TRACE_BIND_IMAGE_TEXTURE, unit, texture, level, layered, layer, access, format);
+	}
+
+}
+
+
+void UTraceBindTexture(GLenum target, GLuint texture) {
+
+	glBindTexture(target, texture);
+	if (tracing) {
+		URecord(TRACE_BIND_TEXTURE, target, texture);
+	}
+
+}
+
+
+void UTraceBindVertexArray(GLuint array) {
+
+	glBindVertexArray(array);
+	if (tracing) {
+		URecord(TRACE_BIND_VERTEX_ARRAY, array);
+	}
+
+}
+
+
+void UTraceBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+
+	glBufferData(target, size, data, usage);
+	if (tracing) {
+		URecord(TRACE_BUFFER_DATA, target, (long long)size, usage);
+		UPutPointer(data, size, 0);
+	}
+
+}
+
+
+void UTraceBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) {
+
+	glBufferStorage(target, size, data, flags);
+	if (tracing) {
+		URecord(TRACE_BUFFER_STORAGE, target, (long long)size, flags);
+		UPutPointer(data, size, 0);
+	}
+
+}
+
+
+void UTraceBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+
+	glBufferSubData(target, offset, size, data);
+	if (tracing) {
+		URecord(TRACE_BUFFER_SUB_DATA, target, (long long)offset, (long long)size);
+		UPutPointer(data, size, 0);
+	}
+
+}
+
+
+GLenum UTraceCheckFramebufferStatus(GLenum target) {
+
+	GLenum status = glCheckFramebufferStatus(target);
+	if (tracing) {
+		URecord(TRACE_CHECK_FRAMEBUFFER_STATUS, target);
+	}
+	return status;
+
+}
+
+
+void UTraceClear(GLbitfield mask) {
+
+	glClear(mask);
+	if (tracing) {
+		URecord(TRACE_CLEAR, mask);
+	}
+
+}
+
+
+void UTraceClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+
+	glClearColor(red, green, blue, alpha);
+	if (tracing) {
+		URecord(TRACE_CLEAR_COLOR, red, green, blue, alpha);
+	}
+
+}
+
+
+GLenum UTraceClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+
+	GLenum result = glClientWaitSync(sync, flags, timeout);
+	if (tracing) {
+		URecord(TRACE_CLIENT_WAIT_SYNC, UOffset(sync), flags, timeout);
+	}
+	return result;
+
+}
+
+
+void UTraceCompileShader(GLuint shader) {
+
+	glCompileShader(shader);
+	if (tracing) {
+		URecord(TRACE_COMPILE_SHADER, shader);
+	}
+
+}
+
+
+void UTraceCompressedTexImage3D(GLenum target, GLint level, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const void* data) {
+
+	glCompressedTexImage3D(target, level, internalFormat, width, height, depth, border, imageSize, data);
+	if (tracing) {
+		URecord(TRACE_COMPRESSED_TEX_IMAGE_3D, target, level, internalFormat, width, height, depth, border, imageSize);
+		UPutPointer(data, imageSize, unpackBuffer);
+	}
+
+}
+
+
+GLuint UTraceCreateProgram(void) {
+
+	GLuint program = glCreateProgram();
+	if (tracing) {
+		URecord(TRACE_CREATE_PROGRAM, program);
+	}
+	return program;
+
+}
+
+
+GLuint UTraceCreateShader(GLenum type) {
+
+	GLuint shader = glCreateShader(type);
+	if (tracing) {
+		URecord(TRACE_CREATE_SHADER, type, shader);
+	}
+	return shader;
+
+}
+
+
+void UTraceDeleteBuffers(GLsizei n, const GLuint* buffers) {
+
+	glDeleteBuffers(n, buffers);
+	if (tracing) {
+		URecord(TRACE_DELETE_BUFFERS);
+		UPutNames(n, buffers);
+	}
+
+}
+
+
+void UTraceDeleteFramebuffers(GLsizei n, const GLuint* framebuffers) {
+
+	glDeleteFramebuffers(n, framebuffers);
+	if (tracing) {
+		URecord(TRACE_DELETE_FRAMEBUFFERS);
+		UPutNames(n, framebuffers);
+	}
+
+}
+
+
+void UTraceDeleteProgram(GLuint program) {
+
+	glDeleteProgram(program);
+	if (tracing) {
+		URecord(TRACE_DELETE_PROGRAM, program);
+	}
+
+}
+
+
+void UTraceDeleteQueries(GLsizei n, const GLuint* ids) {
+
+	glDeleteQueries(n, ids);
+	if (tracing) {
+		URecord(TRACE_DELETE_QUERIES);
+		UPutNames(n, ids);
+	}
+
+}
+
+
+void UTraceDeleteShader(GLuint shader) {
+
+	glDeleteShader(shader);
+	if (tracing) {
+		URecord(TRACE_DELETE_SHADER, shader);
+	}
+
+}
+
+
+void UTraceDeleteSync(GLsync sync) {
+
+	glDeleteSync(sync);
+	if (tracing) {
+		URecord(TRACE_DELETE_SYNC, UOffset(sync));
+	}
+
+}
+
+
+void UTraceDeleteTextures(GLsizei n, const GLuint* textures) {
+
+	glDeleteTextures(n, textures);
+	if (tracing) {
+		URecord(TRACE_DELETE_TEXTURES);
+		UPutNames(n, textures);
+	}
+
+}
+
+
+void UTraceDeleteVertexArrays(GLsizei n, const GLuint* arrays) {
+
+	glDeleteVertexArrays(n, arrays);
+	if (tracing) {
+		URecord(TRACE_DELETE_VERTEX_ARRAYS);
+		UPutNames(n, arrays);
+	}
+
+}
+
+
+void UTraceDetachShader(GLuint program, GLuint shader) {
+
+	glDetachShader(program, shader);
+	if (tracing) {
+		URecord(TRACE_DETACH_SHADER, program, shader);
+	}
+
+}
+
+
+void UTraceDisable(GLenum cap) {
+
+	glDisable(cap);
+	if (tracing) {
+		URecord(TRACE_DISABLE, cap);
+	}
+
+}
+
+
+void UTraceDispatchCompute(GLuint groupsX, GLuint groupsY, GLuint groupsZ) {
+
+	glDispatchCompute(groupsX, groupsY, groupsZ);
+	if (tracing) {
+		URecord(TRACE_DISPATCH_COMPUTE, groupsX, groupsY, groupsZ);
+	}
+
+}
+
+
+void UTraceDrawArrays(GLenum mode, GLint first, GLsizei count) {
+
+	glDrawArrays(mode, first, count);
+	if (tracing) {
+		URecord(TRACE_DRAW_ARRAYS, mode, first, count);
+	}
+
+}
+
+
+void UTraceDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount) {
+
+	glDrawArraysInstanced(mode, first, count, instanceCount);
+	if (tracing) {
+		URecord(TRACE_DRAW_ARRAYS_INSTANCED, mode, first, count, instanceCount);
+	}
+
+}
+
+
+void UTraceDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect) {
+
+	glDrawElementsIndirect(mode, type, indirect);
+	if (tracing) {
+		URecord(TRACE_DRAW_ELEMENTS_INDIRECT, mode, type, UOffset(indirect));
+	}
+
+}
+
+
+void UTraceDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount) {
+
+	glDrawElementsInstanced(mode, count, type, indices, instanceCount);
+	if (tracing) {
+		URecord(TRACE_DRAW_ELEMENTS_INSTANCED, mode, count, type, UOffset(indices), instanceCount);
+	}
+
+}
+
+
+void UTraceEnable(GLenum cap) {
+
+	glEnable(cap);
+	if (tracing) {
+		URecord(TRACE_ENABLE, cap);
+	}
+
+}
+
+
+void UTraceEnableVertexAttribArray(GLuint index) {
+
+	glEnableVertexAttribArray(index);
+	if (tracing) {
+		URecord(TRACE_ENABLE_VERTEX_ATTRIB_ARRAY, index);
+	}
+
+}
+
+
+void UTraceEndQuery(GLenum target) {
+
+	glEndQuery(target);
+	if (tracing) {
+		URecord(TRACE_END_QUERY, target);
+	}
+
+}
+
+
+GLsync UTraceFenceSync(GLenum condition, GLbitfield flags) {
+
+	GLsync sync = glFenceSync(condition, flags);
+	if (tracing) {
+		URecord(TRACE_FENCE_SYNC, condition, flags, UOffset(sync));
+	}
+	return sync;
+
+}
+
+
+void UTraceFinish(void) {
+
+	glFinish();
+	if (tracing) {
+		URecord(TRACE_FINISH);
+	}
+
+}
+
+
+void UTraceFramebufferTexture2D(GLenum target, GLenum attachment, GLenum texTarget, GLuint texture, GLint level) {
+
+	glFramebufferTexture2D(target, attachment, texTarget, texture, level);
+	if (tracing) {
+		URecord(TRACE_FRAMEBUFFER_TEXTURE_2D, target, attachment, texTarget, texture, level);
+	}
+
+}
+
+
+void UTraceGenBuffers(GLsizei n, GLuint* buffers) {
+
+	glGenBuffers(n, buffers);
+	if (tracing) {
+		URecord(TRACE_GEN_BUFFERS);
+		UPutNames(n, buffers);
+	}
+
+}
+
+
+void UTraceGenFramebuffers(GLsizei n, GLuint* framebuffers) {
+
+	glGenFramebuffers(n, framebuffers);
+	if (tracing) {
+		URecord(TRACE_GEN_FRAMEBUFFERS);
+		UPutNames(n, framebuffers);
+	}
+
+}
+
+
+void UTraceGenQueries(GLsizei n, GLuint* ids) {
+
+	glGenQueries(n, ids);
+	if (tracing) {
+		URecord(TRACE_GEN_QUERIES);
+		UPutNames(n, ids);
+	}
+
+}
+
+
+void UTraceGenTextures(GLsizei n, GLuint* textures) {
+
+	glGenTextures(n, textures);
+	if (tracing) {
+		URecord(TRACE_GEN_TEXTURES);
+		UPutNames(n, textures);
+	}
+
+}
+
+
+void UTraceGenVertexArrays(GLsizei n, GLuint* arrays) {
+
+	glGenVertexArrays(n, arrays);
+	if (tracing) {
+		URecord(TRACE_GEN_VERTEX_ARRAYS);
+		UPutNames(n, arrays);
+	}
+
+}
+
+
+void UTraceGetInteger64v(GLenum pname, GLint64* data) {
+
+	glGetInteger64v(pname, data);
+	if (tracing) {
+		URecord(TRACE_GET_INTEGER64V, pname);
+	}
+
+}
+
+
+void UTraceGetIntegerv(GLenum pname, GLint* data) {
+
+	glGetIntegerv(pname, data);
+	if (tracing) {
+		URecord(TRACE_GET_INTEGERV, pname);
+	}
+
+}
+
+
+void UTraceGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+
+	glGetProgramInfoLog(program, bufSize, length, infoLog);
+	if (tracing) {
+		URecord(TRACE_GET_PROGRAM_INFO_LOG, program, bufSize);
+	}
+
+}
+
+
+void UTraceGetProgramiv(GLuint program, GLenum pname, GLint* params) {
+
+	glGetProgramiv(program, pname, params);
+	if (tracing) {
+		URecord(TRACE_GET_PROGRAMIV, program, pname);
+	}
+
+}
+
+
+void UTraceGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) {
+
+	glGetQueryObjectui64v(id, pname, params);
+	if (tracing) {
+		URecord(TRACE_GET_QUERY_OBJECTUI64V, id, pname);
+	}
+
+}
+
+
+void UTraceGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+
+	glGetShaderInfoLog(shader, bufSize, length, infoLog);
+	if (tracing) {
+		URecord(TRACE_GET_SHADER_INFO_LOG, shader, bufSize);
+	}
+
+}
+
+
+void UTraceGetShaderiv(GLuint shader, GLenum pname, GLint* params) {
+
+	glGetShaderiv(shader, pname, params);
+	if (tracing) {
+		URecord(TRACE_GET_SHADERIV, shader, pname);
+	}
+
+}
+
+
+GLuint UTraceGetUniformBlockIndex(GLuint program, const GLchar* name) {
+
+	GLuint index = glGetUniformBlockIndex(program, name);
+	if (tracing) {
+		URecord(TRACE_GET_UNIFORM_BLOCK_INDEX, program, index);
+		UPutString(name, strlen(name));
+	}
+	return index;
+
+}
+
+
+GLint UTraceGetUniformLocation(GLuint program, const GLchar* name) {
+
+	GLint location = glGetUniformLocation(program, name);
+	if (tracing) {
+		URecord(TRACE_GET_UNIFORM_LOCATION, program, location);
+		UPutString(name, strlen(name));
+	}
+	return location;
+
+}
+
+
+GLboolean UTraceIsEnabled(GLenum cap) {
+
+	GLboolean enabled = glIsEnabled(cap);
+	if (tracing) {
+		URecord(TRACE_IS_ENABLED, cap);
+	}
+	return enabled;
+
+}
+
+
+void UTraceLinkProgram(GLuint program) {
+
+	glLinkProgram(program);
+	if (tracing) {
+		URecord(TRACE_LINK_PROGRAM, program);
+	}
+
+}
+
+
+void* UTraceMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+
+	void* pointer = glMapBufferRange(target, offset, length, access);
+	TraceMapping mapping = { pointer, (long long)length, access };
+	mappings[target] = mapping;
+	if (tracing) {
+		URecord(TRACE_MAP_BUFFER_RANGE, target, (long long)offset, (long long)length, access);
+	}
+	return pointer;
+
+}
+
+
+void UTraceMaxShaderCompilerThreadsKHR(GLuint count) {
+
+	glMaxShaderCompilerThreadsKHR(count);
+	if (tracing) {
+		URecord(TRACE_MAX_SHADER_COMPILER_THREADS, count);
+	}
+
+}
+
+
+void UTraceMemoryBarrier(GLbitfield barriers) {
+
+	glMemoryBarrier(barriers);
+	if (tracing) {
+		URecord(TRACE_MEMORY_BARRIER, barriers);
+	}
+
+}
+
+
+void UTraceQueryCounter(GLuint id, GLenum target) {
+
+	glQueryCounter(id, target);
+	if (tracing) {
+		URecord(TRACE_QUERY_COUNTER, id, target);
+	}
+
+}
+
+
+void UTraceReadBuffer(GLenum mode) {
+
+	glReadBuffer(mode);
+	if (tracing) {
+		URecord(TRACE_READ_BUFFER, mode);
+	}
+
+}
+
+
+void UTraceReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels) {
+
+	glReadPixels(x, y, width, height, format, type, pixels);
+	if (tracing) {
+		URecord(TRACE_READ_PIXELS, x, y, width, height, format, type);
+
+		// Only where the pixels went matters, the replayer reads them again
+		if (packBuffer != 0) {
+			UPut((unsigned char)TRACE_POINTER_OFFSET);
+			UPut(UOffset(pixels));
+		}
+		else {
+			UPut((unsigned char)TRACE_POINTER_CLIENT);
+			UPut((unsigned long long)UTracePixelBytes(width, height, 1, format, type));
+		}
+	}
+
+}
+
+
+void UTraceScissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+
+	glScissor(x, y, width, height);
+	if (tracing) {
+		URecord(TRACE_SCISSOR, x, y, width, height);
+	}
+
+}
+
+
+void UTraceShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) {
+
+	glShaderSource(shader, count, string, length);
+	if (tracing) {
+		URecord(TRACE_SHADER_SOURCE, shader, count);
+		for (GLsizei i = 0; i < count; i++) {
+			UPutString(string[i], length != NULL && length[i] >= 0 ? (size_t)length[i] : strlen(string[i]));
+		}
+	}
+
+}
+
+
+void UTraceTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data) {
+
+	glTexImage2D(target, level, internalFormat, width, height, border, format, type, data);
+	if (tracing) {
+		URecord(TRACE_TEX_IMAGE_2D, target, level, internalFormat, width, height, border, format, type);
+		UPutPointer(data, UTracePixelBytes(width, height, 1, format, type), unpackBuffer);
+	}
+
+}
+
+
+void UTraceTexImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void* data) {
+
+	glTexImage3D(target, level, internalFormat, width, height, depth, border, format, type, data);
+	if (tracing) {
+		URecord(TRACE_TEX_IMAGE_3D, target, level, internalFormat, width, height, depth, border, format, type);
+		UPutPointer(data, UTracePixelBytes(width, height, depth, format, type), unpackBuffer);
+	}
+
+}
+
+
+void UTraceTexParameteri(GLenum target, GLenum pname, GLint param) {
+
+	glTexParameteri(target, pname, param);
+	if (tracing) {
+		URecord(TRACE_TEX_PARAMETERI, target, pname, param);
+	}
+
+}
+
+
+void UTraceUniform1f(GLint location, GLfloat v0) {
+
+	glUniform1f(location, v0);
+	if (tracing) {
+		URecord(TRACE_UNIFORM_1F, location, v0);
+	}
+
+}
+
+
+void UTraceUniform1i(GLint location, GLint v0) {
+
+	glUniform1i(location, v0);
+	if (tracing) {
+		URecord(TRACE_UNIFORM_1I, location, v0);
+	}
+
+}
+
+
+void UTraceUniform1ui(GLint location, GLuint v0) {
+
+	glUniform1ui(location, v0);
+	if (tracing) {
+		URecord(TRACE_UNIFORM_1UI, location, v0);
+	}
+
+}
+
+
+void UTraceUniform1uiv(GLint location, GLsizei count, const GLuint* value) {
+
+	glUniform1uiv(location, count, value);
+	if (tracing) {
+		URecord(TRACE_UNIFORM_1UIV, location, count);
+		UPutBytes(value, count * sizeof(GLuint));
+	}
+
+}
+
+
+void UTraceUniform2f(GLint location, GLfloat v0, GLfloat v1) {
+
+	glUniform2f(location, v0, v1);
+	if (tracing) {
+		URecord(TRACE_UNIFORM_2F, location, v0, v1);
+	}
+
+}
+
+
+void UTraceUniform2i(GLint location, GLint v0, GLint v1) {
+
+	glUniform2i(location, v0, v1);
+	if (tracing) {
+		URecord(TRACE_UNIFORM_2I, location, v0, v1);
+	}
+
+}
+
+
+void UTraceUniform2iv(GLint location, GLsizei count, const GLint* value) {
+
+	glUniform2iv(location, count, value);
+	if (tracing) {
+		URecord(TRACE_UNIFORM_2IV, location, count);
+		UPutBytes(value, count * 2 * sizeof(GLint));
+	}
+
+}
+
+
+void UTraceUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) {
+
+	glUniform3f(location, v0, v1, v2);
+	if (tracing) {
+		URecord(TRACE_UNIFORM_3F, location, v0, v1, v2);
+	}
+
+}
+
+
+void UTraceUniform3fv(GLint location, GLsizei count, const GLfloat* value) {
+
+	glUniform3fv(location, count, value);
+	if (tracing) {
+		URecord(TRACE_UNIFORM_3FV, location, count);
+		UPutBytes(value, count * 3 * sizeof(GLfloat));
+	}
+
+}
+
+
+void UTraceUniformBlockBinding(GLuint program, GLuint blockIndex, GLuint blockBinding) {
+
+	glUniformBlockBinding(program, blockIndex, blockBinding);
+	if (tracing) {
+		URecord(TRACE_UNIFORM_BLOCK_BINDING, program, blockIndex, blockBinding);
+	}
+
+}
+
+
+void UTraceUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+
+	glUniformMatrix4fv(location, count, transpose, value);
+	if (tracing) {
+		URecord(TRACE_UNIFORM_MATRIX_4FV, location, count, transpose);
+		UPutBytes(value, count * 16 * sizeof(GLfloat));
+	}
+
+}
+
+
+GLboolean UTraceUnmapBuffer(GLenum target) {
+
+	// What was written through the mapping is only known now, and only until the unmap
+	if (tracing) {
+		URecord(TRACE_UNMAP_BUFFER, target);
+		map<GLenum, TraceMapping>::iterator mapping = mappings.find(target);
+		if (mapping != mappings.end() && (mapping->second.access & GL_MAP_WRITE_BIT) != 0 && mapping->second.pointer != NULL) {
+			UPutPointer(mapping->second.pointer, (size_t)mapping->second.length, 0);
+		}
+		else {
+			UPut((unsigned char)TRACE_POINTER_NULL);
+		}
+	}
+	mappings.erase(target);
+	return glUnmapBuffer(target);
+
+}
+
+
+void UTraceUseProgram(GLuint program) {
+
+	glUseProgram(program);
+	if (tracing) {
+		URecord(TRACE_USE_PROGRAM, program);
+	}
+
+}
+
+
+void UTraceVertexAttribDivisor(GLuint index, GLuint divisor) {
+
+	glVertexAttribDivisor(index, divisor);
+	if (tracing) {
+		URecord(TRACE_VERTEX_ATTRIB_DIVISOR, index, divisor);
+	}
+
+}
+
+
+void UTraceVertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer) {
+
+	glVertexAttribIPointer(index, size, type, stride, pointer);
+	if (tracing) {
+		URecord(TRACE_VERTEX_ATTRIB_I_POINTER, index, size, type, stride, UOffset(pointer));
+	}
+
+}
+
+
+void UTraceVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {
+
+	glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+	if (tracing) {
+		URecord(TRACE_VERTEX_ATTRIB_POINTER, index, size, type, normalized, stride, UOffset(pointer));
+	}
+
+}
+
+
+void UTraceViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+
+	glViewport(x, y, width, height);
+	if (tracing) {
+		URecord(TRACE_VIEWPORT, x, y, width, height);
+	}
+
+}
+
+
+void UTraceViewportArrayv(GLuint first, GLsizei count, const GLfloat* v) {
+
+	glViewportArrayv(first, count, v);
+	if (tracing) {
+		URecord(TRACE_VIEWPORT_ARRAYV, first, count);
+		UPutBytes(v, count * 4 * sizeof(GLfloat));
+	}
+
+}
@@ -0,0 +1,439 @@
+/*
+*	Title:	Final Project / GlTrace.h
+*	Date:	October 19, 2026
+*
+*	Description: GL command stream capture. Every GL call the renderer makes
+*	during startup and the first frames is written to a compact binary trace
+*	together with the data it hands the driver: buffer contents, texture
+*	levels, shader sources and the writes into mapped buffers. TraceReplay.cpp
+*	re-executes a trace headlessly to time the driver without the rest of the
+*	program in the way.
+*
+*	Modules reach GL through this header: included after GL/glew.h it
+*	redirects each GL function the renderer uses to a UTrace wrapper that
+*	makes the call and, while a trace is open, appends it to the trace. A
+*	module that calls a GL function missing from the list below has to add
+*	its wrapper here or the call goes untraced.
+*
+*	Object names, uniform locations and sync objects are stored as the
+*	capture saw them and remapped by the replayer. The recorder assumes one
+*	GL thread and the default pixel unpack alignment of 4.
+*
+*	Command line:
+*		--gl-trace <file>			record a trace of startup and the first frames
+*		--gl-trace-frames <count>	frames recorded after startup, default 60
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <GL/glew.h>
+
+#define TRACE_MAGIC 0x52544C47u		// "GLTR" little endian
+#define TRACE_VERSION 2
+
+// Start of a trace file, frames is filled in when the trace is closed
+struct TraceHeader {
+	unsigned int magic;
+	unsigned int version;
+	int width;					// window size at startup
+	int height;
+	int frames;
+};
+
+// One record per call: the call as one byte, then its arguments in order as
+// stored by GlTrace.cpp. The markers have no arguments.
+enum TraceCall {
+	TRACE_END,					// end of the trace
+	TRACE_SETUP_END,			// startup done, frames follow
+	TRACE_FRAME,				// end of a frame, where the program swapped buffers
+	TRACE_ACTIVE_TEXTURE,
+	TRACE_ATTACH_SHADER,
+	TRACE_BEGIN_QUERY,
+	TRACE_BIND_BUFFER,
+	TRACE_BIND_BUFFER_BASE,
+	TRACE_BIND_FRAMEBUFFER,
+	TRACE_BIND_IMAGE_TEXTURE,
+	TRACE_BIND_TEXTURE,
+	TRACE_BIND_VERTEX_ARRAY,
+	TRACE_BUFFER_DATA,
+	TRACE_BUFFER_STORAGE,
+	TRACE_BUFFER_SUB_DATA,
+	TRACE_CHECK_FRAMEBUFFER_STATUS,
+	TRACE_CLEAR,
+	TRACE_CLEAR_COLOR,
+	TRACE_CLIENT_WAIT_SYNC,
+	TRACE_COMPILE_SHADER,
+	TRACE_COMPRESSED_TEX_IMAGE_3D,
+	TRACE_CREATE_PROGRAM,
+	TRACE_CREATE_SHADER,
+	TRACE_DELETE_BUFFERS,
+	TRACE_DELETE_FRAMEBUFFERS,
+	TRACE_DELETE_PROGRAM,
+	TRACE_DELETE_QUERIES,
+	TRACE_DELETE_SHADER,
+	TRACE_DELETE_SYNC,
+	TRACE_DELETE_TEXTURES,
+	TRACE_DELETE_VERTEX_ARRAYS,
+	TRACE_DETACH_SHADER,
+	TRACE_DISABLE,
+	TRACE_DISPATCH_COMPUTE,
+	TRACE_DRAW_ARRAYS,
+	TRACE_DRAW_ARRAYS_INSTANCED,
+	TRACE_DRAW_ELEMENTS_INDIRECT,
+	TRACE_DRAW_ELEMENTS_INSTANCED,
+	TRACE_ENABLE,
+	TRACE_ENABLE_VERTEX_ATTRIB_ARRAY,
+	TRACE_END_QUERY,
+	TRACE_FENCE_SYNC,
+	TRACE_FINISH,
+	TRACE_FRAMEBUFFER_TEXTURE_2D,
+	TRACE_GEN_BUFFERS,
+	TRACE_GEN_FRAMEBUFFERS,
+	TRACE_GEN_QUERIES,
+	TRACE_GEN_TEXTURES,
+	TRACE_GEN_VERTEX_ARRAYS,
+	TRACE_GET_INTEGER64V,
+	TRACE_GET_INTEGERV,
+	TRACE_GET_PROGRAM_INFO_LOG,
+	TRACE_GET_PROGRAMIV,
+	TRACE_GET_QUERY_OBJECTUI64V,
+	TRACE_GET_SHADER_INFO_LOG,
+	TRACE_GET_SHADERIV,
+	TRACE_GET_UNIFORM_BLOCK_INDEX,
+	TRACE_GET_UNIFORM_LOCATION,
+	TRACE_IS_ENABLED,
+	TRACE_LINK_PROGRAM,
+	TRACE_MAP_BUFFER_RANGE,
+	TRACE_MAX_SHADER_COMPILER_THREADS,
+	TRACE_MEMORY_BARRIER,
+	TRACE_QUERY_COUNTER,
+	TRACE_READ_BUFFER,
+	TRACE_READ_PIXELS,
+	TRACE_SCISSOR,
+	TRACE_SHADER_SOURCE,
+	TRACE_TEX_IMAGE_2D,
+	TRACE_TEX_IMAGE_3D,
+	TRACE_TEX_PARAMETERI,
+	TRACE_UNIFORM_1F,
+	TRACE_UNIFORM_1I,
+	TRACE_UNIFORM_1UI,
+	TRACE_UNIFORM_1UIV,
+	TRACE_UNIFORM_2F,
+	TRACE_UNIFORM_2I,
+	TRACE_UNIFORM_2IV,
+	TRACE_UNIFORM_3F,
+	TRACE_UNIFORM_3FV,
+	TRACE_UNIFORM_BLOCK_BINDING,
+	TRACE_UNIFORM_MATRIX_4FV,
+	TRACE_UNMAP_BUFFER,
+	TRACE_USE_PROGRAM,
+	TRACE_VERTEX_ATTRIB_DIVISOR,
+	TRACE_VERTEX_ATTRIB_I_POINTER,
+	TRACE_VERTEX_ATTRIB_POINTER,
+	TRACE_VIEWPORT,
+	TRACE_VIEWPORT_ARRAYV,
+	TRACE_CALL_COUNT
+};
+
+// How a pointer argument was stored: absent, inline data, an offset into the
+// bound pixel or indirect buffer, or client memory the driver writes to
+enum TracePointer {
+	TRACE_POINTER_NULL,
+	TRACE_POINTER_DATA,
+	TRACE_POINTER_OFFSET,
+	TRACE_POINTER_CLIENT
+};
+
+struct TraceOptions {
+	std::string path;			// empty when not tracing
+	int frames;
+};
+
+// Reads the trace options out of the command line, returns false on a malformed argument
+bool UParseTraceOptions(int argc, char* argv[], TraceOptions& options);
+
+// Opens the trace and starts recording, call straight after glewInit so setup is recorded whole
+void UTraceInit(const TraceOptions& options, int width, int height);
+
+// Marks the end of setup
+void UTraceSetupDone(void);
+
+// Marks the end of a frame, call after the swap. Closes the trace after the last frame.
+void UTraceFrame(void);
+
+bool UTracing(void);
+
+// Closes a trace still open. Safe to call twice, and also run at exit.
+void UTraceShutdown(void);
+
+// GL function name of a call, or the marker's name
+const char* UTraceCallName(int call);
+
+// Bytes of a width x height x depth image in client memory for format and type, rows padded to 4 bytes
+size_t UTracePixelBytes(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type);
+
+// Wrappers, each makes the GL call and records it while tracing
+void UTraceActiveTexture(GLenum texture);
+void UTraceAttachShader(GLuint program, GLuint shader);
+void UTraceBeginQuery(GLenum target, GLuint id);
+void UTraceBindBuffer(GLenum target, GLuint buffer);
+void UTraceBindBufferBase(GLenum target, GLuint index, GLuint buffer);
+void UTraceBindFramebuffer(GLenum target, GLuint framebuffer);
+void UTraceBindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format);
+void UTraceBindTexture(GLenum target, GLuint texture);
+void UTraceBindVertexArray(GLuint array);
+void UTraceBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+void UTraceBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+void UTraceBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+GLenum UTraceCheckFramebufferStatus(GLenum target);
+void UTraceClear(GLbitfield mask);
+void UTraceClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+GLenum UTraceClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+void UTraceCompileShader(GLuint shader);
+void UTraceCompressedTexImage3D(GLenum target, GLint level, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const void* data);
+GLuint UTraceCreateProgram(void);
+GLuint UTraceCreateShader(GLenum type);
+void UTraceDeleteBuffers(GLsizei n, const GLuint* buffers);
+void UTraceDeleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+void UTraceDeleteProgram(GLuint program);
+void UTraceDeleteQueries(GLsizei n, const GLuint* ids);
+void UTraceDeleteShader(GLuint shader);
+void UTraceDeleteSync(GLsync sync);
+void UTraceDeleteTextures(GLsizei n, const GLuint* textures);
+void UTraceDeleteVertexArrays(GLsizei n, const GLuint* arrays);
+void UTraceDetachShader(GLuint program, GLuint shader);
+void UTraceDisable(GLenum cap);
+void UTraceDispatchCompute(GLuint groupsX, GLuint groupsY, GLuint groupsZ);
+void UTraceDrawArrays(GLenum mode, GLint first, GLsizei count);
+void UTraceDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount);
+void UTraceDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect);
+void UTraceDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount);
+void UTraceEnable(GLenum cap);
+void UTraceEnableVertexAttribArray(GLuint index);
+void UTraceEndQuery(GLenum target);
+GLsync UTraceFenceSync(GLenum condition, GLbitfield flags);
+void UTraceFinish(void);
+void UTraceFramebufferTexture2D(GLenum target, GLenum attachment, GLenum texTarget, GLuint texture, GLint level);
+void UTraceGenBuffers(GLsizei n, GLuint* buffers);
+void UTraceGenFramebuffers(GLsizei n, GLuint* framebuffers);
+void UTraceGenQueries(GLsizei n, GLuint* ids);
+void UTraceGenTextures(GLsizei n, GLuint* textures);
+void UTraceGenVertexArrays(GLsizei n, GLuint* arrays);
+void UTraceGetInteger64v(GLenum pname, GLint64* data);
+void UTraceGetIntegerv(GLenum pname, GLint* data);
+void UTraceGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+void UTraceGetProgramiv(GLuint program, GLenum pname, GLint* params);
+void UTraceGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params);
+void UTraceGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+void UTraceGetShaderiv(GLuint shader, GLenum pname, GLint* params);
+GLuint UTraceGetUniformBlockIndex(GLuint program, const GLchar* name);
+GLint UTraceGetUniformLocation(GLuint program, const GLchar* name);
+GLboolean UTraceIsEnabled(GLenum cap);
+void UTraceLinkProgram(GLuint program);
+void* UTraceMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+void UTraceMaxShaderCompilerThreadsKHR(GLuint count);
+void UTraceMemoryBarrier(GLbitfield barriers);
+void UTraceQueryCounter(GLuint id, GLenum target);
+void UTraceReadBuffer(GLenum mode);
+void UTraceReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels);
+void UTraceScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+void UTraceShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+void UTraceTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data);
+void UTraceTexImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void* data);
+void UTraceTexParameteri(GLenum target, GLenum pname, GLint param);
+void UTraceUniform1f(GLint location, GLfloat v0);
+void UTraceUniform1i(GLint location, GLint v0);
+void UTraceUniform1ui(GLint location, GLuint v0);
+void UTraceUniform1uiv(GLint location, GLsizei count, const GLuint* value);
+void UTraceUniform2f(GLint location, GLfloat v0, GLfloat v1);
+void UTraceUniform2i(GLint location, GLint v0, GLint v1);
+void UTraceUniform2iv(GLint location, GLsizei count, const GLint* value);
+void UTraceUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
+void UTraceUniform3fv(GLint location, GLsizei count, const GLfloat* value);
+void UTraceUniformBlockBinding(GLuint program, GLuint blockIndex, GLuint blockBinding);
+void UTraceUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+GLboolean UTraceUnmapBuffer(GLenum target);
+void UTraceUseProgram(GLuint program);
+void UTraceVertexAttribDivisor(GLuint index, GLuint divisor);
+void UTraceVertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer);
+void UTraceVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+void UTraceViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void UTraceViewportArrayv(GLuint first, GLsizei count, const GLfloat* v);
+
+// Everything but GlTrace.cpp and the replayer goes through the wrappers
+#ifndef GL_TRACE_NO_HOOKS
+#undef glActiveTexture
+#define glActiveTexture UTraceActiveTexture
+#undef glAttachShader
+#define glAttachShader UTraceAttachShader
+#undef glBeginQuery
+#define glBeginQuery UTraceBeginQuery
+#undef glBindBuffer
+#define glBindBuffer UTraceBindBuffer
+#undef glBindBufferBase
+#define glBindBufferBase UTraceBindBufferBase
+#undef glBindFramebuffer
+#define glBindFramebuffer UTraceBindFramebuffer
+#undef glBindImageTexture
+#define glBindImageTexture UTraceBindImageTexture
+#undef glBindTexture
+#define glBindTexture UTraceBindTexture
+#undef glBindVertexArray
+#define glBindVertexArray UTraceBindVertexArray
+#undef glBufferData
+#define glBufferData UTraceBufferData
+#undef glBufferStorage
+#define glBufferStorage UTraceBufferStorage
+#undef glBufferSubData
+#define glBufferSubData UTraceBufferSubData
+#undef glCheckFramebufferStatus
+#define glCheckFramebufferStatus UTraceCheckFramebufferStatus
+#undef glClear
+#define glClear UTraceClear
+#undef glClearColor
+#define glClearColor UTraceClearColor
+#undef glClientWaitSync
+#define glClientWaitSync UTraceClientWaitSync
+#undef glCompileShader
+#define glCompileShader UTraceCompileShader
+#undef glCompressedTexImage3D
+#define glCompressedTexImage3D UTraceCompressedTexImage3D
+#undef glCreateProgram
+#define glCreateProgram UTraceCreateProgram
+#undef glCreateShader
+#define glCreateShader UTraceCreateShader
+#undef glDeleteBuffers
+#define glDeleteBuffers UTraceDeleteBuffers
+#undef glDeleteFramebuffers
+#define glDeleteFramebuffers UTraceDeleteFramebuffers
+#undef glDeleteProgram
+#define glDeleteProgram UTraceDeleteProgram
+#undef glDeleteQueries
+#define glDeleteQueries UTraceDeleteQueries
+#undef glDeleteShader
+#define glDeleteShader UTraceDeleteShader
+#undef glDeleteSync
+#define glDeleteSync UTraceDeleteSync
+#undef glDeleteTextures
+#define glDeleteTextures UTraceDeleteTextures
+#undef glDeleteVertexArrays
+#define glDeleteVertexArrays UTraceDeleteVertexArrays
+#undef glDetachShader
+#define glDetachShader UTraceDetachShader
+#undef glDisable
+#define glDisable UTraceDisable
+#undef glDispatchCompute
+#define glDispatchCompute UTraceDispatchCompute
+#undef glDrawArrays
+#define glDrawArrays UTraceDrawArrays
+#undef glDrawArraysInstanced
+#define glDrawArraysInstanced UTraceDrawArraysInstanced
+#undef glDrawElementsIndirect
+#define glDrawElementsIndirect UTraceDrawElementsIndirect
+#undef glDrawElementsInstanced
+#define glDrawElementsInstanced UTraceDrawElementsInstanced
+#undef glEnable
+#define glEnable UTraceEnable
+#undef glEnableVertexAttribArray
+#define glEnableVertexAttribArray UTraceEnableVertexAttribArray
+#undef glEndQuery
+#define glEndQuery UTraceEndQuery
+#undef glFenceSync
+#define glFenceSync UTraceFenceSync
+#undef glFinish
+#define glFinish UTraceFinish
+#undef glFramebufferTexture2D
+#define glFramebufferTexture2D UTraceFramebufferTexture2D
+#undef glGenBuffers
+#define glGenBuffers UTraceGenBuffers
+#undef glGenFramebuffers
+#define glGenFramebuffers UTraceGenFramebuffers
+#undef glGenQueries
+#define glGenQueries UTraceGenQueries
+#undef glGenTextures
+#define glGenTextures UTraceGenTextures
+#undef glGenVertexArrays
+#define glGenVertexArrays UTraceGenVertexArrays
+#undef glGetInteger64v
+#define glGetInteger64v UTraceGetInteger64v
+#undef glGetIntegerv
+#define glGetIntegerv UTraceGetIntegerv
+#undef glGetProgramInfoLog
+#define glGetProgramInfoLog UTraceGetProgramInfoLog
+#undef glGetProgramiv
+#define glGetProgramiv UTraceGetProgramiv
+#undef glGetQueryObjectui64v
+#define glGetQueryObjectui64v UTraceGetQueryObjectui64v
+#undef glGetShaderInfoLog
+#define glGetShaderInfoLog UTraceGetShaderInfoLog
+#undef glGetShaderiv
+#define glGetShaderiv UTraceGetShaderiv
+#undef glGetUniformBlockIndex
+#define glGetUniformBlockIndex UTraceGetUniformBlockIndex
+#undef glGetUniformLocation
+#define glGetUniformLocation UTraceGetUniformLocation
+#undef glIsEnabled
+#define glIsEnabled UTraceIsEnabled
+#undef glLinkProgram
+#define glLinkProgram UTraceLinkProgram
+#undef glMapBufferRange
+#define glMapBufferRange UTraceMapBufferRange
+#undef glMaxShaderCompilerThreadsKHR
+#define glMaxShaderCompilerThreadsKHR UTraceMaxShaderCompilerThreadsKHR
+#undef glMemoryBarrier
+#define glMemoryBarrier UTraceMemoryBarrier
+#undef glQueryCounter
+#define glQueryCounter UTraceQueryCounter
+#undef glReadBuffer
+#define glReadBuffer UTraceReadBuffer
+#undef glReadPixels
+#define glReadPixels UTraceReadPixels
+#undef glScissor
+#define glScissor UTraceScissor
+#undef glShaderSource
+#define glShaderSource UTraceShaderSource
+#undef glTexImage2D
+#define glTexImage2D UTraceTexImage2D
+#undef glTexImage3D
+#define glTexImage3D UTraceTexImage3D
+#undef glTexParameteri
+#define glTexParameteri UTraceTexParameteri
+#undef glUniform1f
+#define glUniform1f UTraceUniform1f
+#undef glUniform1i
+#define glUniform1i UTraceUniform1i
+#undef glUniform1ui
+#define glUniform1ui UTraceUniform1ui
+#undef glUniform1uiv
+#define glUniform1uiv UTraceUniform1uiv
+#undef glUniform2f
+#define glUniform2f UTraceUniform2f
+#undef glUniform2i
+#define glUniform2i UTraceUniform2i
+#undef glUniform2iv
+#define glUniform2iv UTraceUniform2iv
+#undef glUniform3f
+#define glUniform3f UTraceUniform3f
+#undef glUniform3fv
+#define glUniform3fv UTraceUniform3fv
+#undef glUniformBlockBinding
+#define glUniformBlockBinding UTraceUniformBlockBinding
+#undef glUniformMatrix4fv
+#define glUniformMatrix4fv UTraceUniformMatrix4fv
+#undef glUnmapBuffer
+#define glUnmapBuffer UTraceUnmapBuffer
+#undef glUseProgram
+#define glUseProgram UTraceUseProgram
+#undef glVertexAttribDivisor
+#define glVertexAttribDivisor UTraceVertexAttribDivisor
+#undef glVertexAttribIPointer
+#define glVertexAttribIPointer UTraceVertexAttribIPointer
+#undef glVertexAttribPointer
+#define glVertexAttribPointer UTraceVertexAttribPointer
+#undef glViewport
+#define glViewport UTraceViewport
+#undef glViewportArrayv
+#define glViewportArrayv UTraceViewportArrayv
+#endif
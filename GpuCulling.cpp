@@ -0,0 +1,499 @@
+/*
+*	Title:	Final Project / GpuCulling.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Compute culling and Hi-Z pyramid. Each instance is tested
+*	as the eight corners of its box in clip space: it is culled when all of
+*	them are outside one frustum plane, or when the nearest corner lies
+*	behind the farthest depth of the pyramid texels under its screen rect.
+*	The pyramid holds the farthest depth of each 2x2 block, and the test
+*	picks the level where the rect spans at most 2x2 texels. It comes from
+*	last frame's depth and is tested with last frame's matrices, so an object
+*	uncovered by a camera move can appear one frame late.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "GpuCulling.h"
+#include "GlState.h"
+#include "GpuResources.h"
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+#define CULL_GROUP_SIZE 64		// must match local_size_x of the cull shader
+#define HIZ_GROUP_SIZE 8		// must match local_size_x and y of the Hi-Z shader
+#define HIZ_MAX_LEVELS 16
+
+// Instance as the cull shader reads it, std430
+struct CullSource {
+	glm::mat4 model;
+	glm::vec4 boundsMin;
+	glm::vec4 boundsMax;
+};
+
+// Matches DrawElementsIndirectCommand, and the std430 layout of the shader's DrawCommand
+struct DrawCommand {
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+static const char* cullShaderSource = 1 + R"GLSL(
+	#version 430 core
+	layout(local_size_x = 64) in;
+
+	struct SourceInstance {
+		mat4 model;
+		vec4 boundsMin;
+		vec4 boundsMax;
+	};
+
+	struct DrawInstance {
+		mat4 model;
+		uint material;
+		uint padding0;
+		uint padding1;
+		uint padding2;
+	};
+
+	struct DrawCommand {
+		uint count;
+		uint instanceCount;
+		uint firstIndex;
+		int baseVertex;
+		uint baseInstance;
+	};
+
+	layout(std430, binding = 0) readonly buffer Sources { SourceInstance sources[]; };
+	layout(std430, binding = 1) writeonly buffer Instances { DrawInstance instances[]; };
+	layout(std430, binding = 2) buffer Commands { DrawCommand commands[]; };
+
+	uniform uint uInstanceCount;
+	uniform uint uDrawCount;
+	uniform uint uMaterials[4];
+	uniform mat4 uViewProjection;		// with the scene model applied
+
+	// Last frame's pyramid, and the matrix it was drawn with
+	uniform bool uOcclusion;
+	uniform mat4 uHiZViewProjection;
+	uniform sampler2D uHiZ;
+	uniform vec2 uHiZScene;				// pixels the scene covered
+	uniform ivec2 uHiZSizes[16];		// texels in use at each level
+	uniform int uHiZLevels;
+
+	vec3 Corner(vec3 boundsMin, vec3 boundsMax, int i) {
+		return vec3((i & 1) != 0 ? boundsMax.x : boundsMin.x, (i & 2) != 0 ? boundsMax.y : boundsMin.y, (i & 4) != 0 ? boundsMax.z : boundsMin.z);
+	}
+
+	bool OutsideFrustum(mat4 model, vec3 boundsMin, vec3 boundsMax) {
+		vec4 corners[8];
+		for (int i = 0; i < 8; i++) {
+			corners[i] = uViewProjection * model * vec4(Corner(boundsMin, boundsMax, i), 1.0f);
+		}
+
+		// Culled when every corner is outside the same clip plane
+		for (int axis = 0; axis < 3; axis++) {
+			bool allBelow = true;
+			bool allAbove = true;
+			for (int i = 0; i < 8; i++) {
+				allBelow = allBelow && corners[i][axis] < -corners[i].w;
+				allAbove = allAbove && corners[i][axis] > corners[i].w;
+			}
+			if (allBelow || allAbove) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool Occluded(mat4 model, vec3 boundsMin, vec3 boundsMax) {
+		vec3 ndcMin = vec3(1.0f);
+		vec3 ndcMax = vec3(-1.0f);
+		for (int i = 0; i < 8; i++) {
+			vec4 clip = uHiZViewProjection * model * vec4(Corner(boundsMin, boundsMax, i), 1.0f);
+			if (clip.w <= 0.0f) {
+				return false; // crosses the camera plane, nothing to compare against
+			}
+			vec3 ndc = clip.xyz / clip.w;
+			ndcMin = min(ndcMin, ndc);
+			ndcMax = max(ndcMax, ndc);
+		}
+		if (any(greaterThan(ndcMin.xy, vec2(1.0f))) || any(lessThan(ndcMax.xy, vec2(-1.0f)))) {
+			return false; // outside last frame's view
+		}
+
+		// Screen rect in level 0 texels, each covering 2x2 scene pixels
+		vec2 pixelMin = clamp(ndcMin.xy * 0.5f + 0.5f, 0.0f, 1.0f) * uHiZScene;
+		vec2 pixelMax = clamp(ndcMax.xy * 0.5f + 0.5f, 0.0f, 1.0f) * uHiZScene;
+		ivec2 texelMin = ivec2(pixelMin) / 2;
+		ivec2 texelMax = ivec2(min(pixelMax, uHiZScene - 1.0f)) / 2;
+		ivec2 span = texelMax - texelMin + 1;
+		int level = clamp(int(ceil(log2(float(max(span.x, span.y))))), 0, uHiZLevels - 1);
+		texelMin = min(texelMin >> level, uHiZSizes[level] - 1);
+		texelMax = min(texelMax >> level, uHiZSizes[level] - 1);
+
+		float farthest = 0.0f;
+		for (int y = texelMin.y; y <= texelMax.y; y++) {
+			for (int x = texelMin.x; x <= texelMax.x; x++) {
+				farthest = max(farthest, texelFetch(uHiZ, ivec2(x, y), level).r);
+			}
+		}
+		return ndcMin.z * 0.5f + 0.5f > farthest;
+	}
+
+	void main() {
+		uint id = gl_GlobalInvocationID.x;
+		if (id >= uInstanceCount) {
+			return;
+		}
+
+		mat4 model = sources[id].model;
+		vec3 boundsMin = sources[id].boundsMin.xyz;
+		vec3 boundsMax = sources[id].boundsMax.xyz;
+		if (OutsideFrustum(model, boundsMin, boundsMax) || (uOcclusion && Occluded(model, boundsMin, boundsMax))) {
+			return;
+		}
+
+		// Append to every draw's range, each draw keeps its own count
+		for (uint d = 0u; d < uDrawCount; d++) {
+			uint slot = atomicAdd(commands[d].instanceCount, 1u);
+			instances[d * uInstanceCount + slot] = DrawInstance(model, uMaterials[d], 0u, 0u, 0u);
+		}
+	}
+)GLSL";
+
+static const char* hizShaderSource = 1 + R"GLSL(
+	#version 430 core
+	layout(local_size_x = 8, local_size_y = 8) in;
+
+	layout(r32f, binding = 0) writeonly uniform image2D uDestination;
+	uniform sampler2D uSource;
+	uniform int uSourceLevel;
+	uniform ivec2 uSourceSize;
+
+	void main() {
+		ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+		if (any(greaterThanEqual(texel, (uSourceSize + 1) / 2))) {
+			return;
+		}
+
+		// Farthest depth of the 2x2 block, the odd last row and column fold into the block before them
+		ivec2 first = texel * 2;
+		ivec2 last = min(first + 1, uSourceSize - 1);
+		float farthest = max(max(texelFetch(uSource, first, uSourceLevel).r, texelFetch(uSource, ivec2(last.x, first.y), uSourceLevel).r),
+			max(texelFetch(uSource, ivec2(first.x, last.y), uSourceLevel).r, texelFetch(uSource, last, uSourceLevel).r));
+		imageStore(uDestination, texel, vec4(farthest));
+	}
+)GLSL";
+
+static CullOptions cullOptions;
+static bool culling = false;
+
+// Cull pass
+static GLuint cullProgram = 0;
+static GLuint sourceBuffer = 0;
+static GLuint commandBuffer = 0;
+static GLuint outputBuffer = 0;
+static GLuint instanceCount = 0;
+static vector<DrawCommand> resetCommands;	// every count zeroed, uploaded before each pass
+static vector<GLuint> drawMaterials;
+static GLint instanceCountLoc, drawCountLoc, materialsLoc, viewProjectionLoc;
+static GLint occlusionLoc, hizViewProjectionLoc, hizLoc, hizSceneLoc, hizSizesLoc, hizLevelsLoc;
+
+// Hi-Z pyramid
+static GLuint hizProgram = 0;
+static GLuint hizTexture = 0;
+static int hizWidth = 0;					// level 0 allocation, powers of two
+static int hizHeight = 0;
+static int hizLevels = 0;
+static GLint sourceLoc, sourceLevelLoc, sourceSizeLoc;
+static bool hizValid = false;				// a pyramid from the previous frame is ready
+static glm::ivec2 hizScene;					// scene pixels the pyramid was built from
+static glm::ivec2 hizSizes[HIZ_MAX_LEVELS];
+static glm::mat4 frameViewProjection;		// this frame's, stored with the pyramid built from it
+static glm::mat4 hizViewProjection;
+
+
+bool UParseCullOptions(int argc, char* argv[], CullOptions& options) {
+
+	options.enabled = false;
+	options.occlusion = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--gpu-cull") == 0) {
+			options.enabled = true;
+		}
+		else if (strcmp(argv[i], "--hiz") == 0) {
+			options.enabled = true;
+			options.occlusion = true;
+		}
+	}
+	return true;
+
+}
+
+
+// Compiles and links one compute shader, 0 with the log printed on failure
+static GLuint UCreateComputeProgram(const char* source, const char* label) {
+
+	GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(shader, 1, &source, NULL);
+	glCompileShader(shader);
+
+	GLint status = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	if (status != GL_TRUE) {
+		GLchar log[1 << 11] = { 0 };
+		glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+		std::cerr << log << "\n";
+		glDeleteShader(shader);
+		return 0;
+	}
+
+	GLuint program = UGpuCreateProgram(label);
+	glAttachShader(program, shader);
+	glLinkProgram(program);
+	glDeleteShader(shader);
+
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (status != GL_TRUE) {
+		GLchar log[1 << 11] = { 0 };
+		glGetProgramInfoLog(program, sizeof(log), NULL, log);
+		std::cerr << log << "\n";
+		UGpuDeleteProgram(program);
+		return 0;
+	}
+	return program;
+
+}
+
+
+bool UCullInit(const CullOptions& options) {
+
+	cullOptions = options;
+	if (!options.enabled) {
+		return false;
+	}
+
+	bool supported = GLEW_VERSION_4_3 || (GLEW_ARB_compute_shader && GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_draw_indirect);
+	if (!supported) {
+		std::cerr << "GPU culling needs GL 4.3 compute shaders, drawing every instance instead\n";
+		return false;
+	}
+
+	cullProgram = UCreateComputeProgram(cullShaderSource, "cull program");
+	hizProgram = cullOptions.occlusion ? UCreateComputeProgram(hizShaderSource, "hiz program") : 0;
+	if (cullProgram == 0 || (cullOptions.occlusion && hizProgram == 0)) {
+		std::cerr << "GPU culling shaders failed to build, drawing every instance instead\n";
+		UCullShutdown();
+		return false;
+	}
+
+	instanceCountLoc = glGetUniformLocation(cullProgram, "uInstanceCount");
+	drawCountLoc = glGetUniformLocation(cullProgram, "uDrawCount");
+	materialsLoc = glGetUniformLocation(cullProgram, "uMaterials");
+	viewProjectionLoc = glGetUniformLocation(cullProgram, "uViewProjection");
+	occlusionLoc = glGetUniformLocation(cullProgram, "uOcclusion");
+	hizViewProjectionLoc = glGetUniformLocation(cullProgram, "uHiZViewProjection");
+	hizLoc = glGetUniformLocation(cullProgram, "uHiZ");
+	hizSceneLoc = glGetUniformLocation(cullProgram, "uHiZScene");
+	hizSizesLoc = glGetUniformLocation(cullProgram, "uHiZSizes");
+	hizLevelsLoc = glGetUniformLocation(cullProgram, "uHiZLevels");
+	if (hizProgram != 0) {
+		sourceLoc = glGetUniformLocation(hizProgram, "uSource");
+		sourceLevelLoc = glGetUniformLocation(hizProgram, "uSourceLevel");
+		sourceSizeLoc = glGetUniformLocation(hizProgram, "uSourceSize");
+	}
+
+	sourceBuffer = UGpuGenBuffer("cull sources");
+	commandBuffer = UGpuGenBuffer("cull draw commands");
+	culling = true;
+	return true;
+
+}
+
+
+void UCullSetInstances(const vector<glm::mat4>& transforms, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+	const vector<CullDraw>& draws, GLuint instanceBuffer) {
+
+	if (!culling) {
+		return;
+	}
+
+	vector<CullSource> sources(transforms.size());
+	for (size_t i = 0; i < transforms.size(); i++) {
+		sources[i].model = transforms[i];
+		sources[i].boundsMin = glm::vec4(boundsMin, 1.0f);
+		sources[i].boundsMax = glm::vec4(boundsMax, 1.0f);
+	}
+	UStateBindBuffer(GL_SHADER_STORAGE_BUFFER, sourceBuffer);
+	UGpuBufferData(GL_SHADER_STORAGE_BUFFER, sourceBuffer, sources.size() * sizeof(CullSource), sources.data(), GL_STATIC_DRAW);
+	UStateBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	resetCommands.clear();
+	drawMaterials.clear();
+	for (size_t d = 0; d < draws.size() && d < CULL_MAX_DRAWS; d++) {
+		DrawCommand command = { draws[d].indexCount, 0, 0, 0, 0 };
+		resetCommands.push_back(command);
+		drawMaterials.push_back(draws[d].material);
+	}
+	UStateBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	UGpuBufferData(GL_DRAW_INDIRECT_BUFFER, commandBuffer, resetCommands.size() * sizeof(DrawCommand), resetCommands.data(), GL_DYNAMIC_DRAW);
+	UStateBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	instanceCount = (GLuint)transforms.size();
+	outputBuffer = instanceBuffer;
+
+}
+
+
+void UCullRun(const glm::mat4& model, const glm::mat4& viewProjection) {
+
+	if (!culling || resetCommands.empty()) {
+		return;
+	}
+	frameViewProjection = viewProjection * model;
+
+	// Zero the instance counts, a fixed few bytes whatever the scene size
+	UStateBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, resetCommands.size() * sizeof(DrawCommand), resetCommands.data());
+	UStateBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	UStateUseProgram(cullProgram);
+	glUniform1ui(instanceCountLoc, instanceCount);
+	glUniform1ui(drawCountLoc, (GLuint)resetCommands.size());
+	glUniform1uiv(materialsLoc, (GLsizei)drawMaterials.size(), drawMaterials.data());
+	glUniformMatrix4fv(viewProjectionLoc, 1, GL_FALSE, &frameViewProjection[0][0]);
+
+	bool occlusion = cullOptions.occlusion && hizValid;
+	glUniform1i(occlusionLoc, occlusion ? 1 : 0);
+	if (occlusion) {
+		glUniformMatrix4fv(hizViewProjectionLoc, 1, GL_FALSE, &hizViewProjection[0][0]);
+		glUniform2f(hizSceneLoc, (GLfloat)hizScene.x, (GLfloat)hizScene.y);
+		glUniform2iv(hizSizesLoc, hizLevels, &hizSizes[0][0]);
+		glUniform1i(hizLevelsLoc, hizLevels);
+		glUniform1i(hizLoc, 0);
+		UStateBindTexture(0, GL_TEXTURE_2D, hizTexture);
+	}
+
+	UStateBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, sourceBuffer);
+	UStateBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, outputBuffer);
+	UStateBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, commandBuffer);
+	glDispatchCompute((instanceCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+	// The draws read both the counts and the appended instances
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+	if (occlusion) {
+		UStateBindTexture(0, GL_TEXTURE_2D, 0);
+	}
+	UStateUseProgram(0);
+
+}
+
+
+void UCullDraw(int index) {
+
+	UStateBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(index * sizeof(DrawCommand)));
+	UStateBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+}
+
+
+// Smallest power of two at least value
+static int UPowerOfTwo(int value) {
+
+	int power = 1;
+	while (power < value) {
+		power *= 2;
+	}
+	return power;
+
+}
+
+
+// Grows the pyramid texture to hold a level 0 of width x height
+static void UAllocateHiZ(int width, int height) {
+
+	if (hizTexture != 0 && width <= hizWidth && height <= hizHeight) {
+		return;
+	}
+	UGpuDeleteTexture(hizTexture);
+
+	// Power of two levels stay at least as large as the rounded-up halves of any smaller scene
+	hizWidth = UPowerOfTwo(width);
+	hizHeight = UPowerOfTwo(height);
+	hizLevels = 1;
+	while (hizLevels < HIZ_MAX_LEVELS && (max(hizWidth, hizHeight) >> hizLevels) > 0) {
+		hizLevels++;
+	}
+
+	hizTexture = UGpuGenTexture("hiz pyramid");
+	UStateBindTexture(0, GL_TEXTURE_2D, hizTexture);
+	for (int level = 0; level < hizLevels; level++) {
+		UGpuTexImage2D(GL_TEXTURE_2D, hizTexture, level, GL_R32F, max(1, hizWidth >> level), max(1, hizHeight >> level), GL_RED, GL_FLOAT, NULL);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, hizLevels - 1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	UStateBindTexture(0, GL_TEXTURE_2D, 0);
+
+}
+
+
+void UCullBuildHiZ(GLuint depth, int width, int height) {
+
+	if (!culling || hizProgram == 0) {
+		return;
+	}
+
+	hizScene = glm::ivec2(width, height);
+	UAllocateHiZ((width + 1) / 2, (height + 1) / 2);
+
+	UStateUseProgram(hizProgram);
+	glUniform1i(sourceLoc, 0);
+
+	// Level 0 reads the depth buffer, every other level the one below it
+	glm::ivec2 sourceSize = hizScene;
+	for (int level = 0; level < hizLevels; level++) {
+		glm::ivec2 size = (sourceSize + 1) / 2;
+		hizSizes[level] = size;
+
+		UStateBindTexture(0, GL_TEXTURE_2D, level == 0 ? depth : hizTexture);
+		glUniform1i(sourceLevelLoc, level == 0 ? 0 : level - 1);
+		glUniform2i(sourceSizeLoc, sourceSize.x, sourceSize.y);
+		glBindImageTexture(0, hizTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+		glDispatchCompute((size.x + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, (size.y + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, 1);
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+		sourceSize = size;
+	}
+
+	glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+	UStateBindTexture(0, GL_TEXTURE_2D, 0);
+	UStateUseProgram(0);
+
+	hizViewProjection = frameViewProjection;
+	hizValid = true;
+
+}
+
+
+void UCullShutdown(void) {
+
+	UGpuDeleteProgram(cullProgram);
+	UGpuDeleteProgram(hizProgram);
+	UGpuDeleteBuffer(sourceBuffer);
+	UGpuDeleteBuffer(commandBuffer);
+	UGpuDeleteTexture(hizTexture);
+	cullProgram = hizProgram = sourceBuffer = commandBuffer = hizTexture = 0;
+	culling = false;
+	hizValid = false;
+
+}
@@ -0,0 +1,61 @@
+/*
+*	Title:	Final Project / GpuCulling.h
+*	Date:	October 19, 2026
+*
+*	Description: GPU-driven culling. A compute pass tests every instance's
+*	bounds against the view frustum, and optionally against a Hi-Z pyramid
+*	built from the previous frame's depth, and appends the survivors to the
+*	instance buffer the draws read. It also writes the surviving count into a
+*	draw-indirect buffer, so the CPU issues the same handful of calls per
+*	frame however many instances the scene holds. Needs GL 4.3 or the compute
+*	shader, storage buffer and draw indirect extensions; without them
+*	UCullInit returns false and the caller draws every instance itself.
+*
+*	Command line:
+*		--gpu-cull					cull instances on the GPU
+*		--hiz						also cull instances hidden behind last frame's depth,
+*									needs the scene drawn offscreen (see PostProcess.h)
+*/
+
+#pragma once
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#define CULL_MAX_DRAWS 4
+#define CULL_INSTANCE_BYTES 80	// output record: mat4 model, uint material, 3 uints padding
+
+struct CullOptions {
+	bool enabled;
+	bool occlusion;
+};
+
+// One indirect draw fed by the culling pass, every visible instance is drawn by each of them
+struct CullDraw {
+	GLuint indexCount;
+	GLuint material;			// written into each output record
+};
+
+// Reads the culling options out of the command line, returns false on a malformed argument
+bool UParseCullOptions(int argc, char* argv[], CullOptions& options);
+
+// Compiles the compute passes, false when culling is off or the context cannot run it
+bool UCullInit(const CullOptions& options);
+
+// Uploads the instances to cull, each with the same object-space bounds. instanceBuffer receives
+// draws.size() ranges of transforms.size() records, one range per draw in order.
+void UCullSetInstances(const std::vector<glm::mat4>& transforms, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+	const std::vector<CullDraw>& draws, GLuint instanceBuffer);
+
+// Culls every instance for this frame's model and view-projection and fills the indirect buffer
+void UCullRun(const glm::mat4& model, const glm::mat4& viewProjection);
+
+// Issues draw number index from the indirect buffer, with its VAO already bound
+void UCullDraw(int index);
+
+// Builds the Hi-Z pyramid the next frame culls against from this frame's scene depth,
+// sized width x height from the texture's origin. Call after the scene's last draw.
+void UCullBuildHiZ(GLuint depth, int width, int height);
+
+void UCullShutdown(void);
@@ -0,0 +1,294 @@
+/*
+*	Title:	Final Project / GpuResources.cpp
+*	Date:	October 19, 2026
+*
+*	Description: GPU resource registry. Objects are keyed by category and GL
+*	name, textures keep the bytes of each level so re-specifying or releasing a
+*	single mip updates the totals correctly. GL thread only.
+*/
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "GpuResources.h"
+#include "GlState.h"
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+struct GpuResource {
+	const char* label;
+	size_t bytes;
+	vector<size_t> levelBytes;	// textures only, bytes per mip level
+};
+
+static map<GLuint, GpuResource> resources[GPU_RESOURCE_TYPES];
+static size_t categoryBytes[GPU_RESOURCE_TYPES];
+static size_t totalBytes = 0;
+static size_t peakBytes = 0;
+
+static const char* categoryNames[GPU_RESOURCE_TYPES] = { "buffers", "textures", "vertex arrays", "programs", "framebuffers" };
+
+
+static void UTrack(GpuResourceType type, GLuint name, const char* label) {
+
+	if (name == 0) {
+		return;
+	}
+	GpuResource resource = { label, 0, vector<size_t>() };
+	resources[type][name] = resource;
+
+}
+
+
+static void UUntrack(GpuResourceType type, GLuint name) {
+
+	map<GLuint, GpuResource>::iterator found = resources[type].find(name);
+	if (found == resources[type].end()) {
+		return;
+	}
+	categoryBytes[type] -= found->second.bytes;
+	totalBytes -= found->second.bytes;
+	resources[type].erase(found);
+
+}
+
+
+// Moves a resource from oldBytes to newBytes and raises the watermark
+static void UResize(GpuResourceType type, GpuResource& resource, size_t oldBytes, size_t newBytes) {
+
+	resource.bytes = resource.bytes - oldBytes + newBytes;
+	categoryBytes[type] = categoryBytes[type] - oldBytes + newBytes;
+	totalBytes = totalBytes - oldBytes + newBytes;
+	peakBytes = max(peakBytes, totalBytes);
+
+}
+
+
+GLuint UGpuGenBuffer(const char* label) {
+
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	UTrack(GPU_BUFFER, buffer, label);
+	return buffer;
+
+}
+
+
+GLuint UGpuGenTexture(const char* label) {
+
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	UTrack(GPU_TEXTURE, texture, label);
+	return texture;
+
+}
+
+
+GLuint UGpuGenVertexArray(const char* label) {
+
+	GLuint vertexArray = 0;
+	glGenVertexArrays(1, &vertexArray);
+	UTrack(GPU_VERTEX_ARRAY, vertexArray, label);
+	return vertexArray;
+
+}
+
+
+GLuint UGpuCreateProgram(const char* label) {
+
+	GLuint program = glCreateProgram();
+	UTrack(GPU_PROGRAM, program, label);
+	return program;
+
+}
+
+
+GLuint UGpuGenFramebuffer(const char* label) {
+
+	GLuint framebuffer = 0;
+	glGenFramebuffers(1, &framebuffer);
+	UTrack(GPU_FRAMEBUFFER, framebuffer, label);
+	return framebuffer;
+
+}
+
+
+void UGpuDeleteBuffer(GLuint buffer) {
+
+	UUntrack(GPU_BUFFER, buffer);
+	UStateForget(GPU_BUFFER, buffer);
+	glDeleteBuffers(1, &buffer);
+
+}
+
+
+void UGpuDeleteTexture(GLuint texture) {
+
+	UUntrack(GPU_TEXTURE, texture);
+	UStateForget(GPU_TEXTURE, texture);
+	glDeleteTextures(1, &texture);
+
+}
+
+
+void UGpuDeleteVertexArray(GLuint vertexArray) {
+
+	UUntrack(GPU_VERTEX_ARRAY, vertexArray);
+	UStateForget(GPU_VERTEX_ARRAY, vertexArray);
+	glDeleteVertexArrays(1, &vertexArray);
+
+}
+
+
+void UGpuDeleteProgram(GLuint program) {
+
+	UUntrack(GPU_PROGRAM, program);
+	glDeleteProgram(program);
+
+}
+
+
+void UGpuDeleteFramebuffer(GLuint framebuffer) {
+
+	UUntrack(GPU_FRAMEBUFFER, framebuffer);
+	glDeleteFramebuffers(1, &framebuffer);
+
+}
+
+
+void UGpuBufferData(GLenum target, GLuint buffer, GLsizeiptr size, const void* data, GLenum usage) {
+
+	glBufferData(target, size, data, usage);
+
+	map<GLuint, GpuResource>::iterator found = resources[GPU_BUFFER].find(buffer);
+	if (found != resources[GPU_BUFFER].end()) {
+		UResize(GPU_BUFFER, found->second, found->second.bytes, (size_t)size);
+	}
+
+}
+
+
+void UGpuBufferStorage(GLenum target, GLuint buffer, GLsizeiptr size, const void* data, GLbitfield flags) {
+
+	glBufferStorage(target, size, data, flags);
+
+	map<GLuint, GpuResource>::iterator found = resources[GPU_BUFFER].find(buffer);
+	if (found != resources[GPU_BUFFER].end()) {
+		UResize(GPU_BUFFER, found->second, found->second.bytes, (size_t)size);
+	}
+
+}
+
+
+size_t UGpuTexelBytes(GLint internalFormat) {
+
+	switch (internalFormat) {
+	case GL_R8:
+		return 1;
+	case GL_RG8:
+	case GL_R16F:
+		return 2;
+	case GL_RGBA16F:
+	case GL_RGB16F:
+	case GL_RG32F:
+		return 8;
+	case GL_RGBA32F:
+	case GL_RGB32F:
+		return 16;
+	default:
+		return 4; // RGB8, RGBA8, R32F, R11F_G11F_B10F, depth formats
+	}
+
+}
+
+
+// Records the bytes of one texture level
+static void UTrackLevel(GLuint texture, GLint level, size_t bytes) {
+
+	map<GLuint, GpuResource>::iterator found = resources[GPU_TEXTURE].find(texture);
+	if (found == resources[GPU_TEXTURE].end()) {
+		return;
+	}
+	vector<size_t>& levels = found->second.levelBytes;
+	if ((size_t)level >= levels.size()) {
+		levels.resize(level + 1, 0);
+	}
+	UResize(GPU_TEXTURE, found->second, levels[level], bytes);
+	levels[level] = bytes;
+
+}
+
+
+void UGpuTexImage2D(GLenum target, GLuint texture, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data) {
+
+	glTexImage2D(target, level, internalFormat, width, height, 0, format, type, data);
+	UTrackLevel(texture, level, (size_t)width * height * UGpuTexelBytes(internalFormat));
+
+}
+
+
+void UGpuTexImage3D(GLenum target, GLuint texture, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* data) {
+
+	glTexImage3D(target, level, internalFormat, width, height, depth, 0, format, type, data);
+	UTrackLevel(texture, level, (size_t)width * height * depth * UGpuTexelBytes(internalFormat));
+
+}
+
+
+void UGpuCompressedTexImage3D(GLenum target, GLuint texture, GLint level, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLsizei imageSize, const void* data) {
+
+	glCompressedTexImage3D(target, level, internalFormat, width, height, depth, 0, imageSize, data);
+	UTrackLevel(texture, level, (size_t)imageSize);
+
+}
+
+
+GpuMemoryStats UGpuMemoryStats(void) {
+
+	GpuMemoryStats stats;
+	for (int type = 0; type < GPU_RESOURCE_TYPES; type++) {
+		stats.count[type] = (int)resources[type].size();
+		stats.bytes[type] = categoryBytes[type];
+	}
+	stats.totalBytes = totalBytes;
+	stats.peakBytes = peakBytes;
+	return stats;
+
+}
+
+
+void UGpuPrintMemory(void) {
+
+	GpuMemoryStats stats = UGpuMemoryStats();
+	ostringstream report;
+	report << fixed << setprecision(1);
+	for (int type = 0; type < GPU_RESOURCE_TYPES; type++) {
+		report << "GPU " << categoryNames[type] << ": " << stats.count[type] << " live, " << stats.bytes[type] / 1024.0 << " KB\n";
+	}
+	report << "GPU total: " << stats.totalBytes / 1024.0 << " KB, peak " << stats.peakBytes / 1024.0 << " KB\n";
+	std::cout << report.str();
+
+}
+
+
+int UGpuLeakReport(void) {
+
+	int leaks = 0;
+	for (int type = 0; type < GPU_RESOURCE_TYPES; type++) {
+		map<GLuint, GpuResource>::const_iterator it;
+		for (it = resources[type].begin(); it != resources[type].end(); ++it) {
+			std::cerr << "GPU leak: " << categoryNames[type] << " " << it->first << " '" << it->second.label << "' " << it->second.bytes << " bytes\n";
+			leaks++;
+		}
+	}
+	if (leaks > 0) {
+		std::cerr << leaks << " GPU objects were not deleted\n";
+	}
+	return leaks;
+
+}
@@ -0,0 +1,71 @@
+/*
+*	Title:	Final Project / GpuResources.h
+*	Date:	October 19, 2026
+*
+*	Description: Registry of every GL buffer, texture, vertex array, program
+*	and framebuffer the application creates. Creation and deletion go through the
+*	wrappers below, and uploads through UGpuBufferData, UGpuTexImage* and
+*	UGpuCompressedTexImage3D, so the registry knows the bytes each object
+*	holds. It keeps live totals by category and a peak watermark, and lists
+*	whatever is still alive at shutdown as a leak.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <GL/glew.h>
+
+enum GpuResourceType {
+	GPU_BUFFER,
+	GPU_TEXTURE,
+	GPU_VERTEX_ARRAY,
+	GPU_PROGRAM,
+	GPU_FRAMEBUFFER,
+	GPU_RESOURCE_TYPES
+};
+
+struct GpuMemoryStats {
+	int count[GPU_RESOURCE_TYPES];
+	size_t bytes[GPU_RESOURCE_TYPES];
+	size_t totalBytes;
+	size_t peakBytes;		// highest totalBytes seen
+};
+
+// Creation, label names the object in reports and must outlive it (string literals)
+GLuint UGpuGenBuffer(const char* label);
+GLuint UGpuGenTexture(const char* label);
+GLuint UGpuGenVertexArray(const char* label);
+GLuint UGpuCreateProgram(const char* label);
+GLuint UGpuGenFramebuffer(const char* label);
+
+// Deletion, zero names are ignored like glDelete* does
+void UGpuDeleteBuffer(GLuint buffer);
+void UGpuDeleteTexture(GLuint texture);
+void UGpuDeleteVertexArray(GLuint vertexArray);
+void UGpuDeleteProgram(GLuint program);
+void UGpuDeleteFramebuffer(GLuint framebuffer);
+
+// glBufferData on the buffer bound to target, which must be buffer
+void UGpuBufferData(GLenum target, GLuint buffer, GLsizeiptr size, const void* data, GLenum usage);
+
+// glBufferStorage on the buffer bound to target, which must be buffer
+void UGpuBufferStorage(GLenum target, GLuint buffer, GLsizeiptr size, const void* data, GLbitfield flags);
+
+// glTexImage2D/3D on the texture bound to target, which must be texture,
+// a zero sized level releases that level's bytes
+void UGpuTexImage2D(GLenum target, GLuint texture, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data);
+void UGpuTexImage3D(GLenum target, GLuint texture, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* data);
+
+// glCompressedTexImage3D on the texture bound to target, imageSize is what the level holds
+void UGpuCompressedTexImage3D(GLenum target, GLuint texture, GLint level, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLsizei imageSize, const void* data);
+
+// Bytes a texture level takes on the GPU, drivers pad 3 channel formats to 4 bytes
+size_t UGpuTexelBytes(GLint internalFormat);
+
+GpuMemoryStats UGpuMemoryStats(void);
+
+// Prints live counts and bytes by category and the peak watermark
+void UGpuPrintMemory(void);
+
+// Lists every object still alive, returns how many there are
+int UGpuLeakReport(void);
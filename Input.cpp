@@ -0,0 +1,133 @@
+/*
+*	Title:	Final Project / Input.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Input queue and per-frame coalescing. The GLUT callbacks only
+*	push events here, all interpretation happens once per frame.
+*/
+
+#include <chrono>
+#include <GL/freeglut.h>
+
+#include "Input.h"
+
+using namespace std; // standard namespace
+
+// Events received since the last coalesce
+static vector<InputEvent> pendingEvents;
+
+// State carried between frames, mirrors what UMouseMove used to keep globally
+static float lastMouseX = 400, lastMouseY = 300; // Locks the mouse cursor at the center of the screen
+static bool mouseDetected = true; // Initially true when mouse movement is detected
+static int prevY = 0; // previous value of Y for the zoom feature
+static bool leftButton = false;
+static bool rightButton = false;
+static int lastModifiers = 0;
+static int mouseX = 400, mouseY = 300;
+static bool keysHeld[256] = { false };
+
+
+double UElapsedSeconds(void) {
+
+	static const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+}
+
+
+void UQueueInput(InputEvent event) {
+
+	if (event.time < 0.0) {
+		event.time = UElapsedSeconds();
+	}
+	pendingEvents.push_back(event);
+
+}
+
+
+const vector<InputEvent>& UPendingInput(void) {
+
+	return pendingEvents;
+
+}
+
+
+FrameInput UCoalesceInput(void) {
+
+	FrameInput frame = {};
+	int zoomSteps = 0;
+
+	for (size_t i = 0; i < pendingEvents.size(); i++) {
+		const InputEvent& event = pendingEvents[i];
+		lastModifiers = event.modifiers;
+
+		switch (event.type) {
+
+		case INPUT_MOUSE_BUTTON:
+			if (event.button == GLUT_LEFT_BUTTON) {
+				leftButton = (event.state == GLUT_DOWN);
+			}
+			if (event.button == GLUT_RIGHT_BUTTON) {
+				rightButton = (event.state == GLUT_DOWN);
+			}
+			break;
+
+		case INPUT_MOUSE_MOVE:
+			mouseX = event.x;
+			mouseY = event.y;
+
+			if (mouseDetected) {
+				lastMouseX = (float)event.x;
+				lastMouseY = (float)event.y;
+				mouseDetected = false;
+			}
+
+			// Orbit while holding ALT and the left mouse button
+			if (leftButton && event.modifiers == GLUT_ACTIVE_ALT) {
+				frame.orbitX += event.x - lastMouseX;
+				frame.orbitY += lastMouseY - event.y; // inverted Y
+				lastMouseX = (float)event.x;
+				lastMouseY = (float)event.y;
+			}
+
+			// Zoom IN (drag UP) and OUT (drag DOWN) while holding ALT and the right mouse button
+			if (rightButton && event.modifiers == GLUT_ACTIVE_ALT) {
+				if (event.y > prevY) {
+					zoomSteps++;
+				}
+				if (event.y < prevY) {
+					zoomSteps--;
+				}
+				prevY = event.y;
+			}
+			break;
+
+		case INPUT_KEY_DOWN:
+			keysHeld[event.key] = true;
+			break;
+
+		case INPUT_KEY_UP:
+			keysHeld[event.key] = false;
+			break;
+		}
+	}
+
+	frame.zoomDirection = (zoomSteps > 0) - (zoomSteps < 0);
+	frame.leftButton = leftButton;
+	frame.rightButton = rightButton;
+	frame.shiftHeld = (lastModifiers & GLUT_ACTIVE_SHIFT) != 0;
+	frame.mouseX = mouseX;
+	frame.mouseY = mouseY;
+	frame.eventCount = (int)pendingEvents.size();
+
+	pendingEvents.clear();
+	return frame;
+
+}
+
+
+bool UKeyHeld(unsigned char key) {
+
+	return keysHeld[key];
+
+}
@@ -0,0 +1,59 @@
+/*
+*	Title:	Final Project / Input.h
+*	Date:	October 19, 2026
+*
+*	Description: Queues GLUT mouse and keyboard events as they arrive and
+*	coalesces them into a single FrameInput once per frame.
+*/
+
+#pragma once
+
+#include <vector>
+
+// Kinds of queued input events
+enum InputEventType {
+	INPUT_MOUSE_BUTTON,
+	INPUT_MOUSE_MOVE,
+	INPUT_KEY_DOWN,
+	INPUT_KEY_UP
+};
+
+// One raw GLUT event, captured with the modifiers held when it fired
+struct InputEvent {
+	InputEventType type;
+	int x;
+	int y;
+	int button;				// GLUT_LEFT_BUTTON etc. for INPUT_MOUSE_BUTTON
+	int state;				// GLUT_DOWN / GLUT_UP for INPUT_MOUSE_BUTTON
+	unsigned char key;		// ASCII key for INPUT_KEY_DOWN / INPUT_KEY_UP
+	int modifiers;			// glutGetModifiers() at the time of the event
+	double time;			// seconds since start, from UElapsedSeconds()
+};
+
+// Everything the camera needs from one frame's worth of events
+struct FrameInput {
+	float orbitX;			// ALT + left drag, sensitivity not yet applied
+	float orbitY;			// inverted Y
+	int zoomDirection;		// +1 dragging down, -1 dragging up with ALT + right held, 0 otherwise
+	bool leftButton;
+	bool rightButton;
+	bool shiftHeld;
+	int mouseX;
+	int mouseY;
+	int eventCount;			// raw events folded into this frame
+};
+
+// Seconds since the first call, from a monotonic clock
+double UElapsedSeconds(void);
+
+// Adds an event to the queue, stamping it if time is negative
+void UQueueInput(InputEvent event);
+
+// Events queued since the last UCoalesceInput, in arrival order
+const std::vector<InputEvent>& UPendingInput(void);
+
+// Folds every queued event into one FrameInput and empties the queue
+FrameInput UCoalesceInput(void);
+
+// Whether a key is currently held, as of the last UCoalesceInput
+bool UKeyHeld(unsigned char key);
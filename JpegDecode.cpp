@@ -0,0 +1,1005 @@
+/*
+*	Title:	Final Project / JpegDecode.cpp
+*	Date:	October 19, 2026
+*
+*	Description: JPEG decoding. Headers are walked marker by marker, each scan
+*	is entropy decoded block by block straight into dequantized floats and
+*	inverse transformed into a sample plane per component, then the planes
+*	are upsampled and converted to RGBA one output row at a time.
+*
+*	The full size inverse DCT is the AAN float transform, with the AAN scale
+*	factors and the final divide by 8 folded into the dequantization
+*	multipliers. Reduced sizes multiply by the 8-point basis sampled at the
+*	centres of the reduced samples and box filtered, so they match averaging
+*	the full size decode.
+*	Blocks without AC coefficients skip the transform entirely.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JPEG_SSE2 1
+#endif
+
+#include "JpegDecode.h"
+
+using namespace std; // standard namespace
+
+#define JPEG_LOOKUP_BITS 10				// Huffman codes this long or shorter decode with one table lookup
+#define JPEG_MAX_COMPONENTS 3
+
+// Natural (row-major) position of each zigzag index, the tail absorbs runs past 63 in corrupt data
+static const unsigned char zigzag[64 + 16] = {
+	0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+	12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+	35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+	58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+	63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63
+};
+
+struct HuffmanTable {
+	bool present;
+	unsigned char lookupLength[1 << JPEG_LOOKUP_BITS];	// 0 when the code is longer than the lookup
+	unsigned char lookupValue[1 << JPEG_LOOKUP_BITS];
+	int lookupAc[1 << JPEG_LOOKUP_BITS];	// value << 8 | run << 4 | bits when an AC code and its magnitude fit, else 0
+	int minCode[17];
+	int maxCode[18];				// -1 for lengths without codes, maxCode[17] ends the search
+	int valuePointer[17];
+	unsigned char values[256];
+};
+
+struct JpegComponent {
+	int id;
+	int h;
+	int v;
+	int quant;
+	int dcTable;
+	int acTable;
+	int dcPredictor;
+	int blocksW;					// blocks across the plane, a whole number of MCUs
+	int blocksH;
+	int stride;
+	vector<unsigned char> plane;	// samples at the decoded scale
+};
+
+// Entropy coded data, bits are kept left aligned so the next code is always in the top bits
+struct BitReader {
+	const unsigned char* data;
+	const unsigned char* end;
+	uint64_t bits;
+	int count;
+	bool marker;					// reached a marker, zeros are fed from here on
+};
+
+struct JpegState {
+	const unsigned char* data;
+	const unsigned char* end;
+	int width;
+	int height;
+	int componentCount;
+	JpegComponent components[JPEG_MAX_COMPONENTS];
+	int hMax;
+	int vMax;
+	int mcusX;
+	int mcusY;
+	unsigned short quant[4][64];	// natural order
+	bool quantPresent[4];
+	HuffmanTable dc[4];
+	HuffmanTable ac[4];
+	int restartInterval;
+	bool adobeRgb;					// Adobe marker says the three components are RGB, not YCbCr
+	bool frameSeen;
+	int blockSize;					// 8 >> scaleShift
+	float multipliers[4][64];		// dequantization per quant table, natural order
+	BitReader bits;
+};
+
+
+static inline int UReadWord(const unsigned char* p) {
+
+	return (p[0] << 8) | p[1];
+
+}
+
+
+// Builds the decoding tables of a DHT table from its 16 code counts and values
+static bool UBuildHuffman(HuffmanTable& table, const unsigned char* counts, const unsigned char* values, int valueCount) {
+
+	memset(&table, 0, sizeof(table));
+	memcpy(table.values, values, valueCount);
+
+	int code = 0;
+	int k = 0;
+	for (int length = 1; length <= 16; length++) {
+		table.valuePointer[length] = k;
+		table.minCode[length] = code;
+		for (int i = 0; i < counts[length - 1]; i++) {
+			if (length <= JPEG_LOOKUP_BITS) {
+				int shift = JPEG_LOOKUP_BITS - length;
+				for (int fill = 0; fill < (1 << shift); fill++) {
+					table.lookupLength[(code << shift) | fill] = (unsigned char)length;
+					table.lookupValue[(code << shift) | fill] = values[k];
+				}
+			}
+			code++;
+			k++;
+		}
+		table.maxCode[length] = counts[length - 1] != 0 ? code - 1 : -1;
+		if (code > (1 << length)) {
+			return false; // more codes than the length allows
+		}
+		code <<= 1;
+	}
+	table.maxCode[17] = INT32_MAX;
+
+	// Short AC codes with short magnitudes, the bulk of most images, come out of one lookup
+	for (int look = 0; look < (1 << JPEG_LOOKUP_BITS); look++) {
+		int length = table.lookupLength[look];
+		int run = table.lookupValue[look] >> 4;
+		int s = table.lookupValue[look] & 15;
+		if (length == 0 || s == 0 || length + s > JPEG_LOOKUP_BITS) {
+			continue;
+		}
+		int value = (look >> (JPEG_LOOKUP_BITS - length - s)) & ((1 << s) - 1);
+		if (value < (1 << (s - 1))) {
+			value += 1 - (1 << s);
+		}
+		table.lookupAc[look] = value * 256 + (run << 4) + length + s;
+	}
+	table.present = true;
+	return true;
+
+}
+
+
+static inline void URefill(BitReader& reader) {
+
+	while (reader.count <= 56) {
+		unsigned int byte = 0;
+		if (!reader.marker && reader.data < reader.end) {
+			byte = *reader.data;
+			if (byte != 0xFF) {
+				reader.data++;
+			}
+			else if (reader.data + 1 < reader.end && reader.data[1] == 0x00) {
+				reader.data += 2; // stuffed zero
+			}
+			else {
+				reader.marker = true; // leave the data at the marker
+				byte = 0;
+			}
+		}
+		reader.bits |= (uint64_t)byte << (56 - reader.count);
+		reader.count += 8;
+	}
+
+}
+
+
+// Next Huffman coded value, -1 for a code the table does not have
+static inline int UDecodeHuffman(BitReader& reader, const HuffmanTable& table) {
+
+	if (reader.count < 16) {
+		URefill(reader);
+	}
+	unsigned int look = (unsigned int)(reader.bits >> (64 - JPEG_LOOKUP_BITS));
+	int length = table.lookupLength[look];
+	if (length != 0) {
+		reader.bits <<= length;
+		reader.count -= length;
+		return table.lookupValue[look];
+	}
+
+	int code = (int)(reader.bits >> 48);
+	for (length = JPEG_LOOKUP_BITS + 1; length <= 16; length++) {
+		int prefix = code >> (16 - length);
+		if (prefix <= table.maxCode[length]) {
+			reader.bits <<= length;
+			reader.count -= length;
+			return table.values[(table.valuePointer[length] + prefix - table.minCode[length]) & 0xFF];
+		}
+	}
+	return -1;
+
+}
+
+
+// Reads an s-bit magnitude and extends it to its signed value
+static inline int UReceiveExtend(BitReader& reader, int s) {
+
+	if (s == 0) {
+		return 0;
+	}
+	if (reader.count < s) {
+		URefill(reader);
+	}
+	int value = (int)(reader.bits >> (64 - s));
+	reader.bits <<= s;
+	reader.count -= s;
+	return value < (1 << (s - 1)) ? value - (1 << s) + 1 : value;
+
+}
+
+
+// Decodes one block into dequantized coefficients, returns -1 on corrupt data,
+// otherwise 1 when any AC coefficient is non-zero
+static int UDecodeBlock(JpegState& state, JpegComponent& component, float* block) {
+
+	BitReader& reader = state.bits;
+	const float* multipliers = state.multipliers[component.quant];
+
+	int s = UDecodeHuffman(reader, state.dc[component.dcTable]);
+	if (s < 0 || s > 16) {
+		return -1;
+	}
+	component.dcPredictor += UReceiveExtend(reader, s);
+	block[0] = component.dcPredictor * multipliers[0];
+
+	const HuffmanTable& ac = state.ac[component.acTable];
+	int hasAc = 0;
+	for (int k = 1; k < 64; k++) {
+		if (reader.count < 16) {
+			URefill(reader);
+		}
+		int fast = ac.lookupAc[reader.bits >> (64 - JPEG_LOOKUP_BITS)];
+		if (fast != 0) {
+			reader.bits <<= fast & 15;
+			reader.count -= fast & 15;
+			k += (fast >> 4) & 15;
+			int natural = zigzag[k];
+			float value = (fast >> 8) * multipliers[natural];
+			block[natural] = value;
+			hasAc |= value != 0.0f;
+			continue;
+		}
+		int rs = UDecodeHuffman(reader, ac);
+		if (rs < 0) {
+			return -1;
+		}
+		int run = rs >> 4;
+		s = rs & 15;
+		if (s == 0) {
+			if (run != 15) {
+				break; // end of block
+			}
+			k += 15;
+			continue;
+		}
+		k += run;
+		int natural = zigzag[k];
+		float value = UReceiveExtend(reader, s) * multipliers[natural];
+		block[natural] = value;
+		hasAc |= value != 0.0f;
+	}
+	return hasAc;
+
+}
+
+
+// Fills a size x size block with one value, the whole block when it has no AC coefficients
+static void UFillBlock(float dc, int size, unsigned char* out, int stride) {
+
+	int value = (int)lrintf(dc) + 128;
+	unsigned char sample = (unsigned char)min(max(value, 0), 255);
+	for (int y = 0; y < size; y++) {
+		memset(out + (size_t)y * stride, sample, size);
+	}
+
+}
+
+
+#ifdef JPEG_SSE2
+// One 1D AAN inverse DCT down the 8 rows of four columns
+static inline void UIdctQuad(__m128* r) {
+
+	// Even part
+	__m128 tmp10 = _mm_add_ps(r[0], r[4]);
+	__m128 tmp11 = _mm_sub_ps(r[0], r[4]);
+	__m128 tmp13 = _mm_add_ps(r[2], r[6]);
+	__m128 tmp12 = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(r[2], r[6]), _mm_set1_ps(1.414213562f)), tmp13);
+	__m128 tmp0 = _mm_add_ps(tmp10, tmp13);
+	__m128 tmp3 = _mm_sub_ps(tmp10, tmp13);
+	__m128 tmp1 = _mm_add_ps(tmp11, tmp12);
+	__m128 tmp2 = _mm_sub_ps(tmp11, tmp12);
+
+	// Odd part
+	__m128 z13 = _mm_add_ps(r[5], r[3]);
+	__m128 z10 = _mm_sub_ps(r[5], r[3]);
+	__m128 z11 = _mm_add_ps(r[1], r[7]);
+	__m128 z12 = _mm_sub_ps(r[1], r[7]);
+	__m128 tmp7 = _mm_add_ps(z11, z13);
+	tmp11 = _mm_mul_ps(_mm_sub_ps(z11, z13), _mm_set1_ps(1.414213562f));
+	__m128 z5 = _mm_mul_ps(_mm_add_ps(z10, z12), _mm_set1_ps(1.847759065f));
+	tmp10 = _mm_sub_ps(_mm_mul_ps(z12, _mm_set1_ps(1.082392200f)), z5);
+	tmp12 = _mm_add_ps(_mm_mul_ps(z10, _mm_set1_ps(-2.613125930f)), z5);
+	__m128 tmp6 = _mm_sub_ps(tmp12, tmp7);
+	__m128 tmp5 = _mm_sub_ps(tmp11, tmp6);
+	__m128 tmp4 = _mm_add_ps(tmp10, tmp5);
+
+	r[0] = _mm_add_ps(tmp0, tmp7);
+	r[7] = _mm_sub_ps(tmp0, tmp7);
+	r[1] = _mm_add_ps(tmp1, tmp6);
+	r[6] = _mm_sub_ps(tmp1, tmp6);
+	r[2] = _mm_add_ps(tmp2, tmp5);
+	r[5] = _mm_sub_ps(tmp2, tmp5);
+	r[4] = _mm_add_ps(tmp3, tmp4);
+	r[3] = _mm_sub_ps(tmp3, tmp4);
+
+}
+
+
+static inline void UTranspose(const __m128* in, __m128* out) {
+
+	__m128 a = in[0], b = in[1], c = in[2], d = in[3];
+	_MM_TRANSPOSE4_PS(a, b, c, d);
+	out[0] = a;
+	out[1] = b;
+	out[2] = c;
+	out[3] = d;
+
+}
+
+
+// Full size inverse DCT of a dequantized block into 8x8 samples
+static void UIdct8(const float* block, unsigned char* out, int stride) {
+
+	// Columns 0-3 and 4-7 of every row, transformed down the columns
+	__m128 left[8];
+	__m128 right[8];
+	for (int row = 0; row < 8; row++) {
+		left[row] = _mm_loadu_ps(block + row * 8);
+		right[row] = _mm_loadu_ps(block + row * 8 + 4);
+	}
+	UIdctQuad(left);
+	UIdctQuad(right);
+
+	// Transposed, the same pass then runs along the rows
+	__m128 top[8];
+	__m128 bottom[8];
+	UTranspose(left, top);
+	UTranspose(left + 4, bottom);
+	UTranspose(right, top + 4);
+	UTranspose(right + 4, bottom + 4);
+	UIdctQuad(top);
+	UIdctQuad(bottom);
+
+	// Back to rows of samples, the level shift is the only thing left to add
+	__m128 rows[16];
+	UTranspose(top, rows);
+	UTranspose(top + 4, rows + 4);
+	UTranspose(bottom, rows + 8);
+	UTranspose(bottom + 4, rows + 12);
+	__m128 shift = _mm_set1_ps(128.0f);
+	for (int y = 0; y < 8; y++) {
+		const __m128* lo = y < 4 ? &rows[y] : &rows[8 + y - 4];
+		__m128i a = _mm_cvtps_epi32(_mm_add_ps(lo[0], shift));
+		__m128i b = _mm_cvtps_epi32(_mm_add_ps(lo[4], shift));
+		__m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_setzero_si128());
+		_mm_storel_epi64((__m128i*)(out + (size_t)y * stride), packed);
+	}
+
+}
+#else
+// One 1D AAN inverse DCT over 8 values step apart
+static inline void UIdctLine(float* p, int step) {
+
+	float tmp10 = p[0] + p[4 * step];
+	float tmp11 = p[0] - p[4 * step];
+	float tmp13 = p[2 * step] + p[6 * step];
+	float tmp12 = (p[2 * step] - p[6 * step]) * 1.414213562f - tmp13;
+	float tmp0 = tmp10 + tmp13;
+	float tmp3 = tmp10 - tmp13;
+	float tmp1 = tmp11 + tmp12;
+	float tmp2 = tmp11 - tmp12;
+
+	float z13 = p[5 * step] + p[3 * step];
+	float z10 = p[5 * step] - p[3 * step];
+	float z11 = p[1 * step] + p[7 * step];
+	float z12 = p[1 * step] - p[7 * step];
+	float tmp7 = z11 + z13;
+	tmp11 = (z11 - z13) * 1.414213562f;
+	float z5 = (z10 + z12) * 1.847759065f;
+	tmp10 = z12 * 1.082392200f - z5;
+	tmp12 = z10 * -2.613125930f + z5;
+	float tmp6 = tmp12 - tmp7;
+	float tmp5 = tmp11 - tmp6;
+	float tmp4 = tmp10 + tmp5;
+
+	p[0] = tmp0 + tmp7;
+	p[7 * step] = tmp0 - tmp7;
+	p[1 * step] = tmp1 + tmp6;
+	p[6 * step] = tmp1 - tmp6;
+	p[2 * step] = tmp2 + tmp5;
+	p[5 * step] = tmp2 - tmp5;
+	p[4 * step] = tmp3 + tmp4;
+	p[3 * step] = tmp3 - tmp4;
+
+}
+
+
+static void UIdct8(const float* block, unsigned char* out, int stride) {
+
+	float work[64];
+	memcpy(work, block, sizeof(work));
+	for (int column = 0; column < 8; column++) {
+		UIdctLine(work + column, 8);
+	}
+	for (int row = 0; row < 8; row++) {
+		UIdctLine(work + row * 8, 1);
+		for (int x = 0; x < 8; x++) {
+			int value = (int)lrintf(work[row * 8 + x]) + 128;
+			out[(size_t)row * stride + x] = (unsigned char)min(max(value, 0), 255);
+		}
+	}
+
+}
+#endif
+
+
+// Reduced inverse DCT bases, basis[x * 8 + u] = C(u) cos((2x + 1) u pi / 16 * 8 / N) / 2 for N of 4 and 2,
+// the 8-point basis evaluated at the centres of the N reduced samples, times the response of the
+// 8 / N wide box filter at frequency u. Every reduced sample is then exactly the average of the full
+// size samples it covers, high frequencies included, which is what the smaller mips are built from.
+struct ReducedBasis {
+
+	float four[32];
+	float two[16];
+
+	static void UBuild(float* basis, int size) {
+		const double pi = 3.14159265358979323846;
+		int width = 8 / size;
+		for (int x = 0; x < size; x++) {
+			for (int u = 0; u < 8; u++) {
+				double box = 0.0;
+				for (int j = 0; j < width; j++) {
+					box += cos((2 * j + 1 - width) * u * pi / 16.0);
+				}
+				double centre = (2 * x + 1) * width;
+				basis[x * 8 + u] = (float)((u == 0 ? sqrt(0.5) : 1.0) * cos(centre * u * pi / 16.0) / 2.0 * box / width);
+			}
+		}
+	}
+
+	ReducedBasis(void) {
+		UBuild(four, 4);
+		UBuild(two, 2);
+	}
+
+};
+
+
+static const float* UReducedBasis(int size) {
+
+	static const ReducedBasis basis; // built once, safely, by whichever decode thread gets here first
+	return size == 4 ? basis.four : basis.two;
+
+}
+
+
+// Inverse DCT of an 8x8 block straight into size x size samples
+static void UIdctReduced(const float* block, int size, const float* basis, unsigned char* out, int stride) {
+
+	// Down the columns, then along the rows
+	float columns[32];
+	for (int y = 0; y < size; y++) {
+		for (int u = 0; u < 8; u++) {
+			float sum = 0.0f;
+			for (int v = 0; v < 8; v++) {
+				sum += basis[y * 8 + v] * block[v * 8 + u];
+			}
+			columns[y * 8 + u] = sum;
+		}
+	}
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			float sum = 0.0f;
+			for (int u = 0; u < 8; u++) {
+				sum += basis[x * 8 + u] * columns[y * 8 + u];
+			}
+			int value = (int)lrintf(sum) + 128;
+			out[(size_t)y * stride + x] = (unsigned char)min(max(value, 0), 255);
+		}
+	}
+
+}
+
+
+// Dequantization multipliers for the decoded block size
+static void UBuildMultipliers(JpegState& state, int table) {
+
+	static const double aanScale[8] = {
+		1.0, 1.387039845, 1.306562965, 1.175875602, 1.0, 0.785694958, 0.541196100, 0.275899379
+	};
+	int size = state.blockSize;
+	for (int k = 0; k < 64; k++) {
+		int v = k >> 3;
+		int u = k & 7;
+		double multiplier = state.quant[table][k];
+		if (size == 8) {
+			multiplier *= aanScale[v] * aanScale[u] / 8.0;
+		}
+		state.multipliers[table][k] = (float)multiplier;
+	}
+
+}
+
+
+// Skips to the restart marker the encoder put after every restartInterval MCUs
+static bool URestart(JpegState& state) {
+
+	const unsigned char* p = state.bits.data;
+	while (p + 1 < state.end && !(p[0] == 0xFF && p[1] >= 0xD0 && p[1] <= 0xD7)) {
+		p++;
+	}
+	if (p + 1 >= state.end) {
+		return false;
+	}
+	state.bits.data = p + 2;
+	state.bits.bits = 0;
+	state.bits.count = 0;
+	state.bits.marker = false;
+	for (int c = 0; c < state.componentCount; c++) {
+		state.components[c].dcPredictor = 0;
+	}
+	return true;
+
+}
+
+
+// Decodes the block at (blockX, blockY) of a component and writes its samples
+static bool UDecodeBlockAt(JpegState& state, JpegComponent& component, int blockX, int blockY) {
+
+	float block[64];
+	memset(block, 0, sizeof(block));
+	int hasAc = UDecodeBlock(state, component, block);
+	if (hasAc < 0) {
+		return false;
+	}
+
+	int size = state.blockSize;
+	unsigned char* out = &component.plane[(size_t)blockY * size * component.stride + (size_t)blockX * size];
+	if (!hasAc || size == 1) {
+		UFillBlock(size == 8 ? block[0] : block[0] / 8.0f, size, out, component.stride); // only the full size multipliers fold in the 1/8
+	}
+	else if (size == 8) {
+		UIdct8(block, out, component.stride);
+	}
+	else {
+		UIdctReduced(block, size, UReducedBasis(size), out, component.stride);
+	}
+	return true;
+
+}
+
+
+// Entropy decodes one scan starting at its SOS segment, leaves state.data past the scan
+static bool UDecodeScan(JpegState& state, const unsigned char* segment, int length) {
+
+	int count = segment[0];
+	if (count < 1 || count > state.componentCount || length < 1 + 2 * count + 3) {
+		return false;
+	}
+	JpegComponent* scan[JPEG_MAX_COMPONENTS];
+	for (int i = 0; i < count; i++) {
+		int id = segment[1 + 2 * i];
+		int tables = segment[2 + 2 * i];
+		scan[i] = 0;
+		for (int c = 0; c < state.componentCount; c++) {
+			if (state.components[c].id == id) {
+				scan[i] = &state.components[c];
+			}
+		}
+		if (scan[i] == 0 || (tables >> 4) > 3 || (tables & 15) > 3 || !state.dc[tables >> 4].present || !state.ac[tables & 15].present) {
+			return false;
+		}
+		scan[i]->dcTable = tables >> 4;
+		scan[i]->acTable = tables & 15;
+		scan[i]->dcPredictor = 0;
+	}
+
+	state.bits.data = segment + length;
+	state.bits.end = state.end;
+	state.bits.bits = 0;
+	state.bits.count = 0;
+	state.bits.marker = false;
+
+	// One component alone is coded block by block over just the blocks the image covers
+	int unitsX = state.mcusX;
+	int unitsY = state.mcusY;
+	if (count == 1) {
+		JpegComponent& only = *scan[0];
+		unitsX = ((state.width * only.h + state.hMax - 1) / state.hMax + 7) / 8;
+		unitsY = ((state.height * only.v + state.vMax - 1) / state.vMax + 7) / 8;
+	}
+
+	int restartsLeft = state.restartInterval;
+	for (int unitY = 0; unitY < unitsY; unitY++) {
+		for (int unitX = 0; unitX < unitsX; unitX++) {
+			if (state.restartInterval != 0) {
+				if (restartsLeft == 0) {
+					if (!URestart(state)) {
+						return false;
+					}
+					restartsLeft = state.restartInterval;
+				}
+				restartsLeft--;
+			}
+
+			if (count == 1) {
+				if (!UDecodeBlockAt(state, *scan[0], unitX, unitY)) {
+					return false;
+				}
+				continue;
+			}
+			for (int i = 0; i < count; i++) {
+				JpegComponent& component = *scan[i];
+				for (int v = 0; v < component.v; v++) {
+					for (int h = 0; h < component.h; h++) {
+						if (!UDecodeBlockAt(state, component, unitX * component.h + h, unitY * component.v + v)) {
+							return false;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// The next marker follows the entropy coded data
+	const unsigned char* p = state.bits.data;
+	while (p + 1 < state.end && !(p[0] == 0xFF && p[1] != 0x00 && (p[1] < 0xD0 || p[1] > 0xD7) && p[1] != 0xFF)) {
+		p++;
+	}
+	state.data = p;
+	return true;
+
+}
+
+
+// Reads the frame header, sizing the component planes for the decoded scale
+static bool UReadFrame(JpegState& state, const unsigned char* segment, int length, bool allocate) {
+
+	if (length < 6 || segment[0] != 8) {
+		return false; // 12-bit samples
+	}
+	state.height = UReadWord(segment + 1);
+	state.width = UReadWord(segment + 3);
+	state.componentCount = segment[5];
+	if (state.width == 0 || state.height == 0 || (state.componentCount != 1 && state.componentCount != 3) || length < 6 + 3 * state.componentCount) {
+		return false;
+	}
+
+	state.hMax = 1;
+	state.vMax = 1;
+	for (int c = 0; c < state.componentCount; c++) {
+		JpegComponent& component = state.components[c];
+		component.id = segment[6 + 3 * c];
+		component.h = segment[7 + 3 * c] >> 4;
+		component.v = segment[7 + 3 * c] & 15;
+		component.quant = segment[8 + 3 * c];
+		if (component.h < 1 || component.h > 4 || component.v < 1 || component.v > 4 || component.quant > 3) {
+			return false;
+		}
+		state.hMax = max(state.hMax, component.h);
+		state.vMax = max(state.vMax, component.v);
+	}
+	state.mcusX = (state.width + 8 * state.hMax - 1) / (8 * state.hMax);
+	state.mcusY = (state.height + 8 * state.vMax - 1) / (8 * state.vMax);
+	state.frameSeen = true;
+	if (!allocate) {
+		return true;
+	}
+
+	for (int c = 0; c < state.componentCount; c++) {
+		JpegComponent& component = state.components[c];
+		component.blocksW = state.mcusX * component.h;
+		component.blocksH = state.mcusY * component.v;
+		component.stride = component.blocksW * state.blockSize;
+		component.plane.assign((size_t)component.stride * component.blocksH * state.blockSize, 0);
+	}
+	return true;
+
+}
+
+
+static bool UReadQuantization(JpegState& state, const unsigned char* segment, int length) {
+
+	const unsigned char* p = segment;
+	const unsigned char* end = segment + length;
+	while (p < end) {
+		int precision = *p >> 4;
+		int table = *p & 15;
+		int bytes = precision == 0 ? 64 : 128;
+		if (table > 3 || p + 1 + bytes > end) {
+			return false;
+		}
+		for (int k = 0; k < 64; k++) {
+			state.quant[table][zigzag[k]] = (unsigned short)(precision == 0 ? p[1 + k] : UReadWord(p + 1 + 2 * k));
+		}
+		state.quantPresent[table] = true;
+		UBuildMultipliers(state, table);
+		p += 1 + bytes;
+	}
+	return true;
+
+}
+
+
+static bool UReadHuffman(JpegState& state, const unsigned char* segment, int length) {
+
+	const unsigned char* p = segment;
+	const unsigned char* end = segment + length;
+	while (p + 17 <= end) {
+		int tableClass = *p >> 4;
+		int table = *p & 15;
+		int valueCount = 0;
+		for (int i = 0; i < 16; i++) {
+			valueCount += p[1 + i];
+		}
+		if (tableClass > 1 || table > 3 || valueCount > 256 || p + 17 + valueCount > end) {
+			return false;
+		}
+		HuffmanTable& target = tableClass == 0 ? state.dc[table] : state.ac[table];
+		if (!UBuildHuffman(target, p + 1, p + 17, valueCount)) {
+			return false;
+		}
+		p += 17 + valueCount;
+	}
+	return true;
+
+}
+
+
+// Walks the markers, decoding scans when decode is set, otherwise stopping at the frame header
+static bool UReadJpeg(JpegState& state, bool decode) {
+
+	if (state.end - state.data < 4 || state.data[0] != 0xFF || state.data[1] != 0xD8) {
+		return false;
+	}
+	state.data += 2;
+
+	bool scanned = false;
+	for (;;) {
+		// Markers may be preceded by any number of fill bytes
+		while (state.data < state.end && *state.data != 0xFF) {
+			state.data++;
+		}
+		while (state.data < state.end && *state.data == 0xFF) {
+			state.data++;
+		}
+		if (state.data >= state.end) {
+			return scanned;
+		}
+		int marker = *state.data++;
+		if (marker == 0xD9) {
+			return scanned; // end of image
+		}
+		if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+			continue; // no length
+		}
+		if (state.end - state.data < 2) {
+			return false;
+		}
+		int length = UReadWord(state.data) - 2;
+		const unsigned char* segment = state.data + 2;
+		if (length < 0 || segment + length > state.end) {
+			return false;
+		}
+		state.data = segment + length;
+
+		switch (marker) {
+		case 0xC0:
+		case 0xC1:
+			if (state.frameSeen || !UReadFrame(state, segment, length, decode)) {
+				return false;
+			}
+			if (!decode) {
+				return true;
+			}
+			break;
+		case 0xC2: case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+		case 0xC9: case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+			return false; // progressive, lossless, hierarchical or arithmetic coding
+		case 0xC4:
+			if (!UReadHuffman(state, segment, length)) {
+				return false;
+			}
+			break;
+		case 0xDB:
+			if (!UReadQuantization(state, segment, length)) {
+				return false;
+			}
+			break;
+		case 0xDD:
+			if (length < 2) {
+				return false;
+			}
+			state.restartInterval = UReadWord(segment);
+			break;
+		case 0xEE:
+			// Adobe: transform 0 means the components were stored as RGB
+			if (length >= 12 && memcmp(segment, "Adobe", 5) == 0) {
+				state.adobeRgb = segment[11] == 0;
+			}
+			break;
+		case 0xDA:
+			if (!decode || !state.frameSeen) {
+				return false;
+			}
+			for (int c = 0; c < state.componentCount; c++) {
+				if (!state.quantPresent[state.components[c].quant]) {
+					return false;
+				}
+			}
+			if (!UDecodeScan(state, segment, length)) {
+				return false;
+			}
+			scanned = true;
+			break;
+		default:
+			break; // application data and comments
+		}
+	}
+
+}
+
+
+// Samples of one component for output row y at the output width. A component subsampled by 2
+// is upsampled with the triangle filter, 3/4 of the nearest sample and 1/4 of the next one out.
+static void UUpsampleRow(const JpegComponent& component, int factorX, int factorY, int y, int width, int height, int* column, unsigned char* row) {
+
+	int samplesW = (width + factorX - 1) / factorX;
+	int samplesH = (height + factorY - 1) / factorY;
+	int nearY = min(y / factorY, samplesH - 1);
+	const unsigned char* near = &component.plane[(size_t)nearY * component.stride];
+
+	// Vertical pass into column, scaled by 4
+	if (factorY == 2) {
+		int farY = (y & 1) ? min(nearY + 1, samplesH - 1) : max(nearY - 1, 0);
+		const unsigned char* far = &component.plane[(size_t)farY * component.stride];
+		for (int i = 0; i < samplesW; i++) {
+			column[i] = 3 * near[i] + far[i];
+		}
+	}
+	else {
+		for (int i = 0; i < samplesW; i++) {
+			column[i] = 4 * near[i];
+		}
+	}
+
+	// Horizontal pass, dividing the scale back out
+	if (factorX == 1) {
+		for (int x = 0; x < width; x++) {
+			row[x] = (unsigned char)((column[x] + 2) >> 2);
+		}
+	}
+	else if (factorX == 2) {
+		for (int x = 0; x < width; x++) {
+			int i = x >> 1;
+			int j = (x & 1) ? min(i + 1, samplesW - 1) : max(i - 1, 0);
+			row[x] = (unsigned char)((3 * column[i] + column[j] + 8) >> 4);
+		}
+	}
+	else {
+		for (int x = 0; x < width; x++) {
+			row[x] = (unsigned char)((column[x / factorX] + 2) >> 2);
+		}
+	}
+
+}
+
+
+// Converts one row of full-range BT.601 YCbCr to RGBA
+static void UYccToRgba(const unsigned char* y, const unsigned char* cb, const unsigned char* cr, int width, unsigned char* out) {
+
+	int x = 0;
+#ifdef JPEG_SSE2
+	__m128i zero = _mm_setzero_si128();
+	__m128 bias = _mm_set1_ps(128.0f);
+	__m128 low = _mm_setzero_ps();
+	__m128 high = _mm_set1_ps(255.0f);
+	__m128i alpha = _mm_set1_epi32((int)0xFF000000u);
+	for (; x + 4 <= width; x += 4) {
+		int yBytes;
+		int cbBytes;
+		int crBytes;
+		memcpy(&yBytes, y + x, 4);
+		memcpy(&cbBytes, cb + x, 4);
+		memcpy(&crBytes, cr + x, 4);
+		__m128 luma = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(yBytes), zero), zero));
+		__m128 blue = _mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(cbBytes), zero), zero)), bias);
+		__m128 red = _mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(crBytes), zero), zero)), bias);
+
+		__m128 r = _mm_add_ps(luma, _mm_mul_ps(red, _mm_set1_ps(1.402f)));
+		__m128 g = _mm_sub_ps(luma, _mm_add_ps(_mm_mul_ps(blue, _mm_set1_ps(0.344136f)), _mm_mul_ps(red, _mm_set1_ps(0.714136f))));
+		__m128 b = _mm_add_ps(luma, _mm_mul_ps(blue, _mm_set1_ps(1.772f)));
+		__m128i ri = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(r, low), high));
+		__m128i gi = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(g, low), high));
+		__m128i bi = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(b, low), high));
+
+		// Little endian, so red lands in the first byte of each pixel
+		__m128i pixels = _mm_or_si128(_mm_or_si128(ri, _mm_slli_epi32(gi, 8)), _mm_or_si128(_mm_slli_epi32(bi, 16), alpha));
+		_mm_storeu_si128((__m128i*)(out + 4 * x), pixels);
+	}
+#endif
+	for (; x < width; x++) {
+		float luma = y[x];
+		float blue = cb[x] - 128.0f;
+		float red = cr[x] - 128.0f;
+		int r = (int)lrintf(luma + 1.402f * red);
+		int g = (int)lrintf(luma - 0.344136f * blue - 0.714136f * red);
+		int b = (int)lrintf(luma + 1.772f * blue);
+		out[4 * x + 0] = (unsigned char)min(max(r, 0), 255);
+		out[4 * x + 1] = (unsigned char)min(max(g, 0), 255);
+		out[4 * x + 2] = (unsigned char)min(max(b, 0), 255);
+		out[4 * x + 3] = 255;
+	}
+
+}
+
+
+bool UJpegSize(const unsigned char* data, size_t size, int& width, int& height) {
+
+	JpegState* state = new JpegState();
+	state->data = data;
+	state->end = data + size;
+	bool found = UReadJpeg(*state, false) && state->frameSeen;
+	width = state->width;
+	height = state->height;
+	delete state;
+	return found;
+
+}
+
+
+bool UJpegDecode(const unsigned char* data, size_t size, int scaleShift, vector<unsigned char>& rgba, int& width, int& height) {
+
+	// The tables make the state too large for a decode thread's stack
+	JpegState* state = new JpegState();
+	state->data = data;
+	state->end = data + size;
+	int shift = min(max(scaleShift, 0), JPEG_MAX_SCALE_SHIFT);
+	state->blockSize = 8 >> shift;
+	if (!UReadJpeg(*state, true)) {
+		delete state;
+		return false;
+	}
+
+	width = (state->width + (1 << shift) - 1) >> shift;
+	height = (state->height + (1 << shift) - 1) >> shift;
+	rgba.resize((size_t)width * height * 4);
+
+	vector<int> column(width);
+	vector<unsigned char> rows((size_t)width * JPEG_MAX_COMPONENTS);
+	for (int y = 0; y < height; y++) {
+		unsigned char* out = &rgba[(size_t)y * width * 4];
+		for (int c = 0; c < state->componentCount; c++) {
+			const JpegComponent& component = state->components[c];
+			UUpsampleRow(component, state->hMax / component.h, state->vMax / component.v, y, width, height, column.data(), &rows[(size_t)c * width]);
+		}
+
+		if (state->componentCount == 1) {
+			for (int x = 0; x < width; x++) {
+				out[4 * x + 0] = out[4 * x + 1] = out[4 * x + 2] = rows[x];
+				out[4 * x + 3] = 255;
+			}
+		}
+		else if (state->adobeRgb) {
+			for (int x = 0; x < width; x++) {
+				out[4 * x + 0] = rows[x];
+				out[4 * x + 1] = rows[width + x];
+				out[4 * x + 2] = rows[2 * width + x];
+				out[4 * x + 3] = 255;
+			}
+		}
+		else {
+			UYccToRgba(&rows[0], &rows[width], &rows[2 * width], width, out);
+		}
+	}
+	delete state;
+	return true;
+
+}
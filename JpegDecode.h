@@ -0,0 +1,32 @@
+/*
+*	Title:	Final Project / JpegDecode.h
+*	Date:	October 19, 2026
+*
+*	Description: Baseline JPEG decoder for the texture loader. The inverse
+*	DCT and the YCbCr to RGB conversion run four columns or pixels at a time
+*	with SSE2 where it is available, and the output is RGBA so the upload
+*	needs no padding by the driver. Images can be decoded at 1/2, 1/4 or 1/8
+*	size straight from the DCT coefficients: a reduced inverse DCT turns each
+*	8x8 block into 4x4, 2x2 or a single pixel, so a texture that only needs
+*	its small mips never has its full size pixels computed.
+*
+*	Sequential Huffman coded 8-bit images with one or three components are
+*	supported, with any chroma subsampling and restart markers. Progressive
+*	and arithmetic coded files return false so the caller can fall back to
+*	another loader.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Largest scaleShift UJpegDecode takes, decoding at 1/8 size
+#define JPEG_MAX_SCALE_SHIFT 3
+
+// Reads the full size of a JPEG from its frame header without decoding anything
+bool UJpegSize(const unsigned char* data, size_t size, int& width, int& height);
+
+// Decodes to RGBA at 1 / (1 << scaleShift) of full size, sizes rounding up. Returns false for
+// corrupt or unsupported files.
+bool UJpegDecode(const unsigned char* data, size_t size, int scaleShift, std::vector<unsigned char>& rgba, int& width, int& height);
@@ -0,0 +1,231 @@
+/*
+*	Title:	Final Project / Latency.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Frame fences and input-to-present latency samples. GPU
+*	timestamps are moved onto the UElapsedSeconds clock with an offset taken
+*	once at startup, without timer queries a frame is timed when its fence is
+*	first seen signalled, which overstates its latency by up to a frame.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <GL/glew.h>
+
+#include "Latency.h"
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+#define LATENCY_WAIT_NS 100000000ull	// one glClientWaitSync slice, 100 ms
+#define LATENCY_MAX_FRAMES 4			// largest --frames-in-flight
+
+// One swapped frame the GPU may still be working on
+struct FrameFence {
+	GLsync fence;
+	GLuint timestampQuery;			// GL_TIMESTAMP behind the swap, 0 without timer queries
+	vector<double> inputTimes;		// UElapsedSeconds of every event the frame consumed
+};
+
+static LatencyOptions latencyOptions;
+static bool fencing = false;
+static bool gpuTimestamps = false;
+static double gpuClockOffset = 0.0;	// seconds to add to a GPU timestamp for UElapsedSeconds
+
+static deque<FrameFence> framesInFlight;
+static vector<GLuint> freeQueries;
+static vector<double> consumedInput;	// events of the frame being built
+static vector<double> latencyMs;
+static double waitMs = 0.0;
+
+
+bool UParseLatencyOptions(int argc, char* argv[], LatencyOptions& options) {
+
+	options.report = false;
+	options.framesInFlight = 2;
+	options.lowLatency = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--latency") == 0) {
+			options.report = true;
+		}
+		else if (strcmp(argv[i], "--low-latency") == 0) {
+			options.lowLatency = true;
+		}
+		else if (strcmp(argv[i], "--frames-in-flight") == 0) {
+			if (i + 1 >= argc) {
+				std::cerr << argv[i] << " needs a value\n";
+				return false;
+			}
+			options.framesInFlight = min(max(atoi(argv[++i]), 1), LATENCY_MAX_FRAMES);
+		}
+	}
+	if (options.lowLatency) {
+		options.framesInFlight = 1;
+	}
+	return true;
+
+}
+
+
+void ULatencyInit(const LatencyOptions& options) {
+
+	latencyOptions = options;
+	fencing = (GLEW_ARB_sync != 0);
+	gpuTimestamps = fencing && (GLEW_ARB_timer_query != 0);
+	if (!fencing) {
+		std::cerr << "No fence sync, frames in flight are left to the driver and latency is not measured\n";
+		return;
+	}
+
+	if (gpuTimestamps) {
+		// GL_TIMESTAMP reads the GPU clock as soon as the queue drains, pair it with the CPU clock
+		glFinish();
+		GLint64 gpuNow = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+		gpuClockOffset = UElapsedSeconds() - gpuNow / 1.0e9;
+	}
+
+}
+
+
+bool ULatencyLateLatch(void) {
+
+	return latencyOptions.lowLatency;
+
+}
+
+
+void ULatencyConsume(const vector<InputEvent>& events) {
+
+	for (size_t i = 0; i < events.size(); i++) {
+		consumedInput.push_back(events[i].time);
+	}
+
+}
+
+
+// Records the latency of every event the frame consumed, finishedSeconds on the UElapsedSeconds clock
+static void URetireFrame(FrameFence& frame, double finishedSeconds) {
+
+	if (frame.timestampQuery != 0) {
+		GLuint64 gpuTime = 0;
+		glGetQueryObjectui64v(frame.timestampQuery, GL_QUERY_RESULT, &gpuTime); // ready once the fence has signalled
+		finishedSeconds = gpuTime / 1.0e9 + gpuClockOffset;
+		freeQueries.push_back(frame.timestampQuery);
+	}
+	for (size_t i = 0; i < frame.inputTimes.size(); i++) {
+		latencyMs.push_back(max(0.0, (finishedSeconds - frame.inputTimes[i]) * 1000.0));
+	}
+	glDeleteSync(frame.fence);
+
+}
+
+
+// Waits up to timeout for the oldest frame, retiring it if it finished
+static bool UWaitOldest(GLuint64 timeout) {
+
+	FrameFence& oldest = framesInFlight.front();
+	GLenum result = glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+	while (timeout > 0 && result == GL_TIMEOUT_EXPIRED) {
+		result = glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+	}
+	if (result == GL_TIMEOUT_EXPIRED) {
+		return false;
+	}
+
+	// A failed wait still releases the frame, its samples are dropped
+	if (result == GL_WAIT_FAILED) {
+		oldest.inputTimes.clear();
+	}
+	URetireFrame(oldest, UElapsedSeconds());
+	framesInFlight.pop_front();
+	return true;
+
+}
+
+
+void ULatencyFrameSubmitted(void) {
+
+	if (!fencing) {
+		consumedInput.clear();
+		return;
+	}
+
+	FrameFence frame;
+	frame.timestampQuery = 0;
+	if (gpuTimestamps) {
+		if (freeQueries.empty()) {
+			GLuint query = 0;
+			glGenQueries(1, &query);
+			freeQueries.push_back(query);
+		}
+		frame.timestampQuery = freeQueries.back();
+		freeQueries.pop_back();
+		glQueryCounter(frame.timestampQuery, GL_TIMESTAMP);
+	}
+	frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	swap(frame.inputTimes, consumedInput);
+	framesInFlight.push_back(frame);
+
+	// Retire whatever has already finished without waiting
+	while (!framesInFlight.empty() && UWaitOldest(0)) {
+	}
+
+	// Hold the CPU back until the GPU is within the allowed number of frames
+	double waitStart = UElapsedSeconds();
+	while ((int)framesInFlight.size() >= latencyOptions.framesInFlight) {
+		UWaitOldest(LATENCY_WAIT_NS);
+	}
+	waitMs += (UElapsedSeconds() - waitStart) * 1000.0;
+
+}
+
+
+LatencyStats ULatencyStats(void) {
+
+	LatencyStats stats = { (int)latencyMs.size(), 0.0, 0.0, 0.0, 0.0, waitMs };
+	if (latencyMs.empty()) {
+		return stats;
+	}
+
+	vector<double> sorted(latencyMs);
+	sort(sorted.begin(), sorted.end());
+
+	// Nearest-rank percentiles
+	stats.p50Ms = sorted[(size_t)(0.50 * (sorted.size() - 1) + 0.5)];
+	stats.p90Ms = sorted[(size_t)(0.90 * (sorted.size() - 1) + 0.5)];
+	stats.p99Ms = sorted[(size_t)(0.99 * (sorted.size() - 1) + 0.5)];
+	stats.maxMs = sorted.back();
+	return stats;
+
+}
+
+
+void ULatencyShutdown(void) {
+
+	while (!framesInFlight.empty()) {
+		UWaitOldest(LATENCY_WAIT_NS);
+	}
+	if (!freeQueries.empty()) {
+		glDeleteQueries((GLsizei)freeQueries.size(), freeQueries.data());
+		freeQueries.clear();
+	}
+
+	if (latencyOptions.report) {
+		LatencyStats stats = ULatencyStats();
+		ostringstream report;
+		report << fixed << setprecision(2);
+		report << "Input to present (" << stats.samples << " events, at most " << latencyOptions.framesInFlight << " in flight"
+			<< (latencyOptions.lowLatency ? ", late latched" : "") << ")\n";
+		report << "  p50 " << stats.p50Ms << " ms, p90 " << stats.p90Ms << " ms, p99 " << stats.p99Ms << " ms, max " << stats.maxMs << " ms\n";
+		report << "  waited on the GPU " << stats.waitMs << " ms\n";
+		std::cout << report.str();
+	}
+
+}
@@ -0,0 +1,61 @@
+/*
+*	Title:	Final Project / Latency.h
+*	Date:	October 19, 2026
+*
+*	Description: Input-to-present latency. Every input event is stamped when
+*	it is queued, and every frame ends with a fence and a GL_TIMESTAMP query
+*	behind its swap. When the fence signals, the GPU time the frame finished
+*	is mapped onto the input clock and each event the frame consumed gives
+*	one latency sample. The same fences cap how many frames the driver may
+*	queue ahead of the GPU. The end point is the GPU finishing the frame's
+*	commands, swap included, scanout on the display is not visible to GL.
+*
+*	Command line:
+*		--latency					print input-to-present percentiles at exit
+*		--frames-in-flight <count>	frames queued ahead of the GPU, default 2
+*		--low-latency				one frame in flight, and the camera is read
+*									just before the view matrix is built
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "Input.h"
+
+struct LatencyOptions {
+	bool report;
+	int framesInFlight;
+	bool lowLatency;
+};
+
+struct LatencyStats {
+	int samples;			// input events measured to present
+	double p50Ms;
+	double p90Ms;
+	double p99Ms;
+	double maxMs;
+	double waitMs;			// total CPU time spent waiting on frames in flight
+};
+
+// Reads the latency options out of the command line, returns false on a malformed argument
+bool UParseLatencyOptions(int argc, char* argv[], LatencyOptions& options);
+
+// Calibrates the GPU clock against UElapsedSeconds, call once the GL context exists
+void ULatencyInit(const LatencyOptions& options);
+
+// Whether the camera should be read just before the view is built rather than at the top of the frame
+bool ULatencyLateLatch(void);
+
+// Notes the input events the frame being built consumed, before they are coalesced
+void ULatencyConsume(const std::vector<InputEvent>& events);
+
+// Fences the frame just swapped, retires finished frames and waits while too many are in flight.
+// Waiting here, before returning to GLUT, lets events that arrive during the wait reach the next frame.
+void ULatencyFrameSubmitted(void);
+
+LatencyStats ULatencyStats(void);
+
+// Waits for every frame in flight, prints the report when asked for and releases the GL objects.
+// Call while the context is still current, the fences and queries belong to it.
+void ULatencyShutdown(void);
@@ -0,0 +1,371 @@
+/*
+*	Title:	Final Project / MeshGenerator.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Procedural geometry. Boxes are built face by face on a grid that
+*	is denser inside the bevel bands, each grid point is pulled onto the rounded
+*	box and its normal comes from the same projection. Rooms are made by
+*	replicating a table with SIMD transforms, in slices of tables on the task
+*	threads.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GENERATOR_SSE2 1
+#endif
+
+#include "MeshGenerator.h"
+#include "TaskScheduler.h"
+
+using namespace std; // standard namespace
+
+
+TableParams UDefaultTableParams(void) {
+
+	TableParams params;
+	params.legCount = 4;
+	params.width = 1.2f;
+	params.depth = 1.2f;
+	params.height = 1.1f;
+	params.topThickness = 0.1f;
+	params.legWidth = 0.1f;
+	params.legInset = 0.1f;
+	params.bevel = 0.0f;
+	params.subdivision = 1;
+	params.bevelSegments = 2;
+	return params;
+
+}
+
+
+bool UParseGeneratorOptions(int argc, char* argv[], GeneratorOptions& options) {
+
+	options.procedural = false;
+	options.bake = false;
+	options.table = UDefaultTableParams();
+	options.room.rows = 1;
+	options.room.columns = 1;
+	options.room.spacing = 3.0f;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = (i + 1 < argc);
+		if (strcmp(argv[i], "--procedural") == 0) {
+			options.procedural = true;
+		}
+		else if (strcmp(argv[i], "--bake") == 0) {
+			options.bake = true;
+		}
+		else if (strcmp(argv[i], "--legs") == 0 || strcmp(argv[i], "--subdivision") == 0
+			|| strcmp(argv[i], "--bevel") == 0 || strcmp(argv[i], "--room") == 0) {
+			if (!hasValue) {
+				std::cerr << argv[i] << " needs a value\n";
+				return false;
+			}
+			const char* value = argv[++i];
+			if (strcmp(argv[i - 1], "--legs") == 0) {
+				options.table.legCount = max(1, atoi(value));
+			}
+			else if (strcmp(argv[i - 1], "--subdivision") == 0) {
+				options.table.subdivision = max(1, atoi(value));
+			}
+			else if (strcmp(argv[i - 1], "--bevel") == 0) {
+				options.table.bevel = max(0.0f, (float)atof(value));
+			}
+			else if (sscanf(value, "%dx%d", &options.room.rows, &options.room.columns) != 2
+				|| options.room.rows < 1 || options.room.columns < 1) {
+				std::cerr << "--room expects <rows>x<columns>, got " << value << "\n";
+				return false;
+			}
+		}
+	}
+	return true;
+
+}
+
+
+// Coordinates along one box axis from -half to half: bevel bands at both ends, subdivision steps between
+static void UAxisSteps(float half, float bevel, int subdivision, int bevelSegments, vector<float>& steps) {
+
+	steps.clear();
+	float inner = half - bevel;
+	int bands = (bevel > 0.0f) ? bevelSegments : 0;
+
+	for (int i = 0; i < bands; i++) {
+		steps.push_back(-half + bevel * i / bands);
+	}
+	for (int i = 0; i <= subdivision; i++) {
+		steps.push_back(-inner + 2.0f * inner * i / subdivision);
+	}
+	for (int i = 1; i <= bands; i++) {
+		steps.push_back(inner + bevel * i / bands);
+	}
+
+}
+
+
+void UGenerateBox(const glm::vec3& center, const glm::vec3& size, float bevel, int subdivision, int bevelSegments, Mesh& mesh) {
+
+	glm::vec3 half = size * 0.5f;
+	bevel = min(bevel, min(half.x, min(half.y, half.z)));
+	glm::vec3 inner = half - glm::vec3(bevel);
+	subdivision = max(1, subdivision);
+	bevelSegments = max(1, bevelSegments);
+
+	vector<float> steps[3];
+	for (int axis = 0; axis < 3; axis++) {
+		UAxisSteps(half[axis], bevel, subdivision, bevelSegments, steps[axis]);
+	}
+
+	// Six faces: the axis they face along and which way
+	for (int face = 0; face < 6; face++) {
+		int a = face / 2;
+		float sign = (face % 2 == 0) ? 1.0f : -1.0f;
+
+		// u x v points out of the face, so the grid winds counter-clockwise seen from outside
+		int u = (a + 1) % 3;
+		int v = (a + 2) % 3;
+		if (sign < 0.0f) {
+			swap(u, v);
+		}
+
+		const vector<float>& us = steps[u];
+		const vector<float>& vs = steps[v];
+		unsigned int base = (unsigned int)UMeshVertexCount(mesh);
+
+		for (size_t j = 0; j < vs.size(); j++) {
+			for (size_t i = 0; i < us.size(); i++) {
+				glm::vec3 p;
+				p[a] = sign * half[a];
+				p[u] = us[i];
+				p[v] = vs[j];
+
+				// Pull the point onto the rounded box, the offset from the inner box is the normal
+				glm::vec3 core = glm::clamp(p, -inner, inner);
+				glm::vec3 offset = p - core;
+				float length = glm::length(offset);
+				glm::vec3 normal(0.0f);
+				normal[a] = sign;
+				if (bevel > 0.0f && length > 0.0f) {
+					normal = offset / length;
+					p = core + normal * bevel;
+				}
+				p += center;
+
+				float vertex[VERTEX_FLOATS] = {
+					p.x, p.y, p.z,
+					normal.x, normal.y, normal.z,
+					(float)i / (us.size() - 1), (float)j / (vs.size() - 1)
+				};
+				mesh.vertices.insert(mesh.vertices.end(), vertex, vertex + VERTEX_FLOATS);
+			}
+		}
+
+		unsigned int row = (unsigned int)us.size();
+		for (unsigned int j = 0; j + 1 < vs.size(); j++) {
+			for (unsigned int i = 0; i + 1 < row; i++) {
+				unsigned int i00 = base + j * row + i;
+				unsigned int i10 = i00 + 1;
+				unsigned int i01 = i00 + row;
+				unsigned int i11 = i01 + 1;
+				unsigned int quad[] = { i00, i10, i11,		i11, i01, i00 };
+				mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+			}
+		}
+	}
+
+}
+
+
+void UGeneratePyramid(const glm::vec3& baseCenter, float baseSize, float height, Mesh& mesh) {
+
+	float h = baseSize * 0.5f;
+	glm::vec3 apex = baseCenter + glm::vec3(0.0f, height, 0.0f);
+	glm::vec3 corners[4] = {
+		baseCenter + glm::vec3(-h, 0.0f,  h),
+		baseCenter + glm::vec3( h, 0.0f,  h),
+		baseCenter + glm::vec3( h, 0.0f, -h),
+		baseCenter + glm::vec3(-h, 0.0f, -h)
+	};
+
+	// Four flat-shaded sides
+	for (int side = 0; side < 4; side++) {
+		glm::vec3 a = corners[side];
+		glm::vec3 b = corners[(side + 1) % 4];
+		glm::vec3 normal = glm::normalize(glm::cross(b - a, apex - a));
+		unsigned int base = (unsigned int)UMeshVertexCount(mesh);
+		float vertices[] = {
+			a.x, a.y, a.z,				normal.x, normal.y, normal.z,		0.0f, 0.0f,
+			b.x, b.y, b.z,				normal.x, normal.y, normal.z,		1.0f, 0.0f,
+			apex.x, apex.y, apex.z,		normal.x, normal.y, normal.z,		0.5f, 1.0f
+		};
+		mesh.vertices.insert(mesh.vertices.end(), vertices, vertices + 3 * VERTEX_FLOATS);
+		unsigned int triangle[] = { base, base + 1, base + 2 };
+		mesh.indices.insert(mesh.indices.end(), triangle, triangle + 3);
+	}
+
+	// Base, facing down
+	unsigned int base = (unsigned int)UMeshVertexCount(mesh);
+	float uvs[4][2] = { { 0.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, 0.0f }, { 0.0f, 0.0f } };
+	for (int c = 0; c < 4; c++) {
+		float vertex[VERTEX_FLOATS] = { corners[c].x, corners[c].y, corners[c].z, 0.0f, -1.0f, 0.0f, uvs[c][0], uvs[c][1] };
+		mesh.vertices.insert(mesh.vertices.end(), vertex, vertex + VERTEX_FLOATS);
+	}
+	unsigned int quad[] = { base, base + 3, base + 2,		base + 2, base + 1, base };
+	mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+
+}
+
+
+void UGenerateTable(const TableParams& params, Mesh& legs, Mesh& top) {
+
+	legs.vertices.clear();
+	legs.indices.clear();
+	top.vertices.clear();
+	top.indices.clear();
+
+	// The hand-built table stands from y = -0.5 to its top surface, keep that origin
+	float floorY = -0.5f;
+	float topY = floorY + params.height;
+	float legHeight = params.height - params.topThickness;
+
+	UGenerateBox(glm::vec3(0.0f, topY - params.topThickness * 0.5f, 0.0f),
+		glm::vec3(params.width, params.topThickness, params.depth),
+		params.bevel, params.subdivision, params.bevelSegments, top);
+
+	// Legs go round the inset rectangle, four legs land on its corners
+	float reachX = params.width * 0.5f - params.legInset - params.legWidth * 0.5f;
+	float reachZ = params.depth * 0.5f - params.legInset - params.legWidth * 0.5f;
+	for (int i = 0; i < params.legCount; i++) {
+		glm::vec3 center(0.0f, floorY + legHeight * 0.5f, 0.0f);
+		if (params.legCount > 1) {
+			float angle = 2.0f * 3.14159265f * (i + 0.5f) / params.legCount + 3.14159265f * 0.25f * (params.legCount != 4);
+			float dx = cos(angle);
+			float dz = sin(angle);
+			float reach = max(fabs(dx), fabs(dz));
+			center.x = reachX * dx / reach;
+			center.z = reachZ * dz / reach;
+		}
+		UGenerateBox(center, glm::vec3(params.legWidth, legHeight, params.legWidth),
+			min(params.bevel, params.legWidth * 0.25f), params.subdivision, params.bevelSegments, legs);
+	}
+
+}
+
+
+vector<glm::mat4> URoomTransforms(const RoomParams& room) {
+
+	vector<glm::mat4> transforms;
+	transforms.reserve((size_t)room.rows * room.columns);
+	for (int r = 0; r < room.rows; r++) {
+		for (int c = 0; c < room.columns; c++) {
+			glm::vec3 offset((c - (room.columns - 1) * 0.5f) * room.spacing, 0.0f, (r - (room.rows - 1) * 0.5f) * room.spacing);
+			glm::mat4 transform(1.0f);
+			transform[3] = glm::vec4(offset, 1.0f);
+			transforms.push_back(transform);
+		}
+	}
+	return transforms;
+
+}
+
+
+// Transforms one copy of source into out, rebasing its indices by baseVertex
+static void UTransformCopy(const Mesh& source, const glm::mat4& transform, unsigned int baseVertex, float* outVertices, unsigned int* outIndices) {
+
+	size_t vertexCount = UMeshVertexCount(source);
+	const float* in = source.vertices.data();
+	glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+
+#ifdef GENERATOR_SSE2
+	__m128 c0 = _mm_loadu_ps(&transform[0][0]);
+	__m128 c1 = _mm_loadu_ps(&transform[1][0]);
+	__m128 c2 = _mm_loadu_ps(&transform[2][0]);
+	__m128 c3 = _mm_loadu_ps(&transform[3][0]);
+	__m128 n0 = _mm_setr_ps(normalMatrix[0][0], normalMatrix[0][1], normalMatrix[0][2], 0.0f);
+	__m128 n1 = _mm_setr_ps(normalMatrix[1][0], normalMatrix[1][1], normalMatrix[1][2], 0.0f);
+	__m128 n2 = _mm_setr_ps(normalMatrix[2][0], normalMatrix[2][1], normalMatrix[2][2], 0.0f);
+
+	for (size_t v = 0; v < vertexCount; v++, in += VERTEX_FLOATS, outVertices += VERTEX_FLOATS) {
+		__m128 p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(in[0])), _mm_mul_ps(c1, _mm_set1_ps(in[1]))),
+			_mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(in[2])), c3));
+		__m128 n = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n0, _mm_set1_ps(in[3])), _mm_mul_ps(n1, _mm_set1_ps(in[4]))),
+			_mm_mul_ps(n2, _mm_set1_ps(in[5])));
+
+		// Lay the result out as two 4-wide stores: x y z nx | ny nz u v
+		__m128 uv = _mm_castpd_ps(_mm_load_sd((const double*)(in + 6)));
+		__m128 zx = _mm_shuffle_ps(p, n, _MM_SHUFFLE(0, 0, 2, 2));
+		_mm_storeu_ps(outVertices, _mm_shuffle_ps(p, zx, _MM_SHUFFLE(2, 0, 1, 0)));
+		_mm_storeu_ps(outVertices + 4, _mm_shuffle_ps(n, uv, _MM_SHUFFLE(1, 0, 2, 1)));
+	}
+
+	size_t indexCount = source.indices.size();
+	const unsigned int* indices = source.indices.data();
+	__m128i offset = _mm_set1_epi32((int)baseVertex);
+	size_t i = 0;
+	for (; i + 4 <= indexCount; i += 4) {
+		__m128i block = _mm_loadu_si128((const __m128i*)(indices + i));
+		_mm_storeu_si128((__m128i*)(outIndices + i), _mm_add_epi32(block, offset));
+	}
+	for (; i < indexCount; i++) {
+		outIndices[i] = indices[i] + baseVertex;
+	}
+#else
+	for (size_t v = 0; v < vertexCount; v++, in += VERTEX_FLOATS, outVertices += VERTEX_FLOATS) {
+		glm::vec4 p = transform * glm::vec4(in[0], in[1], in[2], 1.0f);
+		glm::vec3 n = normalMatrix * glm::vec3(in[3], in[4], in[5]);
+		outVertices[0] = p.x;
+		outVertices[1] = p.y;
+		outVertices[2] = p.z;
+		outVertices[3] = n.x;
+		outVertices[4] = n.y;
+		outVertices[5] = n.z;
+		outVertices[6] = in[6];
+		outVertices[7] = in[7];
+	}
+	for (size_t i = 0; i < source.indices.size(); i++) {
+		outIndices[i] = source.indices[i] + baseVertex;
+	}
+#endif
+
+}
+
+
+void UReplicateMesh(const Mesh& source, const vector<glm::mat4>& transforms, Mesh& destination) {
+
+	size_t copies = transforms.size();
+	size_t vertexFloats = source.vertices.size();
+	size_t vertexCount = UMeshVertexCount(source);
+	size_t indexCount = source.indices.size();
+
+	// Every copy's slot is known up front, so slices write without sharing anything
+	destination.vertices.resize(copies * vertexFloats);
+	destination.indices.resize(copies * indexCount);
+
+	UTaskParallelFor(copies, 1, [&](size_t first, size_t last) {
+		for (size_t c = first; c < last; c++) {
+			UTransformCopy(source, transforms[c], (unsigned int)(c * vertexCount),
+				destination.vertices.data() + c * vertexFloats, destination.indices.data() + c * indexCount);
+		}
+	});
+
+}
+
+
+void UGenerateRoom(const RoomParams& room, const TableParams& table, Mesh& legs, Mesh& top) {
+
+	Mesh legTemplate;
+	Mesh topTemplate;
+	UGenerateTable(table, legTemplate, topTemplate);
+
+	vector<glm::mat4> transforms = URoomTransforms(room);
+	UReplicateMesh(legTemplate, transforms, legs);
+	UReplicateMesh(topTemplate, transforms, top);
+
+}
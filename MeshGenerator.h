@@ -0,0 +1,74 @@
+/*
+*	Title:	Final Project / MeshGenerator.h
+*	Date:	October 19, 2026
+*
+*	Description: Procedural tables, pyramids and rooms of tables, written in the
+*	same interleaved layout as the hand-built geometry (see Geometry.h) so the
+*	results drop straight into legVAO and topVAO.
+*
+*	Command line:
+*		--procedural				generate the table instead of using the hand-built one
+*		--legs <count>				legs per generated table, default 4
+*		--subdivision <steps>		quads per box face edge, default 1
+*		--bevel <size>				bevel radius on box edges, default 0
+*		--room <rows>x<columns>		draw a grid of tables
+*		--bake						bake the room into one mesh instead of instancing it
+*/
+
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Geometry.h"
+
+// Shape of one generated table, defaults match the hand-built table
+struct TableParams {
+	int legCount;
+	float width;			// table top size on X
+	float depth;			// table top size on Z
+	float height;			// floor to top surface
+	float topThickness;
+	float legWidth;
+	float legInset;			// gap between a leg's outer edge and the top's edge
+	float bevel;			// rounding radius on every box edge, 0 for hard edges
+	int subdivision;		// quads across the flat part of each face edge
+	int bevelSegments;		// quads across each bevel
+};
+
+// Grid of tables
+struct RoomParams {
+	int rows;
+	int columns;
+	float spacing;			// distance between table centers
+};
+
+struct GeneratorOptions {
+	bool procedural;
+	bool bake;
+	TableParams table;
+	RoomParams room;
+};
+
+TableParams UDefaultTableParams(void);
+
+// Reads the generator options out of the command line, returns false on a malformed argument
+bool UParseGeneratorOptions(int argc, char* argv[], GeneratorOptions& options);
+
+// Appends an axis-aligned, optionally bevelled box
+void UGenerateBox(const glm::vec3& center, const glm::vec3& size, float bevel, int subdivision, int bevelSegments, Mesh& mesh);
+
+// Appends a square pyramid standing on the XZ plane, like the one in Transformation.cpp
+void UGeneratePyramid(const glm::vec3& baseCenter, float baseSize, float height, Mesh& mesh);
+
+// Generates one table, legs and top kept apart so each keeps its own material
+void UGenerateTable(const TableParams& params, Mesh& legs, Mesh& top);
+
+// Table transforms for a room, centered on the origin
+std::vector<glm::mat4> URoomTransforms(const RoomParams& room);
+
+// Writes one transformed copy of source per transform into destination, sliced over the task threads
+void UReplicateMesh(const Mesh& source, const std::vector<glm::mat4>& transforms, Mesh& destination);
+
+// Generates a table and bakes a whole room of it into two meshes
+void UGenerateRoom(const RoomParams& room, const TableParams& table, Mesh& legs, Mesh& top);
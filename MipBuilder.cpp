@@ -0,0 +1,220 @@
+/*
+*	Title:	Final Project / MipBuilder.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Mip chain builder. A band of 2^D rows at level 0 covers
+*	exactly 2^(D - l) rows of level l when the sizes stay even down to level
+*	D, so a task halves its band D times, decoding to linear float on the
+*	first halving, writes every level out as it goes and leaves its level D
+*	rows in float for the serial tail. Halving works on whole RGBA texels, one SSE register
+*	each. sRGB goes to linear through a 256 entry table and back through a
+*	table indexed by 16-bit linear values, which lands within one code
+*	value of encoding the filtered value in double precision.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIP_SSE2 1
+#endif
+
+#include "MipBuilder.h"
+#include "TaskScheduler.h"
+
+using namespace std; // standard namespace
+
+#define MIP_BAND_LEVELS 5		// levels a band is carried down, 32 rows at level 0
+#define MIP_LINEAR_STEPS 65535	// linear values the encode table tells apart
+
+// Transfer function tables, built once by whichever thread gets here first
+struct SrgbTables {
+
+	float toLinear[256];
+	unsigned char toSrgb[MIP_LINEAR_STEPS + 1];
+
+	SrgbTables(void) {
+		for (int i = 0; i < 256; i++) {
+			double c = i / 255.0;
+			toLinear[i] = (float)(c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4));
+		}
+		for (int i = 0; i <= MIP_LINEAR_STEPS; i++) {
+			double l = (double)i / MIP_LINEAR_STEPS;
+			double c = l <= 0.0031308 ? l * 12.92 : 1.055 * pow(l, 1.0 / 2.4) - 0.055;
+			toSrgb[i] = (unsigned char)min(max((int)floor(c * 255.0 + 0.5), 0), 255);
+		}
+	}
+
+};
+
+
+static const SrgbTables& USrgbTables(void) {
+
+	static const SrgbTables tables;
+	return tables;
+
+}
+
+
+// Halves a rows x width block of RGBA8 sRGB texels into linear float, the first level of every band.
+// Decoding on the fly keeps the full size level out of float entirely.
+static void UHalveTexels(const unsigned char* in, int width, int rows, float* out) {
+
+	const float* toLinear = USrgbTables().toLinear;
+	int outWidth = max(1, width / 2);
+	int outRows = max(1, rows / 2);
+	for (int y = 0; y < outRows; y++) {
+		const unsigned char* row0 = in + (size_t)min(2 * y, rows - 1) * width * 4;
+		const unsigned char* row1 = in + (size_t)min(2 * y + 1, rows - 1) * width * 4;
+		float* dst = out + (size_t)y * outWidth * 4;
+		for (int x = 0; x < outWidth; x++) {
+			int x0 = min(2 * x, width - 1) * 4;
+			int x1 = min(2 * x + 1, width - 1) * 4;
+			for (int c = 0; c < 3; c++) {
+				dst[c] = (toLinear[row0[x0 + c]] + toLinear[row0[x1 + c]] + toLinear[row1[x0 + c]] + toLinear[row1[x1 + c]]) * 0.25f;
+			}
+			dst[3] = (row0[x0 + 3] + row0[x1 + 3] + row1[x0 + 3] + row1[x1 + 3]) * (0.25f / 255.0f);
+			dst += 4;
+		}
+	}
+
+}
+
+
+// Linear float texels back to RGBA8 sRGB
+static void UEncodeTexels(const float* in, size_t count, unsigned char* out) {
+
+	const unsigned char* toSrgb = USrgbTables().toSrgb;
+#ifdef MIP_SSE2
+	const __m128 scale = _mm_setr_ps((float)MIP_LINEAR_STEPS, (float)MIP_LINEAR_STEPS, (float)MIP_LINEAR_STEPS, 255.0f);
+	const __m128 zero = _mm_setzero_ps();
+	for (size_t i = 0; i < count; i++) {
+		__m128 v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in), scale), zero), scale);
+		int index[4];
+		_mm_storeu_si128((__m128i*)index, _mm_cvtps_epi32(v));
+		out[0] = toSrgb[index[0]];
+		out[1] = toSrgb[index[1]];
+		out[2] = toSrgb[index[2]];
+		out[3] = (unsigned char)index[3];
+		in += 4;
+		out += 4;
+	}
+#else
+	for (size_t i = 0; i < count; i++) {
+		for (int c = 0; c < 3; c++) {
+			out[c] = toSrgb[(int)(min(max(in[c], 0.0f), 1.0f) * MIP_LINEAR_STEPS + 0.5f)];
+		}
+		out[3] = (unsigned char)(min(max(in[3], 0.0f), 1.0f) * 255.0f + 0.5f);
+		in += 4;
+		out += 4;
+	}
+#endif
+
+}
+
+
+// Halves a rows x width block of linear texels with a 2x2 box, odd edges repeat their last texel.
+// rows is the block's own height, which only differs from the image's at the bottom of the chain.
+static void UHalve(const float* in, int width, int rows, float* out) {
+
+	int outWidth = max(1, width / 2);
+	int outRows = max(1, rows / 2);
+	for (int y = 0; y < outRows; y++) {
+		const float* row0 = in + (size_t)min(2 * y, rows - 1) * width * 4;
+		const float* row1 = in + (size_t)min(2 * y + 1, rows - 1) * width * 4;
+		float* dst = out + (size_t)y * outWidth * 4;
+		for (int x = 0; x < outWidth; x++) {
+			int x0 = min(2 * x, width - 1) * 4;
+			int x1 = min(2 * x + 1, width - 1) * 4;
+#ifdef MIP_SSE2
+			__m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1)),
+				_mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1)));
+			_mm_storeu_ps(dst + x * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+			for (int c = 0; c < 4; c++) {
+				dst[x * 4 + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) * 0.25f;
+			}
+#endif
+		}
+	}
+
+}
+
+
+void UBuildMips(const unsigned char* level, int width, int height, int layers, int count, vector<vector<unsigned char> >& mips) {
+
+	mips.assign(max(count - 1, 0), vector<unsigned char>());
+	if (count < 2) {
+		return;
+	}
+	vector<int> widths(count);
+	vector<int> heights(count);
+	for (int l = 0; l < count; l++) {
+		widths[l] = max(1, width >> l);
+		heights[l] = max(1, height >> l);
+		if (l > 0) {
+			mips[l - 1].resize((size_t)widths[l] * heights[l] * layers * 4);
+		}
+	}
+
+	// Bands go down while both sizes stay even, past that a band's rows would straddle its neighbour's.
+	// An odd level 0 has no bands, the tail then starts with the whole of level 1.
+	int bandLevels = 0;
+	while (bandLevels < count - 1 && bandLevels < MIP_BAND_LEVELS && widths[bandLevels] % 2 == 0 && heights[bandLevels] % 2 == 0) {
+		bandLevels++;
+	}
+	int tailLevel = max(bandLevels, 1);
+	size_t layerTexels = (size_t)width * height;
+	size_t tailTexels = (size_t)widths[tailLevel] * heights[tailLevel];
+	vector<float> tail(tailTexels * layers * 4);
+
+	if (bandLevels == 0) {
+		for (int layer = 0; layer < layers; layer++) {
+			UHalveTexels(level + layer * layerTexels * 4, width, height, &tail[layer * tailTexels * 4]);
+		}
+		UEncodeTexels(tail.data(), tailTexels * layers, mips[0].data());
+	}
+	else {
+		int bandRows = 1 << bandLevels;
+		int bandsPerLayer = height / bandRows;
+		UTaskParallelFor((size_t)layers * bandsPerLayer, 1, [&](size_t first, size_t last) {
+			vector<float> current((size_t)bandRows * width); // level 1 of the band, the largest in float
+			vector<float> next(current.size());
+			for (size_t task = first; task < last; task++) {
+				int layer = (int)(task / bandsPerLayer);
+				int bandIndex = (int)(task % bandsPerLayer);
+				int rows = bandRows;
+				for (int l = 1; l <= bandLevels; l++) {
+
+					// The last level of the band lands straight in its rows of the tail
+					float* out = l == bandLevels ? &tail[(layer * tailTexels + (size_t)bandIndex * (rows / 2) * widths[l]) * 4] : next.data();
+					if (l == 1) {
+						UHalveTexels(level + (layer * layerTexels + (size_t)bandIndex * bandRows * width) * 4, width, rows, out);
+					}
+					else {
+						UHalve(current.data(), widths[l - 1], rows, out);
+					}
+					rows /= 2;
+					size_t levelTexels = (size_t)widths[l] * heights[l];
+					UEncodeTexels(out, (size_t)rows * widths[l], &mips[l - 1][(layer * levelTexels + (size_t)bandIndex * rows * widths[l]) * 4]);
+					swap(current, next);
+				}
+			}
+		});
+	}
+
+	// The coarse levels under the bands are a few thousand texels at most
+	vector<float> next;
+	for (int l = tailLevel + 1; l < count; l++) {
+		size_t inTexels = (size_t)widths[l - 1] * heights[l - 1];
+		size_t outTexels = (size_t)widths[l] * heights[l];
+		next.resize(outTexels * layers * 4);
+		for (int layer = 0; layer < layers; layer++) {
+			UHalve(&tail[layer * inTexels * 4], widths[l - 1], heights[l - 1], &next[layer * outTexels * 4]);
+		}
+		UEncodeTexels(next.data(), outTexels * layers, mips[l - 1].data());
+		swap(tail, next);
+	}
+
+}
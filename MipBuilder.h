@@ -0,0 +1,23 @@
+/*
+*	Title:	Final Project / MipBuilder.h
+*	Date:	October 19, 2026
+*
+*	Description: CPU mip chain builder for RGBA8 texture arrays holding sRGB
+*	colour. Texels are averaged in linear light, 2x2 box filtered, and
+*	encoded back to sRGB, so the small mips keep the brightness of the full
+*	size image instead of darkening the way filtering the gamma encoded
+*	bytes does. Alpha is filtered as it is.
+*
+*	Each layer is cut into bands of rows that are carried down several
+*	levels at once in float, bands sliced over the task threads, so the work
+*	spreads over every core without a barrier between levels. The few coarse levels left
+*	below the bands are finished on the calling thread.
+*/
+
+#pragma once
+
+#include <vector>
+
+// Builds levels 1 to count - 1 under level 0 of an RGBA8 array, every layer back to back in each.
+// mips[i] receives level i + 1, sized max(1, width >> (i + 1)) by max(1, height >> (i + 1)).
+void UBuildMips(const unsigned char* level, int width, int height, int layers, int count, std::vector<std::vector<unsigned char> >& mips);
@@ -0,0 +1,1129 @@
+/*
+*	Title:	Final Project / ModelImport.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Model importers. OBJ runs in two parallel passes over the
+*	mapped text: the first counts each chunk's v / vt / vn records and lines,
+*	so the second knows every chunk's global offsets, resolves relative
+*	indices on the spot and writes attributes straight into shared arrays.
+*	Deduplication then walks the triangles once. glTF parses its JSON on one
+*	thread and converts each primitive's vertices in parallel slices.
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ModelImport.h"
+#include "TaskScheduler.h"
+
+using namespace std; // standard namespace
+
+#define IMPORT_CHUNKS_PER_THREAD 4	// OBJ chunks per core, evens out uneven lines
+#define IMPORT_MIN_CHUNK (1 << 16)	// bytes, smaller files are not split further
+#define IMPORT_MIN_SLICE 4096		// glTF vertices per slice
+
+
+bool UParseImportOptions(int argc, char* argv[], ImportOptions& options) {
+
+	options.modelPath.clear();
+	options.topModelPath.clear();
+
+	const char* flags[] = { "--model", "--model-top" };
+	const int flagCount = sizeof(flags) / sizeof(flags[0]);
+
+	for (int i = 1; i < argc; i++) {
+		int flag = 0;
+		while (flag < flagCount && strcmp(argv[i], flags[flag]) != 0) {
+			flag++;
+		}
+		if (flag == flagCount) {
+			continue; // not ours
+		}
+		if (i + 1 >= argc) {
+			std::cerr << argv[i] << " needs a value\n";
+			return false;
+		}
+
+		const char* value = argv[++i];
+		switch (flag) {
+		case 0: options.modelPath = value; break;
+		case 1: options.topModelPath = value; break;
+		}
+	}
+	return true;
+
+}
+
+
+// Read-only view of a whole file
+struct MappedFile {
+	const char* data;
+	size_t size;
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+#endif
+};
+
+
+static bool UMapFile(const string& path, MappedFile& mapped) {
+
+	mapped.data = NULL;
+	mapped.size = 0;
+#ifdef _WIN32
+	mapped.mapping = NULL;
+	mapped.file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (mapped.file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER size;
+	GetFileSizeEx(mapped.file, &size);
+	mapped.size = (size_t)size.QuadPart;
+	if (mapped.size == 0) {
+		return true;
+	}
+	mapped.mapping = CreateFileMappingA(mapped.file, NULL, PAGE_READONLY, 0, 0, NULL);
+	mapped.data = mapped.mapping ? (const char*)MapViewOfFile(mapped.mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+	return mapped.data != NULL;
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) {
+		return false;
+	}
+	struct stat info;
+	if (fstat(file, &info) != 0) {
+		close(file);
+		return false;
+	}
+	mapped.size = (size_t)info.st_size;
+	if (mapped.size > 0) {
+		void* view = mmap(NULL, mapped.size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (view != MAP_FAILED) {
+			madvise(view, mapped.size, MADV_SEQUENTIAL);
+			mapped.data = (const char*)view;
+		}
+	}
+	close(file); // the mapping keeps the file alive
+	return mapped.size == 0 || mapped.data != NULL;
+#endif
+
+}
+
+
+static void UUnmapFile(MappedFile& mapped) {
+
+#ifdef _WIN32
+	if (mapped.data) {
+		UnmapViewOfFile(mapped.data);
+	}
+	if (mapped.mapping) {
+		CloseHandle(mapped.mapping);
+	}
+	if (mapped.file != INVALID_HANDLE_VALUE) {
+		CloseHandle(mapped.file);
+	}
+#else
+	if (mapped.data) {
+		munmap((void*)mapped.data, mapped.size);
+	}
+#endif
+	mapped.data = NULL;
+	mapped.size = 0;
+
+}
+
+
+static inline const char* USkipSpaces(const char* p, const char* end) {
+
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+		p++;
+	}
+	return p;
+
+}
+
+
+static inline const char* UNextLine(const char* p, const char* end) {
+
+	const char* newline = (const char*)memchr(p, '\n', end - p);
+	return newline ? newline + 1 : end;
+
+}
+
+
+// Decimal float without locale or allocation, mantissa digits past the 19th only move the exponent.
+// Returns the character after the number, or p when there is none.
+static const char* UParseFloat(const char* p, const char* end, float& value) {
+
+	static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	const char* start = p;
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+')) {
+		negative = (*p == '-');
+		p++;
+	}
+
+	uint64_t mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool any = false;
+	while (p < end && *p >= '0' && *p <= '9') {
+		if (digits < 19) {
+			mantissa = mantissa * 10 + (*p - '0');
+			digits += (mantissa != 0);
+		}
+		else {
+			exponent++;
+		}
+		any = true;
+		p++;
+	}
+	if (p < end && *p == '.') {
+		p++;
+		while (p < end && *p >= '0' && *p <= '9') {
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				digits += (mantissa != 0);
+				exponent--;
+			}
+			any = true;
+			p++;
+		}
+	}
+	if (!any) {
+		return start;
+	}
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		const char* exponentStart = p++;
+		bool exponentNegative = false;
+		if (p < end && (*p == '-' || *p == '+')) {
+			exponentNegative = (*p == '-');
+			p++;
+		}
+		if (p < end && *p >= '0' && *p <= '9') {
+			int e = 0;
+			while (p < end && *p >= '0' && *p <= '9') {
+				e = min(e * 10 + (*p - '0'), 9999);
+				p++;
+			}
+			exponent += exponentNegative ? -e : e;
+		}
+		else {
+			p = exponentStart; // a bare 'e' is not part of the number
+		}
+	}
+
+	double result = (double)mantissa;
+	if (exponent < 0) {
+		result = (exponent >= -22) ? result / powers[-exponent] : result * pow(10.0, exponent);
+	}
+	else if (exponent > 0) {
+		result = (exponent <= 22) ? result * powers[exponent] : result * pow(10.0, exponent);
+	}
+	value = (float)(negative ? -result : result);
+	return p;
+
+}
+
+
+static const char* UParseInt(const char* p, const char* end, int& value) {
+
+	const char* start = p;
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+')) {
+		negative = (*p == '-');
+		p++;
+	}
+	long long result = 0;
+	const char* digits = p;
+	while (p < end && *p >= '0' && *p <= '9') {
+		result = min(result * 10 + (*p - '0'), 2147483647LL);
+		p++;
+	}
+	if (p == digits) {
+		return start;
+	}
+	value = (int)(negative ? -result : result);
+	return p;
+
+}
+
+
+// Fills vertex normals with the area-weighted average of the normals of the triangles around each
+// position. positionOf maps every vertex to the position it was built from, so vertices split by a
+// texture seam still come out smooth, NULL when each vertex is a position of its own. Only vertices
+// with fill set are written, every one when fill is NULL.
+static void UComputeNormals(Mesh& mesh, const int* positionOf, size_t positionCount, const char* fill) {
+
+	size_t vertexCount = UMeshVertexCount(mesh);
+	vector<glm::vec3> normals(positionOf != NULL ? positionCount : vertexCount, glm::vec3(0.0f));
+	const float* v = mesh.vertices.data();
+	for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+		unsigned int a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+		glm::vec3 pa(v[a * VERTEX_FLOATS], v[a * VERTEX_FLOATS + 1], v[a * VERTEX_FLOATS + 2]);
+		glm::vec3 pb(v[b * VERTEX_FLOATS], v[b * VERTEX_FLOATS + 1], v[b * VERTEX_FLOATS + 2]);
+		glm::vec3 pc(v[c * VERTEX_FLOATS], v[c * VERTEX_FLOATS + 1], v[c * VERTEX_FLOATS + 2]);
+		glm::vec3 face = glm::cross(pb - pa, pc - pa); // length is twice the area
+		normals[positionOf != NULL ? positionOf[a] : a] += face;
+		normals[positionOf != NULL ? positionOf[b] : b] += face;
+		normals[positionOf != NULL ? positionOf[c] : c] += face;
+	}
+	UTaskParallelFor(vertexCount, IMPORT_MIN_SLICE, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; i++) {
+			if (fill != NULL && !fill[i]) {
+				continue;
+			}
+			const glm::vec3& sum = normals[positionOf != NULL ? positionOf[i] : i];
+			float length = glm::length(sum);
+			glm::vec3 n = (length > 0.0f) ? sum / length : glm::vec3(0.0f, 1.0f, 0.0f);
+			mesh.vertices[i * VERTEX_FLOATS + 3] = n.x;
+			mesh.vertices[i * VERTEX_FLOATS + 4] = n.y;
+			mesh.vertices[i * VERTEX_FLOATS + 5] = n.z;
+		}
+	});
+
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// OBJ
+
+// Position, texture coordinate and normal index of one face corner, 0 based, -1 when absent
+struct ObjCorner {
+	int p;
+	int t;
+	int n;
+};
+
+// One line-aligned slice of the file
+struct ObjChunk {
+	const char* begin;
+	const char* end;
+	size_t positions;			// records in this chunk, then the global index of its first one
+	size_t texcoords;
+	size_t normals;
+	size_t lines;
+	vector<ObjCorner> corners;	// three per triangle
+	string error;
+};
+
+
+// Counts the records and lines of a chunk
+static void UCountObjChunk(ObjChunk& chunk) {
+
+	chunk.positions = chunk.texcoords = chunk.normals = chunk.lines = 0;
+	for (const char* p = chunk.begin; p < chunk.end; p = UNextLine(p, chunk.end)) {
+		chunk.lines++;
+		const char* q = USkipSpaces(p, chunk.end);
+		if (q + 1 < chunk.end && q[0] == 'v') {
+			if (q[1] == ' ' || q[1] == '\t') {
+				chunk.positions++;
+			}
+			else if (q[1] == 't') {
+				chunk.texcoords++;
+			}
+			else if (q[1] == 'n') {
+				chunk.normals++;
+			}
+		}
+	}
+
+}
+
+
+// Reads up to count floats after a record tag, missing ones stay as they were
+static const char* UParseFloats(const char* p, const char* end, float* values, int count) {
+
+	for (int i = 0; i < count; i++) {
+		p = USkipSpaces(p, end);
+		const char* next = UParseFloat(p, end, values[i]);
+		if (next == p) {
+			break;
+		}
+		p = next;
+	}
+	return p;
+
+}
+
+
+// Turns an OBJ index into a 0 based one, relative indices count back from the records read so far
+static inline bool UResolveObjIndex(int index, size_t readSoFar, size_t total, int& resolved) {
+
+	long long absolute = (index < 0) ? (long long)readSoFar + index : (long long)index - 1;
+	resolved = (int)absolute;
+	return index != 0 && absolute >= 0 && absolute < (long long)total;
+
+}
+
+
+// Parses a chunk, writing its attributes at its global offsets and its triangles into chunk.corners
+static void UParseObjChunk(ObjChunk& chunk, size_t firstLine, size_t totals[3], float* positions, float* texcoords, float* normals) {
+
+	size_t read[3] = { chunk.positions, chunk.texcoords, chunk.normals };
+	size_t line = firstLine;
+	vector<ObjCorner> face;
+
+	for (const char* p = chunk.begin; p < chunk.end; line++) {
+		const char* lineEnd = UNextLine(p, chunk.end);
+		const char* q = USkipSpaces(p, lineEnd);
+		p = lineEnd;
+		if (q + 1 >= lineEnd) {
+			continue;
+		}
+
+		if (q[0] == 'v' && (q[1] == ' ' || q[1] == '\t')) {
+			UParseFloats(q + 1, lineEnd, positions + 3 * read[0]++, 3);
+		}
+		else if (q[0] == 'v' && q[1] == 't') {
+			UParseFloats(q + 2, lineEnd, texcoords + 2 * read[1]++, 2);
+		}
+		else if (q[0] == 'v' && q[1] == 'n') {
+			UParseFloats(q + 2, lineEnd, normals + 3 * read[2]++, 3);
+		}
+		else if (q[0] == 'f' && (q[1] == ' ' || q[1] == '\t')) {
+			face.clear();
+			q = USkipSpaces(q + 1, lineEnd);
+			while (q < lineEnd && *q != '\n' && *q != '#') {
+				int raw[3] = { 0, 0, 0 };
+				ObjCorner corner = { -1, -1, -1 };
+				const char* next = UParseInt(q, lineEnd, raw[0]);
+				bool valid = (next != q) && UResolveObjIndex(raw[0], read[0], totals[0], corner.p);
+				q = next;
+				for (int slot = 1; slot < 3 && valid && q < lineEnd && *q == '/'; slot++) {
+					q++;
+					next = UParseInt(q, lineEnd, raw[slot]);
+					if (next != q) {
+						int* target = (slot == 1) ? &corner.t : &corner.n;
+						valid = UResolveObjIndex(raw[slot], read[slot], totals[slot], *target);
+						q = next;
+					}
+				}
+				if (!valid) {
+					chunk.error = "bad face index on line " + to_string(line);
+					return;
+				}
+				face.push_back(corner);
+				q = USkipSpaces(q, lineEnd);
+			}
+
+			// Fan the polygon into triangles
+			for (size_t i = 2; i < face.size(); i++) {
+				chunk.corners.push_back(face[0]);
+				chunk.corners.push_back(face[i - 1]);
+				chunk.corners.push_back(face[i]);
+			}
+		}
+	}
+
+}
+
+
+static inline size_t UHashCorner(const ObjCorner& corner) {
+
+	uint64_t h = (uint32_t)corner.p * 0x9E3779B97F4A7C15ull;
+	h ^= ((uint32_t)corner.t + 0x7F4A7C15ull) * 0xC2B2AE3D27D4EB4Full;
+	h ^= ((uint32_t)corner.n + 0x165667B1ull) * 0x165667B19E3779F9ull;
+	return (size_t)(h ^ (h >> 29));
+
+}
+
+
+bool UImportObj(const char* text, size_t length, Mesh& mesh) {
+
+	mesh.vertices.clear();
+	mesh.indices.clear();
+	const char* end = text + length;
+
+	// Line-aligned chunks
+	size_t chunkCount = max<size_t>(1, min<size_t>(UTaskThreadCount() * IMPORT_CHUNKS_PER_THREAD, length / IMPORT_MIN_CHUNK));
+	vector<ObjChunk> chunks(chunkCount);
+	const char* p = text;
+	for (size_t c = 0; c < chunkCount; c++) {
+		chunks[c].begin = p;
+		p = (c + 1 == chunkCount) ? end : UNextLine(min(end, text + length / chunkCount * (c + 1)), end);
+		p = max(p, chunks[c].begin);
+		chunks[c].end = p;
+	}
+
+	// Pass 1 counts, so every chunk knows where its records go and which line it starts on
+	UTaskParallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+		for (size_t c = first; c < last; c++) {
+			UCountObjChunk(chunks[c]);
+		}
+	});
+	size_t totals[3] = { 0, 0, 0 };
+	vector<size_t> firstLines(chunkCount);
+	size_t lines = 1;
+	for (size_t c = 0; c < chunkCount; c++) {
+		size_t counts[3] = { chunks[c].positions, chunks[c].texcoords, chunks[c].normals };
+		chunks[c].positions = totals[0];
+		chunks[c].texcoords = totals[1];
+		chunks[c].normals = totals[2];
+		for (int k = 0; k < 3; k++) {
+			totals[k] += counts[k];
+		}
+		firstLines[c] = lines;
+		lines += chunks[c].lines;
+	}
+
+	// Pass 2 parses every chunk into the shared attribute arrays
+	vector<float> positions(totals[0] * 3, 0.0f);
+	vector<float> texcoords(totals[1] * 2, 0.0f);
+	vector<float> normals(totals[2] * 3, 0.0f);
+	UTaskParallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+		for (size_t c = first; c < last; c++) {
+			UParseObjChunk(chunks[c], firstLines[c], totals, positions.data(), texcoords.data(), normals.data());
+		}
+	});
+
+	size_t cornerCount = 0;
+	for (size_t c = 0; c < chunkCount; c++) {
+		if (!chunks[c].error.empty()) {
+			std::cerr << "OBJ: " << chunks[c].error << "\n";
+			return false;
+		}
+		cornerCount += chunks[c].corners.size();
+	}
+
+	// Deduplicate corners through an open-addressed table of indices into uniqueCorners
+	vector<ObjCorner> uniqueCorners;
+	uniqueCorners.reserve(totals[0]);
+	size_t tableSize = 1024;
+	while (tableSize < totals[0] * 2) {
+		tableSize *= 2;
+	}
+	vector<uint32_t> table(tableSize, 0); // vertex index + 1, 0 for empty
+	bool anyMissingNormal = false;
+
+	mesh.indices.resize(cornerCount);
+	size_t corner = 0;
+	for (size_t c = 0; c < chunkCount; c++) {
+		const vector<ObjCorner>& corners = chunks[c].corners;
+		for (size_t i = 0; i < corners.size(); i++) {
+			const ObjCorner& key = corners[i];
+			size_t slot = UHashCorner(key) & (tableSize - 1);
+			while (table[slot] != 0) {
+				const ObjCorner& existing = uniqueCorners[table[slot] - 1];
+				if (existing.p == key.p && existing.t == key.t && existing.n == key.n) {
+					break;
+				}
+				slot = (slot + 1) & (tableSize - 1);
+			}
+			if (table[slot] == 0) {
+				uniqueCorners.push_back(key);
+				table[slot] = (uint32_t)uniqueCorners.size();
+				anyMissingNormal = anyMissingNormal || key.n < 0;
+
+				// Keep the table at most half full
+				if (uniqueCorners.size() * 2 > tableSize) {
+					tableSize *= 2;
+					table.assign(tableSize, 0);
+					for (size_t u = 0; u < uniqueCorners.size(); u++) {
+						size_t s = UHashCorner(uniqueCorners[u]) & (tableSize - 1);
+						while (table[s] != 0) {
+							s = (s + 1) & (tableSize - 1);
+						}
+						table[s] = (uint32_t)(u + 1);
+					}
+				}
+				mesh.indices[corner++] = (unsigned int)(uniqueCorners.size() - 1);
+			}
+			else {
+				mesh.indices[corner++] = table[slot] - 1;
+			}
+		}
+		vector<ObjCorner>().swap(chunks[c].corners);
+	}
+
+	// Interleave the unique corners
+	mesh.vertices.resize(uniqueCorners.size() * VERTEX_FLOATS);
+	vector<int> positionOf(anyMissingNormal ? uniqueCorners.size() : 0);
+	vector<char> missingNormal(anyMissingNormal ? uniqueCorners.size() : 0);
+	UTaskParallelFor(uniqueCorners.size(), IMPORT_MIN_SLICE, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; i++) {
+			const ObjCorner& key = uniqueCorners[i];
+			if (anyMissingNormal) {
+				positionOf[i] = key.p;
+				missingNormal[i] = key.n < 0;
+			}
+			float* out = &mesh.vertices[i * VERTEX_FLOATS];
+			out[0] = positions[key.p * 3];
+			out[1] = positions[key.p * 3 + 1];
+			out[2] = positions[key.p * 3 + 2];
+			out[3] = (key.n >= 0) ? normals[key.n * 3] : 0.0f;
+			out[4] = (key.n >= 0) ? normals[key.n * 3 + 1] : 0.0f;
+			out[5] = (key.n >= 0) ? normals[key.n * 3 + 2] : 0.0f;
+			out[6] = (key.t >= 0) ? texcoords[key.t * 2] : 0.0f;
+			out[7] = (key.t >= 0) ? texcoords[key.t * 2 + 1] : 0.0f;
+		}
+	});
+
+	// Corners without a normal get smooth ones, the normals the file gives are kept
+	if (anyMissingNormal) {
+		UComputeNormals(mesh, positionOf.data(), totals[0], missingNormal.data());
+	}
+	return true;
+
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// glTF
+
+// Just enough JSON for a glTF document
+struct JsonValue {
+	enum Type { JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT };
+	Type type;
+	double number;
+	string text;
+	vector<JsonValue> items;
+	vector<pair<string, JsonValue> > members;
+
+	JsonValue() : type(JSON_NULL), number(0.0) {}
+
+	const JsonValue* Find(const char* key) const {
+		for (size_t i = 0; i < members.size(); i++) {
+			if (members[i].first == key) {
+				return &members[i].second;
+			}
+		}
+		return NULL;
+	}
+
+	double Number(const char* key, double fallback) const {
+		const JsonValue* value = Find(key);
+		return (value && value->type == JSON_NUMBER) ? value->number : fallback;
+	}
+};
+
+
+static void UAppendUtf8(string& out, unsigned int code) {
+
+	if (code < 0x80) {
+		out += (char)code;
+	}
+	else if (code < 0x800) {
+		out += (char)(0xC0 | (code >> 6));
+		out += (char)(0x80 | (code & 0x3F));
+	}
+	else {
+		out += (char)(0xE0 | (code >> 12));
+		out += (char)(0x80 | ((code >> 6) & 0x3F));
+		out += (char)(0x80 | (code & 0x3F));
+	}
+
+}
+
+
+// Recursive descent JSON parser, returns NULL on malformed input
+static const char* UParseJson(const char* p, const char* end, JsonValue& value, int depth) {
+
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+		p++;
+	}
+	if (p >= end || depth > 64) {
+		return NULL;
+	}
+
+	if (*p == '{' || *p == '[') {
+		bool object = (*p == '{');
+		char close = object ? '}' : ']';
+		value.type = object ? JsonValue::JSON_OBJECT : JsonValue::JSON_ARRAY;
+		p++;
+		while (true) {
+			while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' || *p == ',')) {
+				p++;
+			}
+			if (p >= end) {
+				return NULL;
+			}
+			if (*p == close) {
+				return p + 1;
+			}
+			if (object) {
+				JsonValue key;
+				p = UParseJson(p, end, key, depth + 1);
+				if (!p || key.type != JsonValue::JSON_STRING) {
+					return NULL;
+				}
+				while (p < end && *p != ':') {
+					p++;
+				}
+				value.members.push_back(make_pair(key.text, JsonValue()));
+				p = (p < end) ? UParseJson(p + 1, end, value.members.back().second, depth + 1) : NULL;
+			}
+			else {
+				value.items.push_back(JsonValue());
+				p = UParseJson(p, end, value.items.back(), depth + 1);
+			}
+			if (!p) {
+				return NULL;
+			}
+		}
+	}
+	if (*p == '"') {
+		value.type = JsonValue::JSON_STRING;
+		for (p++; p < end && *p != '"'; p++) {
+			if (*p != '\\') {
+				value.text += *p;
+				continue;
+			}
+			if (++p >= end) {
+				return NULL;
+			}
+			switch (*p) {
+			case 'n': value.text += '\n'; break;
+			case 't': value.text += '\t'; break;
+			case 'r': value.text += '\r'; break;
+			case 'b': value.text += '\b'; break;
+			case 'f': value.text += '\f'; break;
+			case 'u':
+				if (end - p < 5) {
+					return NULL;
+				}
+				UAppendUtf8(value.text, (unsigned int)strtoul(string(p + 1, 4).c_str(), NULL, 16));
+				p += 4;
+				break;
+			default: value.text += *p; break;
+			}
+		}
+		return (p < end) ? p + 1 : NULL;
+	}
+	if (end - p >= 4 && strncmp(p, "true", 4) == 0) {
+		value.type = JsonValue::JSON_BOOL;
+		value.number = 1.0;
+		return p + 4;
+	}
+	if (end - p >= 5 && strncmp(p, "false", 5) == 0) {
+		value.type = JsonValue::JSON_BOOL;
+		return p + 5;
+	}
+	if (end - p >= 4 && strncmp(p, "null", 4) == 0) {
+		return p + 4;
+	}
+
+	float number = 0.0f;
+	const char* next = UParseFloat(p, end, number);
+	if (next == p) {
+		return NULL;
+	}
+	value.type = JsonValue::JSON_NUMBER;
+	value.number = strtod(string(p, next).c_str(), NULL); // full precision for offsets and counts
+	return next;
+
+}
+
+
+static bool UDecodeBase64(const char* p, const char* end, vector<unsigned char>& out) {
+
+	unsigned int bits = 0;
+	int bitCount = 0;
+	for (; p < end && *p != '='; p++) {
+		char c = *p;
+		int v = (c >= 'A' && c <= 'Z') ? c - 'A' : (c >= 'a' && c <= 'z') ? c - 'a' + 26
+			: (c >= '0' && c <= '9') ? c - '0' + 52 : (c == '+') ? 62 : (c == '/') ? 63 : -1;
+		if (v < 0) {
+			return false;
+		}
+		bits = (bits << 6) | v;
+		bitCount += 6;
+		if (bitCount >= 8) {
+			bitCount -= 8;
+			out.push_back((unsigned char)(bits >> bitCount));
+		}
+	}
+	return true;
+
+}
+
+
+// Buffers of one glTF document, mapped, decoded or inside the .glb
+struct GltfDocument {
+	JsonValue root;
+	vector<const unsigned char*> buffers;
+	vector<size_t> bufferSizes;
+	vector<MappedFile> mappedFiles;
+	vector<vector<unsigned char> > decoded;
+};
+
+
+// Typed view of an accessor's elements
+struct GltfAccessor {
+	const unsigned char* data;
+	size_t count;
+	size_t stride;
+	int componentType;
+	int components;
+	bool normalized;
+};
+
+
+static bool UGltfAccessor(const GltfDocument& document, int index, GltfAccessor& accessor) {
+
+	const JsonValue* accessors = document.root.Find("accessors");
+	const JsonValue* views = document.root.Find("bufferViews");
+	if (!accessors || index < 0 || index >= (int)accessors->items.size() || !views) {
+		return false;
+	}
+	const JsonValue& a = accessors->items[index];
+	if (a.Find("sparse")) {
+		std::cerr << "glTF: sparse accessors are not supported\n";
+		return false;
+	}
+	int viewIndex = (int)a.Number("bufferView", -1);
+	if (viewIndex < 0 || viewIndex >= (int)views->items.size()) {
+		return false;
+	}
+	const JsonValue& view = views->items[viewIndex];
+	int buffer = (int)view.Number("buffer", -1);
+	if (buffer < 0 || buffer >= (int)document.buffers.size()) {
+		return false;
+	}
+
+	const JsonValue* type = a.Find("type");
+	string typeName = type ? type->text : "";
+	accessor.components = (typeName == "SCALAR") ? 1 : (typeName == "VEC2") ? 2 : (typeName == "VEC3") ? 3 : (typeName == "VEC4") ? 4 : 0;
+	accessor.componentType = (int)a.Number("componentType", 0);
+	int componentBytes = (accessor.componentType == 5126 || accessor.componentType == 5125) ? 4
+		: (accessor.componentType == 5123 || accessor.componentType == 5122) ? 2 : 1;
+	const JsonValue* normalized = a.Find("normalized");
+	accessor.normalized = normalized && normalized->number != 0.0;
+	accessor.count = (size_t)a.Number("count", 0);
+	accessor.stride = (size_t)view.Number("byteStride", 0);
+	if (accessor.stride == 0) {
+		accessor.stride = (size_t)componentBytes * accessor.components;
+	}
+
+	size_t offset = (size_t)view.Number("byteOffset", 0) + (size_t)a.Number("byteOffset", 0);
+	size_t needed = (accessor.count > 0) ? offset + (accessor.count - 1) * accessor.stride + componentBytes * accessor.components : offset;
+	if (accessor.components == 0 || needed > document.bufferSizes[buffer]) {
+		std::cerr << "glTF: accessor " << index << " does not fit its buffer\n";
+		return false;
+	}
+	accessor.data = document.buffers[buffer] + offset;
+	return true;
+
+}
+
+
+// Component c of element i as a float, normalized integers scaled to 0 - 1, signed ones to -1 - 1
+static inline float UGltfFloat(const GltfAccessor& accessor, size_t i, int c) {
+
+	const unsigned char* element = accessor.data + i * accessor.stride;
+	switch (accessor.componentType) {
+	case 5126: { float f; memcpy(&f, element + c * 4, 4); return f; }
+	case 5123: { unsigned short s; memcpy(&s, element + c * 2, 2); return accessor.normalized ? s / 65535.0f : (float)s; }
+	case 5122: { short s; memcpy(&s, element + c * 2, 2); return accessor.normalized ? max(s / 32767.0f, -1.0f) : (float)s; }
+	case 5121: return accessor.normalized ? element[c] / 255.0f : (float)element[c];
+	case 5120: { signed char b = (signed char)element[c]; return accessor.normalized ? max(b / 127.0f, -1.0f) : (float)b; }
+	default: return 0.0f;
+	}
+
+}
+
+
+static inline unsigned int UGltfIndex(const GltfAccessor& accessor, size_t i) {
+
+	const unsigned char* element = accessor.data + i * accessor.stride;
+	switch (accessor.componentType) {
+	case 5125: { unsigned int v; memcpy(&v, element, 4); return v; }
+	case 5123: { unsigned short v; memcpy(&v, element, 2); return v; }
+	default: return element[0];
+	}
+
+}
+
+
+// Node transform from its matrix or translation / rotation / scale
+static glm::mat4 UGltfNodeMatrix(const JsonValue& node) {
+
+	glm::mat4 matrix(1.0f);
+	const JsonValue* m = node.Find("matrix");
+	if (m && m->items.size() == 16) {
+		for (int i = 0; i < 16; i++) {
+			matrix[i / 4][i % 4] = (float)m->items[i].number;
+		}
+		return matrix;
+	}
+
+	const JsonValue* t = node.Find("translation");
+	const JsonValue* r = node.Find("rotation");
+	const JsonValue* s = node.Find("scale");
+	if (r && r->items.size() == 4) {
+		float x = (float)r->items[0].number, y = (float)r->items[1].number, z = (float)r->items[2].number, w = (float)r->items[3].number;
+		matrix[0] = glm::vec4(1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w), 0.0f);
+		matrix[1] = glm::vec4(2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w), 0.0f);
+		matrix[2] = glm::vec4(2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y), 0.0f);
+	}
+	if (s && s->items.size() == 3) {
+		for (int c = 0; c < 3; c++) {
+			matrix[c] *= (float)s->items[c].number;
+		}
+	}
+	if (t && t->items.size() == 3) {
+		matrix[3] = glm::vec4((float)t->items[0].number, (float)t->items[1].number, (float)t->items[2].number, 1.0f);
+	}
+	return matrix;
+
+}
+
+
+// Appends one triangle primitive to mesh under transform
+static bool UAppendGltfPrimitive(const GltfDocument& document, const JsonValue& primitive, const glm::mat4& transform, Mesh& mesh) {
+
+	if (primitive.Number("mode", 4) != 4) {
+		std::cerr << "glTF: skipping a primitive that is not triangles\n";
+		return true;
+	}
+	const JsonValue* attributes = primitive.Find("attributes");
+	GltfAccessor positions, normals, texcoords, indices;
+	if (!attributes || !UGltfAccessor(document, (int)attributes->Number("POSITION", -1), positions) || positions.components != 3) {
+		std::cerr << "glTF: primitive without usable positions\n";
+		return false;
+	}
+	bool hasNormals = UGltfAccessor(document, (int)attributes->Number("NORMAL", -1), normals) && normals.count == positions.count;
+	bool hasTexcoords = UGltfAccessor(document, (int)attributes->Number("TEXCOORD_0", -1), texcoords) && texcoords.count == positions.count;
+	bool hasIndices = primitive.Find("indices") && UGltfAccessor(document, (int)primitive.Number("indices", -1), indices);
+
+	size_t baseVertex = UMeshVertexCount(mesh);
+	size_t baseIndex = mesh.indices.size();
+	size_t indexCount = hasIndices ? indices.count : positions.count;
+	mesh.vertices.resize((baseVertex + positions.count) * VERTEX_FLOATS);
+	mesh.indices.resize(baseIndex + indexCount);
+
+	glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+	UTaskParallelFor(positions.count, IMPORT_MIN_SLICE, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; i++) {
+			glm::vec4 position = transform * glm::vec4(UGltfFloat(positions, i, 0), UGltfFloat(positions, i, 1), UGltfFloat(positions, i, 2), 1.0f);
+			glm::vec3 normal = hasNormals ? normalMatrix * glm::vec3(UGltfFloat(normals, i, 0), UGltfFloat(normals, i, 1), UGltfFloat(normals, i, 2)) : glm::vec3(0.0f);
+			float* out = &mesh.vertices[(baseVertex + i) * VERTEX_FLOATS];
+			out[0] = position.x;
+			out[1] = position.y;
+			out[2] = position.z;
+			out[3] = normal.x;
+			out[4] = normal.y;
+			out[5] = normal.z;
+			out[6] = hasTexcoords ? UGltfFloat(texcoords, i, 0) : 0.0f;
+			out[7] = hasTexcoords ? 1.0f - UGltfFloat(texcoords, i, 1) : 0.0f; // glTF's V runs down the image
+		}
+	});
+
+	bool inRange = true;
+	for (size_t i = 0; i < indexCount; i++) {
+		unsigned int index = hasIndices ? UGltfIndex(indices, i) : (unsigned int)i;
+		inRange = inRange && index < positions.count;
+		mesh.indices[baseIndex + i] = (unsigned int)baseVertex + index;
+	}
+	if (!inRange) {
+		std::cerr << "glTF: index out of range\n";
+		return false;
+	}
+
+	// Smooth normals for this primitive alone
+	if (!hasNormals) {
+		Mesh part;
+		part.vertices.assign(mesh.vertices.begin() + baseVertex * VERTEX_FLOATS, mesh.vertices.end());
+		part.indices.resize(indexCount);
+		for (size_t i = 0; i < indexCount; i++) {
+			part.indices[i] = mesh.indices[baseIndex + i] - (unsigned int)baseVertex;
+		}
+		UComputeNormals(part, NULL, 0, NULL);
+		copy(part.vertices.begin(), part.vertices.end(), mesh.vertices.begin() + baseVertex * VERTEX_FLOATS);
+	}
+	return true;
+
+}
+
+
+static bool UAppendGltfNode(const GltfDocument& document, int nodeIndex, const glm::mat4& parent, Mesh& mesh, int depth) {
+
+	const JsonValue* nodes = document.root.Find("nodes");
+	if (!nodes || nodeIndex < 0 || nodeIndex >= (int)nodes->items.size() || depth > 64) {
+		return false;
+	}
+	const JsonValue& node = nodes->items[nodeIndex];
+	glm::mat4 transform = parent * UGltfNodeMatrix(node);
+
+	const JsonValue* meshes = document.root.Find("meshes");
+	int meshIndex = (int)node.Number("mesh", -1);
+	if (meshIndex >= 0) {
+		const JsonValue* primitives = (meshes && meshIndex < (int)meshes->items.size()) ? meshes->items[meshIndex].Find("primitives") : NULL;
+		if (!primitives) {
+			return false;
+		}
+		for (size_t p = 0; p < primitives->items.size(); p++) {
+			if (!UAppendGltfPrimitive(document, primitives->items[p], transform, mesh)) {
+				return false;
+			}
+		}
+	}
+
+	const JsonValue* children = node.Find("children");
+	for (size_t c = 0; children && c < children->items.size(); c++) {
+		if (!UAppendGltfNode(document, (int)children->items[c].number, transform, mesh, depth + 1)) {
+			return false;
+		}
+	}
+	return true;
+
+}
+
+
+static bool UImportGltf(const string& path, const MappedFile& file, Mesh& mesh) {
+
+	mesh.vertices.clear();
+	mesh.indices.clear();
+	GltfDocument document;
+	const char* json = file.data;
+	size_t jsonLength = file.size;
+	const unsigned char* binChunk = NULL;
+	size_t binLength = 0;
+
+	// .glb: 12 byte header, then a JSON chunk and an optional BIN chunk
+	if (file.size >= 12 && memcmp(file.data, "glTF", 4) == 0) {
+		const unsigned char* bytes = (const unsigned char*)file.data;
+		size_t offset = 12;
+		json = NULL;
+		while (offset + 8 <= file.size) {
+			uint32_t chunkLength, chunkType;
+			memcpy(&chunkLength, bytes + offset, 4);
+			memcpy(&chunkType, bytes + offset + 4, 4);
+			if (offset + 8 + chunkLength > file.size) {
+				break;
+			}
+			if (chunkType == 0x4E4F534A) { // JSON
+				json = file.data + offset + 8;
+				jsonLength = chunkLength;
+			}
+			else if (chunkType == 0x004E4942) { // BIN
+				binChunk = bytes + offset + 8;
+				binLength = chunkLength;
+			}
+			offset += 8 + chunkLength;
+		}
+		if (!json) {
+			std::cerr << "glTF: " << path << " has no JSON chunk\n";
+			return false;
+		}
+	}
+
+	if (!UParseJson(json, json + jsonLength, document.root, 0) || document.root.type != JsonValue::JSON_OBJECT) {
+		std::cerr << "glTF: " << path << " is not valid JSON\n";
+		return false;
+	}
+
+	// Buffers live in the .glb, in a data URI or in a file next to the model
+	string folder = path.substr(0, path.find_last_of("/\\") + 1);
+	const JsonValue* buffers = document.root.Find("buffers");
+	bool ok = true;
+	for (size_t b = 0; buffers && b < buffers->items.size() && ok; b++) {
+		const JsonValue* uri = buffers->items[b].Find("uri");
+		if (!uri) {
+			document.buffers.push_back(binChunk);
+			document.bufferSizes.push_back(binChunk ? binLength : 0);
+			continue;
+		}
+		if (uri->text.compare(0, 5, "data:") == 0) {
+			size_t comma = uri->text.find(',');
+			document.decoded.push_back(vector<unsigned char>());
+			vector<unsigned char>& data = document.decoded.back();
+			ok = comma != string::npos && UDecodeBase64(uri->text.c_str() + comma + 1, uri->text.c_str() + uri->text.size(), data);
+			document.buffers.push_back(data.empty() ? NULL : data.data());
+			document.bufferSizes.push_back(data.size());
+			continue;
+		}
+		MappedFile buffer;
+		ok = UMapFile(folder + uri->text, buffer);
+		if (!ok) {
+			std::cerr << "glTF: cannot open buffer " << folder + uri->text << "\n";
+			break;
+		}
+		document.mappedFiles.push_back(buffer);
+		document.buffers.push_back((const unsigned char*)buffer.data);
+		document.bufferSizes.push_back(buffer.size);
+	}
+
+	// The default scene's node trees, or every mesh as is when there are no scenes
+	if (ok) {
+		const JsonValue* scenes = document.root.Find("scenes");
+		int sceneIndex = (int)document.root.Number("scene", 0);
+		if (scenes && sceneIndex < (int)scenes->items.size()) {
+			const JsonValue* roots = scenes->items[sceneIndex].Find("nodes");
+			for (size_t n = 0; roots && n < roots->items.size() && ok; n++) {
+				ok = UAppendGltfNode(document, (int)roots->items[n].number, glm::mat4(1.0f), mesh, 0);
+			}
+		}
+		else {
+			const JsonValue* meshes = document.root.Find("meshes");
+			for (size_t m = 0; meshes && m < meshes->items.size() && ok; m++) {
+				const JsonValue* primitives = meshes->items[m].Find("primitives");
+				for (size_t p = 0; primitives && p < primitives->items.size() && ok; p++) {
+					ok = UAppendGltfPrimitive(document, primitives->items[p], glm::mat4(1.0f), mesh);
+				}
+			}
+		}
+	}
+
+	for (size_t f = 0; f < document.mappedFiles.size(); f++) {
+		UUnmapFile(document.mappedFiles[f]);
+	}
+	return ok;
+
+}
+
+
+bool UImportModel(const string& path, Mesh& mesh, ImportStats& stats) {
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	MappedFile file;
+	if (!UMapFile(path, file)) {
+		std::cerr << "Cannot open model " << path << "\n";
+		return false;
+	}
+
+	string extension = path.substr(path.find_last_of('.') + 1);
+	transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	bool ok;
+	if (extension == "obj") {
+		ok = UImportObj(file.data, file.size, mesh);
+	}
+	else if (extension == "gltf" || extension == "glb") {
+		ok = UImportGltf(path, file, mesh);
+	}
+	else {
+		std::cerr << "Unknown model format " << path << ", expected .obj, .gltf or .glb\n";
+		ok = false;
+	}
+
+	stats.fileBytes = file.size;
+	stats.vertices = UMeshVertexCount(mesh);
+	stats.triangles = mesh.indices.size() / 3;
+	stats.milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	UUnmapFile(file);
+	if (ok && mesh.indices.empty()) {
+		std::cerr << "Model " << path << " has no triangles\n";
+		ok = false;
+	}
+	return ok;
+
+}
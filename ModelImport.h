@@ -0,0 +1,52 @@
+/*
+*	Title:	Final Project / ModelImport.h
+*	Date:	October 19, 2026
+*
+*	Description: OBJ and glTF importers. Files are memory-mapped rather than
+*	read, and the work is split across every core: OBJ text is parsed in
+*	line-aligned chunks with a dedicated float parser, glTF vertex data is
+*	converted in slices. OBJ corners are deduplicated through a hash table
+*	keyed on their position / texture coordinate / normal indices. Either way
+*	the result lands straight in the interleaved layout of Geometry.h, so it
+*	can replace the table meshes in legVAO and topVAO. OBJ corners and glTF
+*	primitives without normals get smooth ones from their triangles, averaged
+*	per OBJ position so texture seams do not split them.
+*
+*	Supported: OBJ v / vt / vn / f with polygon faces and negative indices;
+*	glTF 2.0 .gltf (with .bin files or base64 data URIs) and .glb, triangle
+*	primitives with positions, normals and texture coordinates as floats or
+*	as signed or unsigned 8 and 16 bit integers, normalized or not, the node
+*	hierarchy of the default scene. Materials are ignored.
+*
+*	Command line:
+*		--model <file>				draw this model in place of the table legs
+*		--model-top <file>			draw this model in place of the table top
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "Geometry.h"
+
+struct ImportOptions {
+	std::string modelPath;
+	std::string topModelPath;
+};
+
+struct ImportStats {
+	size_t fileBytes;
+	size_t vertices;
+	size_t triangles;
+	double milliseconds;
+};
+
+// Reads the import options out of the command line, returns false on a malformed argument
+bool UParseImportOptions(int argc, char* argv[], ImportOptions& options);
+
+// Loads a .obj, .gltf or .glb file into mesh, by extension. Prints why and returns false on failure.
+bool UImportModel(const std::string& path, Mesh& mesh, ImportStats& stats);
+
+// Parses OBJ text already in memory
+bool UImportObj(const char* text, size_t length, Mesh& mesh);
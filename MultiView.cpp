@@ -0,0 +1,272 @@
+/*
+*	Title:	Final Project / MultiView.cpp
+*	Date:	October 19, 2026
+*
+*	Description: View layout and the fan out. Views are laid out as fractions
+*	of the target, so the same layout holds at any render scale, and their
+*	pixel edges are rounded from the fractions so neighbours meet without a
+*	gap. The view uniforms and viewports are set once per program and frame
+*	whatever the number of views.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "MultiView.h"
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+#define VIEW_NEAR 0.1f
+#define VIEW_FAR 100.0f
+
+static int viewCount = 1;
+static ViewPath viewPath = VIEW_PATH_SINGLE;
+static int shaderVersion = 330;
+static string shaderHeader;				// everything after the #version line
+
+
+bool UParseViewOptions(int argc, char* argv[], ViewOptions& options) {
+
+	options.count = 1;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--views") != 0) {
+			continue; // not ours
+		}
+		if (i + 1 >= argc) {
+			std::cerr << argv[i] << " needs a value\n";
+			return false;
+		}
+		options.count = atoi(argv[++i]);
+		if (options.count != 1 && options.count != 2 && options.count != VIEW_MAX) {
+			std::cerr << "--views takes 1, 2 or " << VIEW_MAX << "\n";
+			return false;
+		}
+	}
+	return true;
+
+}
+
+
+void UViewInit(const ViewOptions& options) {
+
+	viewCount = min(max(options.count, 1), VIEW_MAX);
+	bool viewportArrays = GLEW_VERSION_4_1 || GLEW_ARB_viewport_array;
+	bool vertexViewport = GLEW_ARB_shader_viewport_layer_array || GLEW_AMD_vertex_shader_viewport_index;
+	if (viewCount == 1) {
+		viewPath = VIEW_PATH_SINGLE;
+	}
+	else if (viewportArrays && vertexViewport) {
+		viewPath = VIEW_PATH_INSTANCED;
+	}
+	else {
+		viewPath = VIEW_PATH_PASSES;
+		std::cerr << "No viewport index in the vertex shader here, drawing each of the " << viewCount << " views in its own pass\n";
+	}
+
+	// Shaders keep the numbering of their own source after the header
+	shaderVersion = 330;
+	shaderHeader.clear();
+	if (viewPath == VIEW_PATH_INSTANCED) {
+		shaderVersion = GLEW_VERSION_4_1 ? 410 : 330;
+		shaderHeader += GLEW_ARB_shader_viewport_layer_array ? "#extension GL_ARB_shader_viewport_layer_array : require\n"
+			: "#extension GL_AMD_vertex_shader_viewport_index : require\n";
+		shaderHeader += "#define VIEW_INSTANCED 1\n";
+	}
+	shaderHeader += "#define VIEW_MAX " + to_string(VIEW_MAX) + "\n#line 2\n";
+
+}
+
+
+int UViewCount(void) {
+
+	return viewCount;
+
+}
+
+
+ViewPath UViewPath(void) {
+
+	return viewPath;
+
+}
+
+
+int UViewFanOut(void) {
+
+	return viewPath == VIEW_PATH_INSTANCED ? viewCount : 1;
+
+}
+
+
+int UViewPasses(void) {
+
+	return viewPath == VIEW_PATH_PASSES ? viewCount : 1;
+
+}
+
+
+string UViewShaderSource(const char* source) {
+
+	// A source that needs a later version than the view path keeps its own
+	int version = shaderVersion;
+	const char* first = source + strspn(source, " \t");
+	if (strncmp(first, "#version ", 9) == 0) {
+		version = max(version, atoi(first + 9));
+	}
+	string header = "#version " + to_string(version) + " core\n";
+	if (viewPath == VIEW_PATH_INSTANCED && version < 410) {
+		header += "#extension GL_ARB_viewport_array : require\n";
+	}
+
+	const char* body = strchr(source, '\n');
+	return header + shaderHeader + (body != NULL ? body + 1 : "");
+
+}
+
+
+void UViewLayout(const glm::mat4& view, const glm::vec3& eye, float fieldOfView, float aspect,
+	const glm::vec3& center, float radius, SceneView* views) {
+
+	// Perspective, orthographic, top and side, side by side for two and in a grid for four
+	static const float halves[VIEW_MAX][4] = { { 0.0f, 0.0f, 0.5f, 1.0f }, { 0.5f, 0.0f, 0.5f, 1.0f } };
+	static const float quarters[VIEW_MAX][4] = {
+		{ 0.0f, 0.5f, 0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f, 0.5f }, { 0.0f, 0.0f, 0.5f, 0.5f }, { 0.5f, 0.0f, 0.5f, 0.5f }
+	};
+	for (int v = 0; v < viewCount; v++) {
+		const float* rect = viewCount == 1 ? NULL : viewCount == 2 ? halves[v] : quarters[v];
+		views[v].x = rect != NULL ? rect[0] : 0.0f;
+		views[v].y = rect != NULL ? rect[1] : 0.0f;
+		views[v].width = rect != NULL ? rect[2] : 1.0f;
+		views[v].height = rect != NULL ? rect[3] : 1.0f;
+	}
+
+	// The orthographic views frame the scene, the first one looking the way the camera does
+	float distance = radius * 2.0f;
+	glm::vec3 forward = -glm::vec3(view[0][2], view[1][2], view[2][2]);
+	glm::vec3 up = glm::vec3(view[0][1], view[1][1], view[2][1]);
+	for (int v = 0; v < viewCount; v++) {
+		float viewAspect = aspect * views[v].width / views[v].height;
+		glm::mat4 ortho = glm::ortho(-radius * viewAspect, radius * viewAspect, -radius, radius, VIEW_NEAR, max(VIEW_FAR, distance * 2.0f));
+		switch (v) {
+		case 0:
+			views[v].view = view;
+			views[v].projection = glm::perspective(fieldOfView, viewAspect, VIEW_NEAR, VIEW_FAR);
+			views[v].eye = eye;
+			break;
+		case 1:
+			views[v].eye = center - forward * distance;
+			views[v].view = glm::lookAt(views[v].eye, center, up);
+			views[v].projection = ortho;
+			break;
+		case 2:
+			views[v].eye = center + glm::vec3(0.0f, distance, 0.0f);
+			views[v].view = glm::lookAt(views[v].eye, center, glm::vec3(0.0f, 0.0f, -1.0f));
+			views[v].projection = ortho;
+			break;
+		default:
+			views[v].eye = center + glm::vec3(distance, 0.0f, 0.0f);
+			views[v].view = glm::lookAt(views[v].eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+			views[v].projection = ortho;
+			break;
+		}
+	}
+
+}
+
+
+// Pixel edges of a view, rounded from its fractions so neighbouring views share an edge
+static void UViewRect(const SceneView& view, int width, int height, int& x0, int& y0, int& x1, int& y1) {
+
+	x0 = (int)floor(view.x * width + 0.5f);
+	y0 = (int)floor(view.y * height + 0.5f);
+	x1 = (int)floor((view.x + view.width) * width + 0.5f);
+	y1 = (int)floor((view.y + view.height) * height + 0.5f);
+
+}
+
+
+void UViewSetViewports(const SceneView* views, int width, int height) {
+
+	if (viewPath != VIEW_PATH_INSTANCED) {
+		return;
+	}
+	GLfloat rects[VIEW_MAX * 4];
+	for (int v = 0; v < viewCount; v++) {
+		int x0, y0, x1, y1;
+		UViewRect(views[v], width, height, x0, y0, x1, y1);
+		rects[v * 4 + 0] = (GLfloat)x0;
+		rects[v * 4 + 1] = (GLfloat)y0;
+		rects[v * 4 + 2] = (GLfloat)(x1 - x0);
+		rects[v * 4 + 3] = (GLfloat)(y1 - y0);
+	}
+	glViewportArrayv(0, viewCount, rects);
+
+}
+
+
+void UViewSetUniforms(GLuint program, const SceneView* views) {
+
+	glm::mat4 viewMatrices[VIEW_MAX];
+	glm::mat4 projections[VIEW_MAX];
+	glm::vec3 eyes[VIEW_MAX];
+	for (int v = 0; v < viewCount; v++) {
+		viewMatrices[v] = views[v].view;
+		projections[v] = views[v].projection;
+		eyes[v] = views[v].eye;
+	}
+
+	glUniformMatrix4fv(glGetUniformLocation(program, "views"), viewCount, GL_FALSE, glm::value_ptr(viewMatrices[0]));
+	glUniformMatrix4fv(glGetUniformLocation(program, "projections"), viewCount, GL_FALSE, glm::value_ptr(projections[0]));
+	GLint eyesLoc = glGetUniformLocation(program, "viewPositions");
+	if (eyesLoc >= 0) {
+		glUniform3fv(eyesLoc, viewCount, glm::value_ptr(eyes[0]));
+	}
+	glUniform1i(glGetUniformLocation(program, "viewCount"), UViewFanOut());
+	glUniform1i(glGetUniformLocation(program, "viewFirst"), 0);
+
+}
+
+
+void UViewBeginPass(GLuint program, int pass, const SceneView* views, int width, int height) {
+
+	if (viewPath != VIEW_PATH_PASSES) {
+		return;
+	}
+	int x0, y0, x1, y1;
+	UViewRect(views[pass], width, height, x0, y0, x1, y1);
+	glViewport(x0, y0, x1 - x0, y1 - y0);
+	glUniform1i(glGetUniformLocation(program, "viewFirst"), pass);
+
+}
+
+
+int UViewAt(int x, int y, int width, int height, const SceneView* views, int& viewX, int& viewY, int& viewWidth, int& viewHeight) {
+
+	int up = height - 1 - y; // views are laid out from the bottom
+	int found = 0;
+	for (int v = 0; v < viewCount; v++) {
+		int x0, y0, x1, y1;
+		UViewRect(views[v], width, height, x0, y0, x1, y1);
+		if (x >= x0 && x < x1 && up >= y0 && up < y1) {
+			found = v;
+			break;
+		}
+	}
+
+	int x0, y0, x1, y1;
+	UViewRect(views[found], width, height, x0, y0, x1, y1);
+	viewX = x - x0;
+	viewY = y - (height - y1);
+	viewWidth = x1 - x0;
+	viewHeight = y1 - y0;
+	return found;
+
+}
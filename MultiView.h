@@ -0,0 +1,97 @@
+/*
+*	Title:	Final Project / MultiView.h
+*	Date:	October 19, 2026
+*
+*	Description: Single-pass multi-view rendering. The scene can be shown in
+*	up to four viewports of the one target at once: the camera's perspective
+*	view, an orthographic view looking the same way, and orthographic top and
+*	side views for debugging. Each draw is submitted once and fanned out on
+*	the GPU: every instance is drawn once per view, the instanced attributes
+*	advance once per view count, and the vertex shader picks its view from
+*	gl_InstanceID and routes the primitive with gl_ViewportIndex. The CPU
+*	cost stays that of one view.
+*
+*	The fan out needs viewport arrays and a vertex shader that can write
+*	gl_ViewportIndex (ARB_shader_viewport_layer_array or
+*	AMD_vertex_shader_viewport_index). Without them each draw is repeated
+*	once per view with its own viewport.
+*
+*	Shaders that take part use the arrays views, projections and, when they
+*	light, viewPositions, indexed by
+*		viewFirst + gl_InstanceID % viewCount
+*	and write gl_ViewportIndex when VIEW_INSTANCED is defined. Their source is
+*	passed through UViewShaderSource, which sets the version and extensions.
+*
+*	Command line:
+*		--views <count>				1, 2 (perspective and orthographic side by side) or
+*									4 (plus top and side views), default 1
+*/
+
+#pragma once
+
+#include <string>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#define VIEW_MAX 4
+
+enum ViewPath {
+	VIEW_PATH_SINGLE,			// one view, nothing to fan out
+	VIEW_PATH_INSTANCED,		// one draw fanned out to every view by instancing
+	VIEW_PATH_PASSES			// one draw per view, for contexts without viewport arrays
+};
+
+struct ViewOptions {
+	int count;
+};
+
+// One view of the scene and the part of the target it covers
+struct SceneView {
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec3 eye;
+	float x;					// viewport as fractions of the target, origin at the bottom left
+	float y;
+	float width;
+	float height;
+};
+
+// Reads the view options out of the command line, returns false on a malformed argument
+bool UParseViewOptions(int argc, char* argv[], ViewOptions& options);
+
+// Picks how the views are drawn on this context, call once the GL context exists and before
+// any shader that takes part is submitted
+void UViewInit(const ViewOptions& options);
+
+int UViewCount(void);
+ViewPath UViewPath(void);
+
+// Instances each instance is drawn as, and the divisor of every instanced attribute
+int UViewFanOut(void);
+
+// Times each draw is submitted, one per view on VIEW_PATH_PASSES and once otherwise
+int UViewPasses(void);
+
+// source with its #version line replaced by what the view path needs, never below the version it asked for
+std::string UViewShaderSource(const char* source);
+
+// Lays out this frame's views: the camera's own perspective view first, then orthographic views
+// framing radius around center, looking the way the camera does, down from the top and in from
+// the side. aspect is the whole target's width over height.
+void UViewLayout(const glm::mat4& view, const glm::vec3& eye, float fieldOfView, float aspect,
+	const glm::vec3& center, float radius, SceneView* views);
+
+// Points one viewport at each view over a width x height target, call once per frame after the
+// target is bound
+void UViewSetViewports(const SceneView* views, int width, int height);
+
+// Uploads the views into program, which must be in use
+void UViewSetUniforms(GLuint program, const SceneView* views);
+
+// Starts draw pass number pass of program, on VIEW_PATH_PASSES by moving the viewport to that
+// view of a width x height target
+void UViewBeginPass(GLuint program, int pass, const SceneView* views, int width, int height);
+
+// Finds the view under window position x, y (origin at the top left) of a width x height window
+// and returns its index, with the position and size in that view's own pixels
+int UViewAt(int x, int y, int width, int height, const SceneView* views, int& viewX, int& viewY, int& viewWidth, int& viewHeight);
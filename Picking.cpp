@@ -0,0 +1,650 @@
+/*
+*	Title:	Final Project / Picking.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Hierarchy build and ray traversal. Splits are picked from 16
+*	centroid bins per axis, costed in packets rather than triangles since a
+*	packet is what a leaf test pays for, and the subtrees near the root are
+*	built as tasks of their own. Traversal keeps a stack of nodes with
+*	their entry distances, visits the nearer child first and drops anything
+*	that starts beyond the closest hit so far. Packet tests are Moller-Trumbore
+*	across lanes with the lane masks combined before a single movemask.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PICK_AVX 1
+#define PICK_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PICK_SSE2 1
+#define PICK_LANES 4
+#else
+#define PICK_LANES 4
+#endif
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Picking.h"
+#include "TaskScheduler.h"
+
+using namespace std; // standard namespace
+
+#define PICK_BINS 16
+#define PICK_PACKET_FLOATS (9 * PICK_LANES)	// v0, edge 1, edge 2, each as x / y / z lanes
+#define PICK_MAX_LEAF (4 * PICK_LANES)		// leaves may stay this big when splitting does not pay
+#define PICK_STACK 64
+#define PICK_EPSILON 1e-12f					// smallest determinant counted as a hit
+#define PICK_PARALLEL_MIN (1 << 14)			// triangles below which a subtree is not worth a task
+
+// Scene picked by UPickScene
+static vector<PickBvh> pickMeshes;
+static vector<glm::mat4> pickInverses;		// world-to-instance, one per instance
+static vector<PickNode> pickInstanceBounds;	// box around every mesh of an instance, in world space
+
+
+// Axis-aligned box
+struct PickBox {
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+};
+
+
+static inline void UBoxEmpty(PickBox& box) {
+
+	box.boundsMin = glm::vec3(INFINITY);
+	box.boundsMax = glm::vec3(-INFINITY);
+
+}
+
+
+// Component by component, the build runs these tens of millions of times
+static inline void UBoxGrow(PickBox& box, const glm::vec3& point) {
+
+	for (int axis = 0; axis < 3; axis++) {
+		box.boundsMin[axis] = min(box.boundsMin[axis], point[axis]);
+		box.boundsMax[axis] = max(box.boundsMax[axis], point[axis]);
+	}
+
+}
+
+
+static inline void UBoxGrow(PickBox& box, const PickBox& other) {
+
+	for (int axis = 0; axis < 3; axis++) {
+		box.boundsMin[axis] = min(box.boundsMin[axis], other.boundsMin[axis]);
+		box.boundsMax[axis] = max(box.boundsMax[axis], other.boundsMax[axis]);
+	}
+
+}
+
+
+// Half the surface area, which is all the heuristic needs
+static inline float UBoxArea(const PickBox& box) {
+
+	glm::vec3 size = box.boundsMax - box.boundsMin;
+	return (size.x < 0.0f) ? 0.0f : size.x * size.y + size.y * size.z + size.z * size.x;
+
+}
+
+
+static inline int UPacketCount(int triangles) {
+
+	return (triangles + PICK_LANES - 1) / PICK_LANES;
+
+}
+
+
+// A triangle as the build sees it, moved around as the build sorts triangles into leaves
+struct PickReference {
+	PickBox bounds;
+	glm::vec3 centroid;
+	unsigned int triangle;
+};
+
+// Build state of one hierarchy, or of a subtree built as its own task
+struct PickBuild {
+	const Mesh* mesh;
+	PickReference* references;		// shared by every task, grouped by leaf as the build goes
+	PickBvh* bvh;					// where nodes and packets go
+	int spawnDepth;					// subtrees above this depth may go to another task
+};
+
+
+static glm::vec3 UVertexPosition(const Mesh& mesh, unsigned int index) {
+
+	const float* v = &mesh.vertices[index * VERTEX_FLOATS];
+	return glm::vec3(v[0], v[1], v[2]);
+
+}
+
+
+// Writes references [begin, end) as packets, padding the last one with degenerate lanes
+static void UEmitLeaf(PickBuild& build, int node, int begin, int end) {
+
+	PickBvh& bvh = *build.bvh;
+	const Mesh& mesh = *build.mesh;
+	int packetCount = UPacketCount(end - begin);
+	size_t firstPacket = bvh.triangles.size() / PICK_LANES;
+	bvh.nodes[node].first = (int)firstPacket;
+	bvh.nodes[node].count = packetCount;
+	bvh.packets.resize((firstPacket + packetCount) * PICK_PACKET_FLOATS, 0.0f);
+
+	for (int p = 0; p < packetCount; p++) {
+		float* packet = &bvh.packets[(firstPacket + p) * PICK_PACKET_FLOATS];
+		for (int lane = 0; lane < PICK_LANES; lane++) {
+			int i = begin + p * PICK_LANES + min(lane, end - begin - p * PICK_LANES - 1);
+			unsigned int triangle = build.references[i].triangle;
+			bvh.triangles.push_back(triangle);
+			if (begin + p * PICK_LANES + lane >= end) {
+				continue; // padding, all zero edges never hit
+			}
+
+			glm::vec3 v0 = UVertexPosition(mesh, mesh.indices[triangle * 3]);
+			glm::vec3 e1 = UVertexPosition(mesh, mesh.indices[triangle * 3 + 1]) - v0;
+			glm::vec3 e2 = UVertexPosition(mesh, mesh.indices[triangle * 3 + 2]) - v0;
+			const float values[9] = { v0.x, v0.y, v0.z, e1.x, e1.y, e1.z, e2.x, e2.y, e2.z };
+			for (int k = 0; k < 9; k++) {
+				packet[k * PICK_LANES + lane] = values[k];
+			}
+		}
+	}
+
+}
+
+
+// Builds node from references [begin, end), then its children
+static void UBuildNode(PickBuild& build, int node, int begin, int end, int depth) {
+
+	PickBox bounds;
+	PickBox centroidBounds;
+	UBoxEmpty(bounds);
+	UBoxEmpty(centroidBounds);
+	for (int i = begin; i < end; i++) {
+		UBoxGrow(bounds, build.references[i].bounds);
+		UBoxGrow(centroidBounds, build.references[i].centroid);
+	}
+	PickNode& written = build.bvh->nodes[node];
+	memcpy(written.boundsMin, &bounds.boundsMin[0], sizeof(written.boundsMin));
+	memcpy(written.boundsMax, &bounds.boundsMax[0], sizeof(written.boundsMax));
+
+	int count = end - begin;
+	if (count <= PICK_LANES || depth >= PICK_STACK - 2) {
+		UEmitLeaf(build, node, begin, end);
+		return;
+	}
+
+	// Bin the centroids along all three axes in one pass
+	glm::vec3 extent = centroidBounds.boundsMax - centroidBounds.boundsMin;
+	glm::vec3 scale;
+	for (int axis = 0; axis < 3; axis++) {
+		scale[axis] = (extent[axis] > 0.0f) ? PICK_BINS / extent[axis] : 0.0f;
+	}
+	PickBox binBoxes[3][PICK_BINS];
+	int binCounts[3][PICK_BINS] = { { 0 } };
+	for (int axis = 0; axis < 3; axis++) {
+		for (int b = 0; b < PICK_BINS; b++) {
+			UBoxEmpty(binBoxes[axis][b]);
+		}
+	}
+	for (int i = begin; i < end; i++) {
+		const PickReference& reference = build.references[i];
+		for (int axis = 0; axis < 3; axis++) {
+			int b = min(PICK_BINS - 1, (int)((reference.centroid[axis] - centroidBounds.boundsMin[axis]) * scale[axis]));
+			binCounts[axis][b]++;
+			UBoxGrow(binBoxes[axis][b], reference.bounds);
+		}
+	}
+
+	// Cheapest plane, in packets tested per unit of parent area
+	float bestCost = INFINITY;
+	int bestAxis = -1;
+	int bestBin = 0;
+	for (int axis = 0; axis < 3; axis++) {
+		if (extent[axis] <= 0.0f) {
+			continue;
+		}
+
+		// Sweep from the right to get every right-hand side, then from the left to cost each plane
+		float rightAreas[PICK_BINS];
+		int rightCounts[PICK_BINS];
+		PickBox sweep;
+		UBoxEmpty(sweep);
+		int sweepCount = 0;
+		for (int b = PICK_BINS - 1; b > 0; b--) {
+			UBoxGrow(sweep, binBoxes[axis][b]);
+			sweepCount += binCounts[axis][b];
+			rightAreas[b] = UBoxArea(sweep);
+			rightCounts[b] = sweepCount;
+		}
+		UBoxEmpty(sweep);
+		sweepCount = 0;
+		for (int b = 0; b < PICK_BINS - 1; b++) {
+			UBoxGrow(sweep, binBoxes[axis][b]);
+			sweepCount += binCounts[axis][b];
+			if (sweepCount == 0 || rightCounts[b + 1] == 0) {
+				continue;
+			}
+			float cost = UBoxArea(sweep) * UPacketCount(sweepCount) + rightAreas[b + 1] * UPacketCount(rightCounts[b + 1]);
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = b;
+			}
+		}
+	}
+
+	// Stop when testing every packet here is cheaper than one more level, which costs about a packet
+	float area = UBoxArea(bounds);
+	float leafCost = (float)UPacketCount(count);
+	bool split = bestAxis >= 0 && (area <= 0.0f || 1.0f + bestCost / area < leafCost);
+	if (!split && count <= PICK_MAX_LEAF) {
+		UEmitLeaf(build, node, begin, end);
+		return;
+	}
+
+	int middle;
+	if (bestAxis >= 0) {
+		float axisScale = scale[bestAxis];
+		float planeMin = centroidBounds.boundsMin[bestAxis];
+		middle = (int)(partition(build.references + begin, build.references + end, [&](const PickReference& reference) {
+			return min(PICK_BINS - 1, (int)((reference.centroid[bestAxis] - planeMin) * axisScale)) <= bestBin;
+		}) - build.references);
+	}
+	else {
+		middle = begin + count / 2; // every centroid in one spot, any halving will do
+	}
+
+	int left = (int)build.bvh->nodes.size();
+	build.bvh->nodes[node].first = left;
+	build.bvh->nodes[node].count = 0;
+	build.bvh->nodes.resize(left + 2);
+	if (depth >= build.spawnDepth || end - middle < PICK_PARALLEL_MIN) {
+		UBuildNode(build, left, begin, middle, depth + 1);
+		UBuildNode(build, left + 1, middle, end, depth + 1);
+		return;
+	}
+
+	// The right subtree goes into a hierarchy of its own as another task, then is appended
+	PickBvh rightBvh;
+	rightBvh.nodes.resize(1);
+	PickBuild rightBuild = build;
+	rightBuild.bvh = &rightBvh;
+	TaskCounter rightDone;
+	UTaskRun([&rightBuild, middle, end, depth] { UBuildNode(rightBuild, 0, middle, end, depth + 1); }, &rightDone);
+	UBuildNode(build, left, begin, middle, depth + 1);
+	UTaskWait(rightDone);
+
+	PickBvh& bvh = *build.bvh;
+	int nodeOffset = (int)bvh.nodes.size() - 1; // the right root takes the slot reserved for it
+	int packetOffset = (int)(bvh.triangles.size() / PICK_LANES);
+	for (size_t i = 0; i < rightBvh.nodes.size(); i++) {
+		PickNode moved = rightBvh.nodes[i];
+		moved.first += (moved.count > 0) ? packetOffset : nodeOffset;
+		if (i == 0) {
+			bvh.nodes[left + 1] = moved;
+		}
+		else {
+			bvh.nodes.push_back(moved);
+		}
+	}
+	bvh.packets.insert(bvh.packets.end(), rightBvh.packets.begin(), rightBvh.packets.end());
+	bvh.triangles.insert(bvh.triangles.end(), rightBvh.triangles.begin(), rightBvh.triangles.end());
+
+}
+
+
+void UBvhBuild(const Mesh& mesh, PickBvh& bvh) {
+
+	size_t triangleCount = mesh.indices.size() / 3;
+	bvh.nodes.clear();
+	bvh.packets.clear();
+	bvh.triangles.clear();
+	bvh.triangleCount = triangleCount;
+
+	vector<PickReference> references(triangleCount);
+	for (size_t t = 0; t < triangleCount; t++) {
+		PickReference& reference = references[t];
+		UBoxEmpty(reference.bounds);
+		for (int corner = 0; corner < 3; corner++) {
+			UBoxGrow(reference.bounds, UVertexPosition(mesh, mesh.indices[t * 3 + corner]));
+		}
+		reference.centroid = (reference.bounds.boundsMin + reference.bounds.boundsMax) * 0.5f;
+		reference.triangle = (unsigned int)t;
+	}
+
+	bvh.nodes.reserve(2 * UPacketCount((int)triangleCount) + 1);
+	bvh.packets.reserve((UPacketCount((int)triangleCount) + 1) * PICK_PACKET_FLOATS);
+	bvh.nodes.resize(1);
+	if (triangleCount == 0) {
+		memset(&bvh.nodes[0], 0, sizeof(PickNode));
+		return;
+	}
+
+	// Every split above spawnDepth hands one side to a new task, so the tasks double per level
+	PickBuild build;
+	build.mesh = &mesh;
+	build.references = references.data();
+	build.bvh = &bvh;
+	build.spawnDepth = 0;
+	while ((1 << build.spawnDepth) < UTaskThreadCount()) {
+		build.spawnDepth++;
+	}
+	UBuildNode(build, 0, 0, (int)triangleCount, 0);
+
+}
+
+
+// Ray with its reciprocal direction, for the slab tests
+struct PickRay {
+	glm::vec3 origin;
+	glm::vec3 direction;
+	glm::vec3 inverse;
+};
+
+
+// Distance at which the ray enters the node's box, INFINITY if it misses or enters beyond limit
+static inline float UNodeEntry(const PickNode& node, const PickRay& ray, float limit) {
+
+	float entry = 0.0f;
+	float exit = limit;
+	for (int axis = 0; axis < 3; axis++) {
+		float t0 = (node.boundsMin[axis] - ray.origin[axis]) * ray.inverse[axis];
+		float t1 = (node.boundsMax[axis] - ray.origin[axis]) * ray.inverse[axis];
+		entry = max(entry, min(t0, t1));
+		exit = min(exit, max(t0, t1));
+	}
+	return (entry <= exit) ? entry : INFINITY;
+
+}
+
+
+// Tests every lane of one packet, keeps the nearest hit closer than best
+static inline bool UIntersectPacket(const float* packet, const PickRay& ray, float& best, int& bestLane) {
+
+#if defined(PICK_AVX) || defined(PICK_SSE2)
+#ifdef PICK_AVX
+	typedef __m256 Lanes;
+#define LANES_LOAD(k) _mm256_loadu_ps(packet + (k) * PICK_LANES)
+#define LANES_SET _mm256_set1_ps
+#define LANES_ADD _mm256_add_ps
+#define LANES_SUB _mm256_sub_ps
+#define LANES_MUL _mm256_mul_ps
+#define LANES_DIV _mm256_div_ps
+#define LANES_AND _mm256_and_ps
+#define LANES_ANDNOT _mm256_andnot_ps
+#define LANES_GREATER(a, b) _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#define LANES_GREATER_EQUAL(a, b) _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+#define LANES_MASK _mm256_movemask_ps
+#define LANES_STORE _mm256_storeu_ps
+#else
+	typedef __m128 Lanes;
+#define LANES_LOAD(k) _mm_loadu_ps(packet + (k) * PICK_LANES)
+#define LANES_SET _mm_set1_ps
+#define LANES_ADD _mm_add_ps
+#define LANES_SUB _mm_sub_ps
+#define LANES_MUL _mm_mul_ps
+#define LANES_DIV _mm_div_ps
+#define LANES_AND _mm_and_ps
+#define LANES_ANDNOT _mm_andnot_ps
+#define LANES_GREATER(a, b) _mm_cmpgt_ps(a, b)
+#define LANES_GREATER_EQUAL(a, b) _mm_cmpge_ps(a, b)
+#define LANES_MASK _mm_movemask_ps
+#define LANES_STORE _mm_storeu_ps
+#endif
+
+	Lanes dx = LANES_SET(ray.direction.x), dy = LANES_SET(ray.direction.y), dz = LANES_SET(ray.direction.z);
+	Lanes e1x = LANES_LOAD(3), e1y = LANES_LOAD(4), e1z = LANES_LOAD(5);
+	Lanes e2x = LANES_LOAD(6), e2y = LANES_LOAD(7), e2z = LANES_LOAD(8);
+
+	// p = d x e2, det = e1 . p
+	Lanes px = LANES_SUB(LANES_MUL(dy, e2z), LANES_MUL(dz, e2y));
+	Lanes py = LANES_SUB(LANES_MUL(dz, e2x), LANES_MUL(dx, e2z));
+	Lanes pz = LANES_SUB(LANES_MUL(dx, e2y), LANES_MUL(dy, e2x));
+	Lanes det = LANES_ADD(LANES_ADD(LANES_MUL(e1x, px), LANES_MUL(e1y, py)), LANES_MUL(e1z, pz));
+	Lanes inverseDet = LANES_DIV(LANES_SET(1.0f), det);
+
+	// s = o - v0, u = s . p / det
+	Lanes sx = LANES_SUB(LANES_SET(ray.origin.x), LANES_LOAD(0));
+	Lanes sy = LANES_SUB(LANES_SET(ray.origin.y), LANES_LOAD(1));
+	Lanes sz = LANES_SUB(LANES_SET(ray.origin.z), LANES_LOAD(2));
+	Lanes u = LANES_MUL(LANES_ADD(LANES_ADD(LANES_MUL(sx, px), LANES_MUL(sy, py)), LANES_MUL(sz, pz)), inverseDet);
+
+	// q = s x e1, v = d . q / det, t = e2 . q / det
+	Lanes qx = LANES_SUB(LANES_MUL(sy, e1z), LANES_MUL(sz, e1y));
+	Lanes qy = LANES_SUB(LANES_MUL(sz, e1x), LANES_MUL(sx, e1z));
+	Lanes qz = LANES_SUB(LANES_MUL(sx, e1y), LANES_MUL(sy, e1x));
+	Lanes v = LANES_MUL(LANES_ADD(LANES_ADD(LANES_MUL(dx, qx), LANES_MUL(dy, qy)), LANES_MUL(dz, qz)), inverseDet);
+	Lanes t = LANES_MUL(LANES_ADD(LANES_ADD(LANES_MUL(e2x, qx), LANES_MUL(e2y, qy)), LANES_MUL(e2z, qz)), inverseDet);
+
+	// |det| clears the sign bit, NaN lanes from padding fail every compare
+	Lanes zero = LANES_SET(0.0f);
+	Lanes mask = LANES_GREATER(LANES_ANDNOT(LANES_SET(-0.0f), det), LANES_SET(PICK_EPSILON));
+	mask = LANES_AND(mask, LANES_GREATER_EQUAL(u, zero));
+	mask = LANES_AND(mask, LANES_GREATER_EQUAL(v, zero));
+	mask = LANES_AND(mask, LANES_GREATER_EQUAL(LANES_SET(1.0f), LANES_ADD(u, v)));
+	mask = LANES_AND(mask, LANES_GREATER(t, zero));
+	mask = LANES_AND(mask, LANES_GREATER(LANES_SET(best), t));
+	int hits = LANES_MASK(mask);
+	if (hits == 0) {
+		return false;
+	}
+
+	float distances[PICK_LANES];
+	LANES_STORE(distances, t);
+	for (int lane = 0; lane < PICK_LANES; lane++) {
+		if ((hits & (1 << lane)) && distances[lane] < best) {
+			best = distances[lane];
+			bestLane = lane;
+		}
+	}
+	return true;
+
+#undef LANES_LOAD
+#undef LANES_SET
+#undef LANES_ADD
+#undef LANES_SUB
+#undef LANES_MUL
+#undef LANES_DIV
+#undef LANES_AND
+#undef LANES_ANDNOT
+#undef LANES_GREATER
+#undef LANES_GREATER_EQUAL
+#undef LANES_MASK
+#undef LANES_STORE
+#else
+	bool found = false;
+	for (int lane = 0; lane < PICK_LANES; lane++) {
+		glm::vec3 v0(packet[lane], packet[PICK_LANES + lane], packet[2 * PICK_LANES + lane]);
+		glm::vec3 e1(packet[3 * PICK_LANES + lane], packet[4 * PICK_LANES + lane], packet[5 * PICK_LANES + lane]);
+		glm::vec3 e2(packet[6 * PICK_LANES + lane], packet[7 * PICK_LANES + lane], packet[8 * PICK_LANES + lane]);
+		glm::vec3 p = glm::cross(ray.direction, e2);
+		float det = glm::dot(e1, p);
+		if (fabs(det) <= PICK_EPSILON) {
+			continue;
+		}
+		float inverseDet = 1.0f / det;
+		glm::vec3 s = ray.origin - v0;
+		float u = glm::dot(s, p) * inverseDet;
+		glm::vec3 q = glm::cross(s, e1);
+		float v = glm::dot(ray.direction, q) * inverseDet;
+		float t = glm::dot(e2, q) * inverseDet;
+		if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t > 0.0f && t < best) {
+			best = t;
+			bestLane = lane;
+			found = true;
+		}
+	}
+	return found;
+#endif
+
+}
+
+
+bool UBvhIntersect(const PickBvh& bvh, const glm::vec3& origin, const glm::vec3& direction, PickHit& hit) {
+
+	if (bvh.triangleCount == 0) {
+		return false;
+	}
+	PickRay ray;
+	ray.origin = origin;
+	ray.direction = direction;
+	ray.inverse = 1.0f / direction; // zero components give infinities, which the slab test handles
+
+	struct Entry {
+		int node;
+		float distance;
+	};
+	Entry stack[PICK_STACK];
+	int depth = 0;
+	float rootEntry = UNodeEntry(bvh.nodes[0], ray, hit.distance);
+	if (rootEntry == INFINITY) {
+		return false;
+	}
+	stack[depth++] = { 0, rootEntry };
+
+	bool found = false;
+	while (depth > 0) {
+		Entry entry = stack[--depth];
+		if (entry.distance >= hit.distance) {
+			continue; // a closer hit turned up since this was pushed
+		}
+		const PickNode& node = bvh.nodes[entry.node];
+
+		if (node.count > 0) {
+			for (int p = 0; p < node.count; p++) {
+				int lane = -1;
+				if (UIntersectPacket(&bvh.packets[(size_t)(node.first + p) * PICK_PACKET_FLOATS], ray, hit.distance, lane)) {
+					hit.triangle = bvh.triangles[(size_t)(node.first + p) * PICK_LANES + lane];
+					found = true;
+				}
+			}
+			continue;
+		}
+
+		// Push the farther child first so the nearer one is visited next
+		float leftEntry = UNodeEntry(bvh.nodes[node.first], ray, hit.distance);
+		float rightEntry = UNodeEntry(bvh.nodes[node.first + 1], ray, hit.distance);
+		Entry left = { node.first, leftEntry };
+		Entry right = { node.first + 1, rightEntry };
+		if (leftEntry < rightEntry) {
+			swap(left, right);
+		}
+		if (left.distance != INFINITY) {
+			stack[depth++] = left;
+		}
+		if (right.distance != INFINITY) {
+			stack[depth++] = right;
+		}
+	}
+	return found;
+
+}
+
+
+void UPickClear(void) {
+
+	pickMeshes.clear();
+	pickInverses.clear();
+	pickInstanceBounds.clear();
+
+}
+
+
+int UPickAddMesh(const Mesh& mesh) {
+
+	pickMeshes.push_back(PickBvh());
+	UBvhBuild(mesh, pickMeshes.back());
+	return (int)pickMeshes.size() - 1;
+
+}
+
+
+int UPickAddBvh(PickBvh& bvh) {
+
+	pickMeshes.push_back(PickBvh());
+	swap(pickMeshes.back(), bvh);
+	return (int)pickMeshes.size() - 1;
+
+}
+
+
+void UPickSetInstances(const vector<glm::mat4>& transforms) {
+
+	// Box around every mesh's root, then around its corners once transformed
+	PickBox meshBounds;
+	UBoxEmpty(meshBounds);
+	for (size_t m = 0; m < pickMeshes.size(); m++) {
+		if (pickMeshes[m].triangleCount > 0) {
+			const PickNode& root = pickMeshes[m].nodes[0];
+			UBoxGrow(meshBounds, glm::vec3(root.boundsMin[0], root.boundsMin[1], root.boundsMin[2]));
+			UBoxGrow(meshBounds, glm::vec3(root.boundsMax[0], root.boundsMax[1], root.boundsMax[2]));
+		}
+	}
+
+	pickInverses.resize(transforms.size());
+	pickInstanceBounds.resize(transforms.size());
+	for (size_t i = 0; i < transforms.size(); i++) {
+		pickInverses[i] = glm::inverse(transforms[i]);
+		PickBox bounds;
+		UBoxEmpty(bounds);
+		for (int corner = 0; corner < 8; corner++) {
+			glm::vec3 point((corner & 1) ? meshBounds.boundsMax.x : meshBounds.boundsMin.x, (corner & 2) ? meshBounds.boundsMax.y : meshBounds.boundsMin.y,
+				(corner & 4) ? meshBounds.boundsMax.z : meshBounds.boundsMin.z);
+			UBoxGrow(bounds, glm::vec3(transforms[i] * glm::vec4(point, 1.0f)));
+		}
+		memcpy(pickInstanceBounds[i].boundsMin, &bounds.boundsMin[0], sizeof(pickInstanceBounds[i].boundsMin));
+		memcpy(pickInstanceBounds[i].boundsMax, &bounds.boundsMax[0], sizeof(pickInstanceBounds[i].boundsMax));
+	}
+
+}
+
+
+void UPickRay(int x, int y, int width, int height, const glm::mat4& view, const glm::mat4& projection, glm::vec3& origin, glm::vec3& direction) {
+
+	glm::vec4 viewport(0.0f, 0.0f, (float)width, (float)height);
+	glm::vec3 window((float)x + 0.5f, (float)(height - y) - 0.5f, 0.0f); // pixel center, GL counts rows up
+	origin = glm::unProject(window, view, projection, viewport);
+	window.z = 1.0f;
+	direction = glm::normalize(glm::unProject(window, view, projection, viewport) - origin);
+
+}
+
+
+bool UPickScene(const glm::vec3& origin, const glm::vec3& direction, const glm::mat4& model, PickHit& hit) {
+
+	hit.instance = -1;
+	hit.mesh = -1;
+	hit.triangle = 0;
+	hit.distance = INFINITY;
+
+	// Directions are not renormalized along the way, so distances stay in world units
+	glm::mat4 inverseModel = glm::inverse(model);
+	PickRay ray;
+	ray.origin = glm::vec3(inverseModel * glm::vec4(origin, 1.0f));
+	ray.direction = glm::vec3(inverseModel * glm::vec4(direction, 0.0f));
+	ray.inverse = 1.0f / ray.direction;
+	for (size_t i = 0; i < pickInverses.size(); i++) {
+		if (UNodeEntry(pickInstanceBounds[i], ray, hit.distance) == INFINITY) {
+			continue; // misses the instance, or only reaches it past a closer hit
+		}
+		glm::vec3 localOrigin = glm::vec3(pickInverses[i] * glm::vec4(ray.origin, 1.0f));
+		glm::vec3 localDirection = glm::vec3(pickInverses[i] * glm::vec4(ray.direction, 0.0f));
+		for (size_t m = 0; m < pickMeshes.size(); m++) {
+			if (UBvhIntersect(pickMeshes[m], localOrigin, localDirection, hit)) {
+				hit.instance = (int)i;
+				hit.mesh = (int)m;
+			}
+		}
+	}
+	if (hit.instance < 0) {
+		return false;
+	}
+	hit.point = origin + direction * hit.distance;
+	return true;
+
+}
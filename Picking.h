@@ -0,0 +1,70 @@
+/*
+*	Title:	Final Project / Picking.h
+*	Date:	October 19, 2026
+*
+*	Description: Ray picking against the scene's triangles. Every mesh gets a
+*	bounding volume hierarchy built with the surface area heuristic, and its
+*	leaves hold triangles in packets of 4 (8 with AVX) stored as structure of
+*	arrays, so one ray is tested against a whole packet at once. Instances
+*	share their mesh's hierarchy, the ray is moved into each instance's space
+*	instead. A click is turned into a ray through the current view and
+*	projection.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Geometry.h"
+
+// One hierarchy node, 32 bytes
+struct PickNode {
+	float boundsMin[3];
+	int first;					// leaves: first packet, interior nodes: left child, the right one follows it
+	float boundsMax[3];
+	int count;					// leaves: packets, 0 for interior nodes
+};
+
+// Hierarchy over one mesh's triangles
+struct PickBvh {
+	std::vector<PickNode> nodes;			// node 0 is the root
+	std::vector<float> packets;				// per packet: v0, edge 1, edge 2 as x / y / z lanes
+	std::vector<unsigned int> triangles;	// source triangle of every packet lane
+	size_t triangleCount;
+};
+
+// Nearest hit along a ray
+struct PickHit {
+	int instance;				// -1 when nothing was hit
+	int mesh;
+	unsigned int triangle;		// index into the mesh's triangles, i.e. indices / 3
+	float distance;				// ray parameter, world units when the direction is a unit vector
+	glm::vec3 point;			// world space
+};
+
+// Builds the hierarchy for mesh, replacing whatever bvh held
+void UBvhBuild(const Mesh& mesh, PickBvh& bvh);
+
+// Nearest hit closer than hit.distance in the mesh's own space, fills triangle and distance.
+// Start with hit.distance at the longest distance that counts.
+bool UBvhIntersect(const PickBvh& bvh, const glm::vec3& origin, const glm::vec3& direction, PickHit& hit);
+
+// Forgets every mesh and instance
+void UPickClear(void);
+
+// Adds a mesh to the pickable scene, returns its number for PickHit::mesh
+int UPickAddMesh(const Mesh& mesh);
+
+// Same with a hierarchy UBvhBuild already built, say on a task thread. Takes bvh's contents.
+int UPickAddBvh(PickBvh& bvh);
+
+// Transforms of the instances, every instance draws every mesh. Call after the meshes are added.
+void UPickSetInstances(const std::vector<glm::mat4>& transforms);
+
+// World-space ray through window pixel (x, y), y counted down from the top as GLUT does
+void UPickRay(int x, int y, int width, int height, const glm::mat4& view, const glm::mat4& projection, glm::vec3& origin, glm::vec3& direction);
+
+// Nearest instance hit by the ray, with model applied on top of every instance transform
+bool UPickScene(const glm::vec3& origin, const glm::vec3& direction, const glm::mat4& model, PickHit& hit);
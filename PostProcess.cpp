@@ -0,0 +1,696 @@
+/*
+*	Title:	Final Project / PostProcess.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Post-processing passes, their fusion into stages and the
+*	render target pool.
+*
+*	Every pass is a GLSL function. A per-pixel pass is vec3 name(vec3 color)
+*	and a neighbourhood pass, which samples around its pixel, is
+*	vec3 name(vec2 uv) reading its input through fetch(). A stage is one
+*	full-screen draw: at most one neighbourhood pass, the per-pixel passes
+*	that follow it applied to its result, and, for passes that allow it, the
+*	per-pixel passes before it applied inside fetch(). Tone mapping ahead of
+*	FXAA is fused that way, so the default chain is a single draw, or two
+*	when the upscale is needed.
+*
+*	Targets are allocated at window size and a stage draws into the lower
+*	left corner it needs, the same trick the scene uses to change resolution
+*	without reallocating.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <GL/glew.h>
+
+#include "GlState.h"
+#include "GpuResources.h"
+#include "PostProcess.h"
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+#define POST_POOL_FRAMES 120	// frames an unused target stays pooled
+
+struct PostPassInfo {
+	const char* name;		// GLSL function and --post keyword
+	bool perPixel;			// reads only its own pixel
+	bool fusesInput;		// neighbourhood pass that can run per-pixel passes on each fetch
+	const char* source;
+};
+
+// One full-screen draw
+struct PostStage {
+	int neighbourhood;		// pass sampling around its pixel, -1 for none
+	vector<int> prologue;	// per-pixel passes applied to every fetch
+	vector<int> epilogue;	// per-pixel passes applied to the result
+	bool hdrOutput;			// output still needs tone mapping
+	bool windowSized;		// runs at window size rather than render size
+	GLuint program;
+	GLint inputLoc;
+	GLint inputScaleLoc;
+	GLint texelLoc;
+	GLint exposureLoc;
+	GLint contrastLoc;
+	GLint saturationLoc;
+	GLint sharpnessLoc;
+};
+
+// Pooled render target
+struct PostTarget {
+	GLuint fbo;
+	GLuint color;
+	GLuint depth;			// 0 without a depth attachment
+	int width;
+	int height;
+	GLenum format;
+	bool inUse;
+	long long lastUsed;
+};
+
+
+// FULL-SCREEN VERTEX SHADER SOURCE CODE
+// One triangle covering the target, built from gl_VertexID
+static const char* postVertexShaderSource = 1 + R"GLSL(
+	#version 330 core
+
+	out vec2 windowCoordinate;
+
+	void main() {
+		vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+		windowCoordinate = corner;
+		gl_Position = vec4(corner * 2.0f - 1.0f, 0.0f, 1.0f);
+	}
+)GLSL";
+
+
+// Declarations every stage fragment shader starts with
+static const char* postHeaderSource = 1 + R"GLSL(
+	#version 330 core
+
+	in vec2 windowCoordinate;
+	out vec4 fragmentColor;
+
+	uniform sampler2D uInput;
+	uniform vec2 uInputScale;	// rendered part of the input, in texture coordinates
+	uniform vec2 uTexel;		// one input texel, in texture coordinates
+)GLSL";
+
+
+// TONE MAPPING
+// Identity up to the knee so the scene keeps its look, then a shoulder that approaches 1
+static const char* tonemapSource = 1 + R"GLSL(
+	uniform float uExposure;
+
+	vec3 tonemap(vec3 color) {
+		const float knee = 0.8f;
+		color *= uExposure;
+		vec3 over = max(color - knee, 0.0f);
+		vec3 shoulder = knee + (1.0f - knee) * over / (over + (1.0f - knee));
+		return mix(color, shoulder, step(knee, color));
+	}
+)GLSL";
+
+
+// FXAA
+// Edge direction from the luma of the four diagonal neighbours, then a blend along it
+static const char* fxaaSource = 1 + R"GLSL(
+	vec3 fxaa(vec2 uv) {
+		const float reduceMin = 1.0f / 128.0f;
+		const float reduceMul = 1.0f / 8.0f;
+		const float spanMax = 8.0f;
+		const vec3 lumaWeights = vec3(0.299f, 0.587f, 0.114f);
+
+		vec3 colorM = fetch(uv);
+		float lumaNW = dot(fetch(uv + vec2(-1.0f, 1.0f) * uTexel), lumaWeights);
+		float lumaNE = dot(fetch(uv + vec2(1.0f, 1.0f) * uTexel), lumaWeights);
+		float lumaSW = dot(fetch(uv + vec2(-1.0f, -1.0f) * uTexel), lumaWeights);
+		float lumaSE = dot(fetch(uv + vec2(1.0f, -1.0f) * uTexel), lumaWeights);
+		float lumaM = dot(colorM, lumaWeights);
+		float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+		float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+		vec2 dir = vec2((lumaSW + lumaSE) - (lumaNW + lumaNE), (lumaNW + lumaSW) - (lumaNE + lumaSE));
+		float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25f * reduceMul, reduceMin);
+		float rcpDirMin = 1.0f / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+		dir = clamp(dir * rcpDirMin, -spanMax, spanMax) * uTexel;
+
+		vec3 colorA = 0.5f * (fetch(uv + dir * (1.0f / 3.0f - 0.5f)) + fetch(uv + dir * (2.0f / 3.0f - 0.5f)));
+		vec3 colorB = colorA * 0.5f + 0.25f * (fetch(uv - dir * 0.5f) + fetch(uv + dir * 0.5f));
+		float lumaB = dot(colorB, lumaWeights);
+		return (lumaB < lumaMin || lumaB > lumaMax) ? colorA : colorB;
+	}
+)GLSL";
+
+
+// COLOR GRADING
+static const char* gradeSource = 1 + R"GLSL(
+	uniform float uContrast;
+	uniform float uSaturation;
+
+	vec3 grade(vec3 color) {
+		float luma = dot(color, vec3(0.2126f, 0.7152f, 0.0722f));
+		color = mix(vec3(luma), color, uSaturation);
+		color = (color - 0.5f) * uContrast + 0.5f;
+		return clamp(color, 0.0f, 1.0f);
+	}
+)GLSL";
+
+
+// UPSCALE
+// Bilinear fetch, optionally sharpened against the four neighbours
+static const char* upscaleSource = 1 + R"GLSL(
+	uniform float uSharpness;
+
+	vec3 upscale(vec2 uv) {
+		vec3 center = fetch(uv);
+		if (uSharpness > 0.0f) {
+			vec3 neighbours = fetch(uv + vec2(uTexel.x, 0.0f)) + fetch(uv - vec2(uTexel.x, 0.0f))
+				+ fetch(uv + vec2(0.0f, uTexel.y)) + fetch(uv - vec2(0.0f, uTexel.y));
+			center = clamp(center + uSharpness * (center - 0.25f * neighbours), 0.0f, 1.0f);
+		}
+		return center;
+	}
+)GLSL";
+
+
+// Indexed by PostPassType
+static const PostPassInfo passInfo[POST_PASS_TYPES] = {
+	{ "tonemap", true, false, tonemapSource },
+	{ "fxaa", false, true, fxaaSource },
+	{ "grade", true, false, gradeSource },
+	{ "upscale", false, true, upscaleSource },
+};
+
+static PostOptions postOptions;
+static vector<PostStage> chains[2];		// at full scale, and ending in the upscale
+static vector<PostTarget> pool;
+static GLuint postVAO = 0;
+static GLenum hdrFormat = GL_R11F_G11F_B10F;
+static long long postFrame = 0;
+static int passCount = 0;
+
+static bool disabled = false;			// no renderable HDR format
+
+// Current frame
+static bool direct = false;				// scene drawn straight to the window
+static int activeChain = 0;
+static int sceneTarget = -1;
+static int windowW = 0;
+static int windowH = 0;
+static int renderW = 0;
+static int renderH = 0;
+
+
+bool UParsePostOptions(int argc, char* argv[], PostOptions& options) {
+
+	options.passes.clear();
+	options.passes.push_back(POST_TONEMAP);
+	options.passes.push_back(POST_FXAA);
+	options.passes.push_back(POST_GRADE);
+	options.exposure = 0.0f;
+	options.contrast = 1.0f;
+	options.saturation = 1.0f;
+	options.sharpen = true;
+	options.sharpness = 0.5f;
+
+	const char* flags[] = { "--post", "--exposure", "--grade", "--upscale" };
+	const int flagCount = sizeof(flags) / sizeof(flags[0]);
+
+	for (int i = 1; i < argc; i++) {
+		int flag = 0;
+		while (flag < flagCount && strcmp(argv[i], flags[flag]) != 0) {
+			flag++;
+		}
+		if (flag == flagCount) {
+			continue; // not ours
+		}
+		if (i + 1 >= argc) {
+			std::cerr << argv[i] << " needs a value\n";
+			return false;
+		}
+
+		const char* value = argv[++i];
+		switch (flag) {
+		case 0: {
+			options.passes.clear();
+			if (strcmp(value, "none") == 0) {
+				break;
+			}
+			string list = value;
+			size_t start = 0;
+			while (start <= list.size()) {
+				size_t end = list.find(',', start);
+				string name = list.substr(start, end == string::npos ? string::npos : end - start);
+				int pass = 0;
+				while (pass < POST_UPSCALE && name != passInfo[pass].name) {
+					pass++;
+				}
+				if (pass == POST_UPSCALE) {
+					std::cerr << "--post expects tonemap, fxaa, grade or none, got " << name << "\n";
+					return false;
+				}
+				options.passes.push_back((PostPassType)pass);
+				if (end == string::npos) {
+					break;
+				}
+				start = end + 1;
+			}
+			break;
+		}
+		case 1: options.exposure = (float)atof(value); break;
+		case 2:
+			if (sscanf(value, "%f,%f", &options.contrast, &options.saturation) != 2) {
+				std::cerr << "--grade expects <contrast>,<saturation>, got " << value << "\n";
+				return false;
+			}
+			break;
+		case 3:
+			if (strcmp(value, "bilinear") != 0 && strcmp(value, "sharpen") != 0) {
+				std::cerr << "--upscale expects bilinear or sharpen, got " << value << "\n";
+				return false;
+			}
+			options.sharpen = strcmp(value, "sharpen") == 0;
+			break;
+		}
+	}
+	return true;
+
+}
+
+
+static PostStage UEmptyStage(bool windowSized) {
+
+	PostStage stage;
+	stage.neighbourhood = -1;
+	stage.hdrOutput = true;
+	stage.windowSized = windowSized;
+	stage.program = 0;
+	return stage;
+
+}
+
+
+// Groups a chain of passes into as few full-screen stages as fusion allows
+static vector<PostStage> UBuildStages(const vector<PostPassType>& passes) {
+
+	vector<PostStage> stages;
+	PostStage current = UEmptyStage(false);
+	bool open = false;
+	bool hdr = true;
+	bool windowSized = false;
+
+	for (size_t i = 0; i < passes.size(); i++) {
+		int pass = passes[i];
+		const PostPassInfo& info = passInfo[pass];
+
+		if (info.perPixel) {
+			if (!open) {
+				current = UEmptyStage(windowSized);
+				open = true;
+			}
+			current.epilogue.push_back(pass);
+		}
+		else if (open && current.neighbourhood < 0 && info.fusesInput) {
+			// The stage so far only has per-pixel passes, run them on this pass's fetches instead
+			current.prologue = current.epilogue;
+			current.epilogue.clear();
+			current.neighbourhood = pass;
+		}
+		else {
+			if (open) {
+				stages.push_back(current);
+			}
+			current = UEmptyStage(windowSized);
+			current.neighbourhood = pass;
+			open = true;
+		}
+
+		if (pass == POST_TONEMAP) {
+			hdr = false;
+		}
+		if (pass == POST_UPSCALE) {
+			windowSized = true;
+			current.windowSized = true;
+		}
+		current.hdrOutput = hdr;
+	}
+
+	// An empty chain still copies the scene to the window
+	if (!open) {
+		current = UEmptyStage(true);
+	}
+	stages.push_back(current);
+	return stages;
+
+}
+
+
+static string UStageSource(const PostStage& stage) {
+
+	string source = postHeaderSource;
+
+	// Per-pixel functions first, then the fetch that applies the prologue, then the pass that calls it
+	vector<bool> included(POST_PASS_TYPES, false);
+	vector<int> perPixel = stage.prologue;
+	perPixel.insert(perPixel.end(), stage.epilogue.begin(), stage.epilogue.end());
+	for (size_t i = 0; i < perPixel.size(); i++) {
+		if (!included[perPixel[i]]) {
+			source += passInfo[perPixel[i]].source;
+			included[perPixel[i]] = true;
+		}
+	}
+
+	source += "\tvec3 fetch(vec2 uv) {\n";
+	source += "\t\tvec3 color = texture(uInput, clamp(uv, 0.5f * uTexel, uInputScale - 0.5f * uTexel)).rgb;\n";
+	for (size_t i = 0; i < stage.prologue.size(); i++) {
+		source += string("\t\tcolor = ") + passInfo[stage.prologue[i]].name + "(color);\n";
+	}
+	source += "\t\treturn color;\n\t}\n";
+
+	if (stage.neighbourhood >= 0) {
+		source += passInfo[stage.neighbourhood].source;
+	}
+
+	source += "\tvoid main() {\n";
+	source += "\t\tvec2 uv = windowCoordinate * uInputScale;\n";
+	source += string("\t\tvec3 color = ") + (stage.neighbourhood >= 0 ? passInfo[stage.neighbourhood].name : "fetch") + "(uv);\n";
+	for (size_t i = 0; i < stage.epilogue.size(); i++) {
+		source += string("\t\tcolor = ") + passInfo[stage.epilogue[i]].name + "(color);\n";
+	}
+	source += "\t\tfragmentColor = vec4(color, 1.0f);\n\t}\n";
+	return source;
+
+}
+
+
+static void UCompilePostShader(GLuint program, GLenum type, const char* source) {
+
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 1, &source, NULL);
+	glCompileShader(shader);
+
+	GLint status = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	if (status != GL_TRUE) {
+		GLchar log[1 << 11] = { 0 };
+		glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+		std::cerr << log << "\n" << source << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+	glAttachShader(program, shader);
+	glDeleteShader(shader);
+
+}
+
+
+static void UCreateStageProgram(PostStage& stage) {
+
+	string fragmentSource = UStageSource(stage);
+	stage.program = UGpuCreateProgram("post stage program");
+	UCompilePostShader(stage.program, GL_VERTEX_SHADER, postVertexShaderSource);
+	UCompilePostShader(stage.program, GL_FRAGMENT_SHADER, fragmentSource.c_str());
+	glLinkProgram(stage.program);
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(stage.program, GL_LINK_STATUS, &status);
+	if (status != GL_TRUE) {
+		GLchar log[1 << 11] = { 0 };
+		glGetProgramInfoLog(stage.program, sizeof(log), NULL, log);
+		std::cerr << log << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+
+	stage.inputLoc = glGetUniformLocation(stage.program, "uInput");
+	stage.inputScaleLoc = glGetUniformLocation(stage.program, "uInputScale");
+	stage.texelLoc = glGetUniformLocation(stage.program, "uTexel");
+	stage.exposureLoc = glGetUniformLocation(stage.program, "uExposure");
+	stage.contrastLoc = glGetUniformLocation(stage.program, "uContrast");
+	stage.saturationLoc = glGetUniformLocation(stage.program, "uSaturation");
+	stage.sharpnessLoc = glGetUniformLocation(stage.program, "uSharpness");
+
+}
+
+
+void UPostInit(const PostOptions& options) {
+
+	postOptions = options;
+
+	vector<PostPassType> upscaled = options.passes;
+	upscaled.push_back(POST_UPSCALE);
+	chains[0] = UBuildStages(options.passes);
+	chains[1] = UBuildStages(upscaled);
+	for (int c = 0; c < 2; c++) {
+		for (size_t i = 0; i < chains[c].size(); i++) {
+			UCreateStageProgram(chains[c][i]);
+		}
+	}
+
+	// The full-screen triangle has no attributes but core profiles still need a VAO bound
+	postVAO = UGpuGenVertexArray("post VAO");
+
+}
+
+
+static void UDeleteTarget(PostTarget& target) {
+
+	UGpuDeleteFramebuffer(target.fbo);
+	UGpuDeleteTexture(target.color);
+	UGpuDeleteTexture(target.depth);
+
+}
+
+
+// Hands out a free pooled target of this size and format, creating one if none fits. -1 if the
+// format cannot be rendered to.
+static int UAcquireTarget(int width, int height, GLenum format, bool depth) {
+
+	for (size_t i = 0; i < pool.size(); i++) {
+		PostTarget& target = pool[i];
+		if (!target.inUse && target.width == width && target.height == height && target.format == format && (target.depth != 0) == depth) {
+			target.inUse = true;
+			target.lastUsed = postFrame;
+			return (int)i;
+		}
+	}
+
+	PostTarget target;
+	target.width = width;
+	target.height = height;
+	target.format = format;
+	target.inUse = true;
+	target.lastUsed = postFrame;
+	target.depth = 0;
+
+	target.color = UGpuGenTexture("post target color");
+	UStateBindTexture(0, GL_TEXTURE_2D, target.color);
+	UGpuTexImage2D(GL_TEXTURE_2D, target.color, 0, format, width, height, GL_RGBA, format == GL_RGBA8 ? GL_UNSIGNED_BYTE : GL_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	if (depth) {
+		target.depth = UGpuGenTexture("post target depth");
+		UStateBindTexture(0, GL_TEXTURE_2D, target.depth);
+		UGpuTexImage2D(GL_TEXTURE_2D, target.depth, 0, GL_DEPTH_COMPONENT24, width, height, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	}
+	UStateBindTexture(0, GL_TEXTURE_2D, 0);
+
+	target.fbo = UGpuGenFramebuffer("post target");
+	glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.color, 0);
+	if (depth) {
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, target.depth, 0);
+	}
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE) {
+		UDeleteTarget(target);
+		return -1;
+	}
+	pool.push_back(target);
+	return (int)pool.size() - 1;
+
+}
+
+
+static void UReleaseTarget(int target) {
+
+	if (target >= 0) {
+		pool[target].inUse = false;
+	}
+
+}
+
+
+// Deletes targets nothing has asked for in a while, such as those sized for an old window
+static void UTrimPool(void) {
+
+	for (size_t i = pool.size(); i-- > 0;) {
+		if (!pool[i].inUse && postFrame - pool[i].lastUsed > POST_POOL_FRAMES) {
+			UDeleteTarget(pool[i]);
+			pool.erase(pool.begin() + i);
+		}
+	}
+
+}
+
+
+void UPostBeginScene(int windowWidth, int windowHeight, float scale) {
+
+	postFrame++;
+	windowW = max(1, windowWidth);
+	windowH = max(1, windowHeight);
+	renderW = max(1, (int)(windowW * scale + 0.5f));
+	renderH = max(1, (int)(windowH * scale + 0.5f));
+	activeChain = (renderW == windowW && renderH == windowH) ? 0 : 1;
+
+	// Nothing to post-process, draw the scene straight to the window
+	direct = disabled || (activeChain == 0 && postOptions.passes.empty());
+	if (!direct) {
+		sceneTarget = UAcquireTarget(windowW, windowH, hdrFormat, true);
+		if (sceneTarget < 0 && hdrFormat != GL_RGBA16F) {
+			std::cerr << "R11F_G11F_B10F is not renderable here, using RGBA16F for HDR targets\n";
+			hdrFormat = GL_RGBA16F;
+			sceneTarget = UAcquireTarget(windowW, windowH, hdrFormat, true);
+		}
+		if (sceneTarget < 0) {
+			std::cerr << "No renderable HDR format, post-processing and resolution scaling are off\n";
+			disabled = true;
+			direct = true;
+		}
+	}
+	if (direct) {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(0, 0, windowW, windowH);
+		return;
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, pool[sceneTarget].fbo);
+	glViewport(0, 0, renderW, renderH);
+
+	// Clears only touch the rendered corner
+	glScissor(0, 0, renderW, renderH);
+	UStateEnable(GL_SCISSOR_TEST);
+
+}
+
+
+void UPostSceneSize(int& width, int& height) {
+
+	width = direct ? windowW : renderW;
+	height = direct ? windowH : renderH;
+
+}
+
+
+bool UPostSceneDepth(GLuint& depth, int& width, int& height) {
+
+	if (direct || sceneTarget < 0) {
+		return false;
+	}
+	depth = pool[sceneTarget].depth;
+	width = renderW;
+	height = renderH;
+	return true;
+
+}
+
+
+void UPostEndScene(void) {
+
+	passCount = 0;
+	if (direct) {
+		return;
+	}
+
+	UStateDisable(GL_SCISSOR_TEST);
+	GLboolean depthTest = UStateIsEnabled(GL_DEPTH_TEST);
+	UStateDisable(GL_DEPTH_TEST);
+	UStateBindVertexArray(postVAO);
+
+	const vector<PostStage>& stages = chains[activeChain];
+	int input = sceneTarget;
+	int inputW = renderW;
+	int inputH = renderH;
+
+	for (size_t i = 0; i < stages.size(); i++) {
+		const PostStage& stage = stages[i];
+		bool last = (i + 1 == stages.size());
+		int outputW = (stage.windowSized || last) ? windowW : renderW;
+		int outputH = (stage.windowSized || last) ? windowH : renderH;
+
+		// The last stage writes the window, the others a pooled target
+		int output = -1;
+		if (last) {
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		}
+		else {
+			output = UAcquireTarget(windowW, windowH, stage.hdrOutput ? hdrFormat : GL_RGBA8, false);
+			glBindFramebuffer(GL_FRAMEBUFFER, pool[output].fbo);
+		}
+		glViewport(0, 0, outputW, outputH);
+
+		const PostTarget& source = pool[input];
+		UStateUseProgram(stage.program);
+		glUniform1i(stage.inputLoc, 0);
+		glUniform2f(stage.inputScaleLoc, (GLfloat)inputW / source.width, (GLfloat)inputH / source.height);
+		glUniform2f(stage.texelLoc, 1.0f / source.width, 1.0f / source.height);
+		glUniform1f(stage.exposureLoc, pow(2.0f, postOptions.exposure));
+		glUniform1f(stage.contrastLoc, postOptions.contrast);
+		glUniform1f(stage.saturationLoc, postOptions.saturation);
+		glUniform1f(stage.sharpnessLoc, postOptions.sharpen ? postOptions.sharpness : 0.0f);
+		UStateBindTexture(0, GL_TEXTURE_2D, source.color);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		passCount++;
+
+		// The input is free for the next stage's output once this draw has read it
+		UReleaseTarget(input);
+		input = output;
+		inputW = outputW;
+		inputH = outputH;
+	}
+
+	UStateBindTexture(0, GL_TEXTURE_2D, 0);
+	UStateBindVertexArray(0);
+	if (depthTest) {
+		UStateEnable(GL_DEPTH_TEST);
+	}
+	sceneTarget = -1;
+	UTrimPool();
+
+}
+
+
+int UPostPassCount(void) {
+
+	return passCount;
+
+}
+
+
+void UPostShutdown(void) {
+
+	for (int c = 0; c < 2; c++) {
+		for (size_t i = 0; i < chains[c].size(); i++) {
+			UGpuDeleteProgram(chains[c][i].program);
+		}
+		chains[c].clear();
+	}
+	for (size_t i = 0; i < pool.size(); i++) {
+		UDeleteTarget(pool[i]);
+	}
+	pool.clear();
+	UGpuDeleteVertexArray(postVAO);
+	postVAO = 0;
+
+}
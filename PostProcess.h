@@ -0,0 +1,65 @@
+/*
+*	Title:	Final Project / PostProcess.h
+*	Date:	October 19, 2026
+*
+*	Description: Post-processing chain. The scene renders into an HDR target,
+*	then a chain of full-screen passes (tone mapping, FXAA, color grading and
+*	the upscale to window size) turns it into the final image. Passes that
+*	only read their own pixel are fused into the shader of a neighbouring
+*	pass, so they add no full-screen read or write of their own. Render
+*	targets come from a pool and are reused between passes and frames.
+*
+*	Command line:
+*		--post <passes>				comma separated tonemap, fxaa, grade, or none,
+*									default tonemap,fxaa,grade
+*		--exposure <stops>			exposure applied before tone mapping, default 0
+*		--grade <contrast>,<saturation>		default 1,1
+*		--upscale <filter>			bilinear or sharpen, default sharpen
+*/
+
+#pragma once
+
+#include <vector>
+#include <GL/glew.h>
+
+enum PostPassType {
+	POST_TONEMAP,
+	POST_FXAA,
+	POST_GRADE,
+	POST_UPSCALE,		// added automatically when the scene renders below window size
+	POST_PASS_TYPES
+};
+
+struct PostOptions {
+	std::vector<PostPassType> passes;
+	float exposure;			// stops
+	float contrast;
+	float saturation;
+	bool sharpen;
+	float sharpness;		// 0 - 1, sharpen filter strength
+};
+
+// Reads the post-processing options out of the command line, returns false on a malformed argument
+bool UParsePostOptions(int argc, char* argv[], PostOptions& options);
+
+// Builds and compiles the fused passes, call once the GL context exists
+void UPostInit(const PostOptions& options);
+
+// Binds an HDR target for the scene sized scale * the window, with viewport and scissor set.
+// With no passes at full scale the scene goes straight to the window.
+void UPostBeginScene(int windowWidth, int windowHeight, float scale);
+
+// Size of the scene target bound by the last UPostBeginScene, the window when it goes straight there
+void UPostSceneSize(int& width, int& height);
+
+// Depth texture of the scene drawn since UPostBeginScene and the size it covers from the
+// origin, false when the scene goes straight to the window. Valid until UPostEndScene.
+bool UPostSceneDepth(GLuint& depth, int& width, int& height);
+
+// Runs the chain from the scene target into the window
+void UPostEndScene(void);
+
+// Full-screen passes drawn by the last UPostEndScene
+int UPostPassCount(void);
+
+void UPostShutdown(void);
@@ -0,0 +1,368 @@
+/*
+*	Title:	Final Project / Replay.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Input script recording and replay benchmark.
+*
+*	Script format, one frame per line followed by its events:
+*		frame <simulation seconds> <event count>
+*		<type> <x> <y> <button> <state> <key> <modifiers> <time>
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+#include "Replay.h"
+
+using namespace std; // standard namespace
+
+// One scripted frame
+struct ReplayFrame {
+	double seconds;
+	vector<InputEvent> events;
+};
+
+static ReplayOptions replayOptions;
+static ofstream recordFile;
+static vector<ReplayFrame> script;
+static size_t nextFrame = 0;
+static bool replaying = false;
+
+// Replay measurements
+static vector<double> frameTimes; // milliseconds
+static long long totalDrawCalls = 0;
+static long long totalStateCalls = 0;
+static long long totalStateElided = 0;
+static double lastFrameEnd = -1.0;
+static int framesDone = 0;
+
+
+// False when the script has no frame left to time past the warmup. The first frame is never timed,
+// it has no previous frame end to measure from.
+static bool UReplayEnoughFrames(const ReplayOptions& options) {
+
+	ifstream in(options.replayPath.c_str());
+	if (!in) {
+		return true; // UReplayInit reports it
+	}
+	int frames = 0;
+	string line;
+	while (getline(in, line)) {
+		if (line.compare(0, 6, "frame ") == 0) {
+			frames++;
+		}
+	}
+	if (frames > max(options.warmupFrames, 1)) {
+		return true;
+	}
+	std::cerr << "Replay script " << options.replayPath << " has " << frames << " frames, none left to time after "
+		<< options.warmupFrames << " warmup frames\n";
+	return false;
+
+}
+
+
+bool UParseReplayOptions(int argc, char* argv[], ReplayOptions& options) {
+
+	options.threshold = 0.10;
+	options.warmupFrames = 10;
+
+	const char* flags[] = { "--record", "--replay", "--baseline", "--save-baseline", "--threshold", "--warmup" };
+	const int flagCount = sizeof(flags) / sizeof(flags[0]);
+
+	for (int i = 1; i < argc; i++) {
+		int flag = 0;
+		while (flag < flagCount && strcmp(argv[i], flags[flag]) != 0) {
+			flag++;
+		}
+		if (flag == flagCount) {
+			continue; // not ours
+		}
+		if (i + 1 >= argc) {
+			std::cerr << argv[i] << " needs a value\n";
+			return false;
+		}
+
+		const char* value = argv[++i];
+		switch (flag) {
+		case 0: options.recordPath = value; break;
+		case 1: options.replayPath = value; break;
+		case 2: options.baselinePath = value; break;
+		case 3: options.saveBaselinePath = value; break;
+		case 4: options.threshold = atof(value); break;
+		case 5: options.warmupFrames = atoi(value); break;
+		}
+	}
+	if (options.warmupFrames < 0) {
+		std::cerr << "--warmup takes a frame count of 0 or more\n";
+		return false;
+	}
+	if (!options.replayPath.empty() && !UReplayEnoughFrames(options)) {
+		return false;
+	}
+	return true;
+
+}
+
+
+void UReplayInit(const ReplayOptions& options) {
+
+	replayOptions = options;
+
+	if (!options.recordPath.empty()) {
+		recordFile.open(options.recordPath.c_str());
+		if (!recordFile) {
+			std::cerr << "Failed to open " << options.recordPath << " for recording\n";
+			std::exit(EXIT_FAILURE);
+		}
+
+		// Frame times drive the camera on replay, so they are written to the last bit
+		recordFile << setprecision(numeric_limits<double>::max_digits10);
+	}
+
+	if (!options.replayPath.empty()) {
+		ifstream in(options.replayPath.c_str());
+		if (!in) {
+			std::cerr << "Failed to open replay script " << options.replayPath << "\n";
+			std::exit(EXIT_FAILURE);
+		}
+
+		string tag;
+		while (in >> tag) {
+			ReplayFrame frame;
+			size_t eventCount = 0;
+			if (tag != "frame" || !(in >> frame.seconds >> eventCount)) {
+				std::cerr << "Malformed replay script " << options.replayPath << "\n";
+				std::exit(EXIT_FAILURE);
+			}
+			for (size_t i = 0; i < eventCount; i++) {
+				InputEvent event = {};
+				int type = 0;
+				int key = 0;
+				in >> type >> event.x >> event.y >> event.button >> event.state >> key >> event.modifiers >> event.time;
+				event.type = (InputEventType)type;
+				event.key = (unsigned char)key;
+				frame.events.push_back(event);
+			}
+			script.push_back(frame);
+		}
+
+		replaying = !script.empty();
+		if (!replaying) {
+			std::cerr << "Replay script " << options.replayPath << " has no frames\n";
+			std::exit(EXIT_FAILURE);
+		}
+	}
+
+}
+
+
+bool URecording(void) {
+
+	return recordFile.is_open();
+
+}
+
+
+bool UReplaying(void) {
+
+	return replaying;
+
+}
+
+
+void URecordFrame(double frameSeconds, const vector<InputEvent>& events) {
+
+	recordFile << "frame " << frameSeconds << " " << events.size() << "\n";
+	for (size_t i = 0; i < events.size(); i++) {
+		const InputEvent& event = events[i];
+		recordFile << event.type << " " << event.x << " " << event.y << " " << event.button << " " << event.state << " "
+			<< (int)event.key << " " << event.modifiers << " " << event.time << "\n";
+	}
+
+}
+
+
+bool UReplayFrame(double& frameSeconds) {
+
+	if (nextFrame >= script.size()) {
+		return false;
+	}
+
+	const ReplayFrame& frame = script[nextFrame++];
+	for (size_t i = 0; i < frame.events.size(); i++) {
+		UQueueInput(frame.events[i]);
+	}
+	frameSeconds = frame.seconds;
+	return true;
+
+}
+
+
+void UReplayFrameDone(int drawCalls, int stateCalls, int stateElided) {
+
+	double now = UElapsedSeconds();
+	framesDone++;
+
+	// Frame time is measured end to end, so it includes the swap of the previous frame
+	if (lastFrameEnd >= 0.0 && framesDone > replayOptions.warmupFrames) {
+		frameTimes.push_back((now - lastFrameEnd) * 1000.0);
+		totalDrawCalls += drawCalls;
+		totalStateCalls += stateCalls;
+		totalStateElided += stateElided;
+	}
+	lastFrameEnd = now;
+
+	if (nextFrame < script.size()) {
+		return;
+	}
+
+	ReplayReport report = UBuildReplayReport(frameTimes, totalDrawCalls);
+	report.stateCalls = totalStateCalls;
+	report.stateElided = totalStateElided;
+	UPrintReplayReport(report);
+	if (report.frames == 0) {
+		std::cerr << "Replay timed no frames past the warmup\n";
+		std::exit(EXIT_FAILURE);
+	}
+
+	if (!replayOptions.saveBaselinePath.empty() && !USaveReplayReport(replayOptions.saveBaselinePath, report)) {
+		std::cerr << "Failed to write baseline " << replayOptions.saveBaselinePath << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+
+	int regressions = 0;
+	if (!replayOptions.baselinePath.empty()) {
+		ReplayReport baseline;
+		if (!ULoadReplayReport(replayOptions.baselinePath, baseline)) {
+			std::cerr << "Failed to read baseline " << replayOptions.baselinePath << "\n";
+			std::exit(EXIT_FAILURE);
+		}
+		regressions = UCompareReplayReports(report, baseline, replayOptions.threshold);
+	}
+
+	std::exit(regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+
+}
+
+
+ReplayReport UBuildReplayReport(const vector<double>& frameMs, long long drawCalls) {
+
+	ReplayReport report = {};
+	report.frames = (int)frameMs.size();
+	report.drawCalls = drawCalls;
+	if (frameMs.empty()) {
+		return report;
+	}
+
+	vector<double> sorted(frameMs);
+	sort(sorted.begin(), sorted.end());
+
+	double sum = 0.0;
+	for (size_t i = 0; i < sorted.size(); i++) {
+		sum += sorted[i];
+	}
+
+	// Nearest-rank percentiles
+	size_t p95 = (size_t)(0.95 * (sorted.size() - 1) + 0.5);
+	size_t p99 = (size_t)(0.99 * (sorted.size() - 1) + 0.5);
+
+	report.minMs = sorted.front();
+	report.avgMs = sum / sorted.size();
+	report.p95Ms = sorted[p95];
+	report.p99Ms = sorted[p99];
+	return report;
+
+}
+
+
+void UPrintReplayReport(const ReplayReport& report) {
+
+	std::cout << "frames       " << report.frames << "\n"
+		<< "min_ms       " << report.minMs << "\n"
+		<< "avg_ms       " << report.avgMs << "\n"
+		<< "p95_ms       " << report.p95Ms << "\n"
+		<< "p99_ms       " << report.p99Ms << "\n"
+		<< "draw_calls   " << report.drawCalls << "\n"
+		<< "state_calls  " << report.stateCalls << "\n"
+		<< "state_elided " << report.stateElided << std::endl;
+
+}
+
+
+bool ULoadReplayReport(const string& path, ReplayReport& report) {
+
+	ifstream in(path.c_str());
+	if (!in) {
+		return false;
+	}
+
+	report = ReplayReport();
+	string key;
+	while (in >> key) {
+		if (key == "frames") in >> report.frames;
+		else if (key == "min_ms") in >> report.minMs;
+		else if (key == "avg_ms") in >> report.avgMs;
+		else if (key == "p95_ms") in >> report.p95Ms;
+		else if (key == "p99_ms") in >> report.p99Ms;
+		else if (key == "draw_calls") in >> report.drawCalls;
+		else if (key == "state_calls") in >> report.stateCalls;
+		else if (key == "state_elided") in >> report.stateElided;
+		else return false;
+	}
+	return true;
+
+}
+
+
+bool USaveReplayReport(const string& path, const ReplayReport& report) {
+
+	ofstream out(path.c_str());
+	if (!out) {
+		return false;
+	}
+	out << "frames " << report.frames << "\n"
+		<< "min_ms " << report.minMs << "\n"
+		<< "avg_ms " << report.avgMs << "\n"
+		<< "p95_ms " << report.p95Ms << "\n"
+		<< "p99_ms " << report.p99Ms << "\n"
+		<< "draw_calls " << report.drawCalls << "\n"
+		<< "state_calls " << report.stateCalls << "\n"
+		<< "state_elided " << report.stateElided << "\n";
+	return (bool)out;
+
+}
+
+
+int UCompareReplayReports(const ReplayReport& current, const ReplayReport& baseline, double threshold) {
+
+	struct Metric { const char* name; double current; double baseline; };
+	Metric metrics[] = {
+		{ "min_ms", current.minMs, baseline.minMs },
+		{ "avg_ms", current.avgMs, baseline.avgMs },
+		{ "p95_ms", current.p95Ms, baseline.p95Ms },
+		{ "p99_ms", current.p99Ms, baseline.p99Ms },
+		{ "draw_calls", (double)current.drawCalls, (double)baseline.drawCalls },
+		{ "state_calls", (double)current.stateCalls, (double)baseline.stateCalls }
+	};
+
+	int regressions = 0;
+	for (size_t i = 0; i < sizeof(metrics) / sizeof(metrics[0]); i++) {
+		if (baseline.stateCalls == 0 && strcmp(metrics[i].name, "state_calls") == 0) {
+			continue;
+		}
+		double limit = metrics[i].baseline * (1.0 + threshold);
+		if (metrics[i].current > limit) {
+			std::cerr << "REGRESSION " << metrics[i].name << ": " << metrics[i].current
+				<< " > " << limit << " (baseline " << metrics[i].baseline << ")\n";
+			regressions++;
+		}
+	}
+	return regressions;
+
+}
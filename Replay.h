@@ -0,0 +1,76 @@
+/*
+*	Title:	Final Project / Replay.h
+*	Date:	October 19, 2026
+*
+*	Description: Records the input consumed by each frame to a script file and
+*	replays it deterministically as a benchmark. A replay reports frame time
+*	min/avg/p95/p99, draw calls and the GL state calls issued and elided by
+*	the state cache, and fails when a metric regresses past a
+*	threshold against a stored baseline.
+*
+*	Command line:
+*		--record <script>			record live input to a script
+*		--replay <script>			replay a script, print the report and exit
+*		--baseline <file>			compare the replay against a baseline report
+*		--save-baseline <file>		write the replay report as a new baseline
+*		--threshold <fraction>		allowed regression, default 0.10 (10%)
+*		--warmup <frames>			frames excluded from the statistics, default 10, must
+*									leave at least one of the script's frames to time
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Input.h"
+
+struct ReplayOptions {
+	std::string recordPath;
+	std::string replayPath;
+	std::string baselinePath;
+	std::string saveBaselinePath;
+	double threshold;
+	int warmupFrames;
+};
+
+// Summary of one replay run
+struct ReplayReport {
+	int frames;
+	double minMs;
+	double avgMs;
+	double p95Ms;
+	double p99Ms;
+	long long drawCalls;
+	long long stateCalls;		// state changes that reached the driver
+	long long stateElided;		// redundant ones the cache skipped
+};
+
+// Reads the replay options out of the command line, returns false on a malformed argument
+bool UParseReplayOptions(int argc, char* argv[], ReplayOptions& options);
+
+// Opens the record script or loads the replay script
+void UReplayInit(const ReplayOptions& options);
+
+bool URecording(void);
+bool UReplaying(void);
+
+// Appends one frame's simulation time and consumed events to the record script
+void URecordFrame(double frameSeconds, const std::vector<InputEvent>& events);
+
+// Queues the next scripted frame's events and sets its simulation time, false once the script is done
+bool UReplayFrame(double& frameSeconds);
+
+// Ends a replayed frame with its draw and state call counts, once the script is done this
+// reports, compares and exits
+void UReplayFrameDone(int drawCalls, int stateCalls, int stateElided);
+
+// Report helpers, also usable on their own
+ReplayReport UBuildReplayReport(const std::vector<double>& frameMs, long long drawCalls);
+void UPrintReplayReport(const ReplayReport& report);
+bool ULoadReplayReport(const std::string& path, ReplayReport& report);
+bool USaveReplayReport(const std::string& path, const ReplayReport& report);
+
+// Returns the number of metrics worse than baseline by more than threshold, state calls are
+// skipped against a baseline saved before they were reported
+int UCompareReplayReports(const ReplayReport& current, const ReplayReport& baseline, double threshold);
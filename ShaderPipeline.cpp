@@ -0,0 +1,224 @@
+/*
+*	Title:	Final Project / ShaderPipeline.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Shader build queue and startup timeline. A program counts as
+*	done when a poll first sees GL_COMPLETION_STATUS, so with parallel
+*	compiles its done time is exact to the phase boundary it was polled at.
+*	Without them the only way to know is the blocking status read, and the
+*	done time is when the program was first needed.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "Input.h"
+#include "ShaderPipeline.h"
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+// A submitted program and the shaders it links
+struct PendingProgram {
+	GLuint program;
+	vector<GLuint> shaders;
+	double submitted;		// UElapsedSeconds when its last command was issued
+	double finished;		// when it was first seen done, negative until then
+	bool checked;			// statuses read by UShaderRequire
+};
+
+struct TimelinePhase {
+	const char* name;
+	double start;
+	double end;
+};
+
+static ShaderOptions shaderOptions;
+static bool parallelCompile = false;
+static vector<PendingProgram> programs;
+static vector<TimelinePhase> phases;
+static bool reported = false;
+
+
+bool UParseShaderOptions(int argc, char* argv[], ShaderOptions& options) {
+
+	options.timeline = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--startup-timeline") == 0) {
+			options.timeline = true;
+		}
+	}
+	return true;
+
+}
+
+
+void UShaderInit(const ShaderOptions& options) {
+
+	shaderOptions = options;
+	parallelCompile = GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+	if (GLEW_KHR_parallel_shader_compile) {
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF); // as many threads as the driver likes
+	}
+	else if (GLEW_ARB_parallel_shader_compile) {
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+	}
+
+}
+
+
+void UShaderSubmit(GLuint program, const ShaderStage* stages, int stageCount) {
+
+	PendingProgram pending;
+	pending.program = program;
+	for (int i = 0; i < stageCount; i++) {
+		GLuint shader = glCreateShader(stages[i].type);
+		glShaderSource(shader, 1, &stages[i].source, NULL);
+		glCompileShader(shader);
+		glAttachShader(program, shader);
+		pending.shaders.push_back(shader);
+	}
+	glLinkProgram(program);
+
+	pending.submitted = UElapsedSeconds();
+	pending.finished = -1.0;
+	pending.checked = false;
+	programs.push_back(pending);
+
+}
+
+
+void UShaderPoll(void) {
+
+	if (!parallelCompile) {
+		return;
+	}
+	for (size_t i = 0; i < programs.size(); i++) {
+		if (programs[i].finished >= 0.0) {
+			continue;
+		}
+		GLint complete = GL_FALSE;
+		glGetProgramiv(programs[i].program, GL_COMPLETION_STATUS_KHR, &complete);
+		if (complete == GL_TRUE) {
+			programs[i].finished = UElapsedSeconds();
+		}
+	}
+
+}
+
+
+// Prints the log of every shader that failed and of the program, then exits
+static void UShaderFail(const PendingProgram& pending) {
+
+	GLchar log[1 << 11] = { 0 };
+	for (size_t i = 0; i < pending.shaders.size(); i++) {
+		GLint status = GL_FALSE;
+		glGetShaderiv(pending.shaders[i], GL_COMPILE_STATUS, &status);
+		if (status != GL_TRUE) {
+			glGetShaderInfoLog(pending.shaders[i], sizeof(log), NULL, log);
+			std::cerr << log << "\n";
+		}
+	}
+	glGetProgramInfoLog(pending.program, sizeof(log), NULL, log);
+	std::cerr << log << "\n";
+	std::exit(EXIT_FAILURE);
+
+}
+
+
+bool UShaderRequire(GLuint program) {
+
+	for (size_t i = 0; i < programs.size(); i++) {
+		PendingProgram& pending = programs[i];
+		if (pending.program != program) {
+			continue;
+		}
+		if (pending.checked) {
+			return false;
+		}
+
+		// Blocks until the link is done, unless a poll already saw it finish
+		GLint status = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (pending.finished < 0.0) {
+			pending.finished = UElapsedSeconds();
+		}
+		if (status != GL_TRUE) {
+			UShaderFail(pending);
+		}
+
+		for (size_t s = 0; s < pending.shaders.size(); s++) {
+			glDetachShader(program, pending.shaders[s]);
+			glDeleteShader(pending.shaders[s]);
+		}
+		pending.shaders.clear();
+		pending.checked = true;
+		return true;
+	}
+	return false; // never submitted here
+
+}
+
+
+void UTimelinePhase(const char* name) {
+
+	double now = UElapsedSeconds();
+	UShaderPoll();
+	if (!phases.empty()) {
+		phases.back().end = now;
+	}
+	TimelinePhase phase = { name, now, now };
+	phases.push_back(phase);
+
+}
+
+
+void UTimelineReport(void) {
+
+	if (reported || phases.empty()) {
+		return;
+	}
+	reported = true;
+	UShaderPoll();
+	phases.back().end = UElapsedSeconds();
+	if (!shaderOptions.timeline) {
+		return;
+	}
+
+	// Shader work runs from the last submission to the last program done
+	double shaderStart = 0.0;
+	double shaderEnd = 0.0;
+	for (size_t i = 0; i < programs.size(); i++) {
+		shaderStart = (i == 0) ? programs[i].submitted : max(shaderStart, programs[i].submitted);
+		shaderEnd = max(shaderEnd, programs[i].finished);
+	}
+
+	double origin = phases.front().start;
+	double overlapTotal = 0.0;
+	ostringstream report;
+	report << fixed << setprecision(1);
+	report << "Startup timeline (ms)          start      end   shader overlap\n";
+	for (size_t i = 0; i < phases.size(); i++) {
+		double overlap = max(0.0, min(phases[i].end, shaderEnd) - max(phases[i].start, shaderStart));
+		if (i + 1 < phases.size()) {
+			overlapTotal += overlap; // the last phase is where programs get used, and waited on
+		}
+		report << "  " << left << setw(24) << phases[i].name << right << setw(9) << (phases[i].start - origin) * 1000.0
+			<< setw(9) << (phases[i].end - origin) * 1000.0 << setw(17) << overlap * 1000.0 << "\n";
+	}
+	report << "  " << programs.size() << " programs, last submitted at " << (shaderStart - origin) * 1000.0 << " ms, all done by "
+		<< (shaderEnd - origin) * 1000.0 << " ms" << (parallelCompile ? "" : " (no completion status, done means first needed)") << "\n";
+	if (parallelCompile) {
+		report << "  " << overlapTotal * 1000.0 << " ms of " << (shaderEnd - shaderStart) * 1000.0 << " ms of shader work ran alongside loading\n";
+	}
+	else {
+		report << "  up to " << overlapTotal * 1000.0 << " ms of shader work could have run alongside loading\n";
+	}
+	std::cout << report.str();
+
+}
@@ -0,0 +1,50 @@
+/*
+*	Title:	Final Project / ShaderPipeline.h
+*	Date:	October 19, 2026
+*
+*	Description: Deferred shader builds and the startup timeline. Programs
+*	are submitted with every compile and the link queued back to back and no
+*	status read in between, so the driver can work on all of them while the
+*	application loads buffers and textures. With KHR_parallel_shader_compile
+*	the compiles run on driver threads and completion is polled without
+*	blocking; either way a program's status is first read when it is needed.
+*
+*	Command line:
+*		--startup-timeline			print startup phases and shader overlap after the first frame
+*/
+
+#pragma once
+
+#include <GL/glew.h>
+
+struct ShaderOptions {
+	bool timeline;
+};
+
+// One shader of a program
+struct ShaderStage {
+	GLenum type;
+	const char* source;		// must stay alive until the program is required
+};
+
+// Reads the shader options out of the command line, returns false on a malformed argument
+bool UParseShaderOptions(int argc, char* argv[], ShaderOptions& options);
+
+// Turns on parallel compiles where the driver offers them, call once the GL context exists
+void UShaderInit(const ShaderOptions& options);
+
+// Compiles every stage and links program without reading any status
+void UShaderSubmit(GLuint program, const ShaderStage* stages, int stageCount);
+
+// Waits for program to finish linking and checks it, exits with the logs on failure.
+// Returns true the first time, so one-off setup that needs a linked program can follow.
+bool UShaderRequire(GLuint program);
+
+// Notes which submitted programs have finished without waiting on any
+void UShaderPoll(void);
+
+// Starts a named startup phase, ending the one before it. The name must be a string literal.
+void UTimelinePhase(const char* name);
+
+// Ends the last phase and prints the timeline once when asked for
+void UTimelineReport(void);
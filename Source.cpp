@@ -14,7 +14,11 @@
 
 // Header inclusions
 #include <iostream>
+#include <string>
 #include <vector>
+#include <cstddef>
+#include <cfloat>
+#include <mutex>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
 
@@ -26,6 +30,30 @@
 // Soil2 header file
 #include "SOIL2/SOIL2.h"
 
+// Input queue and camera simulation
+#include "Input.h"
+#include "Camera.h"
+#include "Replay.h"
+#include "Geometry.h"
+#include "MeshGenerator.h"
+#include "TextureStream.h"
+#include "GpuResources.h"
+#include "DynamicResolution.h"
+#include "PostProcess.h"
+#include "TransformHierarchy.h"
+#include "Latency.h"
+#include "GpuCulling.h"
+#include "ShaderPipeline.h"
+#include "ModelImport.h"
+#include "Picking.h"
+#include "FrameCapture.h"
+#include "GlState.h"
+#include "FrameArena.h"
+#include "MultiView.h"
+#include "VertexPulling.h"
+#include "TaskScheduler.h"
+#include "GlTrace.h"
+
 using namespace std; // standard namespace
 
 #define WINDOW_TITLE "Final Project - Brandon Rickman" // page title macro
@@ -55,8 +83,82 @@ GLuint topEBO;
 GLuint keyLightVAO;
 GLuint fillLightVAO;
 GLuint lightVBO;
-GLuint topTex;
-GLuint legTex;
+GLuint instanceVBO;
+GLuint legIndexCount;
+GLuint topIndexCount;
+
+// Material Textures & Table
+// Every material texture of matching size and format lives in one layer of materialTexArray,
+// and materialUBO maps a material ID to that layer plus its lighting parameters.
+// MAX_MATERIALS must match the array size declared in the object fragment shader.
+#define MAX_MATERIALS 64
+GLuint materialTexArray;
+int materialTexStream; // streaming handle of materialTexArray
+GLuint materialUBO;
+GLuint materialBlockBinding = 0;
+
+struct Material {
+	GLint layer;				// texture array layer
+	GLfloat keySpecular;		// key light specular intensity
+	GLfloat fillSpecular;		// fill light specular intensity
+	GLfloat highlightSize;		// specular exponent
+};
+
+// Material IDs used by the table
+enum { MATERIAL_LEG = 0, MATERIAL_TOP = 1 };
+vector<Material> materials;
+
+// Per-instance data, one entry per leg set or table top drawn
+// Legs and tops occupy separate ranges of instanceVBO so each draws as a single instanced batch
+struct DrawInstance {
+	glm::mat4 model;			// instance transform, applied after the scene model
+	GLuint material;			// index into the material table
+	GLuint padding[3];
+};
+static_assert(sizeof(DrawInstance) == CULL_INSTANCE_BYTES, "DrawInstance must match the culling pass's output record");
+vector<glm::mat4> tableTransforms(1, glm::mat4(1.0f)); // one table at the scene origin by default
+GLsizei tableCount = 0;
+
+// Procedural table and room settings from the command line
+GeneratorOptions generatorOptions;
+
+
+// Texture streaming settings from the command line
+StreamOptions streamOptions;
+
+// Render scale and post-processing settings from the command line
+ResolutionOptions resolutionOptions;
+PostOptions postOptions;
+
+// Frames in flight and latency reporting from the command line
+LatencyOptions latencyOptions;
+
+// GPU culling settings from the command line, and whether the context runs it
+CullOptions cullOptions;
+bool gpuCulling = false;
+glm::vec3 tableBoundsMin; // object-space box around one instance, or the whole baked room
+glm::vec3 tableBoundsMax;
+
+// Vertex pulling settings from the command line, and whether the tables are drawn that way
+PullOptions pullOptions;
+bool vertexPulling = false;
+
+// Shader build settings from the command line
+ShaderOptions shaderOptions;
+
+// Imported models from the command line
+ImportOptions importOptions;
+
+// Frame capture settings from the command line
+CaptureOptions captureOptions;
+
+// Task threads from the command line
+TaskOptions taskOptions;
+#define TABLE_SLICE_MIN 1024 // tables per slice of the per-frame passes over every table
+
+// Views drawn from the command line, and this frame's layout of them
+ViewOptions viewOptions;
+SceneView sceneViews[VIEW_MAX];
 
 // Subject position and scale
 glm::vec3 objectPosition(0.0f, 0.0f, 0.0f);
@@ -72,58 +174,60 @@ glm::vec3 keyLightPosition(-1.0f, 5.5f, -6.0f);
 glm::vec3 fillLightPosition(3.0f, 0.0f, 0.0f);
 glm::vec3 lightScale(0.3f);
 
+// Scene transforms. The room and both lights hang off sceneNode, every table off roomNode,
+// so each light sits at its own position instead of inheriting the room's transform.
+TransformHierarchy sceneTransforms;
+TransformNode sceneNode;
+TransformNode roomNode;
+TransformNode keyLightNode;
+TransformNode fillLightNode;
+vector<TransformNode> tableNodes; // room position of every table, instanced or baked
+
 // Camera Position
 glm::vec3 cameraPosition(0.0f, -1.5f, -6.0f);
-GLfloat cameraSpeed = 0.05f; // movement speed per frame
+GLfloat cameraSpeed = 3.0f; // zoom speed in front-lengths per second
 glm::vec3 CameraUpY = glm::vec3(0.0f, 1.0f, 0.0f); // temporary y unit vector
 glm::vec3 CameraForwardZ = glm::vec3(0.0f, 0.0f, 0.0f); // temporary z unit vector
 glm::vec3 front; // temporary z unit vector for mouse
-int prevY = 0; // var to hold previous value of Y for zoom feature
 float cameraRotation = glm::radians(-25.0f); // Camera Rotation
 
+// Camera simulation, advanced on a fixed clock and interpolated for each frame
+CameraSimulation cameraSim;
+double lastFrameTime = 0.0; // seconds, from UElapsedSeconds
+
+// Draw calls issued by the current frame, reported by replays
+int frameDrawCalls = 0;
+
 // Global mouse movements
-GLfloat lastMouseX = 400, lastMouseY = 300; // Locks the mouse cursor at the center of the screen
-GLfloat mouseXOffset, mouseYOffset, yaw = 0.0f, pitch = 0.0f; // mouse offset, yaw, and pitch var.
 GLfloat sensitivity = 0.005f; // Used for mouse / camera rotation sensitivity
-bool mouseDetected = true; // Initially true when mouse movement is detected
 bool leftButton = false; // init left Mouse button not pressed
 bool rightButton = false; // init right Mouse button not pressed
 
+// Click waiting to be picked once this frame's view is known
+bool pickPending = false;
+int pickX = 0;
+int pickY = 0;
+int pickLegMesh = -1; // PickHit::mesh of the table legs, the top is the other one
+
 // function prototypes
-void CheckStatus(GLuint, bool);
-void AttachShader(GLuint, GLenum, const char*);
 void UResizeWindow(int, int);
+void UCloseWindow(void);
 void URenderGraphics(void);
 void UCreateShader(void);
+void UCreateTransforms(void);
 void UCreateBuffers(void);
 void UGenerateTexture(void);
+void UCreateMaterials(void);
+void UUploadInstances(void);
 void UMouseClick(int button, int state, int x, int y);
 void UMouseMove(int x, int y);
 void UKeyboard(unsigned char key, int x, int y);
+void UKeyboardUp(unsigned char key, int x, int y);
+void UUpdateCamera(void);
+void USceneBounds(glm::vec3& center, float& radius);
+void UPickUnderCursor(const glm::mat4& model, const SceneView* views);
 
 
-// Modified Shader Code from Mod 4
-void CheckStatus(GLuint obj, bool isShader)
-{
-	GLint status = GL_FALSE, log[1 << 11] = { 0 };
-	(isShader ? glGetShaderiv : glGetProgramiv)(obj, isShader ? GL_COMPILE_STATUS : GL_LINK_STATUS, &status);
-	(isShader ? glGetShaderInfoLog : glGetProgramInfoLog)(obj, sizeof(log), NULL, (GLchar*)log);
-	if (status == GL_TRUE) return;
-	std::cerr << (GLchar*)log << "\n";
-	std::exit(EXIT_FAILURE);
-}
-
-
-void AttachShader(GLuint program, GLenum type, const char* src)
-{
-	GLuint shader = glCreateShader(type);
-	glShaderSource(shader, 1, &src, NULL);
-	glCompileShader(shader);
-	CheckStatus(shader, true);
-	glAttachShader(program, shader);
-	glDeleteShader(shader);
-}
-
 /*
 *	Object VERTEX SHADER SOURCE CODE
 */
@@ -132,20 +236,33 @@ const char* objectVertexShaderSource = 1 + R"GLSL(
 	layout(location = 0) in vec3 position;
 	layout(location = 1) in vec3 normal;
 	layout(location = 2) in vec2 textureCoordinate;
+	layout(location = 3) in uint instanceMaterial;
+	layout(location = 4) in mat4 instanceModel;
 
 	out vec3 Normal;
 	out vec3 FragmentPos;
 	out vec2 mobileTextureCoordinate;
+	flat out uint materialID;
+	flat out int viewIndex;
 
 	uniform mat4 model;
-	uniform mat4 view;
-	uniform mat4 projection;
+	uniform mat4 views[VIEW_MAX];
+	uniform mat4 projections[VIEW_MAX];
+	uniform int viewCount;
+	uniform int viewFirst;
 
 	void main() {
-		gl_Position = projection * view * model * vec4(position, 1.0f);
-		FragmentPos = vec3(model * vec4(position, 1.0f));
-		Normal = mat3(transpose(inverse(model))) * normal;
+		// Each table is drawn once per view, the instance attributes advance once per view count
+		viewIndex = viewFirst + gl_InstanceID % viewCount;
+		mat4 world = model * instanceModel;
+		gl_Position = projections[viewIndex] * views[viewIndex] * world * vec4(position, 1.0f);
+		FragmentPos = vec3(world * vec4(position, 1.0f));
+		Normal = mat3(transpose(inverse(world))) * normal;
 		mobileTextureCoordinate = vec2(textureCoordinate.x, 1.0f - textureCoordinate.y);
+		materialID = instanceMaterial;
+	#ifdef VIEW_INSTANCED
+		gl_ViewportIndex = viewIndex;
+	#endif
 	}
 )GLSL";
 
@@ -155,17 +272,31 @@ const char* objectFragmentShaderSource = 1 + R"GLSL(
 	in vec3 Normal;
 	in vec3 FragmentPos;
 	in vec2 mobileTextureCoordinate;
+	flat in uint materialID;
+	flat in int viewIndex;
 
 	out vec4 pyramidColor;
 
+	struct Material {
+		int layer;
+		float keySpecular;
+		float fillSpecular;
+		float highlightSize;
+	};
+
+	layout(std140) uniform Materials {
+		Material materials[64];
+	};
+
 	uniform vec3 keyLightColor;
 	uniform vec3 fillLightColor;
 	uniform vec3 keyLightPos;
 	uniform vec3 fillLightPos;
-	uniform vec3 viewPosition;
-	uniform sampler2D uTexture;
+	uniform vec3 viewPositions[VIEW_MAX];
+	uniform sampler2DArray uTextures;
 
 	void main() {
+		Material material = materials[materialID];
 
 		float ambientStrength = 0.1f;
 		vec3 keyAmbient = ambientStrength * keyLightColor;
@@ -179,10 +310,10 @@ const char* objectFragmentShaderSource = 1 + R"GLSL(
 		vec3 keyDiffuse = keyImpact * keyLightColor;
 		vec3 fillDiffuse = fillImpact * fillLightColor;
 
-		float keySpecularIntensity = 1.0f;
-		float fillSpecularIntensity = 0.1f;
-		float highlightSize = 16.0f;
-		vec3 viewDir = normalize(viewPosition - FragmentPos);
+		float keySpecularIntensity = material.keySpecular;
+		float fillSpecularIntensity = material.fillSpecular;
+		float highlightSize = material.highlightSize;
+		vec3 viewDir = normalize(viewPositions[viewIndex] - FragmentPos);
 		vec3 keyReflectDir = reflect(-keyLightDirection, norm);
 		vec3 fillReflectDir = reflect(-fillLightDirection, norm);
 		float keySpecularComponent = pow(max(dot(viewDir, keyReflectDir), 0.0), highlightSize);
@@ -190,7 +321,7 @@ const char* objectFragmentShaderSource = 1 + R"GLSL(
 		vec3 keySpecular = keySpecularIntensity * keySpecularComponent * keyLightColor;
 		vec3 fillSpecular = fillSpecularIntensity * fillSpecularComponent * fillLightColor;
 		
-		vec3 objectColor = texture(uTexture, mobileTextureCoordinate).xyz;
+		vec3 objectColor = texture(uTextures, vec3(mobileTextureCoordinate, material.layer)).xyz;
 		vec3 keyPhong = (keyAmbient + keyDiffuse + keySpecular) * objectColor;
 		vec3 fillPhong = (fillAmbient + fillDiffuse + fillSpecular) * objectColor;
 		vec3 phong = keyPhong + fillPhong;
@@ -204,11 +335,17 @@ const char* keyLightVertexShaderSource = 1 + R"GLSL(
 	layout(location = 0) in vec3 position;
 
 	uniform mat4 model;
-	uniform mat4 view;
-	uniform mat4 projection;
+	uniform mat4 views[VIEW_MAX];
+	uniform mat4 projections[VIEW_MAX];
+	uniform int viewCount;
+	uniform int viewFirst;
 
 	void main() {
-		gl_Position = projection * view * model * vec4(position, 1.0f);
+		int viewIndex = viewFirst + gl_InstanceID % viewCount;
+		gl_Position = projections[viewIndex] * views[viewIndex] * model * vec4(position, 1.0f);
+	#ifdef VIEW_INSTANCED
+		gl_ViewportIndex = viewIndex;
+	#endif
 	}
 )GLSL";
 
@@ -229,11 +366,17 @@ const char* fillLightVertexShaderSource = 1 + R"GLSL(
 	layout(location = 0) in vec3 position;
 	
 	uniform mat4 model;
-	uniform mat4 view;
-	uniform mat4 projection;
+	uniform mat4 views[VIEW_MAX];
+	uniform mat4 projections[VIEW_MAX];
+	uniform int viewCount;
+	uniform int viewFirst;
 
 	void main() {
-		gl_Position = projection * view * model * vec4(position, 1.0f);
+		int viewIndex = viewFirst + gl_InstanceID % viewCount;
+		gl_Position = projections[viewIndex] * views[viewIndex] * model * vec4(position, 1.0f);
+	#ifdef VIEW_INSTANCED
+		gl_ViewportIndex = viewIndex;
+	#endif
 	}
 )GLSL";
 
@@ -254,10 +397,30 @@ const char* fillLightFragmentShaderSource = 1 + R"GLSL(
 int main(int argc, char* argv[]) {
 
 	glutInit(&argc, argv);
+
+	// Record, replay and scene generation options, left in argv by glutInit
+	ReplayOptions replayOptions;
+	TraceOptions traceOptions;
+	if (!UParseReplayOptions(argc, argv, replayOptions) || !UParseGeneratorOptions(argc, argv, generatorOptions)
+		|| !UParseStreamOptions(argc, argv, streamOptions) || !UParseResolutionOptions(argc, argv, resolutionOptions)
+		|| !UParsePostOptions(argc, argv, postOptions) || !UParseLatencyOptions(argc, argv, latencyOptions)
+		|| !UParseCullOptions(argc, argv, cullOptions) || !UParseShaderOptions(argc, argv, shaderOptions)
+		|| !UParseImportOptions(argc, argv, importOptions) || !UParseCaptureOptions(argc, argv, captureOptions)
+		|| !UParseTraceOptions(argc, argv, traceOptions) || !UParseViewOptions(argc, argv, viewOptions)
+		|| !UParsePullOptions(argc, argv, pullOptions) || !UParseTaskOptions(argc, argv, taskOptions))
+	{
+		return -1;
+	}
+
 	glutInitDisplayMode(GLUT_DEPTH | GLUT_DOUBLE | GLUT_RGBA);
 	glutInitWindowSize(windowWidth, windowHeight);
 	glutCreateWindow(WINDOW_TITLE);
 
+	// Return from glutMainLoop on window close so the cleanup below runs. GL objects go in
+	// UCloseWindow, the window's context is gone by the time glutMainLoop returns.
+	glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
+	glutCloseFunc(UCloseWindow);
+
 	glutReshapeFunc(UResizeWindow);
 
 	glewExperimental = GL_TRUE;
@@ -267,34 +430,82 @@ int main(int argc, char* argv[]) {
 		return -1;
 	}
 
+	// Records every GL call from here on with --gl-trace
+	UTraceInit(traceOptions, windowWidth, windowHeight);
 	
+	// Startup phases, reported after the first frame with --startup-timeline. The task threads come
+	// first, loading and every frame after it share them.
+	UTaskInit(taskOptions);
+	UShaderInit(shaderOptions);
+	UViewInit(viewOptions); // decides the header of every shader drawing into the views
+	if (pullOptions.enabled && (generatorOptions.procedural || generatorOptions.bake || !importOptions.modelPath.empty()
+		|| !importOptions.topModelPath.empty()))
+	{
+		std::cerr << "Vertex pulling builds the hand-built table only, drawing the tables from vertex buffers\n";
+		pullOptions.enabled = false;
+	}
+	vertexPulling = UPullInit(pullOptions); // decides the object vertex shader
+	UTimelinePhase("shader submit");
 	UCreateShader();
+	UTimelinePhase("transforms");
+	UCreateTransforms();
+	UTimelinePhase("gpu culling");
+	if (cullOptions.enabled && UViewCount() > 1) {
+		std::cerr << "GPU culling tests a single view, drawing every instance into the " << UViewCount() << " views\n";
+		cullOptions.enabled = false;
+	}
+	if (cullOptions.enabled && vertexPulling) {
+		std::cerr << "GPU culling fills the instance vertex buffer, which vertex pulling does not read, drawing every table\n";
+		cullOptions.enabled = false;
+	}
+	gpuCulling = UCullInit(cullOptions);
+	UTimelinePhase("buffers");
 	UCreateBuffers();
+	UTimelinePhase("textures");
+	UStreamInit(streamOptions);
 	UGenerateTexture();
+	UTimelinePhase("materials");
+	UCreateMaterials();
+	UTimelinePhase("post processing");
+	UResolutionInit(resolutionOptions);
+	UPostInit(postOptions);
+	ULatencyInit(latencyOptions);
+	UCaptureInit(captureOptions);
+
+	// Start the camera at rest where the scene expects it
+	CameraState startCamera = { cameraPosition, 0.0f, 0.0f };
+	UCameraInit(cameraSim, startCamera);
+	lastFrameTime = UElapsedSeconds();
+	UReplayInit(replayOptions);
 
 	glClearColor(0.82f, 0.7f, 0.554f, 1.0f); // sets background color to BLACK
 
 	glutDisplayFunc(URenderGraphics);
 
-	// view projections
-	glutKeyboardFunc(UKeyboard); // detects key press
-	glutKeyboardUpFunc(UKeyboard); // detects key release
+	// A replay supplies all input from its script
+	if (!UReplaying()) {
 
-	// mouse operations
-	glutMouseFunc(UMouseClick); // detects mouse click
-	glutPassiveMotionFunc(UMouseMove); // detects mouse movement
-	glutMotionFunc(UMouseMove); // detects mouse press and movement
+		// view projections
+		glutKeyboardFunc(UKeyboard); // detects key press
+		glutKeyboardUpFunc(UKeyboardUp); // detects key release
 
+		// mouse operations
+		glutMouseFunc(UMouseClick); // detects mouse click
+		glutPassiveMotionFunc(UMouseMove); // detects mouse movement
+		glutMotionFunc(UMouseMove); // detects mouse press and movement
+	}
+
+	UTraceSetupDone();
+	UTimelinePhase("first frame");
 	glutMainLoop();
+	UCaptureShutdown(); // once the encoders have written every frame
 
-	// Destroy Buffer Objects once used
-	glDeleteVertexArrays(1, &legVAO);
-	glDeleteVertexArrays(1, &topVAO);
-	glDeleteVertexArrays(1, &keyLightVAO);
-	glDeleteVertexArrays(1, &fillLightVAO);
-	glDeleteBuffers(1, &legVBO);
-	glDeleteBuffers(1, &topVBO);
-	glDeleteBuffers(1, &lightVBO);
+	// GL state calls per frame, frame arena use and task use over the run
+	UStatePrintStats();
+	UArenaPrintStats();
+	UStreamPrintStats();
+	UTaskShutdown(); // after the streaming, which waits for its decode tasks
+	UTaskPrintStats();
 
 	// Successfully exit the program
 	return 0;
@@ -304,31 +515,31 @@ int main(int argc, char* argv[]) {
 
 // Function that creates shaders
 void UCreateShader(void) {
-	// pyramid SHADERS
-	// Creates the shader program and returns and ID for the pyramid
-	objectShaderProgram = glCreateProgram();
 
-	// Attach the pyramid's vertex shader to the shader program
-	AttachShader(objectShaderProgram, GL_VERTEX_SHADER, objectVertexShaderSource);
-	// Attach the pyramid's fragment shader to the shader program
-	AttachShader(objectShaderProgram, GL_FRAGMENT_SHADER, objectFragmentShaderSource);
-	// Link vertex and fragment shaders to the pyramid's shader program
-	glLinkProgram(objectShaderProgram);
-	CheckStatus(objectShaderProgram, false);
+	// Every compile and link is queued here and checked when the program is first used,
+	// so the driver builds them while buffers and textures load. The sources that draw into
+	// the views get the view path's header, and are kept here until then. With vertex pulling
+	// the object program builds the tables from their shapes instead of vertex attributes.
+	static string objectVertexSource = UViewShaderSource(vertexPulling ? UPullVertexShaderSource() : objectVertexShaderSource);
+	static string objectFragmentSource = UViewShaderSource(objectFragmentShaderSource);
+	static string keyLightVertexSource = UViewShaderSource(keyLightVertexShaderSource);
+	static string fillLightVertexSource = UViewShaderSource(fillLightVertexShaderSource);
+
+	// pyramid SHADERS
+	objectShaderProgram = UGpuCreateProgram("objectShaderProgram");
+	ShaderStage objectStages[] = { { GL_VERTEX_SHADER, objectVertexSource.c_str() }, { GL_FRAGMENT_SHADER, objectFragmentSource.c_str() } };
+	UShaderSubmit(objectShaderProgram, objectStages, 2);
 
 	// KEY LAMP SHADERS
-	keyLightShaderProgram = glCreateProgram();
-	AttachShader(keyLightShaderProgram, GL_VERTEX_SHADER, keyLightVertexShaderSource);
-	AttachShader(keyLightShaderProgram, GL_FRAGMENT_SHADER, keyLightFragmentShaderSource);
-	glLinkProgram(keyLightShaderProgram);
-	CheckStatus(keyLightShaderProgram, false);
+	keyLightShaderProgram = UGpuCreateProgram("keyLightShaderProgram");
+	ShaderStage keyLightStages[] = { { GL_VERTEX_SHADER, keyLightVertexSource.c_str() }, { GL_FRAGMENT_SHADER, keyLightFragmentShaderSource } };
+	UShaderSubmit(keyLightShaderProgram, keyLightStages, 2);
 
 	// FILL LAMP SHADERS
-	fillLightShaderProgram = glCreateProgram();
-	AttachShader(fillLightShaderProgram, GL_VERTEX_SHADER, fillLightVertexShaderSource);
-	AttachShader(fillLightShaderProgram, GL_FRAGMENT_SHADER, fillLightFragmentShaderSource);
-	glLinkProgram(fillLightShaderProgram);
-	CheckStatus(fillLightShaderProgram, false);
+	fillLightShaderProgram = UGpuCreateProgram("fillLightShaderProgram");
+	ShaderStage fillLightStages[] = { { GL_VERTEX_SHADER, fillLightVertexSource.c_str() }, { GL_FRAGMENT_SHADER, fillLightFragmentShaderSource } };
+	UShaderSubmit(fillLightShaderProgram, fillLightStages, 2);
+
 }
 
 
@@ -342,135 +553,281 @@ void UResizeWindow(int w, int h) {
 }
 
 
+// Tears down the GL objects while the closing window's context is still current
+void UCloseWindow(void) {
+
+	UTraceShutdown(); // teardown is not part of the trace
+
+	// Drains the frames in flight before anything they use is deleted
+	ULatencyShutdown();
+	UCaptureFinish(); // hands the frames still being read back to the encoders
+
+	// GPU memory in use at the end of the run
+	UGpuPrintMemory();
+
+	// Destroy every GPU object once used
+	UGpuDeleteVertexArray(legVAO);
+	UGpuDeleteVertexArray(topVAO);
+	UGpuDeleteVertexArray(keyLightVAO);
+	UGpuDeleteVertexArray(fillLightVAO);
+	UGpuDeleteBuffer(legVBO);
+	UGpuDeleteBuffer(legEBO);
+	UGpuDeleteBuffer(topVBO);
+	UGpuDeleteBuffer(topEBO);
+	UGpuDeleteBuffer(lightVBO);
+	UGpuDeleteBuffer(instanceVBO);
+	UGpuDeleteBuffer(materialUBO);
+	UGpuDeleteProgram(objectShaderProgram);
+	UGpuDeleteProgram(keyLightShaderProgram);
+	UGpuDeleteProgram(fillLightShaderProgram);
+	UStreamShutdown(); // deletes materialTexArray
+	UPostShutdown();
+	UResolutionShutdown();
+	UCullShutdown();
+	UPullShutdown();
+
+	// Anything still registered here was leaked
+	UGpuLeakReport();
+
+}
+
+
 // Render graphics
 void URenderGraphics(void) {
 
-	glEnable(GL_DEPTH_TEST); // allows z-axis
+	UArenaBeginFrame(); // scratch memory from two frames ago is reused from here on
+	UStateEnable(GL_DEPTH_TEST); // allows z-axis
 
+	// Draw the scene into the post-processing chain's HDR target at the current render scale
+	UResolutionBegin();
+	UPostBeginScene(windowWidth, windowHeight, UResolutionScale());
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // clears screen
+	frameDrawCalls = 0;
 
 	GLint modelLoc;
-	GLint viewLoc;
-	GLint projLoc;
-	GLint uTextureLoc;
+	GLint uTexturesLoc;
 	GLint keyLightColorLoc;
 	GLint fillLightColorLoc;
 	GLint keyLightPositionLoc;
 	GLint fillLightPositionLoc;
-	GLint viewPositionLoc;
 
 	glm::mat4 model(1.0f);
 	glm::mat4 view(1.0f);
 	glm::mat4 projection;
+	int targetWidth;
+	int targetHeight;
+
+	// Apply this frame's input and advance the camera, low-latency mode does it just before the view is built
+	if (!ULatencyLateLatch()) {
+		UUpdateCamera();
+	}
+
+	// Bring in the texture levels last frame asked for
+	UStreamUpdate();
+
+	// Recompute world matrices for whatever moved since the last frame, large subtrees on the task threads
+	UTransformUpdate(sceneTransforms);
 
 
 	// Table Leg Draw
 	// USE THE SHADER AND ACTIVIATE pyramid VAO FOR RENDERING AND TRANSFORMING
-	glUseProgram(objectShaderProgram);
-	glBindVertexArray(legVAO);
+	if (UShaderRequire(objectShaderProgram)) {
+		// Point the material table block at the UBO binding shared by every object draw
+		glUniformBlockBinding(objectShaderProgram, glGetUniformBlockIndex(objectShaderProgram, "Materials"), materialBlockBinding);
+	}
+	UStateUseProgram(objectShaderProgram);
+	UStateBindVertexArray(legVAO);
 
 	// Transform the pyramid
-	model = glm::translate(model, objectPosition);
-	model = glm::scale(model, objectScale);	
+	model = UTransformWorld(sceneTransforms, roomNode);
 
 	// Transform the camera
+	if (ULatencyLateLatch()) {
+		UUpdateCamera();
+	}
 	CameraForwardZ = front; // Replaces camera forward vector with Radians normalized as a unit vector
 	view = glm::translate(view, cameraPosition);
 	view = glm::rotate(view, cameraRotation, glm::vec3(0.0f, 0.0f, 0.0f));
 	view = glm::lookAt(cameraPosition - CameraForwardZ, cameraPosition, CameraUpY); // moves the world 0.5 units on X and 5 units in Z
    
-	// Set the camera projection to perspective
-	projection = glm::perspective(45.0f, (GLfloat)windowWidth / (GLfloat)windowHeight, 0.1f, 100.0f);
+	// Lay out the views, the first is the camera's perspective view the rest of the frame works from
+	glm::vec3 sceneCenter;
+	float sceneRadius;
+	USceneBounds(sceneCenter, sceneRadius);
+	UViewLayout(view, cameraPosition, 45.0f, (GLfloat)windowWidth / (GLfloat)windowHeight, sceneCenter, sceneRadius, sceneViews);
+	projection = sceneViews[0].projection;
+	UPostSceneSize(targetWidth, targetHeight);
+	UViewSetViewports(sceneViews, targetWidth, targetHeight);
+
+	// Pick what the last click landed on, through the matrices this frame draws with
+	if (pickPending) {
+		pickPending = false;
+		UPickUnderCursor(model, sceneViews);
+	}
+
+	// The nearest table decides how fine the material textures need to be, large rooms are
+	// searched in slices on the task threads
+	float tableSize = generatorOptions.table.width * objectScale.x;
+	glm::vec3 eye = cameraPosition - CameraForwardZ;
+	float nearest = FLT_MAX;
+	mutex nearestMutex;
+	UTaskParallelFor(tableNodes.size(), TABLE_SLICE_MIN, [&](size_t first, size_t last) {
+		float sliceNearest = FLT_MAX;
+		for (size_t i = first; i < last; i++) {
+			sliceNearest = min(sliceNearest, glm::length(UTransformWorldPosition(sceneTransforms, tableNodes[i]) - eye));
+		}
+		lock_guard<mutex> lock(nearestMutex);
+		nearest = min(nearest, sliceNearest);
+	});
+	if (!tableNodes.empty()) {
+		UStreamNeed(materialTexStream, UStreamProjectedSize(tableSize, nearest, projection[1][1], (int)(windowHeight * UResolutionScale() * sceneViews[0].height)));
+	}
+
+	// Cull the tables on the GPU, the compute pass leaves its own program bound
+	if (gpuCulling) {
+		UCullRun(model, projection * view);
+		UStateUseProgram(objectShaderProgram);
+	}
 
 	// Reference matrix uniforms from the pyramid Shader Program
 	modelLoc = glGetUniformLocation(objectShaderProgram, "model");
-	viewLoc = glGetUniformLocation(objectShaderProgram, "view");
-	projLoc = glGetUniformLocation(objectShaderProgram, "projection");
 
-	// Pass matrix data to the pyramid Shader Program's matrix uniforms
+	// Pass matrix data to the pyramid Shader Program's matrix uniforms, every view's camera included
 	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-	glUniformMatrix4fv(viewLoc, 1, GL_FALSE, value_ptr(view));
-	glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+	UViewSetUniforms(objectShaderProgram, sceneViews);
 
 	// Reference matrix uniforms from the pyramid Shader program for:
-	// the pyramid color, light color, light position and camera position
-	uTextureLoc = glGetUniformLocation(objectShaderProgram, "uTexture");
+	// the pyramid color, light color and light position
+	uTexturesLoc = glGetUniformLocation(objectShaderProgram, "uTextures");
 	keyLightColorLoc = glGetUniformLocation(objectShaderProgram, "keyLightColor");
 	fillLightColorLoc = glGetUniformLocation(objectShaderProgram, "fillLightColor");
 	keyLightPositionLoc = glGetUniformLocation(objectShaderProgram, "keyLightPos");
 	fillLightPositionLoc = glGetUniformLocation(objectShaderProgram, "fillLightPos");
-	viewPositionLoc = glGetUniformLocation(objectShaderProgram, "viewPosition");
 
-	// Pass color, light and camera data to the pyramid Shader program's corresponding uniforms
-	glUniform1i(uTextureLoc, 0);
+	// Pass color and light data to the pyramid Shader program's corresponding uniforms
+	glUniform1i(uTexturesLoc, 0);
 	glUniform3f(keyLightColorLoc, keyLightColor.r, keyLightColor.g, keyLightColor.b);
 	glUniform3f(fillLightColorLoc, fillLightColor.r, fillLightColor.g, fillLightColor.b);
-	glUniform3f(keyLightPositionLoc, keyLightPosition.x, keyLightPosition.y, keyLightPosition.z);
-	glUniform3f(fillLightPositionLoc, fillLightPosition.x, fillLightPosition.y, fillLightPosition.z);
-	glUniform3f(viewPositionLoc, cameraPosition.x, cameraPosition.y, cameraPosition.z);
-
-	// Provide texture to the pyramid
-	glBindTexture(GL_TEXTURE_2D, legTex);
-
-	//Draw the triangles
-	glDrawElements(GL_TRIANGLES, 180, GL_UNSIGNED_INT, 0);
-
-	// Deactiviate the pyramid Vertex Array Object
-	glBindVertexArray(0);
+	glm::vec3 keyLightWorld = UTransformWorldPosition(sceneTransforms, keyLightNode);
+	glm::vec3 fillLightWorld = UTransformWorldPosition(sceneTransforms, fillLightNode);
+	glUniform3f(keyLightPositionLoc, keyLightWorld.x, keyLightWorld.y, keyLightWorld.z);
+	glUniform3f(fillLightPositionLoc, fillLightWorld.x, fillLightWorld.y, fillLightWorld.z);
+
+	// Provide every material texture and the material table once for all table draws
+	UStateBindTexture(0, GL_TEXTURE_2D_ARRAY, materialTexArray);
+	UStateBindBufferBase(GL_UNIFORM_BUFFER, materialBlockBinding, materialUBO);
+
+	// Draw the legs of every table in one batch, each instance selects its own material and
+	// is repeated for every view the batch fans out to
+	for (int pass = 0; pass < UViewPasses(); pass++) {
+		UViewBeginPass(objectShaderProgram, pass, sceneViews, targetWidth, targetHeight);
+		if (vertexPulling) {
+			UPullDraw(tableCount * UViewFanOut()); // the tops too
+		}
+		else if (gpuCulling) {
+			UCullDraw(0);
+		}
+		else {
+			glDrawElementsInstanced(GL_TRIANGLES, legIndexCount, GL_UNSIGNED_INT, 0, tableCount * UViewFanOut());
+		}
+		frameDrawCalls++;
+	}
 
 
-	// Table Top Draw
-	glBindVertexArray(topVAO);
-	glBindTexture(GL_TEXTURE_2D, topTex);
-	glDrawElements(GL_TRIANGLES, 180, GL_UNSIGNED_INT, 0);
-	glBindVertexArray(0);
+	// Table Top Draw, the next draw binds its own vertex array so there is no unbind in between
+	if (!vertexPulling) {
+		UStateBindVertexArray(topVAO);
+		for (int pass = 0; pass < UViewPasses(); pass++) {
+			UViewBeginPass(objectShaderProgram, pass, sceneViews, targetWidth, targetHeight);
+			if (gpuCulling) {
+				UCullDraw(1);
+			}
+			else {
+				glDrawElementsInstanced(GL_TRIANGLES, topIndexCount, GL_UNSIGNED_INT, 0, tableCount * UViewFanOut());
+			}
+			frameDrawCalls++;
+		}
+	}
 
 
 	// KEY LIGHT DRAW
 	// USE THE KEY LIGHT SHADER AND ACTIVATE LAMP VERTEX ARRAY OBJECT FOR RENDERING AND TRANSFORMING
-	glUseProgram(keyLightShaderProgram);
-	glBindVertexArray(keyLightVAO);
+	UShaderRequire(keyLightShaderProgram);
+	UStateUseProgram(keyLightShaderProgram);
+	UStateBindVertexArray(keyLightVAO);
 
 	// Transform the smaller pyramid used as a visual que for the light source
-	model = glm::translate(model, keyLightPosition);
-	model = glm::scale(model, lightScale);
+	model = UTransformWorld(sceneTransforms, keyLightNode);
 
 	// Reference matrix uniforms from the lamp shader program
 	modelLoc = glGetUniformLocation(keyLightShaderProgram, "model");
-	viewLoc = glGetUniformLocation(keyLightShaderProgram, "view");
-	projLoc = glGetUniformLocation(keyLightShaderProgram, "projection");
 
 	// Pass matrix data to the lamp shader program's matrix uniforms
 	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-	glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-	glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+	UViewSetUniforms(keyLightShaderProgram, sceneViews);
 
-	// Draw the smaller LAMP cube
-	glDrawArrays(GL_TRIANGLES, 0, 36);
-
-	// Deactivate the lamp vertex array object
-	glBindVertexArray(0);
+	// Draw the smaller LAMP cube, once per view
+	for (int pass = 0; pass < UViewPasses(); pass++) {
+		UViewBeginPass(keyLightShaderProgram, pass, sceneViews, targetWidth, targetHeight);
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 36, UViewFanOut());
+		frameDrawCalls++;
+	}
 
 	
 	// FILL LIGHT DRAW
 	// USE THE FILL LIGHT SHADER AND ACTIVATE LAMP VERTEX ARRAY OBJECT FOR RENDERING AND TRANSFORMING
-	glUseProgram(fillLightShaderProgram);
-	glBindVertexArray(fillLightVAO);
-	model = glm::translate(model, keyLightPosition);
-	model = glm::scale(model, lightScale);
-	modelLoc = glGetUniformLocation(keyLightShaderProgram, "model");
-	viewLoc = glGetUniformLocation(keyLightShaderProgram, "view");
-	projLoc = glGetUniformLocation(keyLightShaderProgram, "projection");
+	UShaderRequire(fillLightShaderProgram);
+	UStateUseProgram(fillLightShaderProgram);
+	UStateBindVertexArray(fillLightVAO);
+	model = UTransformWorld(sceneTransforms, fillLightNode);
+	modelLoc = glGetUniformLocation(fillLightShaderProgram, "model");
 	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-	glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-	glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-	glDrawArrays(GL_TRIANGLES, 0, 36);
-	glBindVertexArray(0);
+	UViewSetUniforms(fillLightShaderProgram, sceneViews);
+	for (int pass = 0; pass < UViewPasses(); pass++) {
+		UViewBeginPass(fillLightShaderProgram, pass, sceneViews, targetWidth, targetHeight);
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 36, UViewFanOut());
+		frameDrawCalls++;
+	}
+
+	// The next frame's occlusion culling tests against this frame's depth
+	GLuint sceneDepth;
+	int sceneWidth;
+	int sceneHeight;
+	if (gpuCulling && UPostSceneDepth(sceneDepth, sceneWidth, sceneHeight)) {
+		UCullBuildHiZ(sceneDepth, sceneWidth, sceneHeight);
+	}
 
 	// CLEAN UP
 	glutPostRedisplay();
-	glBindVertexArray(0); //Deactivate the vertex array object
+	UStateBindVertexArray(0); //Deactivate the vertex array object
+	UPostEndScene(); // tone mapping, antialiasing, grading and the upscale to window size
+	UResolutionEnd();
+	UCaptureFrame(windowWidth, windowHeight); // queues a read of the finished frame, collected frames later
 	glutSwapBuffers(); // Flips the back buffer to the front buffer every frame.
+	UTraceFrame();
+	ULatencyFrameSubmitted(); // waits here while too many frames are queued
+	UTimelineReport(); // once, after the first frame
+	GlStateStats stateStats = UStateEndFrame();
+
+	// Replays time every frame and exit with their verdict after the last one
+	if (UReplaying()) {
+		UReplayFrameDone(frameDrawCalls, stateStats.totalIssued, stateStats.totalElided);
+	}
+
+}
+
+
+// Builds the scene's transform hierarchy, tables are added under roomNode by UCreateBuffers
+void UCreateTransforms(void) {
+
+	glm::mat4 room = glm::scale(glm::translate(glm::mat4(1.0f), objectPosition), objectScale);
+	glm::mat4 keyLight = glm::scale(glm::translate(glm::mat4(1.0f), keyLightPosition), lightScale);
+	glm::mat4 fillLight = glm::scale(glm::translate(glm::mat4(1.0f), fillLightPosition), lightScale);
+
+	sceneNode = UTransformAdd(sceneTransforms, TRANSFORM_NO_PARENT, glm::mat4(1.0f));
+	roomNode = UTransformAdd(sceneTransforms, sceneNode, room);
+	keyLightNode = UTransformAdd(sceneTransforms, sceneNode, keyLight);
+	fillLightNode = UTransformAdd(sceneTransforms, sceneNode, fillLight);
 
 }
 
@@ -478,270 +835,277 @@ void URenderGraphics(void) {
 // Implements the UCreateBuffers function
 void UCreateBuffers() {
 
+	// Table geometry, see Geometry.cpp, or generated with --procedural
+	Mesh legMesh;
+	Mesh topMesh;
+	vector<float> lightV;
+	if (generatorOptions.procedural) {
+		UGenerateTable(generatorOptions.table, legMesh, topMesh);
+	}
+	else {
+		UBuildTableLegs(legMesh);
+		UBuildTableTop(topMesh);
+	}
+	UBuildLightCube(lightV);
 
-	float legVertices[] = {
-
-		// Position				// Normals				//TexCoords
-		// Left Front Leg		
-		-0.5f, -0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		0.0f, 0.0f,		// vert 0 
-		-0.4f, -0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		1.0f, 0.0f,		// vert 1
-		-0.4f,  0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		1.0f, 1.0f,		// vert 2
-		-0.5f,  0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		0.0f, 1.0f,		// vert 3
-		-0.5f, -0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		1.0f, 0.0f,		// vert 4 
-		-0.5f,  0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		1.0f, 1.0f,		// vert 5
-		-0.4f, -0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		0.0f, 0.0f,		// vert 6
-		-0.4f,	0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		0.0f, 1.0f,		// vert 7
-
-		 // Right Front Leg
-		 0.4f, -0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		0.0f, 0.0f,		// vert 8 
-		 0.5f, -0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		1.0f, 0.0f,		// vert 9
-		 0.5f,  0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		1.0f, 1.0f,		// vert 10
-		 0.4f,  0.5f,  0.5f,	0.0f, 0.0f,  1.0f,		0.0f, 1.0f,		// vert 11
-		 0.4f, -0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		1.0f, 0.0f,		// vert 12
-		 0.4f,  0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		1.0f, 1.0f,		// vert 13
-		 0.5f, -0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		0.0f, 0.0f,		// vert 14
-		 0.5f,  0.5f,  0.4f,	0.0f, 0.0f, -1.0f,		0.0f, 1.0f,		// vert 15
-
-		 // Right Back Leg
-		 0.4f, -0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		0.0f, 0.0f,		// vert 16
-		 0.5f, -0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		1.0f, 0.0f,		// vert 17
-		 0.5f,  0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		1.0f, 1.0f,		// vert 18
-		 0.4f,  0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		0.0f, 1.0f,		// vert 19
-		 0.4f, -0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		1.0f, 0.0f,		// vert 20
-		 0.4f,  0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		1.0f, 1.0f,		// vert 21
-		 0.5f, -0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		0.0f, 0.0f,		// vert 22
-		 0.5f,  0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		0.0f, 1.0f,		// vert 23
-
-		// Left Back Leg
-		-0.5f, -0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		0.0f, 0.0f,		// vert 24
-		-0.4f, -0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		1.0f, 0.0f,		// vert 25
-		-0.4f,  0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		1.0f, 1.0f,		// vert 26
-		-0.5f,  0.5f, -0.4f,	0.0f, 0.0f,  1.0f,		0.0f, 1.0f,		// vert 27
-		-0.5f, -0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		1.0f, 0.0f,		// vert 28
-		-0.5f,  0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		1.0f, 1.0f,		// vert 29
-		-0.4f, -0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		0.0f, 0.0f,		// vert 30
-		-0.4f,  0.5f, -0.5f,	0.0f, 0.0f, -1.0f,		0.0f, 1.0f		// vert 31
-	};
+	// A room of tables is drawn as instances, or baked into the meshes with --bake
+	vector<glm::mat4> roomTransforms = URoomTransforms(generatorOptions.room);
+	tableNodes.clear();
+	for (size_t i = 0; i < roomTransforms.size(); i++) {
+		tableNodes.push_back(UTransformAdd(sceneTransforms, roomNode, roomTransforms[i]));
+	}
+	if (generatorOptions.bake) {
+		tableTransforms.assign(1, glm::mat4(1.0f));
+	}
+	else {
+		tableTransforms = roomTransforms;
+	}
 
-	float topVertices[] 
-	{
+	// The legs and the top are prepared side by side on the task threads. Imported models replace
+	// either, --bake replicates them over the room, and each one's bounds and picking hierarchy
+	// follow as a continuation, so the legs' hierarchy builds while the top may still be importing.
+	const string* modelPaths[] = { &importOptions.modelPath, &importOptions.topModelPath };
+	Mesh* meshes[] = { &legMesh, &topMesh };
+	ImportStats importStats[2];
+	bool imported[2] = { true, true };
+	glm::vec3 boundsMin[2];
+	glm::vec3 boundsMax[2];
+	PickBvh pickBvhs[2];
+	TaskCounter shaped[2]; // each mesh in its final form
+	TaskCounter prepared; // bounds and picking hierarchies
+	for (int i = 0; i < 2; i++) {
+		UTaskRun([&, i] {
+			if (!modelPaths[i]->empty()) {
+				imported[i] = UImportModel(*modelPaths[i], *meshes[i], importStats[i]);
+			}
+			if (imported[i] && generatorOptions.bake) {
+				Mesh meshTemplate;
+				swap(meshTemplate, *meshes[i]);
+				UReplicateMesh(meshTemplate, roomTransforms, *meshes[i]);
+			}
+		}, &shaped[i]);
+		UTaskRun([&, i] {
+			if (imported[i]) {
+				UMeshBounds(*meshes[i], boundsMin[i], boundsMax[i]);
+				UBvhBuild(*meshes[i], pickBvhs[i]);
+			}
+		}, &prepared, &shaped[i]);
+	}
 
-		// Table Top
-		-0.6f,  0.5f,  0.6f,	0.0f, 1.0f, 1.0f,		0.0f, 0.0f,		// vert 0
-		 0.6f,  0.5f,  0.6f,	0.0f, 1.0f, 1.0f,		1.0f, 0.0f,		// vert 1	
-		 0.6f,  0.6f,  0.6f,	0.0f, 1.0f, 1.0f,		1.0f, 1.0f,		// vert 2	
-		-0.6f,  0.6f,  0.6f,	0.0f, 1.0f, 1.0f,		0.0f, 1.0f,		// vert 3	
-		-0.6f,  0.5f, -0.6f,	0.0f, 1.0f, 1.0f,		1.0f, 0.0f,		// vert 4	
-		-0.6f,  0.6f, -0.6f,	0.0f, 1.0f, 1.0f,		1.0f, 1.0f,		// vert 5	
-		 0.6f,  0.5f, -0.6f,	0.0f, 1.0f, 1.0f,		0.0f, 0.0f,		// vert 6	
-		 0.6f,  0.6f, -0.6f,	0.0f, 1.0f, 1.0f,		0.0f, 1.0f		// vert 7	
+	// Generate buffer IDs
+	legVBO = UGpuGenBuffer("legVBO");
+	legEBO = UGpuGenBuffer("legEBO");
+	topVBO = UGpuGenBuffer("topVBO");
+	topEBO = UGpuGenBuffer("topEBO");
+	lightVBO = UGpuGenBuffer("lightVBO");
+	instanceVBO = UGpuGenBuffer("instanceVBO");
+
+	legVAO = UGpuGenVertexArray("legVAO");
+	topVAO = UGpuGenVertexArray("topVAO");
+	fillLightVAO = UGpuGenVertexArray("fillLightVAO");
+	keyLightVAO = UGpuGenVertexArray("keyLightVAO");
 
-	};
+	// KEY LIGHT
+	UStateBindVertexArray(keyLightVAO);
+	UStateBindBuffer(GL_ARRAY_BUFFER, lightVBO);
+	UGpuBufferData(GL_ARRAY_BUFFER, lightVBO, lightV.size() * sizeof(float), lightV.data(), GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
+	glEnableVertexAttribArray(0);
+	UStateBindVertexArray(0);
 
-	GLuint legIndicies[]
-	{
-		// Left Front Leg
-		0,1,2,		2,3,0,		3,0,4,		4,5,3,		5,4,6,		6,7,5,
-		6,7,2,		2,1,6,		3,2,7,		7,5,3,		0,1,6,		6,4,0,
+	// FILL LIGHT
+	UStateBindVertexArray(fillLightVAO);
+	UStateBindBuffer(GL_ARRAY_BUFFER, lightVBO);
+	UGpuBufferData(GL_ARRAY_BUFFER, lightVBO, lightV.size() * sizeof(float), lightV.data(), GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
+	glEnableVertexAttribArray(0);
+	UStateBindVertexArray(0);
+
+	// The GL thread helps with whatever is left of the meshes, then of their hierarchies
+	UTaskWait(shaped[0]);
+	UTaskWait(shaped[1]);
+	UTaskWait(prepared);
+	for (int i = 0; i < 2; i++) {
+		if (!imported[i]) {
+			std::exit(EXIT_FAILURE);
+		}
+		if (!modelPaths[i]->empty()) {
+			std::cout << "Imported " << *modelPaths[i] << ": " << importStats[i].fileBytes / (1024.0 * 1024.0) << " MB, " << importStats[i].vertices
+				<< " vertices, " << importStats[i].triangles << " triangles in " << importStats[i].milliseconds << " ms\n";
+		}
+	}
 
-		// Right Front Leg
-		8,9,10,		10,11,8,	11,8,12,	12,13,11,	13,12,14,	14,15,13,
-		14,15,10,	10,9,14,	11,10,15,	15,13,11,	8,9,14,		14,12,8,
+	// Culling bounds cover one table, or the whole room once baked
+	tableBoundsMin = glm::min(boundsMin[0], boundsMin[1]);
+	tableBoundsMax = glm::max(boundsMax[0], boundsMax[1]);
+
+	// Picking hierarchies, the instances are set with the draw instances
+	UPickClear();
+	pickLegMesh = UPickAddBvh(pickBvhs[0]);
+	UPickAddBvh(pickBvhs[1]);
+
+	legIndexCount = (GLuint)legMesh.indices.size();
+	topIndexCount = (GLuint)topMesh.indices.size();
+
+	// Vertex pulling keeps only the shapes of the tables on the GPU, the meshes stay on the CPU for picking
+	if (vertexPulling) {
+		vector<Shape> shapes;
+		UBuildTableLegShapes(shapes, MATERIAL_LEG);
+		UBuildTableTopShapes(shapes, MATERIAL_TOP);
+		UPullSetShapes(shapes);
+		size_t meshBytes = (legMesh.vertices.size() + topMesh.vertices.size()) * sizeof(float)
+			+ (legMesh.indices.size() + topMesh.indices.size()) * sizeof(GLuint);
+		std::cout << "Vertex pulling: " << shapes.size() << " shapes in " << shapes.size() * sizeof(Shape) << " bytes instead of "
+			<< meshBytes << " bytes of vertices and indices, " << sizeof(glm::mat4) << " bytes per table instead of "
+			<< 2 * sizeof(DrawInstance) << "\n";
+	}
+	else {
+		// Table Legs
+		// Activate the VAO before binding and setting any VBOs and Vertex Attribute Pointers
+		UStateBindVertexArray(legVAO);
 
-		// Right Back Leg
-		16,17,18,	18,19,16,	19,16,20,	20,21,19,	21,20,22,	22,23,21,
-		22,23,18,	18,17,22,	19,18,23,	23,21,19,	16,17,22,	22,20,16,
+		// Activate the VBO
+		UStateBindBuffer(GL_ARRAY_BUFFER, legVBO);
+		UGpuBufferData(GL_ARRAY_BUFFER, legVBO, legMesh.vertices.size() * sizeof(float), legMesh.vertices.data(), GL_STATIC_DRAW); // Copy vertices to VBO
 
-		// Left Back Leg
-		24,25,26,	26,27,24,	27,24,28,	28,29,27,	29,28,30,	30,31,29,
-		30,31,26,	26,25,30,	27,26,31,	31,29,27,	24,25,30,	30,28,24
+		// Activate the EBO for index connections
+		UStateBindBuffer(GL_ELEMENT_ARRAY_BUFFER, legEBO);
+		UGpuBufferData(GL_ELEMENT_ARRAY_BUFFER, legEBO, legMesh.indices.size() * sizeof(GLuint), legMesh.indices.data(), GL_STATIC_DRAW);
 
-	};
+		// Set attrib ptr 0 to hold Position data
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(0); // Enable vertex attribute 0
 
-	GLuint topIndices[]
-	{
+		// Set attrib ptr 1 to hold normal data
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+		glEnableVertexAttribArray(1); // Enable vertex attribute 1
+
+		// Set attrib ptr 2 to hold texture data
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+		glEnableVertexAttribArray(2);
+		UStateBindVertexArray(0); // Deactivates the VAO
 
 		// Table Top
-		0,1,2,		2,3,0,		3,0,4,		4,5,3,		5,4,6,		6,7,5,
-		6,7,2,		2,1,6,		3,2,7,		7,5,3,		0,1,6,		6,4,0
+		UStateBindVertexArray(topVAO);
+		UStateBindBuffer(GL_ARRAY_BUFFER, topVBO);
+		UGpuBufferData(GL_ARRAY_BUFFER, topVBO, topMesh.vertices.size() * sizeof(float), topMesh.vertices.data(), GL_STATIC_DRAW);
+		UStateBindBuffer(GL_ELEMENT_ARRAY_BUFFER, topEBO);
+		UGpuBufferData(GL_ELEMENT_ARRAY_BUFFER, topEBO, topMesh.indices.size() * sizeof(GLuint), topMesh.indices.data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+		glEnableVertexAttribArray(2);
+		UStateBindVertexArray(0);
+	}
 
-	};
+	// Per-instance material and transform for the leg and top batches
+	UUploadInstances();
 
-	float lightV[]
-	{
-		//Position				
-		// Back Face			
-		 0.5f, -0.5f, -0.5f,
-		 0.5f,  0.5f, -0.5f,
-		 0.5f,  0.5f, -0.5f,
-		-0.5f,  0.5f, -0.5f,
-		-0.5f, -0.5f, -0.5f,
-
-		// Front Face
-		-0.5f, -0.5f,  0.5f,
-		 0.5f, -0.5f,  0.5f,
-		 0.5f,  0.5f,  0.5f,
-		 0.5f,  0.5f,  0.5f,
-		-0.5f,  0.5f,  0.5f,
-		-0.5f, -0.5f,  0.5f,
-
-		// Left Face
-		-0.5f,  0.5f,  0.5f,
-		-0.5f,  0.5f, -0.5f,
-		-0.5f, -0.5f, -0.5f,
-		-0.5f, -0.5f, -0.5f,
-		-0.5f, -0.5f,  0.5f,
-		-0.5f,  0.5f,  0.5f,
-
-		// Right Face
-		 0.5f,  0.5f,  0.5f,
-		 0.5f,  0.5f, -0.5f,
-		 0.5f, -0.5f, -0.5f,
-		 0.5f, -0.5f, -0.5f,
-		 0.5f, -0.5f,  0.5f,
-		 0.5f,  0.5f,  0.5f,
-
-		// Bottom Face
-		-0.5f, -0.5f, -0.5f,
-		 0.5f, -0.5f, -0.5f,
-		 0.5f, -0.5f,  0.5f,
-		 0.5f, -0.5f,  0.5f,
-		-0.5f, -0.5f,  0.5f,
-		-0.5f, -0.5f, -0.5f,
-
-		// Top Face	
-		-0.5f,  0.5f, -0.5f,
-		 0.5f,  0.5f, -0.5f,
-		 0.5f,  0.5f,  0.5f,
-		 0.5f,  0.5f,  0.5f,
-		-0.5f,  0.5f,  0.5f,
-		-0.5f,  0.5f, -0.5f
-	
-	};
+}
 
-	// Generate buffer IDs
-	glGenBuffers(1, &legVBO);
-	glGenBuffers(1, &legEBO);
-	glGenBuffers(1, &topVBO);
-	glGenBuffers(1, &topEBO);
-	glGenBuffers(1, &lightVBO);
-
-	glGenVertexArrays(1, &legVAO);
-	glGenVertexArrays(1, &topVAO);
-	glGenVertexArrays(1, &fillLightVAO);
-	glGenVertexArrays(1, &keyLightVAO);
-
-	// Table Legs
-	// Activate the VAO before binding and setting any VBOs and Vertex Attribute Pointers
-	glBindVertexArray(legVAO);
-
-	// Activate the VBO
-	glBindBuffer(GL_ARRAY_BUFFER, legVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(legVertices), legVertices, GL_STATIC_DRAW); // Copy vertices to VBO
-
-	// Activate the EBO for index connections
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, legEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(legIndicies), legIndicies, GL_STATIC_DRAW);
-
-	// Set attrib ptr 0 to hold Position data
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-	glEnableVertexAttribArray(0); // Enable vertex attribute 0
-
-	// Set attrib ptr 1 to hold normal data
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(1); // Enable vertex attribute 1
-
-	// Set attrib ptr 2 to hold texture data
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-	glEnableVertexAttribArray(2);
-	glBindVertexArray(0); // Deactivates the VAO
-
-	// Table Top
-	glBindVertexArray(topVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, topVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(topVertices), topVertices, GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, topEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(topIndices), topIndices, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-	glEnableVertexAttribArray(2);
-	glBindVertexArray(0);
 
-	// KEY LIGHT
-	glBindVertexArray(keyLightVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, lightVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(lightV), lightV, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-	glEnableVertexAttribArray(0);
-	glBindVertexArray(0);
+// Fills instanceVBO with one leg instance and one top instance per table
+// and points the instanced attributes of legVAO and topVAO at their ranges
+void UUploadInstances(void) {
 
-	// FILL LIGHT
-	glBindVertexArray(fillLightVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, lightVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(lightV), lightV, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-	glEnableVertexAttribArray(0);
-	glBindVertexArray(0);
+	vector<DrawInstance> instances;
+	tableCount = (GLsizei)tableTransforms.size();
+
+	// Vertex pulling reads one transform per table, the shapes carry the materials
+	if (vertexPulling) {
+		UPullSetInstances(tableTransforms);
+		UPickSetInstances(tableTransforms);
+		return;
+	}
+
+	// Legs first, then tops, so each VAO reads a contiguous range
+	for (GLsizei i = 0; i < tableCount; i++) {
+		DrawInstance leg = { tableTransforms[i], MATERIAL_LEG, { 0, 0, 0 } };
+		instances.push_back(leg);
+	}
+	for (GLsizei i = 0; i < tableCount; i++) {
+		DrawInstance top = { tableTransforms[i], MATERIAL_TOP, { 0, 0, 0 } };
+		instances.push_back(top);
+	}
+
+	UStateBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	UGpuBufferData(GL_ARRAY_BUFFER, instanceVBO, instances.size() * sizeof(DrawInstance), instances.data(), GL_STATIC_DRAW);
+	UPickSetInstances(tableTransforms);
+
+	GLuint vaos[] = { legVAO, topVAO };
+	for (int v = 0; v < 2; v++) {
+		size_t base = v * tableCount * sizeof(DrawInstance);
+		UStateBindVertexArray(vaos[v]);
+
+		// Set attrib ptr 3 to hold the material ID, advanced once per table after all its views
+		glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(DrawInstance), (void*)(base + offsetof(DrawInstance, material)));
+		glEnableVertexAttribArray(3);
+		glVertexAttribDivisor(3, UViewFanOut());
+
+		// Set attrib ptrs 4 - 7 to hold the instance model matrix, one column each
+		for (int column = 0; column < 4; column++) {
+			glVertexAttribPointer(4 + column, 4, GL_FLOAT, GL_FALSE, sizeof(DrawInstance), (void*)(base + offsetof(DrawInstance, model) + column * sizeof(glm::vec4)));
+			glEnableVertexAttribArray(4 + column);
+			glVertexAttribDivisor(4 + column, UViewFanOut());
+		}
+	}
+	UStateBindVertexArray(0);
+
+	// The culling pass rewrites both ranges every frame with only the visible tables
+	if (gpuCulling) {
+		vector<CullDraw> draws(2);
+		draws[0].indexCount = legIndexCount;
+		draws[0].material = MATERIAL_LEG;
+		draws[1].indexCount = topIndexCount;
+		draws[1].material = MATERIAL_TOP;
+		UCullSetInstances(tableTransforms, tableBoundsMin, tableBoundsMax, draws, instanceVBO);
+	}
 
 }
 
 
+// Creates the material texture array, its finer mips stream in as the tables need them
 void UGenerateTexture(void) {
-	// Local Variable Declarations
-	int width;
-	int height;
-	// Loads texture file
-	unsigned char* topImage = SOIL_load_image("TableTop.jpg", &width, &height, 0, SOIL_LOAD_RGB);
-	unsigned char* legImage = SOIL_load_image("TableLeg.jpg", &width, &height, 0, SOIL_LOAD_RGB);
-	
-	// Create texture
-	glGenTextures(1, &topTex);
-	// Bind to type of texture
-	glBindTexture(GL_TEXTURE_2D, topTex);
-
-	// Load the texture image - TableTop.jpg
-	// Parameters: (1) Texture Target, (2) Level of Detail, (3) Internal Pixel Format
-	// (4) Width, (5) Height, (6) "0", (7 & 8) Format of Pixels, (9) Image Array
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, topImage);
-	// Filter texture with mipmap to provide higher quality and performance
-	glGenerateMipmap(GL_TEXTURE_2D);
-	// Load configured image texture
-	SOIL_free_image_data(topImage);
-	// Deactivate texture after using it
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	// Load the texture image - TableLeg.jpg
-	glGenTextures(1, &legTex);
-	glBindTexture(GL_TEXTURE_2D, legTex);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, legImage);
-	glGenerateMipmap(GL_TEXTURE_2D);
-	SOIL_free_image_data(legImage);
-	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// Layer order matches the material table
+	vector<string> layerFiles;
+	layerFiles.push_back("TableLeg.jpg");
+	layerFiles.push_back("TableTop.jpg");
+
+	materialTexStream = UStreamCreateArray(layerFiles, materialTexArray);
+
+	// Draw nothing until every texture has its coarse mips
+	UStreamWaitResident();
 
 }
 
 
-// Implements the UMouseClick function
-void UMouseClick(int button, int state, int x, int y) {
+// Builds the material table and uploads it to materialUBO
+void UCreateMaterials(void) {
 
-	if ((button == GLUT_LEFT_BUTTON) && (state == GLUT_DOWN)) {
-		leftButton = true; // pressed
-	}
+	// layer, key specular, fill specular, highlight size
+	Material leg = { 0, 1.0f, 0.1f, 16.0f };
+	Material top = { 1, 1.0f, 0.1f, 16.0f };
+	materials.assign(MAX_MATERIALS, leg);
+	materials[MATERIAL_LEG] = leg;
+	materials[MATERIAL_TOP] = top;
 
-	if ((button == GLUT_LEFT_BUTTON) && (state == GLUT_UP)) {
-		leftButton = false; // released
-	}
+	materialUBO = UGpuGenBuffer("materialUBO");
+	UStateBindBuffer(GL_UNIFORM_BUFFER, materialUBO);
+	UGpuBufferData(GL_UNIFORM_BUFFER, materialUBO, MAX_MATERIALS * sizeof(Material), materials.data(), GL_STATIC_DRAW);
+	UStateBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-	if ((button == GLUT_RIGHT_BUTTON) && (state == GLUT_DOWN)) {
-		rightButton = true; // pressed
-	}
+}
 
-	if ((button == GLUT_RIGHT_BUTTON) && (state == GLUT_UP)) {
-		rightButton = false; // released
-	}
+
+// Implements the UMouseClick function
+void UMouseClick(int button, int state, int x, int y) {
+
+	// Queue the click, UCoalesceInput tracks the button state
+	InputEvent event = { INPUT_MOUSE_BUTTON, x, y, button, state, 0, glutGetModifiers(), -1.0 };
+	UQueueInput(event);
 
 }
 
@@ -753,73 +1117,130 @@ void UMouseMove(int x, int y) {
 	// Allows access to SHIFT, CTRL, and ALT keys
 	int mod = glutGetModifiers();
 
-	if (mouseDetected) {
+	// Queue the movement, orbit and zoom are worked out once per frame
+	InputEvent event = { INPUT_MOUSE_MOVE, x, y, 0, 0, 0, mod, -1.0 };
+	UQueueInput(event);
 
-		lastMouseX = x;
-		lastMouseY = y;
-		mouseDetected = false;
+}
+
+
+// Folds the queued input into the camera simulation and advances it to the current time
+void UUpdateCamera(void) {
 
+	double now = UElapsedSeconds();
+	double frameSeconds = now - lastFrameTime;
+	lastFrameTime = now;
+
+	// A replay drives the simulation with its recorded frame times and input instead of the clock
+	if (UReplaying()) {
+		UReplayFrame(frameSeconds);
+	}
+	else if (URecording()) {
+		URecordFrame(frameSeconds, UPendingInput());
 	}
 
-	front.x = 10.0f * cos(yaw);
-	front.y = 10.0f * sin(pitch);
-	front.z = sin(yaw) * cos(pitch) * 10.0f;
+	// Replayed events carry the recording's timestamps, so only live input is measured
+	if (!UReplaying()) {
+		ULatencyConsume(UPendingInput());
+	}
 
-	// Orbit around 3D object while holding ALT and click/hold the left mouse button, then move mouse
-	if (leftButton && mod == 4) {
+	// A left click without ALT, which orbits, picks
+	const vector<InputEvent>& events = UPendingInput();
+	for (size_t i = 0; i < events.size(); i++) {
+		if (events[i].type == INPUT_MOUSE_BUTTON && events[i].button == GLUT_LEFT_BUTTON && events[i].state == GLUT_DOWN
+			&& !(events[i].modifiers & GLUT_ACTIVE_ALT))
+		{
+			pickPending = true;
+			pickX = events[i].x;
+			pickY = events[i].y;
+		}
+	}
 
-		// Gets the direction the mouse was moved in x and y
-		mouseXOffset = x - lastMouseX;
-		mouseYOffset = lastMouseY - y; // inverted Y
+	FrameInput input = UCoalesceInput();
+	leftButton = input.leftButton;
+	rightButton = input.rightButton;
 
-		// Updates with new mouse coords
-		lastMouseX = x;
-		lastMouseY = y;
+	UCameraApplyInput(cameraSim, input, sensitivity);
+	UCameraAdvance(cameraSim, frameSeconds, cameraSpeed);
 
-		// Applies sensitivity to mouse direction
-		mouseXOffset *= sensitivity;
-		mouseYOffset *= sensitivity;
+	// Front vector is computed once per frame from the interpolated orientation
+	CameraState camera = UCameraInterpolate(cameraSim);
+	cameraPosition = camera.position;
+	front = UCameraFront(camera.yaw, camera.pitch);
 
-		// Accumulates the yaw and pitch vars
-		yaw += mouseXOffset;
-		pitch += mouseYOffset;
+}
 
-		front.x = 10.0f * cos(yaw);
-		front.y = 10.0f * sin(pitch);
-		front.z = sin(yaw) * cos(pitch) * 10.0f;
 
-	}
-	// Right mouse click and hold while holding ALT to zoom IN (Drag UP) and zoom OUT (Drag DOWN)
-	if (rightButton && mod == 4) {
+// Sphere around every table and both lights, framed by the orthographic views. Never smaller
+// than the room the single orthographic view used to show, and only worked out with more than one view.
+void USceneBounds(glm::vec3& center, float& radius) {
 
-		if (y > prevY) {
-			cameraPosition += cameraSpeed * CameraForwardZ;
-		}
-		if (y < prevY) {
-			cameraPosition -= cameraSpeed * CameraForwardZ;
-		}
-		prevY = y;
+	center = glm::vec3(0.0f);
+	radius = 5.0f;
+	if (UViewCount() == 1) {
+		return;
+	}
 
+	glm::vec3 low = UTransformWorldPosition(sceneTransforms, keyLightNode);
+	glm::vec3 high = low;
+	glm::vec3 fillLight = UTransformWorldPosition(sceneTransforms, fillLightNode);
+	low = glm::min(low, fillLight);
+	high = glm::max(high, fillLight);
+	for (size_t i = 0; i < tableNodes.size(); i++) {
+		glm::vec3 table = UTransformWorldPosition(sceneTransforms, tableNodes[i]);
+		low = glm::min(low, table);
+		high = glm::max(high, table);
 	}
+
+	// Table positions are their origins, pad by a table so the outer ones stay whole
+	float tableSize = max(generatorOptions.table.width, generatorOptions.table.depth) * objectScale.x;
+	center = (low + high) * 0.5f;
+	radius = max(radius, glm::length(high - low) * 0.5f + tableSize);
+
 }
 
 
-// Implement Keyboard function
-void UKeyboard(unsigned char key, int x, int y)
-{
-	glm::mat4 projection;
-	int VIEW = glutGetModifiers();
+// Casts a ray through the click, in whichever view it landed, and reports the nearest table part it hits
+void UPickUnderCursor(const glm::mat4& model, const SceneView* views) {
 
-	// Hold SHIFT to view ORTHO
-	if (VIEW == 1)
-	{
-		projection = glm::ortho(-5.0f, 5.0f, -5.0f, 5.0f, 0.1f, 100.0f); // orthographic view
+	double start = UElapsedSeconds();
+	glm::vec3 origin;
+	glm::vec3 direction;
+	PickHit hit;
+	int viewX, viewY, viewWidth, viewHeight;
+	int v = UViewAt(pickX, pickY, windowWidth, windowHeight, views, viewX, viewY, viewWidth, viewHeight);
+	UPickRay(viewX, viewY, viewWidth, viewHeight, views[v].view, views[v].projection, origin, direction);
+	bool found = UPickScene(origin, direction, model, hit);
+	double microseconds = (UElapsedSeconds() - start) * 1e6;
 
+	if (!found) {
+		std::cout << "Picked nothing in " << microseconds << " us\n";
+		return;
 	}
-	// views PERSPECTIVE by deafault
-	else
-	{
-		projection = glm::perspective(45.0f, (GLfloat)windowWidth / (GLfloat)windowHeight, 0.1f, 100.0f); // perspective view
+	const char* part = (hit.mesh == pickLegMesh) ? "legs" : "top";
+	if (generatorOptions.bake) {
+		std::cout << "Picked the baked room's " << part;
 	}
+	else {
+		std::cout << "Picked table " << hit.instance << " " << part;
+	}
+	std::cout << ", triangle " << hit.triangle << " at (" << hit.point.x << ", " << hit.point.y << ", " << hit.point.z << ") in "
+		<< microseconds << " us\n";
+
+}
+
+
+// Implement Keyboard function, the orthographic view is drawn beside the perspective one with --views
+void UKeyboard(unsigned char key, int x, int y)
+{
+	InputEvent event = { INPUT_KEY_DOWN, x, y, 0, 0, key, glutGetModifiers(), -1.0 };
+	UQueueInput(event);
+}
 
+
+// Implement Keyboard release function
+void UKeyboardUp(unsigned char key, int x, int y)
+{
+	InputEvent event = { INPUT_KEY_UP, x, y, 0, 0, key, glutGetModifiers(), -1.0 };
+	UQueueInput(event);
 }
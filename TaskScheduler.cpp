@@ -0,0 +1,449 @@
+/*
+*	Title:	Final Project / TaskScheduler.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Deques, workers and waits. Each deque has its own lock,
+*	taken by its owner at the back and by thieves at the front. The locks
+*	are only ever held for a push or a pop, so they are almost never
+*	contended. A count of queued tasks lets an idle worker go to sleep
+*	without scanning, and lets a push skip the wake up when every worker is
+*	already busy. Busy time is measured per outermost task, less whatever
+*	the task spent blocked in UTaskWait, so nested tasks are not counted
+*	twice.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "TaskScheduler.h"
+
+using namespace std; // standard namespace
+
+#define TASK_MAX_OUTSIDE 16			// outside threads with a deque of their own, later ones share the last
+#define TASK_SLICES_PER_THREAD 4	// parallel-for slices per thread, the spare ones even out slow slices
+#define TASK_POLL_US 100			// how often a worker blocked in UTaskWait looks for work to steal
+
+struct Task {
+	function<void(void)> work;
+	TaskCounter* done;
+};
+
+// One thread's deque, and what that thread did
+struct TaskQueue {
+	mutex lock;
+	deque<Task*> tasks;
+	atomic<long long> run;
+	atomic<long long> stolen;
+	atomic<long long> busyNs;
+	atomic<long long> waitNs;
+};
+
+// Workers use the first TASK_MAX_WORKERS deques, outside threads the rest
+static TaskQueue queues[TASK_MAX_WORKERS + TASK_MAX_OUTSIDE];
+static vector<thread> workers;
+static int workerCount = 0;					// workers running, 0 runs every task where it is submitted
+static int startedWorkers = 0;				// workers the stats cover
+static atomic<int> outsideThreads(0);		// outside threads given a deque so far
+static atomic<int> queued(0);				// tasks sitting in a deque
+static atomic<int> sleepingWorkers(0);
+static mutex sleepMutex;
+static condition_variable wake;
+static bool stopping = false;
+static chrono::steady_clock::time_point startTime;
+static double stoppedWallMs = -1.0;			// wall time the stats cover once the workers are joined
+
+static thread_local int threadSlot = -1;
+static thread_local bool workerThread = false;
+static thread_local int taskDepth = 0;			// tasks running on this thread, nested ones included
+static thread_local long long blockedNs = 0;	// time this thread has spent blocked in UTaskWait
+
+static void UTaskPush(Task* task);
+
+
+static long long UNanoseconds(chrono::steady_clock::time_point start) {
+
+	return (long long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+}
+
+
+// Deque of the calling thread, an outside thread gets one on its first task
+static int UThreadSlot(void) {
+
+	if (threadSlot < 0) {
+		threadSlot = TASK_MAX_WORKERS + min(outsideThreads.fetch_add(1), TASK_MAX_OUTSIDE - 1);
+	}
+	return threadSlot;
+
+}
+
+
+// Deque number i counting the workers' first and then the outside threads' with no gap
+static int UDenseSlot(int i) {
+
+	return i < workerCount ? i : TASK_MAX_WORKERS + i - workerCount;
+
+}
+
+
+// Takes a task for the thread in slot: its own newest one, or with steal the oldest one of another
+// thread. With filter it only takes its own tasks counted into filter.
+static Task* UTaskTake(int slot, TaskCounter* filter, bool steal) {
+
+	if (queued.load() == 0) {
+		return NULL;
+	}
+
+	{
+		TaskQueue& own = queues[slot];
+		lock_guard<mutex> lock(own.lock);
+		for (size_t i = own.tasks.size(); i-- > 0;) {
+			Task* task = own.tasks[i];
+			if (filter == NULL || task->done == filter) {
+				own.tasks.erase(own.tasks.begin() + i);
+				queued--;
+				return task;
+			}
+		}
+	}
+	if (!steal) {
+		return NULL;
+	}
+
+	// Start after this thread so the thieves spread out over the victims
+	int slots = workerCount + min(outsideThreads.load(), TASK_MAX_OUTSIDE);
+	int first = slot < TASK_MAX_WORKERS ? slot : workerCount + slot - TASK_MAX_WORKERS;
+	for (int k = 1; k < slots; k++) {
+		TaskQueue& victim = queues[UDenseSlot((first + k) % slots)];
+		lock_guard<mutex> lock(victim.lock);
+		if (!victim.tasks.empty()) {
+			Task* task = victim.tasks.front();
+			victim.tasks.pop_front();
+			queued--;
+			queues[slot].stolen++;
+			return task;
+		}
+	}
+	return NULL;
+
+}
+
+
+// One task finished: counts it off and releases the tasks held back once the counter is done
+static void UTaskFinish(TaskCounter* counter) {
+
+	if (counter == NULL) {
+		return;
+	}
+	vector<Task*> released;
+	{
+		lock_guard<mutex> lock(counter->mutex);
+		if (--counter->pending > 0) {
+			return;
+		}
+		released.swap(counter->waiting);
+		counter->finished.notify_all();
+	}
+
+	// The counter may be gone once its lock is released, the waiter is free to return
+	for (size_t i = 0; i < released.size(); i++) {
+		UTaskPush(released[i]);
+	}
+
+}
+
+
+static void URunTask(Task* task, int slot) {
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	long long blockedBefore = blockedNs;
+	taskDepth++;
+	task->work();
+	taskDepth--;
+	if (taskDepth == 0) {
+		queues[slot].busyNs += UNanoseconds(start) - (blockedNs - blockedBefore);
+	}
+	queues[slot].run++;
+
+	TaskCounter* done = task->done;
+	delete task;
+	UTaskFinish(done);
+
+}
+
+
+static void UTaskPush(Task* task) {
+
+	int slot = UThreadSlot();
+	if (workerCount == 0) {
+		URunTask(task, slot);
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(queues[slot].lock);
+		queues[slot].tasks.push_back(task);
+	}
+
+	// A worker going to sleep counts itself before it checks queued, so one of the two sees the other
+	queued++;
+	if (sleepingWorkers.load() > 0) {
+		{
+			lock_guard<mutex> lock(sleepMutex);
+		}
+		wake.notify_one();
+	}
+
+}
+
+
+static void UTaskWorker(int slot) {
+
+	threadSlot = slot;
+	workerThread = true;
+	for (;;) {
+		Task* task = UTaskTake(slot, NULL, true);
+		if (task != NULL) {
+			URunTask(task, slot);
+			continue;
+		}
+
+		unique_lock<mutex> lock(sleepMutex);
+		sleepingWorkers++;
+		wake.wait(lock, [] { return stopping || queued.load() > 0; });
+		sleepingWorkers--;
+		if (stopping && queued.load() == 0) {
+			return;
+		}
+	}
+
+}
+
+
+bool UParseTaskOptions(int argc, char* argv[], TaskOptions& options) {
+
+	options.threads = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--task-threads") != 0) {
+			continue; // not ours
+		}
+		if (i + 1 >= argc) {
+			std::cerr << argv[i] << " needs a value\n";
+			return false;
+		}
+		options.threads = atoi(argv[++i]);
+		if (options.threads < 1) {
+			std::cerr << "--task-threads takes a count of at least 1\n";
+			return false;
+		}
+	}
+	return true;
+
+}
+
+
+void UTaskInit(const TaskOptions& options) {
+
+	UTaskShutdown();
+	int threads = options.threads > 0 ? options.threads : (int)thread::hardware_concurrency();
+	workerCount = min(max(threads - 1, 0), TASK_MAX_WORKERS);
+	startedWorkers = workerCount;
+	for (int i = 0; i < TASK_MAX_WORKERS + TASK_MAX_OUTSIDE; i++) {
+		queues[i].run = 0;
+		queues[i].stolen = 0;
+		queues[i].busyNs = 0;
+		queues[i].waitNs = 0;
+	}
+
+	stopping = false;
+	stoppedWallMs = -1.0;
+	startTime = chrono::steady_clock::now();
+	for (int i = 0; i < workerCount; i++) {
+		workers.push_back(thread(UTaskWorker, i));
+	}
+
+	static bool registered = false;
+	if (!registered) {
+		atexit(UTaskShutdown);
+		registered = true;
+	}
+
+}
+
+
+int UTaskThreadCount(void) {
+
+	return workerCount + 1;
+
+}
+
+
+void UTaskRun(function<void(void)> work, TaskCounter* done, TaskCounter* after) {
+
+	Task* task = new Task;
+	task->work = std::move(work);
+	task->done = done;
+	if (done != NULL) {
+		done->pending++;
+	}
+	if (after != NULL) {
+		lock_guard<mutex> lock(after->mutex);
+		if (after->pending.load() > 0) {
+			after->waiting.push_back(task);
+			return;
+		}
+	}
+	UTaskPush(task);
+
+}
+
+
+void UTaskWait(TaskCounter& counter) {
+
+	int slot = UThreadSlot();
+	while (counter.pending.load() > 0) {
+		Task* task = workerCount > 0 ? UTaskTake(slot, workerThread ? NULL : &counter, workerThread) : NULL;
+		if (task != NULL) {
+			URunTask(task, slot);
+			continue;
+		}
+
+		// Nothing this thread may run. An outside thread sleeps until the counter is done, the
+		// workers run the rest; a worker looks for something to steal again now and then.
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		{
+			unique_lock<mutex> lock(counter.mutex);
+			if (workerThread) {
+				counter.finished.wait_for(lock, chrono::microseconds(TASK_POLL_US), [&] { return counter.pending.load() == 0; });
+			}
+			else {
+				counter.finished.wait(lock, [&] { return counter.pending.load() == 0; });
+			}
+		}
+		long long waited = UNanoseconds(start);
+		blockedNs += waited;
+		queues[slot].waitNs += waited;
+	}
+
+	// The thread that finished the last task may still hold the lock, the counter must outlive it
+	lock_guard<mutex> lock(counter.mutex);
+
+}
+
+
+void UTaskParallelFor(size_t count, size_t minSlice, const function<void(size_t, size_t)>& work) {
+
+	size_t slices = min(count / max<size_t>(1, minSlice), (size_t)UTaskThreadCount() * TASK_SLICES_PER_THREAD);
+	if (slices <= 1 || workerCount == 0) {
+		if (count > 0) {
+			work(0, count);
+		}
+		return;
+	}
+
+	// Queued back to front, so the thieves start on the far end and the caller on the near one
+	size_t slice = (count + slices - 1) / slices;
+	TaskCounter done;
+	for (size_t first = slice; first < count; first += slice) {
+		size_t last = min(count, first + slice);
+		UTaskRun([&work, first, last] { work(first, last); }, &done);
+	}
+	work(0, slice);
+	UTaskWait(done);
+
+}
+
+
+static TaskThreadStats UThreadStats(const TaskQueue& queue) {
+
+	TaskThreadStats stats;
+	stats.tasks = queue.run.load();
+	stats.stolen = queue.stolen.load();
+	stats.busyMs = queue.busyNs.load() / 1e6;
+	stats.waitMs = queue.waitNs.load() / 1e6;
+	return stats;
+
+}
+
+
+TaskStats UTaskGetStats(void) {
+
+	TaskStats stats;
+	stats.workers = startedWorkers;
+	stats.wallMs = stoppedWallMs >= 0.0 ? stoppedWallMs : UNanoseconds(startTime) / 1e6;
+
+	double busyMs = 0.0;
+	for (int i = 0; i < startedWorkers; i++) {
+		stats.threads.push_back(UThreadStats(queues[i]));
+		busyMs += stats.threads.back().busyMs;
+	}
+	stats.utilization = startedWorkers > 0 && stats.wallMs > 0.0 ? busyMs / (stats.wallMs * startedWorkers) : 0.0;
+
+	memset(&stats.outside, 0, sizeof(stats.outside));
+	for (int i = 0; i < min(outsideThreads.load(), TASK_MAX_OUTSIDE); i++) {
+		TaskThreadStats outside = UThreadStats(queues[TASK_MAX_WORKERS + i]);
+		stats.outside.tasks += outside.tasks;
+		stats.outside.stolen += outside.stolen;
+		stats.outside.busyMs += outside.busyMs;
+		stats.outside.waitMs += outside.waitMs;
+	}
+	return stats;
+
+}
+
+
+void UTaskPrintStats(void) {
+
+	TaskStats stats = UTaskGetStats();
+	long long tasks = stats.outside.tasks;
+	long long stolen = 0;
+	for (size_t i = 0; i < stats.threads.size(); i++) {
+		tasks += stats.threads[i].tasks;
+		stolen += stats.threads[i].stolen;
+	}
+	if (tasks == 0) {
+		return;
+	}
+
+	ostringstream report;
+	report << fixed << setprecision(1) << "Tasks: " << tasks << " run, " << stolen << " stolen, " << stats.workers
+		<< (stats.workers == 1 ? " worker " : " workers ") << stats.utilization * 100.0 << "% busy over " << stats.wallMs / 1000.0
+		<< " s, outside threads ran " << stats.outside.tasks << " and waited " << stats.outside.waitMs << " ms\n";
+	if (!stats.threads.empty()) {
+		report << "Task workers busy:";
+		for (size_t i = 0; i < stats.threads.size(); i++) {
+			report << " " << (stats.wallMs > 0.0 ? stats.threads[i].busyMs * 100.0 / stats.wallMs : 0.0) << "%";
+		}
+		report << "\n";
+	}
+	std::cout << report.str();
+
+}
+
+
+void UTaskShutdown(void) {
+
+	if (workers.empty()) {
+		return;
+	}
+	{
+		lock_guard<mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+	workers.clear();
+	stoppedWallMs = UNanoseconds(startTime) / 1e6;
+	workerCount = 0;
+
+}
@@ -0,0 +1,101 @@
+/*
+*	Title:	Final Project / TaskScheduler.h
+*	Date:	October 19, 2026
+*
+*	Description: Work-stealing task scheduler shared by loading and per-frame
+*	work. There is a worker thread per spare core, each with a deque of its
+*	own. A thread pushes and pops at the back of its own deque, so it runs
+*	its newest task next while that task's data is still in cache. An idle
+*	worker steals the oldest task from the front of someone else's, which
+*	tends to be the largest piece of work left. Threads outside the pool,
+*	such as the GL thread, get a deque of their own on their first task.
+*
+*	Tasks are counted into a TaskCounter, and UTaskWait returns once the
+*	counter drops to zero. A waiting thread does not just block: it runs
+*	tasks until then. A worker runs anything, so tasks may wait on tasks
+*	they spawned. An outside thread only runs tasks from its own deque that
+*	count into what it waits for, so a wait on the GL thread never picks up
+*	a long texture decode. A task can also be held back until another
+*	counter drops to zero. That is how dependencies and continuations are
+*	expressed.
+*
+*	With no workers, either before UTaskInit or with --task-threads 1, a
+*	task runs on the thread that submits or releases it.
+*
+*	Command line:
+*		--task-threads <count>		threads running tasks, the GL thread included,
+*									default one per core
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#define TASK_MAX_WORKERS 31
+
+struct TaskOptions {
+	int threads;				// 0 for one per core
+};
+
+struct Task;
+
+// Tasks still to finish, and the tasks held back until they have. Must outlive every task counted
+// into it or held back by it, so wait on it before it goes out of scope.
+struct TaskCounter {
+	TaskCounter(void) : pending(0) {}
+
+	std::atomic<int> pending;
+	std::mutex mutex;
+	std::condition_variable finished;
+	std::vector<Task*> waiting;
+};
+
+// What one thread did since UTaskInit
+struct TaskThreadStats {
+	long long tasks;			// tasks run
+	long long stolen;			// of those, taken from another thread's deque
+	double busyMs;				// running tasks, not counting time blocked in UTaskWait inside them
+	double waitMs;				// blocked in UTaskWait with nothing to help with
+};
+
+struct TaskStats {
+	int workers;
+	double wallMs;						// since UTaskInit
+	double utilization;					// workers' busy time over their wall time
+	TaskThreadStats outside;			// every thread outside the pool, the GL thread among them
+	std::vector<TaskThreadStats> threads;	// one per worker
+};
+
+// Reads the task options out of the command line, returns false on a malformed argument
+bool UParseTaskOptions(int argc, char* argv[], TaskOptions& options);
+
+// Starts the workers, call before anything submits a task
+void UTaskInit(const TaskOptions& options);
+
+// Threads that may run tasks at once, the calling thread included
+int UTaskThreadCount(void);
+
+// Queues work on the calling thread's deque, counted into done when that is not NULL. With after,
+// the task is held back until after drops to zero.
+void UTaskRun(std::function<void(void)> work, TaskCounter* done = NULL, TaskCounter* after = NULL);
+
+// Returns once every task counted into counter has finished, running tasks in the meantime
+void UTaskWait(TaskCounter& counter);
+
+// Runs work over [0, count) in slices of at least minSlice items, a few per thread so a slow slice
+// can be balanced by stealing, and waits for all of them. The calling thread takes the first.
+void UTaskParallelFor(size_t count, size_t minSlice, const std::function<void(size_t, size_t)>& work);
+
+TaskStats UTaskGetStats(void);
+
+// Prints the tasks run and stolen, how busy the workers were and how long outside threads waited
+void UTaskPrintStats(void);
+
+// Finishes the queued tasks and joins the workers. Safe to call twice, and also run at exit since
+// replays end the process from inside the main loop.
+void UTaskShutdown(void);
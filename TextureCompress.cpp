@@ -0,0 +1,691 @@
+/*
+*	Title:	Final Project / TextureCompress.cpp
+*	Date:	October 19, 2026
+*
+*	Description: BC1 and BC7 encoders and the compressed texture cache. A
+*	block is held channel by channel as floats, so one SSE2 register covers
+*	a channel of four texels and a candidate palette is scored against the
+*	whole block in four steps. The encoders keep the palettes the decoder
+*	will build, so the error they minimise is the error the GPU shows.
+*/
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BC_SSE2 1
+#endif
+
+#include "TaskScheduler.h"
+#include "TextureCompress.h"
+
+using namespace std; // standard namespace
+
+#define BC_SEARCH_PASSES 2			// rounds of trying each quantized endpoint one step either way
+#define CACHE_MAGIC 0x31435854u		// "TXC1"
+
+// BC7 interpolation weights for 4-bit indices, out of 64
+static const int bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// BC1 palette order is endpoint 0, endpoint 1, then the two thirds between them
+static const float bc1Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+// One 4x4 block, texel t of channel c at texels[c][t] in row order
+struct BlockTexels {
+	float texels[4][16];
+};
+
+
+bool UParseCodec(const char* name, TextureCodec& codec) {
+
+	if (strcmp(name, "none") == 0) {
+		codec = CODEC_NONE;
+	}
+	else if (strcmp(name, "bc1") == 0) {
+		codec = CODEC_BC1;
+	}
+	else if (strcmp(name, "bc7") == 0) {
+		codec = CODEC_BC7;
+	}
+	else {
+		return false;
+	}
+	return true;
+
+}
+
+
+const char* UCodecName(TextureCodec codec) {
+
+	switch (codec) {
+	case CODEC_BC1: return "bc1";
+	case CODEC_BC7: return "bc7";
+	default: return "none";
+	}
+
+}
+
+
+GLenum UCodecFormat(TextureCodec codec) {
+
+	switch (codec) {
+	case CODEC_BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case CODEC_BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	default: return GL_RGBA8;
+	}
+
+}
+
+
+size_t UCompressedBytes(TextureCodec codec, int width, int height) {
+
+	size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+	switch (codec) {
+	case CODEC_BC1: return blocks * 8;
+	case CODEC_BC7: return blocks * 16;
+	default: return (size_t)width * height * 4;
+	}
+
+}
+
+
+int UCodecChannels(TextureCodec codec) {
+
+	return codec == CODEC_BC1 ? 3 : 4;
+
+}
+
+
+double UPsnr(double squaredError, double samples) {
+
+	if (squaredError <= 0.0 || samples <= 0.0) {
+		return 99.0; // lossless, reported as the usual cap
+	}
+	return min(99.0, 10.0 * log10(255.0 * 255.0 * samples / squaredError));
+
+}
+
+
+// Picks the closest of entries palette colours for every texel, returns the summed squared error
+static float UFitPalette(const BlockTexels& block, const float (*palette)[4], int entries, int channels, unsigned char* indices) {
+
+	float total = 0.0f;
+#ifdef BC_SSE2
+	for (int q = 0; q < 16; q += 4) {
+		__m128 x[4];
+		for (int c = 0; c < channels; c++) {
+			x[c] = _mm_loadu_ps(&block.texels[c][q]);
+		}
+		__m128 best = _mm_set1_ps(FLT_MAX);
+		__m128i bestIndex = _mm_setzero_si128();
+		for (int e = 0; e < entries; e++) {
+			__m128 distance = _mm_setzero_ps();
+			for (int c = 0; c < channels; c++) {
+				__m128 difference = _mm_sub_ps(x[c], _mm_set1_ps(palette[e][c]));
+				distance = _mm_add_ps(distance, _mm_mul_ps(difference, difference));
+			}
+			__m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, best));
+			best = _mm_min_ps(distance, best);
+			bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(e)), _mm_andnot_si128(closer, bestIndex));
+		}
+		int picked[4];
+		float errors[4];
+		_mm_storeu_si128((__m128i*)picked, bestIndex);
+		_mm_storeu_ps(errors, best);
+		for (int i = 0; i < 4; i++) {
+			indices[q + i] = (unsigned char)picked[i];
+			total += errors[i];
+		}
+	}
+#else
+	for (int t = 0; t < 16; t++) {
+		float best = FLT_MAX;
+		for (int e = 0; e < entries; e++) {
+			float distance = 0.0f;
+			for (int c = 0; c < channels; c++) {
+				float difference = block.texels[c][t] - palette[e][c];
+				distance += difference * difference;
+			}
+			if (distance < best) {
+				best = distance;
+				indices[t] = (unsigned char)e;
+			}
+		}
+		total += best;
+	}
+#endif
+	return total;
+
+}
+
+
+// Endpoints at the ends of the block's spread along its principal axis
+static void UPrincipalEndpoints(const BlockTexels& block, int channels, float* e0, float* e1) {
+
+	float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int c = 0; c < channels; c++) {
+		for (int t = 0; t < 16; t++) {
+			mean[c] += block.texels[c][t];
+		}
+		mean[c] /= 16.0f;
+	}
+	float covariance[4][4] = {};
+	for (int t = 0; t < 16; t++) {
+		for (int i = 0; i < channels; i++) {
+			for (int j = i; j < channels; j++) {
+				covariance[i][j] += (block.texels[i][t] - mean[i]) * (block.texels[j][t] - mean[j]);
+			}
+		}
+	}
+	for (int i = 0; i < channels; i++) {
+		for (int j = 0; j < i; j++) {
+			covariance[i][j] = covariance[j][i];
+		}
+	}
+
+	// Power iteration, started on the diagonal so grey ramps converge at once
+	float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	for (int iteration = 0; iteration < 8; iteration++) {
+		float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float largest = 0.0f;
+		for (int i = 0; i < channels; i++) {
+			for (int j = 0; j < channels; j++) {
+				next[i] += covariance[i][j] * axis[j];
+			}
+			largest = max(largest, fabsf(next[i]));
+		}
+		if (largest <= 0.0f) {
+			break; // flat block, the endpoints collapse onto the mean
+		}
+		for (int i = 0; i < channels; i++) {
+			axis[i] = next[i] / largest;
+		}
+	}
+
+	float length = 0.0f;
+	for (int c = 0; c < channels; c++) {
+		length += axis[c] * axis[c];
+	}
+	float low = 0.0f;
+	float high = 0.0f;
+	for (int t = 0; t < 16; t++) {
+		float projection = 0.0f;
+		for (int c = 0; c < channels; c++) {
+			projection += (block.texels[c][t] - mean[c]) * axis[c];
+		}
+		projection /= max(length, 1e-12f);
+		low = min(low, projection);
+		high = max(high, projection);
+	}
+	for (int c = 0; c < channels; c++) {
+		e0[c] = min(max(mean[c] + low * axis[c], 0.0f), 255.0f);
+		e1[c] = min(max(mean[c] + high * axis[c], 0.0f), 255.0f);
+	}
+
+}
+
+
+// Least squares endpoints for fixed indices, false when every texel sits on one weight
+static bool URefineEndpoints(const BlockTexels& block, int channels, const unsigned char* indices, const float* weights, float* e0, float* e1) {
+
+	float a = 0.0f;
+	float b = 0.0f;
+	float c = 0.0f;
+	float x0[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float x1[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int t = 0; t < 16; t++) {
+		float w = weights[indices[t]];
+		a += (1.0f - w) * (1.0f - w);
+		b += (1.0f - w) * w;
+		c += w * w;
+		for (int ch = 0; ch < channels; ch++) {
+			x0[ch] += (1.0f - w) * block.texels[ch][t];
+			x1[ch] += w * block.texels[ch][t];
+		}
+	}
+	float determinant = a * c - b * b;
+	if (fabsf(determinant) < 1e-6f) {
+		return false;
+	}
+	for (int ch = 0; ch < channels; ch++) {
+		e0[ch] = min(max((c * x0[ch] - b * x1[ch]) / determinant, 0.0f), 255.0f);
+		e1[ch] = min(max((a * x1[ch] - b * x0[ch]) / determinant, 0.0f), 255.0f);
+	}
+	return true;
+
+}
+
+
+// Gathers the block at (blockX, blockY), texels past the edge repeat the last row or column
+static void UGatherBlock(const unsigned char* rgba, int width, int height, int blockX, int blockY, BlockTexels& block) {
+
+	for (int y = 0; y < 4; y++) {
+		const unsigned char* row = rgba + (size_t)min(blockY * 4 + y, height - 1) * width * 4;
+		for (int x = 0; x < 4; x++) {
+			const unsigned char* texel = row + min(blockX * 4 + x, width - 1) * 4;
+			for (int c = 0; c < 4; c++) {
+				block.texels[c][y * 4 + x] = texel[c];
+			}
+		}
+	}
+
+}
+
+
+// BC1 endpoints as 5:6:5 values, q[endpoint * 3 + channel]
+static const int bc1Max[3] = { 31, 63, 31 };
+
+static int UBc1Pack(const int* q) {
+
+	return (q[0] << 11) | (q[1] << 5) | q[2];
+
+}
+
+
+// The palette a decoder builds from two 5:6:5 endpoints, one entry when they pack the same
+// since equal endpoints switch the block to its three colour mode
+static int UBc1Palette(const int* q, float (*palette)[4]) {
+
+	int expanded[2][3];
+	for (int e = 0; e < 2; e++) {
+		expanded[e][0] = (q[e * 3] << 3) | (q[e * 3] >> 2);
+		expanded[e][1] = (q[e * 3 + 1] << 2) | (q[e * 3 + 1] >> 4);
+		expanded[e][2] = (q[e * 3 + 2] << 3) | (q[e * 3 + 2] >> 2);
+	}
+	for (int c = 0; c < 3; c++) {
+		palette[0][c] = (float)expanded[0][c];
+		palette[1][c] = (float)expanded[1][c];
+		palette[2][c] = (float)((2 * expanded[0][c] + expanded[1][c]) / 3);
+		palette[3][c] = (float)((expanded[0][c] + 2 * expanded[1][c]) / 3);
+	}
+	return UBc1Pack(q) == UBc1Pack(q + 3) ? 1 : 4;
+
+}
+
+
+static float UBc1Score(const BlockTexels& block, const int* q, unsigned char* indices) {
+
+	float palette[4][4];
+	int entries = UBc1Palette(q, palette);
+	return UFitPalette(block, palette, entries, 3, indices);
+
+}
+
+
+static void UBc1Quantize(const float* e0, const float* e1, int* q) {
+
+	for (int c = 0; c < 3; c++) {
+		q[c] = (int)lrintf(e0[c] * bc1Max[c] / 255.0f);
+		q[3 + c] = (int)lrintf(e1[c] * bc1Max[c] / 255.0f);
+	}
+
+}
+
+
+static float UEncodeBc1(const BlockTexels& block, unsigned char* out) {
+
+	float e0[4];
+	float e1[4];
+	UPrincipalEndpoints(block, 3, e0, e1);
+	int q[6];
+	UBc1Quantize(e0, e1, q);
+	unsigned char indices[16];
+	float error = UBc1Score(block, q, indices);
+
+	// Least squares on the fitted indices, kept while it helps
+	for (int iteration = 0; iteration < 2; iteration++) {
+		if (!URefineEndpoints(block, 3, indices, bc1Weights, e0, e1)) {
+			break;
+		}
+		int refined[6];
+		unsigned char refinedIndices[16];
+		UBc1Quantize(e0, e1, refined);
+		float refinedError = UBc1Score(block, refined, refinedIndices);
+		if (refinedError >= error) {
+			break;
+		}
+		error = refinedError;
+		memcpy(q, refined, sizeof(q));
+		memcpy(indices, refinedIndices, sizeof(indices));
+	}
+
+	// Every quantized endpoint channel one step either way
+	for (int pass = 0; pass < BC_SEARCH_PASSES && error > 0.0f; pass++) {
+		bool improved = false;
+		for (int p = 0; p < 6; p++) {
+			for (int step = -1; step <= 1; step += 2) {
+				int value = q[p] + step;
+				if (value < 0 || value > bc1Max[p % 3]) {
+					continue;
+				}
+				int candidate[6];
+				memcpy(candidate, q, sizeof(q));
+				candidate[p] = value;
+				unsigned char candidateIndices[16];
+				float candidateError = UBc1Score(block, candidate, candidateIndices);
+				if (candidateError < error) {
+					error = candidateError;
+					memcpy(q, candidate, sizeof(q));
+					memcpy(indices, candidateIndices, sizeof(indices));
+					improved = true;
+				}
+			}
+		}
+		if (!improved) {
+			break;
+		}
+	}
+
+	// Four colour mode needs endpoint 0 to pack larger, swapping them swaps 0 with 1 and 2 with 3
+	int color0 = UBc1Pack(q);
+	int color1 = UBc1Pack(q + 3);
+	unsigned int bits = 0;
+	if (color0 < color1) {
+		swap(color0, color1);
+		for (int t = 0; t < 16; t++) {
+			indices[t] ^= 1;
+		}
+	}
+	if (color0 != color1) {
+		for (int t = 0; t < 16; t++) {
+			bits |= (unsigned int)indices[t] << (2 * t);
+		}
+	}
+	out[0] = (unsigned char)color0;
+	out[1] = (unsigned char)(color0 >> 8);
+	out[2] = (unsigned char)color1;
+	out[3] = (unsigned char)(color1 >> 8);
+	for (int i = 0; i < 4; i++) {
+		out[4 + i] = (unsigned char)(bits >> (8 * i));
+	}
+	return error;
+
+}
+
+
+// BC7 mode 6 endpoints, 7 bits per channel in q[endpoint * 4 + channel] plus one p-bit per endpoint
+struct Bc7Endpoints {
+	int q[8];
+	int p[2];
+};
+
+static float UBc7Score(const BlockTexels& block, const Bc7Endpoints& endpoints, unsigned char* indices) {
+
+	float palette[16][4];
+	for (int c = 0; c < 4; c++) {
+		int a = (endpoints.q[c] << 1) | endpoints.p[0];
+		int b = (endpoints.q[4 + c] << 1) | endpoints.p[1];
+		for (int i = 0; i < 16; i++) {
+			palette[i][c] = (float)(((64 - bc7Weights[i]) * a + bc7Weights[i] * b + 32) >> 6);
+		}
+	}
+	return UFitPalette(block, palette, 16, 4, indices);
+
+}
+
+
+// Best p-bits for float endpoints, each p-bit choice quantizing the channels to match it
+static float UBc7Quantize(const BlockTexels& block, const float* e0, const float* e1, Bc7Endpoints& endpoints, unsigned char* indices) {
+
+	float best = FLT_MAX;
+	for (int pbits = 0; pbits < 4; pbits++) {
+		Bc7Endpoints candidate;
+		candidate.p[0] = pbits & 1;
+		candidate.p[1] = pbits >> 1;
+		for (int c = 0; c < 4; c++) {
+			candidate.q[c] = min(max((int)lrintf((e0[c] - candidate.p[0]) * 0.5f), 0), 127);
+			candidate.q[4 + c] = min(max((int)lrintf((e1[c] - candidate.p[1]) * 0.5f), 0), 127);
+		}
+		unsigned char candidateIndices[16];
+		float error = UBc7Score(block, candidate, candidateIndices);
+		if (error < best) {
+			best = error;
+			endpoints = candidate;
+			memcpy(indices, candidateIndices, 16);
+		}
+	}
+	return best;
+
+}
+
+
+// Appends the low bits of value to a 128-bit little endian block
+static void UPutBits(uint64_t* words, int& position, unsigned int value, int bits) {
+
+	for (int b = 0; b < bits; b++, position++) {
+		words[position >> 6] |= (uint64_t)((value >> b) & 1) << (position & 63);
+	}
+
+}
+
+
+static float UEncodeBc7(const BlockTexels& block, unsigned char* out) {
+
+	float e0[4];
+	float e1[4];
+	UPrincipalEndpoints(block, 4, e0, e1);
+	Bc7Endpoints endpoints;
+	unsigned char indices[16];
+	float error = UBc7Quantize(block, e0, e1, endpoints, indices);
+
+	float weights[16];
+	for (int i = 0; i < 16; i++) {
+		weights[i] = bc7Weights[i] / 64.0f;
+	}
+	for (int iteration = 0; iteration < 2; iteration++) {
+		if (!URefineEndpoints(block, 4, indices, weights, e0, e1)) {
+			break;
+		}
+		Bc7Endpoints refined;
+		unsigned char refinedIndices[16];
+		float refinedError = UBc7Quantize(block, e0, e1, refined, refinedIndices);
+		if (refinedError >= error) {
+			break;
+		}
+		error = refinedError;
+		endpoints = refined;
+		memcpy(indices, refinedIndices, sizeof(indices));
+	}
+
+	for (int pass = 0; pass < BC_SEARCH_PASSES && error > 0.0f; pass++) {
+		bool improved = false;
+		for (int p = 0; p < 8; p++) {
+			for (int step = -1; step <= 1; step += 2) {
+				int value = endpoints.q[p] + step;
+				if (value < 0 || value > 127) {
+					continue;
+				}
+				Bc7Endpoints candidate = endpoints;
+				candidate.q[p] = value;
+				unsigned char candidateIndices[16];
+				float candidateError = UBc7Score(block, candidate, candidateIndices);
+				if (candidateError < error) {
+					error = candidateError;
+					endpoints = candidate;
+					memcpy(indices, candidateIndices, sizeof(indices));
+					improved = true;
+				}
+			}
+		}
+		if (!improved) {
+			break;
+		}
+	}
+
+	// The first index drops its top bit, so it has to be in the lower half
+	if (indices[0] >= 8) {
+		for (int c = 0; c < 4; c++) {
+			swap(endpoints.q[c], endpoints.q[4 + c]);
+		}
+		swap(endpoints.p[0], endpoints.p[1]);
+		for (int t = 0; t < 16; t++) {
+			indices[t] = (unsigned char)(15 - indices[t]);
+		}
+	}
+
+	// Mode 6: mode bits, endpoints channel by channel, p-bits, then the indices
+	uint64_t words[2] = { 0, 0 };
+	int position = 0;
+	UPutBits(words, position, 1 << 6, 7);
+	for (int c = 0; c < 4; c++) {
+		UPutBits(words, position, endpoints.q[c], 7);
+		UPutBits(words, position, endpoints.q[4 + c], 7);
+	}
+	UPutBits(words, position, endpoints.p[0], 1);
+	UPutBits(words, position, endpoints.p[1], 1);
+	UPutBits(words, position, indices[0], 3);
+	for (int t = 1; t < 16; t++) {
+		UPutBits(words, position, indices[t], 4);
+	}
+	for (int i = 0; i < 16; i++) {
+		out[i] = (unsigned char)(words[i >> 3] >> (8 * (i & 7)));
+	}
+	return error;
+
+}
+
+
+double UCompressLayer(TextureCodec codec, const unsigned char* rgba, int width, int height, vector<unsigned char>& blocks) {
+
+	if (codec == CODEC_NONE) {
+		blocks.assign(rgba, rgba + (size_t)width * height * 4);
+		return 0.0;
+	}
+	int blocksX = (width + 3) / 4;
+	int blocksY = (height + 3) / 4;
+	size_t blockBytes = codec == CODEC_BC1 ? 8 : 16;
+	blocks.resize((size_t)blocksX * blocksY * blockBytes);
+
+	// Each block row keeps its own error, so the slices share nothing
+	vector<double> rowErrors(blocksY, 0.0);
+	UTaskParallelFor(blocksY, 1, [&](size_t first, size_t last) {
+		BlockTexels block;
+		for (size_t y = first; y < last; y++) {
+			double error = 0.0;
+			for (int x = 0; x < blocksX; x++) {
+				UGatherBlock(rgba, width, height, x, (int)y, block);
+				unsigned char* out = &blocks[(y * blocksX + x) * blockBytes];
+				error += codec == CODEC_BC1 ? UEncodeBc1(block, out) : UEncodeBc7(block, out);
+			}
+			rowErrors[y] = error;
+		}
+	});
+
+	// Partial edge blocks were scored on their repeated texels too, close enough for a quality report
+	double total = 0.0;
+	for (int y = 0; y < blocksY; y++) {
+		total += rowErrors[y];
+	}
+	return total * ((double)width * height / ((double)blocksX * blocksY * 16));
+
+}
+
+
+// FNV-1a over the source file, enough to tell edited images apart
+static uint64_t UHashBytes(const unsigned char* data, size_t size) {
+
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	}
+	return hash;
+
+}
+
+
+string UCachePath(const string& cacheDir, const string& file, const unsigned char* data, size_t size, TextureCodec codec) {
+
+	size_t slash = file.find_last_of("/\\");
+	string name = slash == string::npos ? file : file.substr(slash + 1);
+	char hash[17];
+	snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)UHashBytes(data, size));
+	return cacheDir + "/" + name + "." + hash + "." + UCodecName(codec);
+
+}
+
+
+// Cache file layout: magic, codec, width, height and level count, then per level its byte count
+// (0 when absent) and squared error, then the present levels back to back
+struct CacheHeader {
+	uint32_t magic;
+	uint32_t codec;
+	int32_t width;
+	int32_t height;
+	int32_t levelCount;
+};
+
+struct CacheLevel {
+	uint32_t bytes;
+	uint32_t padding;
+	double squaredError;
+};
+
+
+static int ULevelCount(int width, int height) {
+
+	return 1 + (int)floor(log2((double)max(width, height)));
+
+}
+
+
+bool UCacheLoad(const string& path, TextureCodec codec, CompressedImage& image) {
+
+	ifstream in(path.c_str(), ios::binary);
+	CacheHeader header;
+	if (!in.read((char*)&header, sizeof(header)) || header.magic != CACHE_MAGIC || header.codec != (uint32_t)codec
+		|| header.width <= 0 || header.height <= 0 || header.levelCount != ULevelCount(header.width, header.height)) {
+		return false;
+	}
+	vector<CacheLevel> levels(header.levelCount);
+	if (!in.read((char*)levels.data(), levels.size() * sizeof(CacheLevel))) {
+		return false;
+	}
+
+	image.width = header.width;
+	image.height = header.height;
+	image.levels.assign(header.levelCount, vector<unsigned char>());
+	image.squaredErrors.assign(header.levelCount, 0.0);
+	for (int l = 0; l < header.levelCount; l++) {
+		if (levels[l].bytes == 0) {
+			continue;
+		}
+		if (levels[l].bytes != UCompressedBytes(codec, max(1, header.width >> l), max(1, header.height >> l))) {
+			return false;
+		}
+		image.levels[l].resize(levels[l].bytes);
+		if (!in.read((char*)image.levels[l].data(), levels[l].bytes)) {
+			return false;
+		}
+		image.squaredErrors[l] = levels[l].squaredError;
+	}
+	return true;
+
+}
+
+
+bool UCacheStore(const string& path, TextureCodec codec, const CompressedImage& image) {
+
+	CacheHeader header = { CACHE_MAGIC, (uint32_t)codec, image.width, image.height, (int32_t)image.levels.size() };
+	vector<CacheLevel> levels(image.levels.size());
+	for (size_t l = 0; l < levels.size(); l++) {
+		levels[l].bytes = (uint32_t)image.levels[l].size();
+		levels[l].padding = 0;
+		levels[l].squaredError = l < image.squaredErrors.size() ? image.squaredErrors[l] : 0.0;
+	}
+
+	ofstream out(path.c_str(), ios::binary | ios::trunc);
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)levels.data(), levels.size() * sizeof(CacheLevel));
+	for (size_t l = 0; l < image.levels.size(); l++) {
+		out.write((const char*)image.levels[l].data(), image.levels[l].size());
+	}
+	return (bool)out;
+
+}
@@ -0,0 +1,72 @@
+/*
+*	Title:	Final Project / TextureCompress.h
+*	Date:	October 19, 2026
+*
+*	Description: BC1 and BC7 block compression for RGBA8 texture levels, and
+*	a disk cache of the results. BC1 stores an opaque 4x4 block in 8 bytes,
+*	an eighth of RGBA8, BC7 stores it in 16 at much higher quality. BC7
+*	blocks are all mode 6, one pair of RGBA endpoints with 16 interpolation
+*	steps, which suits smooth wood grain and keeps the encoder small.
+*
+*	Both encoders fit endpoints along the block's principal axis, refine them
+*	by least squares and then search the neighbouring quantized endpoints,
+*	scoring every candidate with SSE2 four texels at a time. Block rows are
+*	spread over every core.
+*
+*	The cache keeps one file per source image and codec, named after a hash
+*	of the source bytes so an edited image never matches a stale entry. Each
+*	file holds whichever levels of the chain have been compressed so far,
+*	later runs add to it, and a cache filled ahead of time is the offline
+*	path: the streamer then never decodes or compresses those images.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+enum TextureCodec {
+	CODEC_NONE,
+	CODEC_BC1,
+	CODEC_BC7
+};
+
+// Parses none, bc1 or bc7, returns false for anything else
+bool UParseCodec(const char* name, TextureCodec& codec);
+
+const char* UCodecName(TextureCodec codec);
+
+// GL internal format of a codec, GL_RGBA8 for CODEC_NONE
+GLenum UCodecFormat(TextureCodec codec);
+
+// Bytes of one width x height layer, partial blocks at the edges count as whole ones
+size_t UCompressedBytes(TextureCodec codec, int width, int height);
+
+// Compresses one RGBA8 layer into blocks, returns the squared error summed over the channels the
+// codec keeps, RGB for BC1 and RGBA for BC7
+double UCompressLayer(TextureCodec codec, const unsigned char* rgba, int width, int height, std::vector<unsigned char>& blocks);
+
+// Channels UCompressLayer's error is summed over
+int UCodecChannels(TextureCodec codec);
+
+// Peak signal to noise ratio in dB of a squared error over samples 8-bit samples
+double UPsnr(double squaredError, double samples);
+
+// One source image's compressed chain, levels the cache does not hold are empty
+struct CompressedImage {
+	int width;					// full size of the source image
+	int height;
+	std::vector<std::vector<unsigned char> > levels;
+	std::vector<double> squaredErrors;
+};
+
+// Cache file for a source image, keyed by a hash of its bytes
+std::string UCachePath(const std::string& cacheDir, const std::string& file, const unsigned char* data, size_t size, TextureCodec codec);
+
+// Reads a cache file, false when it is missing or not for codec
+bool UCacheLoad(const std::string& path, TextureCodec codec, CompressedImage& image);
+
+// Writes every non-empty level of image, false when the file cannot be written
+bool UCacheStore(const std::string& path, TextureCodec codec, const CompressedImage& image);
@@ -0,0 +1,834 @@
+/*
+*	Title:	Final Project / TextureStream.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Texture mip streaming. Decode tasks on the task scheduler
+*	turn a job into pixel data for a run of mip levels, decoding the layers
+*	side by side. Everything touching GL or the residency bookkeeping stays
+*	on the GL thread in UStreamUpdate. At most --stream-threads decode tasks
+*	run at once, each taking jobs off the queue until it is empty, so
+*	streaming never holds every task thread the frame might want.
+*
+*	Levels are always resident as one contiguous run from a texture's base
+*	level down to its last mip. Streaming in adds the next finer run above the
+*	base, eviction drops the base level. Evicted levels are re-specified with a
+*	zero size so the driver can release their storage, which is why the arrays
+*	use mutable glTexImage3D storage rather than glTexStorage3D.
+*
+*	Levels are RGBA, which is what the driver stores RGB8 as anyway, so rows
+*	upload without unpack alignment fixups. JPEG layers go through
+*	JpegDecode, at half size when that is the finest level a job keeps,
+*	and every level under that comes from MipBuilder, filtered in linear
+*	light. The decoder's own downscaling averages gamma encoded values, so
+*	it is never used for a level further down the chain. With a codec
+*	the decode task also block compresses every level it built, and with a
+*	cache folder it first looks there for the whole run and only decodes when
+*	a layer or level is missing.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+#include "SOIL2/SOIL2.h"
+
+#include "FrameArena.h"
+#include "GlState.h"
+#include "GpuResources.h"
+#include "JpegDecode.h"
+#include "MipBuilder.h"
+#include "TaskScheduler.h"
+#include "TextureStream.h"
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+#define STREAM_SCALED_LEVEL 1		// the one level JPEGs may be decoded straight at, half size
+
+// Residency of one streamed texture array, owned by the GL thread
+struct StreamTexture {
+	vector<string> files;
+	GLuint name;
+	bool created;			// coarse mips uploaded and size known
+	bool failed;			// no layer could be loaded
+	bool jobInFlight;
+	int width;
+	int height;
+	int layers;
+	int levelCount;
+	int floorLevel;			// levels from here down are always resident
+	int baseLevel;			// finest resident level
+	float neededPixels;		// largest projected size since the last update
+	int rejectedLevel;		// finest level of the last run that did not fit, -1 for none
+	size_t rejectedRoom;	// room there was for that run, it is not asked for again until there is more
+	vector<long long> levelLastNeeded;	// frame each level was last needed
+};
+
+// Decode request for levels [firstLevel, lastLevel), a firstLevel of -1 asks for the coarse mips
+struct StreamJob {
+	int texture;
+	vector<string> files;
+	int firstLevel;
+	int lastLevel;
+	int floorSize;
+};
+
+// Decoded levels, each holding every layer back to back as glTexImage3D expects, compressed when a
+// codec is in use
+struct StreamResult {
+	int texture;
+	int width;
+	int height;
+	int firstLevel;
+	int lastLevel;
+	vector<vector<unsigned char> > levels;
+	double squaredError;	// compression error over every level
+	bool cached;			// read from the compressed texture cache
+};
+
+static StreamOptions streamOptions;
+static vector<StreamTexture> textures;
+static long long streamFrame = 0;
+static int pendingCoarse = 0;
+static StreamStats stats;
+
+// Codec actually in use, and what the compressed uploads added up to
+static TextureCodec codec = CODEC_NONE;
+static double uploadedBytes = 0.0;
+static double uncompressedBytes = 0.0;
+static double uploadedError = 0.0;
+static double uploadedSamples = 0.0;
+static int levelsUploaded = 0;
+static int levelsCached = 0;
+static mutex cacheMutex;	// decode tasks merging into the same cache file
+
+// Decode tasks and the queues they share with the GL thread
+static TaskCounter decodeTasks;
+static int decodersRunning = 0;
+static mutex jobMutex;
+static deque<StreamJob> jobs;
+static bool stopping = false;
+static mutex resultMutex;
+static deque<StreamResult> results;
+
+
+bool UParseStreamOptions(int argc, char* argv[], StreamOptions& options) {
+
+	options.budgetBytes = (size_t)256 << 20;
+	options.threads = 2;
+	options.floorSize = 64;
+	options.uploadsPerFrame = 2;
+	options.codec = CODEC_NONE;
+	options.cacheDir.clear();
+
+	const char* flags[] = { "--texture-budget", "--stream-threads", "--stream-floor", "--texture-compress", "--texture-cache" };
+	const int flagCount = sizeof(flags) / sizeof(flags[0]);
+
+	for (int i = 1; i < argc; i++) {
+		int flag = 0;
+		while (flag < flagCount && strcmp(argv[i], flags[flag]) != 0) {
+			flag++;
+		}
+		if (flag == flagCount) {
+			continue; // not ours
+		}
+		if (i + 1 >= argc) {
+			std::cerr << argv[i] << " needs a value\n";
+			return false;
+		}
+
+		const char* value = argv[++i];
+		switch (flag) {
+		case 0: options.budgetBytes = (size_t)(max(0.0, atof(value)) * (1 << 20)); break;
+		case 1: options.threads = max(1, atoi(value)); break;
+		case 2: options.floorSize = max(1, atoi(value)); break;
+		case 3:
+			if (!UParseCodec(value, options.codec)) {
+				std::cerr << "--texture-compress takes none, bc1 or bc7\n";
+				return false;
+			}
+			break;
+		case 4: options.cacheDir = value; break;
+		}
+	}
+	return true;
+
+}
+
+
+// Size in bytes of one level of a texture
+static size_t ULevelBytes(const StreamTexture& texture, int level) {
+
+	size_t width = max(1, texture.width >> level);
+	size_t height = max(1, texture.height >> level);
+	if (codec != CODEC_NONE) {
+		return UCompressedBytes(codec, (int)width, (int)height) * texture.layers;
+	}
+	return width * height * texture.layers * UGpuTexelBytes(GL_RGBA8);
+
+}
+
+
+// First level a job decodes, coarse requests start at the first level no larger than the floor size
+static int UJobFirstLevel(const StreamJob& job, int width, int height) {
+
+	if (job.firstLevel >= 0) {
+		return job.firstLevel;
+	}
+	int level = 0;
+	while (max(width, height) >> level > job.floorSize) {
+		level++;
+	}
+	return level;
+
+}
+
+
+// Loads one layer as RGBA at full size. A JPEG is decoded straight at half size instead when that
+// is the finest level the job keeps and maxLevel allows it, so the full size level it does not
+// want is never computed. The decoder filters in gamma space, so coarser levels are left to
+// UBuildMips.
+static bool ULoadLayer(const StreamJob& job, const vector<unsigned char>& data, int maxLevel, vector<unsigned char>& pixels, int& width, int& height, int& level) {
+
+	if (UJpegSize(data.data(), data.size(), width, height)) {
+		// Odd sizes would round up where the chain rounds down
+		bool scaled = UJobFirstLevel(job, width, height) == STREAM_SCALED_LEVEL && maxLevel >= STREAM_SCALED_LEVEL
+			&& ((width | height) & ((1 << STREAM_SCALED_LEVEL) - 1)) == 0;
+		level = scaled ? STREAM_SCALED_LEVEL : 0;
+		int levelWidth;
+		int levelHeight;
+		if (UJpegDecode(data.data(), data.size(), level, pixels, levelWidth, levelHeight)) {
+			return true;
+		}
+	}
+
+	// Progressive JPEGs and every other format
+	level = 0;
+	unsigned char* image = SOIL_load_image_from_memory(data.data(), (int)data.size(), &width, &height, 0, SOIL_LOAD_RGBA);
+	if (image == NULL) {
+		return false;
+	}
+	pixels.assign(image, image + (size_t)width * height * 4);
+	SOIL_free_image_data(image);
+	return true;
+
+}
+
+
+// Fills result from the compressed texture cache, false unless every layer has every level asked for
+static bool UReadCache(const StreamJob& job, const vector<vector<unsigned char> >& sources, StreamResult& result) {
+
+	int layers = (int)job.files.size();
+	vector<CompressedImage> images(layers);
+	for (int layer = 0; layer < layers; layer++) {
+		if (sources[layer].empty()) {
+			return false;
+		}
+		string path = UCachePath(streamOptions.cacheDir, job.files[layer], sources[layer].data(), sources[layer].size(), codec);
+		lock_guard<mutex> lock(cacheMutex);
+		if (!UCacheLoad(path, codec, images[layer]) || images[layer].width != images[0].width || images[layer].height != images[0].height) {
+			return false;
+		}
+	}
+
+	int width = images[0].width;
+	int height = images[0].height;
+	int firstLevel = UJobFirstLevel(job, width, height);
+	int lastLevel = job.firstLevel < 0 ? (int)images[0].levels.size() : job.lastLevel;
+	for (int l = firstLevel; l < lastLevel; l++) {
+		for (int layer = 0; layer < layers; layer++) {
+			if (images[layer].levels[l].empty()) {
+				return false;
+			}
+		}
+	}
+
+	result.width = width;
+	result.height = height;
+	result.firstLevel = firstLevel;
+	result.lastLevel = lastLevel;
+	for (int l = firstLevel; l < lastLevel; l++) {
+		vector<unsigned char> level;
+		for (int layer = 0; layer < layers; layer++) {
+			level.insert(level.end(), images[layer].levels[l].begin(), images[layer].levels[l].end());
+			result.squaredError += images[layer].squaredErrors[l];
+		}
+		result.levels.push_back(std::move(level));
+	}
+	result.cached = true;
+	return true;
+
+}
+
+
+// Compresses every level of result layer by layer, adding the layers that loaded to the cache
+static void UCompressResult(const StreamJob& job, const vector<vector<unsigned char> >& sources, const vector<bool>& loaded, StreamResult& result) {
+
+	int layers = (int)job.files.size();
+	int levelCount = 1 + (int)floor(log2((double)max(result.width, result.height)));
+	vector<CompressedImage> images(layers);
+	vector<unsigned char> blocks;
+	for (int l = result.firstLevel; l < result.lastLevel; l++) {
+		int width = max(1, result.width >> l);
+		int height = max(1, result.height >> l);
+		const vector<unsigned char>& level = result.levels[l - result.firstLevel];
+		vector<unsigned char> compressed;
+		for (int layer = 0; layer < layers; layer++) {
+			double error = UCompressLayer(codec, &level[(size_t)layer * width * height * 4], width, height, blocks);
+			compressed.insert(compressed.end(), blocks.begin(), blocks.end());
+			result.squaredError += error;
+			if (images[layer].levels.empty()) {
+				images[layer].levels.resize(levelCount);
+				images[layer].squaredErrors.assign(levelCount, 0.0);
+			}
+			images[layer].levels[l] = blocks;
+			images[layer].squaredErrors[l] = error;
+		}
+		result.levels[l - result.firstLevel] = std::move(compressed);
+	}
+	if (streamOptions.cacheDir.empty()) {
+		return;
+	}
+
+	// Merge into what earlier jobs cached, the coarse and fine runs of an image land in one file
+	for (int layer = 0; layer < layers; layer++) {
+		if (!loaded[layer]) {
+			continue;
+		}
+		string path = UCachePath(streamOptions.cacheDir, job.files[layer], sources[layer].data(), sources[layer].size(), codec);
+		lock_guard<mutex> lock(cacheMutex);
+		CompressedImage cached;
+		if (UCacheLoad(path, codec, cached) && cached.width == result.width && cached.height == result.height) {
+			for (int l = 0; l < levelCount; l++) {
+				if (images[layer].levels[l].empty()) {
+					images[layer].levels[l].swap(cached.levels[l]);
+					images[layer].squaredErrors[l] = cached.squaredErrors[l];
+				}
+			}
+		}
+		images[layer].width = result.width;
+		images[layer].height = result.height;
+		if (!UCacheStore(path, codec, images[layer])) {
+			std::cerr << "Failed to write texture cache " << path << "\n";
+		}
+	}
+
+}
+
+
+// Decodes every layer and builds the requested levels, runs on a decode task
+static void UDecodeJob(const StreamJob& job, StreamResult& result) {
+
+	result.texture = job.texture;
+	result.width = 0;
+	result.height = 0;
+	result.squaredError = 0.0;
+	result.cached = false;
+
+	int layers = (int)job.files.size();
+	vector<vector<unsigned char> > sources(layers);
+	for (int layer = 0; layer < layers; layer++) {
+		ifstream in(job.files[layer].c_str(), ios::binary);
+		sources[layer].assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+	}
+	if (codec != CODEC_NONE && !streamOptions.cacheDir.empty() && UReadCache(job, sources, result)) {
+		return;
+	}
+
+	// Every layer decodes on its own task. Layers of one size land on the same level, so only a
+	// layer that loaded coarser than the first one, which a failed scaled decode can cause, loads again.
+	vector<vector<unsigned char> > images(layers);
+	vector<int> widths(layers);
+	vector<int> heights(layers);
+	vector<int> loadedLevels(layers);
+	vector<char> decoded(layers);
+	UTaskParallelFor(layers, 1, [&](size_t first, size_t last) {
+		for (size_t layer = first; layer < last; layer++) {
+			decoded[layer] = ULoadLayer(job, sources[layer], STREAM_SCALED_LEVEL, images[layer], widths[layer], heights[layer], loadedLevels[layer]);
+		}
+	});
+
+	// The first image that loads decides the size of every layer and the level the chain starts at
+	int startLevel = STREAM_SCALED_LEVEL;
+	vector<bool> loaded(layers, false);
+	vector<unsigned char> level;
+	vector<vector<unsigned char> > mips;
+	for (int layer = 0; layer < layers; layer++) {
+		vector<unsigned char>& image = images[layer];
+		int width = widths[layer];
+		int height = heights[layer];
+		int loadedLevel = loadedLevels[layer];
+		if (decoded[layer] && result.width != 0 && loadedLevel > startLevel) {
+			decoded[layer] = ULoadLayer(job, sources[layer], startLevel, image, width, height, loadedLevel);
+		}
+		if (!decoded[layer]) {
+			std::cerr << "Failed to load texture " << job.files[layer] << "\n";
+			continue;
+		}
+		if (result.width == 0) {
+			result.width = width;
+			result.height = height;
+			startLevel = loadedLevel;
+			level.assign((size_t)max(1, width >> startLevel) * max(1, height >> startLevel) * 4 * layers, 0);
+		}
+
+		// Only textures of matching size can share the array
+		if (width != result.width || height != result.height) {
+			std::cerr << job.files[layer] << " is " << width << "x" << height << ", texture array layers are " << result.width << "x" << result.height << "\n";
+			continue;
+		}
+
+		// A layer that loaded finer than the first one, say a PNG among JPEGs, is filtered down to match
+		if (loadedLevel < startLevel) {
+			UBuildMips(image.data(), max(1, width >> loadedLevel), max(1, height >> loadedLevel), 1, startLevel - loadedLevel + 1, mips);
+			swap(image, mips.back());
+		}
+		size_t layerBytes = (size_t)max(1, width >> startLevel) * max(1, height >> startLevel) * 4;
+		memcpy(&level[layer * layerBytes], image.data(), layerBytes);
+		loaded[layer] = true;
+		vector<unsigned char>().swap(image);
+	}
+	if (result.width == 0) {
+		return;
+	}
+
+	int levelCount = 1 + (int)floor(log2((double)max(result.width, result.height)));
+	result.firstLevel = UJobFirstLevel(job, result.width, result.height);
+	result.lastLevel = job.firstLevel < 0 ? levelCount : job.lastLevel;
+
+	// Build the chain down from the level the layers loaded at, keeping the requested run
+	UBuildMips(level.data(), max(1, result.width >> startLevel), max(1, result.height >> startLevel), layers, result.lastLevel - startLevel, mips);
+	for (int l = result.firstLevel; l < result.lastLevel; l++) {
+		result.levels.push_back(std::move(l == startLevel ? level : mips[l - startLevel - 1]));
+	}
+	if (codec != CODEC_NONE) {
+		UCompressResult(job, sources, loaded, result);
+	}
+
+}
+
+
+// One decode task, works through the queue and ends once it is empty
+static void UStreamDecoder(void) {
+
+	for (;;) {
+		StreamJob job;
+		{
+			lock_guard<mutex> lock(jobMutex);
+			if (stopping || jobs.empty()) {
+				decodersRunning--;
+				return;
+			}
+			job = jobs.front();
+			jobs.pop_front();
+		}
+
+		StreamResult result;
+		UDecodeJob(job, result);
+		{
+			lock_guard<mutex> lock(resultMutex);
+			results.push_back(std::move(result));
+		}
+	}
+
+}
+
+
+// Drops the queued jobs and waits for the running ones, also run at exit since glutMainLoop may
+// end the process itself
+static void UStopDecoders(void) {
+
+	{
+		lock_guard<mutex> lock(jobMutex);
+		stopping = true;
+		jobs.clear();
+	}
+	UTaskWait(decodeTasks);
+
+}
+
+
+// Whether the GL context can sample a codec's blocks
+static bool UCodecSupported(TextureCodec candidate) {
+
+	switch (candidate) {
+	case CODEC_BC1: return GLEW_EXT_texture_compression_s3tc != 0;
+	case CODEC_BC7: return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+	default: return true;
+	}
+
+}
+
+
+void UStreamInit(const StreamOptions& options) {
+
+	streamOptions = options;
+	memset(&stats, 0, sizeof(stats));
+	codec = options.codec;
+	if (!UCodecSupported(codec)) {
+		std::cerr << "This GL context cannot sample " << UCodecName(codec) << " textures, streaming them uncompressed\n";
+		codec = CODEC_NONE;
+	}
+	stopping = false;
+	atexit(UStopDecoders);
+
+}
+
+
+// Queues a job, starting another decode task while fewer than --stream-threads run
+static void UQueueJob(const StreamJob& job) {
+
+	bool start = false;
+	{
+		lock_guard<mutex> lock(jobMutex);
+		jobs.push_back(job);
+		if (decodersRunning < streamOptions.threads) {
+			decodersRunning++;
+			start = true;
+		}
+	}
+	if (start) {
+		UTaskRun(UStreamDecoder, &decodeTasks);
+	}
+
+}
+
+
+int UStreamCreateArray(const vector<string>& layerFiles, GLuint& texture) {
+
+	StreamTexture streamed;
+	streamed.files = layerFiles;
+	streamed.created = false;
+	streamed.failed = false;
+	streamed.jobInFlight = true;
+	streamed.width = 0;
+	streamed.height = 0;
+	streamed.layers = (int)layerFiles.size();
+	streamed.levelCount = 0;
+	streamed.floorLevel = 0;
+	streamed.baseLevel = 0;
+	streamed.neededPixels = 0.0f;
+	streamed.rejectedLevel = -1;
+	streamed.rejectedRoom = 0;
+	streamed.name = UGpuGenTexture("streamed texture array");
+	texture = streamed.name;
+
+	int handle = (int)textures.size();
+	textures.push_back(streamed);
+	pendingCoarse++;
+
+	StreamJob job = { handle, layerFiles, -1, -1, streamOptions.floorSize };
+	UQueueJob(job);
+	return handle;
+
+}
+
+
+// Drops the finest resident level of a texture
+static void UEvictLevel(StreamTexture& texture) {
+
+	int level = texture.baseLevel;
+	texture.baseLevel++;
+
+	UStateBindTexture(0, GL_TEXTURE_2D_ARRAY, texture.name);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, texture.baseLevel);
+	UGpuTexImage3D(GL_TEXTURE_2D_ARRAY, texture.name, level, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	UStateBindTexture(0, GL_TEXTURE_2D_ARRAY, 0);
+
+	stats.residentBytes -= ULevelBytes(texture, level);
+	stats.levelsEvicted++;
+
+}
+
+
+// Least recently needed texture with a level that can go, skipping keep and anything needed this frame
+static int UEvictionCandidate(int keep) {
+
+	int candidate = -1;
+	long long oldest = streamFrame;
+	for (int i = 0; i < (int)textures.size(); i++) {
+		const StreamTexture& texture = textures[i];
+		if (i == keep || !texture.created || texture.baseLevel >= texture.floorLevel) {
+			continue;
+		}
+		if (texture.levelLastNeeded[texture.baseLevel] < oldest) {
+			oldest = texture.levelLastNeeded[texture.baseLevel];
+			candidate = i;
+		}
+	}
+	return candidate;
+
+}
+
+
+// Bytes held by levels nobody needed this frame, all of which UMakeRoom may reclaim
+static size_t UEvictableBytes(int keep) {
+
+	size_t bytes = 0;
+	for (int i = 0; i < (int)textures.size(); i++) {
+		const StreamTexture& texture = textures[i];
+		if (i == keep || !texture.created) {
+			continue;
+		}
+		for (int l = texture.baseLevel; l < texture.floorLevel && texture.levelLastNeeded[l] < streamFrame; l++) {
+			bytes += ULevelBytes(texture, l);
+		}
+	}
+	return bytes;
+
+}
+
+
+// Bytes a texture's finer levels could take once everything not needed is evicted
+static size_t URoomFor(int texture) {
+
+	size_t budget = streamOptions.budgetBytes;
+	return budget - min(budget, stats.residentBytes) + UEvictableBytes(texture);
+
+}
+
+
+// Evicts until bytes more fit in the budget. False, with nothing evicted, when that would take
+// levels still in use.
+static bool UMakeRoom(size_t bytes, int keep) {
+
+	size_t budget = streamOptions.budgetBytes;
+	if (stats.residentBytes + bytes > budget + UEvictableBytes(keep)) {
+		return false;
+	}
+	while (stats.residentBytes + bytes > budget) {
+		int candidate = UEvictionCandidate(keep);
+		if (candidate < 0) {
+			return false;
+		}
+		UEvictLevel(textures[candidate]);
+	}
+	return true;
+
+}
+
+
+// Uploads levels [first, last) of result, finest last so the texture is never sampled past its base
+static void UUploadLevels(StreamTexture& texture, const StreamResult& result) {
+
+	UStateBindTexture(0, GL_TEXTURE_2D_ARRAY, texture.name);
+	for (int l = result.lastLevel - 1; l >= result.firstLevel; l--) {
+		int width = max(1, texture.width >> l);
+		int height = max(1, texture.height >> l);
+		const vector<unsigned char>& level = result.levels[l - result.firstLevel];
+		if (codec != CODEC_NONE) {
+			UGpuCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, texture.name, l, UCodecFormat(codec), width, height, texture.layers, (GLsizei)level.size(), level.data());
+		}
+		else {
+			UGpuTexImage3D(GL_TEXTURE_2D_ARRAY, texture.name, l, GL_RGBA8, width, height, texture.layers, GL_RGBA, GL_UNSIGNED_BYTE, level.data());
+		}
+		stats.residentBytes += ULevelBytes(texture, l);
+		uploadedBytes += (double)level.size();
+		uncompressedBytes += (double)width * height * texture.layers * 4;
+		uploadedSamples += (double)width * height * texture.layers * UCodecChannels(codec);
+	}
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, result.firstLevel);
+	UStateBindTexture(0, GL_TEXTURE_2D_ARRAY, 0);
+
+	texture.baseLevel = result.firstLevel;
+	stats.peakBytes = max(stats.peakBytes, stats.residentBytes);
+	uploadedError += result.squaredError;
+	levelsUploaded += result.lastLevel - result.firstLevel;
+	levelsCached += result.cached ? result.lastLevel - result.firstLevel : 0;
+
+}
+
+
+static void UApplyResult(const StreamResult& result) {
+
+	StreamTexture& texture = textures[result.texture];
+	texture.jobInFlight = false;
+
+	// First result, size the texture and make the coarse mips resident
+	if (!texture.created) {
+		pendingCoarse--;
+		if (result.width == 0) {
+			texture.failed = true;
+			return;
+		}
+		texture.width = result.width;
+		texture.height = result.height;
+		texture.levelCount = result.lastLevel;
+		texture.floorLevel = result.firstLevel;
+		texture.levelLastNeeded.assign(texture.levelCount, 0);
+		texture.created = true;
+
+		UStateBindTexture(0, GL_TEXTURE_2D_ARRAY, texture.name);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, texture.levelCount - 1);
+		UUploadLevels(texture, result);
+		if (stats.residentBytes > streamOptions.budgetBytes) {
+			std::cerr << "Coarse texture mips alone exceed the texture budget\n";
+		}
+		return;
+	}
+
+	// A finer run only fits on top of the base it was requested for
+	if (result.width == 0 || result.lastLevel != texture.baseLevel) {
+		return;
+	}
+	size_t bytes = 0;
+	for (int l = result.firstLevel; l < result.lastLevel; l++) {
+		bytes += ULevelBytes(texture, l);
+	}
+	if (!UMakeRoom(bytes, result.texture)) {
+		texture.rejectedLevel = result.firstLevel;
+		texture.rejectedRoom = URoomFor(result.texture);
+		return;
+	}
+	texture.rejectedLevel = -1;
+	UUploadLevels(texture, result);
+	stats.levelsStreamed += result.lastLevel - result.firstLevel;
+
+}
+
+
+void UStreamWaitResident(void) {
+
+	// The GL thread decodes alongside the task threads rather than sleeping, and once the decode
+	// tasks are done every coarse job has its result queued
+	UTaskWait(decodeTasks);
+	while (pendingCoarse > 0) {
+		StreamResult result;
+		{
+			lock_guard<mutex> lock(resultMutex);
+			if (results.empty()) {
+				break;
+			}
+			result = std::move(results.front());
+			results.pop_front();
+		}
+		UApplyResult(result);
+	}
+
+}
+
+
+float UStreamProjectedSize(float worldSize, float distance, float projectionScaleY, int viewportHeight) {
+
+	return worldSize * projectionScaleY * 0.5f * viewportHeight / max(distance, 0.001f);
+
+}
+
+
+void UStreamNeed(int texture, float pixels) {
+
+	if (texture >= 0 && texture < (int)textures.size()) {
+		textures[texture].neededPixels = max(textures[texture].neededPixels, pixels);
+	}
+
+}
+
+
+void UStreamUpdate(void) {
+
+	streamFrame++;
+
+	// Turn last frame's projected sizes into the finest level each texture needs
+	FrameVector<int> wanted(textures.size());
+	for (size_t i = 0; i < textures.size(); i++) {
+		StreamTexture& texture = textures[i];
+		wanted[i] = texture.floorLevel;
+		if (!texture.created || texture.neededPixels <= 0.0f) {
+			texture.neededPixels = 0.0f;
+			continue;
+		}
+		float texels = (float)max(texture.width, texture.height);
+		int level = (int)floor(log2(texels / max(texture.neededPixels, 1.0f)));
+		wanted[i] = min(max(level, 0), texture.floorLevel);
+		for (int l = wanted[i]; l < texture.levelCount; l++) {
+			texture.levelLastNeeded[l] = streamFrame;
+		}
+		texture.neededPixels = 0.0f;
+	}
+
+	// Upload what the decode tasks finished, a few levels per frame
+	for (int i = 0; i < streamOptions.uploadsPerFrame; i++) {
+		StreamResult result;
+		{
+			lock_guard<mutex> lock(resultMutex);
+			if (results.empty()) {
+				break;
+			}
+			result = std::move(results.front());
+			results.pop_front();
+		}
+		UApplyResult(result);
+	}
+
+	// Request the finer levels that fit once everything not needed is evicted
+	for (size_t i = 0; i < textures.size(); i++) {
+		StreamTexture& texture = textures[i];
+		if (!texture.created || texture.jobInFlight || wanted[i] >= texture.baseLevel) {
+			continue;
+		}
+		size_t available = URoomFor((int)i);
+		int finest = wanted[i];
+		if (texture.rejectedLevel >= 0 && available <= texture.rejectedRoom) {
+			finest = max(finest, texture.rejectedLevel + 1); // would be turned away again
+		}
+		int target = texture.baseLevel;
+		while (target > finest && ULevelBytes(texture, target - 1) <= available) {
+			available -= ULevelBytes(texture, target - 1);
+			target--;
+		}
+		if (target < texture.baseLevel) {
+			StreamJob job = { (int)i, texture.files, target, texture.baseLevel, streamOptions.floorSize };
+			texture.jobInFlight = true;
+			UQueueJob(job);
+		}
+	}
+
+}
+
+
+StreamStats UStreamGetStats(void) {
+
+	StreamStats current = stats;
+	current.jobsPending = 0;
+	for (size_t i = 0; i < textures.size(); i++) {
+		current.jobsPending += textures[i].jobInFlight ? 1 : 0;
+	}
+	return current;
+
+}
+
+
+void UStreamPrintStats(void) {
+
+	ostringstream report;
+	report << fixed << setprecision(1) << "Texture streaming: " << levelsUploaded << " levels uploaded, "
+		<< stats.levelsEvicted << " evicted, peak " << stats.peakBytes / 1024.0 << " KB resident";
+	if (codec != CODEC_NONE && uploadedBytes > 0.0) {
+		report << ", " << UCodecName(codec) << " " << uncompressedBytes / uploadedBytes << "x smaller than RGBA8 at "
+			<< UPsnr(uploadedError, uploadedSamples) << " dB PSNR, " << levelsCached << " levels from the cache";
+	}
+	report << "\n";
+	std::cout << report.str();
+
+}
+
+
+void UStreamShutdown(void) {
+
+	UStopDecoders();
+	for (size_t i = 0; i < textures.size(); i++) {
+		UGpuDeleteTexture(textures[i].name);
+	}
+	textures.clear();
+	stats.residentBytes = 0;
+
+}
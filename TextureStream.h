@@ -0,0 +1,77 @@
+/*
+*	Title:	Final Project / TextureStream.h
+*	Date:	October 19, 2026
+*
+*	Description: Streams the mip levels of texture arrays under a GPU memory
+*	budget. A texture starts with only its coarse mips resident, finer mips are
+*	decoded on the task threads once its projected screen size asks for them,
+*	and the least recently needed mips are evicted when the budget runs out.
+*	GL_TEXTURE_BASE_LEVEL and GL_TEXTURE_MAX_LEVEL keep sampling inside the
+*	resident levels.
+*
+*	Command line:
+*		--texture-budget <MB>		GPU memory for streamed textures, default 256
+*		--stream-threads <count>	decode tasks running at once, default 2
+*		--stream-floor <pixels>		mips this size and smaller stay resident, default 64
+*		--texture-compress <codec>	none, bc1 or bc7, compressed by the decode tasks, default none
+*		--texture-cache <folder>	keeps compressed levels there and reuses them on later runs
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+#include "TextureCompress.h"
+
+struct StreamOptions {
+	size_t budgetBytes;
+	int threads;
+	int floorSize;			// largest mip edge that is always resident
+	int uploadsPerFrame;	// finished decodes uploaded per UStreamUpdate
+	TextureCodec codec;
+	std::string cacheDir;	// empty for no compressed texture cache
+};
+
+struct StreamStats {
+	size_t residentBytes;
+	size_t peakBytes;
+	int levelsStreamed;
+	int levelsEvicted;
+	int jobsPending;
+};
+
+// Reads the streaming options out of the command line, returns false on a malformed argument
+bool UParseStreamOptions(int argc, char* argv[], StreamOptions& options);
+
+// Sets up decoding on the task scheduler, falling back to uncompressed textures when the codec is not supported
+void UStreamInit(const StreamOptions& options);
+
+// Creates a streamed GL_TEXTURE_2D_ARRAY with one layer per file and queues its coarse mips,
+// returns the streaming handle and the GL texture name
+int UStreamCreateArray(const std::vector<std::string>& layerFiles, GLuint& texture);
+
+// Returns once every texture created so far has its coarse mips resident, the calling thread
+// decodes in the meantime
+void UStreamWaitResident(void);
+
+// Screen size in pixels of an object worldSize across at distance from the eye,
+// projectionScaleY is projection[1][1]
+float UStreamProjectedSize(float worldSize, float distance, float projectionScaleY, int viewportHeight);
+
+// Records that a texture covers about pixels across on screen this frame
+void UStreamNeed(int texture, float pixels);
+
+// Once per frame on the GL thread: uploads finished levels, evicts under pressure
+// and requests the finer levels last frame's needs asked for
+void UStreamUpdate(void);
+
+StreamStats UStreamGetStats(void);
+
+// Prints the streaming totals and, when compressing, the size ratio and PSNR of what was uploaded
+void UStreamPrintStats(void);
+
+// Waits for the running decode tasks and deletes every streamed texture
+void UStreamShutdown(void);
@@ -0,0 +1,981 @@
+/*
+*	Title:	Final Project / TraceReplay.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Standalone replayer for the GL traces written with
+*	--gl-trace. It opens a hidden window of the traced size, re-executes
+*	the setup once and then the recorded frames as fast as the driver takes
+*	them, with no swaps and no vsync, and reports how long each type of
+*	call took. The whole trace is loaded before the first call so disk
+*	reads never land in the timings, and buffer and texture data are handed
+*	to GL straight out of it.
+*
+*	Every GL call is timed on its own on the CPU, less the cost of reading
+*	the clock, so the table shows where the driver spends its submission
+*	time. Each frame ends in glFinish, which is where the GPU work catches
+*	up and is listed as "frame end". Objects a frame creates are created
+*	again on every pass over the frames.
+*
+*	Build it as its own executable from this file plus GlTrace.cpp, linked
+*	against freeglut and GLEW.
+*
+*	Command line:
+*		TraceReplay <trace> [--loops <count>]		--loops replays the frames count times, default 1
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+
+#define GL_TRACE_NO_HOOKS
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+// Times one GL call against its record's type
+#define REPLAY_TIMED(call, statement) { long long start = UNowNs(); statement; UCount(call, start); }
+
+struct TraceReader {
+	const unsigned char* at;
+	const unsigned char* end;
+	bool failed;				// ran past the end of the trace
+};
+
+struct CallStats {
+	long long count;
+	long long nanoseconds;
+};
+
+// Captured names to the ones this run's driver handed out, 0 always stays 0. A deleted name maps
+// to 0, so later passes over the frames do not free setup objects the first pass already freed,
+// and a name the driver hands out again overwrites its entry.
+typedef unordered_map<GLuint, GLuint> NameMap;
+
+static NameMap buffers;
+static NameMap textures;
+static NameMap vertexArrays;
+static NameMap framebuffers;
+static NameMap queries;
+static NameMap programs;
+static NameMap shaders;
+static map<unsigned long long, GLsync> syncs;
+static map<pair<GLuint, GLint>, GLint> locations;		// by captured program and location
+static map<pair<GLuint, GLuint>, GLuint> blockIndices;
+static map<GLenum, void*> mappedBuffers;
+static GLuint currentProgram = 0;						// captured name, for uniform locations
+
+// Outputs the replay discards
+static GLint scratchInts[64];
+static GLint64 scratchInt64s[64];
+static GLuint64 scratchUint64;
+static vector<GLchar> scratchLog;
+static vector<unsigned char> scratchPixels;
+
+static CallStats setupStats[TRACE_CALL_COUNT];
+static CallStats frameStats[TRACE_CALL_COUNT];
+static CallStats* stats = setupStats;
+static long long clockOverhead = 0;
+
+
+static long long UNowNs(void) {
+
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+
+}
+
+
+static void UCount(int call, long long start) {
+
+	stats[call].count++;
+	stats[call].nanoseconds += max(0LL, UNowNs() - start - clockOverhead);
+
+}
+
+
+// Cheapest back to back clock read, taken off every timed call
+static long long UClockOverhead(void) {
+
+	long long best = LLONG_MAX;
+	for (int i = 0; i < 1000; i++) {
+		long long start = UNowNs();
+		best = min(best, UNowNs() - start);
+	}
+	return best;
+
+}
+
+
+template <typename T>
+static T UGet(TraceReader& reader) {
+
+	T value = T();
+	if ((size_t)(reader.end - reader.at) < sizeof(T)) {
+		reader.failed = true;
+		reader.at = reader.end;
+		return value;
+	}
+	memcpy(&value, reader.at, sizeof(T));
+	reader.at += sizeof(T);
+	return value;
+
+}
+
+
+// Skips size bytes and returns where they start, NULL past the end of the trace
+static const unsigned char* UGetBytes(TraceReader& reader, size_t size) {
+
+	if ((size_t)(reader.end - reader.at) < size) {
+		reader.failed = true;
+		reader.at = reader.end;
+		return NULL;
+	}
+	const unsigned char* bytes = reader.at;
+	reader.at += size;
+	return bytes;
+
+}
+
+
+static string UGetString(TraceReader& reader) {
+
+	unsigned int length = UGet<unsigned int>(reader);
+	const unsigned char* text = UGetBytes(reader, length);
+	return text != NULL ? string((const char*)text, length) : string();
+
+}
+
+
+// Inline data points into the trace, offsets become pointers again and client memory is scratch
+static const void* UGetPointer(TraceReader& reader) {
+
+	unsigned char kind = UGet<unsigned char>(reader);
+	if (kind == TRACE_POINTER_DATA) {
+		return UGetBytes(reader, (size_t)UGet<unsigned long long>(reader));
+	}
+	if (kind == TRACE_POINTER_OFFSET) {
+		return (const void*)(size_t)UGet<unsigned long long>(reader);
+	}
+	if (kind == TRACE_POINTER_CLIENT) {
+		scratchPixels.resize((size_t)UGet<unsigned long long>(reader));
+		return scratchPixels.data();
+	}
+	return NULL;
+
+}
+
+
+static const void* UGetOffset(TraceReader& reader) {
+
+	return (const void*)(size_t)UGet<unsigned long long>(reader);
+
+}
+
+
+static GLuint UName(const NameMap& names, GLuint captured) {
+
+	NameMap::const_iterator name = names.find(captured);
+	return name != names.end() ? name->second : captured;
+
+}
+
+
+static GLint ULocation(GLint captured) {
+
+	map<pair<GLuint, GLint>, GLint>::const_iterator location = locations.find(make_pair(currentProgram, captured));
+	return location != locations.end() ? location->second : captured;
+
+}
+
+
+static vector<GLuint> UGetNames(TraceReader& reader) {
+
+	GLsizei n = UGet<GLsizei>(reader);
+	vector<GLuint> names(max(n, 0));
+	const unsigned char* bytes = UGetBytes(reader, names.size() * sizeof(GLuint));
+	if (bytes != NULL && !names.empty()) {
+		memcpy(names.data(), bytes, names.size() * sizeof(GLuint));
+	}
+	return names;
+
+}
+
+
+// Creates n objects with gen and maps the captured names onto them
+static void UGenNames(TraceReader& reader, TraceCall call, void (*gen)(GLsizei, GLuint*), NameMap& names) {
+
+	vector<GLuint> captured = UGetNames(reader);
+	vector<GLuint> created(captured.size());
+	REPLAY_TIMED(call, gen((GLsizei)created.size(), created.data()));
+	for (size_t i = 0; i < captured.size(); i++) {
+		names[captured[i]] = created[i];
+	}
+
+}
+
+
+static void UDeleteNames(TraceReader& reader, TraceCall call, void (*remove)(GLsizei, const GLuint*), NameMap& names) {
+
+	vector<GLuint> captured = UGetNames(reader);
+	vector<GLuint> replayed(captured.size());
+	for (size_t i = 0; i < captured.size(); i++) {
+		replayed[i] = UName(names, captured[i]);
+		names[captured[i]] = 0;
+	}
+	REPLAY_TIMED(call, remove((GLsizei)replayed.size(), replayed.data()));
+
+}
+
+
+// GL entry points as plain functions, GLEW's are pointers that are only set after glewInit
+static void UGenBuffers(GLsizei n, GLuint* names) { glGenBuffers(n, names); }
+static void UGenFramebuffers(GLsizei n, GLuint* names) { glGenFramebuffers(n, names); }
+static void UGenQueries(GLsizei n, GLuint* names) { glGenQueries(n, names); }
+static void UGenTextures(GLsizei n, GLuint* names) { glGenTextures(n, names); }
+static void UGenVertexArrays(GLsizei n, GLuint* names) { glGenVertexArrays(n, names); }
+static void UDeleteBuffers(GLsizei n, const GLuint* names) { glDeleteBuffers(n, names); }
+static void UDeleteFramebuffers(GLsizei n, const GLuint* names) { glDeleteFramebuffers(n, names); }
+static void UDeleteQueries(GLsizei n, const GLuint* names) { glDeleteQueries(n, names); }
+static void UDeleteTextures(GLsizei n, const GLuint* names) { glDeleteTextures(n, names); }
+static void UDeleteVertexArrays(GLsizei n, const GLuint* names) { glDeleteVertexArrays(n, names); }
+
+
+// Executes one recorded call, false on a call this replayer does not know
+static bool UReplayCall(TraceReader& reader, TraceCall call) {
+
+	switch (call) {
+	case TRACE_ACTIVE_TEXTURE: {
+		GLenum texture = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glActiveTexture(texture));
+		break;
+	}
+	case TRACE_ATTACH_SHADER: {
+		GLuint program = UName(programs, UGet<GLuint>(reader));
+		GLuint shader = UName(shaders, UGet<GLuint>(reader));
+		REPLAY_TIMED(call, glAttachShader(program, shader));
+		break;
+	}
+	case TRACE_BEGIN_QUERY: {
+		GLenum target = UGet<GLenum>(reader);
+		GLuint id = UName(queries, UGet<GLuint>(reader));
+		REPLAY_TIMED(call, glBeginQuery(target, id));
+		break;
+	}
+	case TRACE_BIND_BUFFER: {
+		GLenum target = UGet<GLenum>(reader);
+		GLuint buffer = UName(buffers, UGet<GLuint>(reader));
+		REPLAY_TIMED(call, glBindBuffer(target, buffer));
+		break;
+	}
+	case TRACE_BIND_BUFFER_BASE: {
+		GLenum target = UGet<GLenum>(reader);
+		GLuint index = UGet<GLuint>(reader);
+		GLuint buffer = UName(buffers, UGet<GLuint>(reader));
+		REPLAY_TIMED(call, glBindBufferBase(target, index, buffer));
+		break;
+	}
+	case TRACE_BIND_FRAMEBUFFER: {
+		GLenum target = UGet<GLenum>(reader);
+		GLuint framebuffer = UName(framebuffers, UGet<GLuint>(reader));
+		REPLAY_TIMED(call, glBindFramebuffer(target, framebuffer));
+		break;
+	}
+	case TRACE_BIND_IMAGE_TEXTURE: {
+		GLuint unit = UGet<GLuint>(reader);
+		GLuint texture = UName(textures, UGet<GLuint>(reader));
+		GLint level = UGet<GLint>(reader);
+		GLboolean layered = UGet<GLboolean>(reader);
+		GLint layer = UGet<GLint>(reader);
+		GLenum access = UGet<GLenum>(reader);
+		GLenum format = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glBindImageTexture(unit, texture, level, layered, layer, access, format));
+		break;
+	}
+	case TRACE_BIND_TEXTURE: {
+		GLenum target = UGet<GLenum>(reader);
+		GLuint texture = UName(textures, UGet<GLuint>(reader));
+		REPLAY_TIMED(call, glBindTexture(target, texture));
+		break;
+	}
+	case TRACE_BIND_VERTEX_ARRAY: {
+		GLuint array = UName(vertexArrays, UGet<GLuint>(reader));
+		REPLAY_TIMED(call, glBindVertexArray(array));
+		break;
+	}
+	case TRACE_BUFFER_DATA: {
+		GLenum target = UGet<GLenum>(reader);
+		GLsizeiptr size = (GLsizeiptr)UGet<long long>(reader);
+		GLenum usage = UGet<GLenum>(reader);
+		const void* data = UGetPointer(reader);
+		REPLAY_TIMED(call, glBufferData(target, size, data, usage));
+		break;
+	}
+	case TRACE_BUFFER_STORAGE: {
+		GLenum target = UGet<GLenum>(reader);
+		GLsizeiptr size = (GLsizeiptr)UGet<long long>(reader);
+		GLbitfield flags = UGet<GLbitfield>(reader);
+		const void* data = UGetPointer(reader);
+		REPLAY_TIMED(call, glBufferStorage(target, size, data, flags));
+		break;
+	}
+	case TRACE_BUFFER_SUB_DATA: {
+		GLenum target = UGet<GLenum>(reader);
+		GLintptr offset = (GLintptr)UGet<long long>(reader);
+		GLsizeiptr size = (GLsizeiptr)UGet<long long>(reader);
+		const void* data = UGetPointer(reader);
+		REPLAY_TIMED(call, glBufferSubData(target, offset, size, data));
+		break;
+	}
+	case TRACE_CHECK_FRAMEBUFFER_STATUS: {
+		GLenum target = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glCheckFramebufferStatus(target));
+		break;
+	}
+	case TRACE_CLEAR: {
+		GLbitfield mask = UGet<GLbitfield>(reader);
+		REPLAY_TIMED(call, glClear(mask));
+		break;
+	}
+	case TRACE_CLEAR_COLOR: {
+		GLfloat red = UGet<GLfloat>(reader);
+		GLfloat green = UGet<GLfloat>(reader);
+		GLfloat blue = UGet<GLfloat>(reader);
+		GLfloat alpha = UGet<GLfloat>(reader);
+		REPLAY_TIMED(call, glClearColor(red, green, blue, alpha));
+		break;
+	}
+	case TRACE_CLIENT_WAIT_SYNC: {
+		GLsync sync = syncs[UGet<unsigned long long>(reader)];
+		GLbitfield flags = UGet<GLbitfield>(reader);
+		GLuint64 timeout = UGet<GLuint64>(reader);
+		if (sync != NULL) {
+			REPLAY_TIMED(call, glClientWaitSync(sync, flags, timeout));
+		}
+		break;
+	}
+	case TRACE_COMPILE_SHADER: {
+		GLuint shader = UName(shaders, UGet<GLuint>(reader));
+		REPLAY_TIMED(call, glCompileShader(shader));
+		break;
+	}
+	case TRACE_COMPRESSED_TEX_IMAGE_3D: {
+		GLenum target = UGet<GLenum>(reader);
+		GLint level = UGet<GLint>(reader);
+		GLenum internalFormat = UGet<GLenum>(reader);
+		GLsizei width = UGet<GLsizei>(reader);
+		GLsizei height = UGet<GLsizei>(reader);
+		GLsizei depth = UGet<GLsizei>(reader);
+		GLint border = UGet<GLint>(reader);
+		GLsizei imageSize = UGet<GLsizei>(reader);
+		const void* data = UGetPointer(reader);
+		REPLAY_TIMED(call, glCompressedTexImage3D(target, level, internalFormat, width, height, depth, border, imageSize, data));
+		break;
+	}
+	case TRACE_CREATE_PROGRAM: {
+		GLuint captured = UGet<GLuint>(reader);
+		GLuint program;
+		REPLAY_TIMED(call, program = glCreateProgram());
+		programs[captured] = program;
+		break;
+	}
+	case TRACE_CREATE_SHADER: {
+		GLenum type = UGet<GLenum>(reader);
+		GLuint captured = UGet<GLuint>(reader);
+		GLuint shader;
+		REPLAY_TIMED(call, shader = glCreateShader(type));
+		shaders[captured] = shader;
+		break;
+	}
+	case TRACE_DELETE_BUFFERS: UDeleteNames(reader, call, UDeleteBuffers, buffers); break;
+	case TRACE_DELETE_FRAMEBUFFERS: UDeleteNames(reader, call, UDeleteFramebuffers, framebuffers); break;
+	case TRACE_DELETE_PROGRAM: {
+		GLuint captured = UGet<GLuint>(reader);
+		GLuint program = UName(programs, captured);
+		programs[captured] = 0;
+		REPLAY_TIMED(call, glDeleteProgram(program));
+		break;
+	}
+	case TRACE_DELETE_QUERIES: UDeleteNames(reader, call, UDeleteQueries, queries); break;
+	case TRACE_DELETE_SHADER: {
+		GLuint captured = UGet<GLuint>(reader);
+		GLuint shader = UName(shaders, captured);
+		shaders[captured] = 0;
+		REPLAY_TIMED(call, glDeleteShader(shader));
+		break;
+	}
+	case TRACE_DELETE_SYNC: {
+		unsigned long long captured = UGet<unsigned long long>(reader);
+		GLsync sync = syncs[captured];
+		syncs.erase(captured);
+		if (sync != NULL) {
+			REPLAY_TIMED(call, glDeleteSync(sync));
+		}
+		break;
+	}
+	case TRACE_DELETE_TEXTURES: UDeleteNames(reader, call, UDeleteTextures, textures); break;
+	case TRACE_DELETE_VERTEX_ARRAYS: UDeleteNames(reader, call, UDeleteVertexArrays, vertexArrays); break;
+	case TRACE_DETACH_SHADER: {
+		GLuint program = UName(programs, UGet<GLuint>(reader));
+		GLuint shader = UName(shaders, UGet<GLuint>(reader));
+		if (program != 0 && shader != 0) {
+			REPLAY_TIMED(call, glDetachShader(program, shader));
+		}
+		break;
+	}
+	case TRACE_DISABLE: {
+		GLenum cap = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glDisable(cap));
+		break;
+	}
+	case TRACE_DISPATCH_COMPUTE: {
+		GLuint groupsX = UGet<GLuint>(reader);
+		GLuint groupsY = UGet<GLuint>(reader);
+		GLuint groupsZ = UGet<GLuint>(reader);
+		REPLAY_TIMED(call, glDispatchCompute(groupsX, groupsY, groupsZ));
+		break;
+	}
+	case TRACE_DRAW_ARRAYS: {
+		GLenum mode = UGet<GLenum>(reader);
+		GLint first = UGet<GLint>(reader);
+		GLsizei count = UGet<GLsizei>(reader);
+		REPLAY_TIMED(call, glDrawArrays(mode, first, count));
+		break;
+	}
+	case TRACE_DRAW_ARRAYS_INSTANCED: {
+		GLenum mode = UGet<GLenum>(reader);
+		GLint first = UGet<GLint>(reader);
+		GLsizei count = UGet<GLsizei>(reader);
+		GLsizei instanceCount = UGet<GLsizei>(reader);
+		REPLAY_TIMED(call, glDrawArraysInstanced(mode, first, count, instanceCount));
+		break;
+	}
+	case TRACE_DRAW_ELEMENTS_INDIRECT: {
+		GLenum mode = UGet<GLenum>(reader);
+		GLenum type = UGet<GLenum>(reader);
+		const void* indirect = UGetOffset(reader);
+		REPLAY_TIMED(call, glDrawElementsIndirect(mode, type, indirect));
+		break;
+	}
+	case TRACE_DRAW_ELEMENTS_INSTANCED: {
+		GLenum mode = UGet<GLenum>(reader);
+		GLsizei count = UGet<GLsizei>(reader);
+		GLenum type = UGet<GLenum>(reader);
+		const void* indices = UGetOffset(reader);
+		GLsizei instanceCount = UGet<GLsizei>(reader);
+		REPLAY_TIMED(call, glDrawElementsInstanced(mode, count, type, indices, instanceCount));
+		break;
+	}
+	case TRACE_ENABLE: {
+		GLenum cap = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glEnable(cap));
+		break;
+	}
+	case TRACE_ENABLE_VERTEX_ATTRIB_ARRAY: {
+		GLuint index = UGet<GLuint>(reader);
+		REPLAY_TIMED(call, glEnableVertexAttribArray(index));
+		break;
+	}
+	case TRACE_END_QUERY: {
+		GLenum target = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glEndQuery(target));
+		break;
+	}
+	case TRACE_FENCE_SYNC: {
+		GLenum condition = UGet<GLenum>(reader);
+		GLbitfield flags = UGet<GLbitfield>(reader);
+		unsigned long long captured = UGet<unsigned long long>(reader);
+		GLsync sync;
+		REPLAY_TIMED(call, sync = glFenceSync(condition, flags));
+		syncs[captured] = sync;
+		break;
+	}
+	case TRACE_FINISH: REPLAY_TIMED(call, glFinish()); break;
+	case TRACE_FRAMEBUFFER_TEXTURE_2D: {
+		GLenum target = UGet<GLenum>(reader);
+		GLenum attachment = UGet<GLenum>(reader);
+		GLenum texTarget = UGet<GLenum>(reader);
+		GLuint texture = UName(textures, UGet<GLuint>(reader));
+		GLint level = UGet<GLint>(reader);
+		REPLAY_TIMED(call, glFramebufferTexture2D(target, attachment, texTarget, texture, level));
+		break;
+	}
+	case TRACE_GEN_BUFFERS: UGenNames(reader, call, UGenBuffers, buffers); break;
+	case TRACE_GEN_FRAMEBUFFERS: UGenNames(reader, call, UGenFramebuffers, framebuffers); break;
+	case TRACE_GEN_QUERIES: UGenNames(reader, call, UGenQueries, queries); break;
+	case TRACE_GEN_TEXTURES: UGenNames(reader, call, UGenTextures, textures); break;
+	case TRACE_GEN_VERTEX_ARRAYS: UGenNames(reader, call, UGenVertexArrays, vertexArrays); break;
+	case TRACE_GET_INTEGER64V: {
+		GLenum pname = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glGetInteger64v(pname, scratchInt64s));
+		break;
+	}
+	case TRACE_GET_INTEGERV: {
+		GLenum pname = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glGetIntegerv(pname, scratchInts));
+		break;
+	}
+	case TRACE_GET_PROGRAM_INFO_LOG: {
+		GLuint program = UName(programs, UGet<GLuint>(reader));
+		GLsizei bufSize = UGet<GLsizei>(reader);
+		scratchLog.resize(max(bufSize, 1));
+		REPLAY_TIMED(call, glGetProgramInfoLog(program, bufSize, NULL, scratchLog.data()));
+		break;
+	}
+	case TRACE_GET_PROGRAMIV: {
+		GLuint program = UName(programs, UGet<GLuint>(reader));
+		GLenum pname = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glGetProgramiv(program, pname, scratchInts));
+		break;
+	}
+	case TRACE_GET_QUERY_OBJECTUI64V: {
+		GLuint id = UName(queries, UGet<GLuint>(reader));
+		GLenum pname = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glGetQueryObjectui64v(id, pname, &scratchUint64));
+		break;
+	}
+	case TRACE_GET_SHADER_INFO_LOG: {
+		GLuint shader = UName(shaders, UGet<GLuint>(reader));
+		GLsizei bufSize = UGet<GLsizei>(reader);
+		scratchLog.resize(max(bufSize, 1));
+		REPLAY_TIMED(call, glGetShaderInfoLog(shader, bufSize, NULL, scratchLog.data()));
+		break;
+	}
+	case TRACE_GET_SHADERIV: {
+		GLuint shader = UName(shaders, UGet<GLuint>(reader));
+		GLenum pname = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glGetShaderiv(shader, pname, scratchInts));
+		break;
+	}
+	case TRACE_GET_UNIFORM_BLOCK_INDEX: {
+		GLuint captured = UGet<GLuint>(reader);
+		GLuint capturedIndex = UGet<GLuint>(reader);
+		string name = UGetString(reader);
+		GLuint program = UName(programs, captured);
+		GLuint index;
+		REPLAY_TIMED(call, index = glGetUniformBlockIndex(program, name.c_str()));
+		blockIndices[make_pair(captured, capturedIndex)] = index;
+		break;
+	}
+	case TRACE_GET_UNIFORM_LOCATION: {
+		GLuint captured = UGet<GLuint>(reader);
+		GLint capturedLocation = UGet<GLint>(reader);
+		string name = UGetString(reader);
+		GLuint program = UName(programs, captured);
+		GLint location;
+		REPLAY_TIMED(call, location = glGetUniformLocation(program, name.c_str()));
+		locations[make_pair(captured, capturedLocation)] = location;
+		break;
+	}
+	case TRACE_IS_ENABLED: {
+		GLenum cap = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glIsEnabled(cap));
+		break;
+	}
+	case TRACE_LINK_PROGRAM: {
+		GLuint program = UName(programs, UGet<GLuint>(reader));
+		REPLAY_TIMED(call, glLinkProgram(program));
+		break;
+	}
+	case TRACE_MAP_BUFFER_RANGE: {
+		GLenum target = UGet<GLenum>(reader);
+		GLintptr offset = (GLintptr)UGet<long long>(reader);
+		GLsizeiptr length = (GLsizeiptr)UGet<long long>(reader);
+		GLbitfield access = UGet<GLbitfield>(reader);
+		void* pointer;
+		REPLAY_TIMED(call, pointer = glMapBufferRange(target, offset, length, access));
+		mappedBuffers[target] = pointer;
+		break;
+	}
+	case TRACE_MAX_SHADER_COMPILER_THREADS: {
+		GLuint count = UGet<GLuint>(reader);
+		if (GLEW_KHR_parallel_shader_compile) {
+			REPLAY_TIMED(call, glMaxShaderCompilerThreadsKHR(count));
+		}
+		break;
+	}
+	case TRACE_MEMORY_BARRIER: {
+		GLbitfield barriers = UGet<GLbitfield>(reader);
+		REPLAY_TIMED(call, glMemoryBarrier(barriers));
+		break;
+	}
+	case TRACE_QUERY_COUNTER: {
+		GLuint id = UName(queries, UGet<GLuint>(reader));
+		GLenum target = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glQueryCounter(id, target));
+		break;
+	}
+	case TRACE_READ_BUFFER: {
+		GLenum mode = UGet<GLenum>(reader);
+		REPLAY_TIMED(call, glReadBuffer(mode));
+		break;
+	}
+	case TRACE_READ_PIXELS: {
+		GLint x = UGet<GLint>(reader);
+		GLint y = UGet<GLint>(reader);
+		GLsizei width = UGet<GLsizei>(reader);
+		GLsizei height = UGet<GLsizei>(reader);
+		GLenum format = UGet<GLenum>(reader);
+		GLenum type = UGet<GLenum>(reader);
+		void* pixels = (void*)UGetPointer(reader);
+		REPLAY_TIMED(call, glReadPixels(x, y, width, height, format, type, pixels));
+		break;
+	}
+	case TRACE_SCISSOR: {
+		GLint x = UGet<GLint>(reader);
+		GLint y = UGet<GLint>(reader);
+		GLsizei width = UGet<GLsizei>(reader);
+		GLsizei height = UGet<GLsizei>(reader);
+		REPLAY_TIMED(call, glScissor(x, y, width, height));
+		break;
+	}
+	case TRACE_SHADER_SOURCE: {
+		GLuint shader = UName(shaders, UGet<GLuint>(reader));
+		GLsizei count = max(UGet<GLsizei>(reader), 0);
+		vector<string> sources(count);
+		vector<const GLchar*> strings(count);
+		for (GLsizei i = 0; i < count; i++) {
+			sources[i] = UGetString(reader);
+			strings[i] = sources[i].c_str();
+		}
+		REPLAY_TIMED(call, glShaderSource(shader, count, strings.data(), NULL));
+		break;
+	}
+	case TRACE_TEX_IMAGE_2D: {
+		GLenum target = UGet<GLenum>(reader);
+		GLint level = UGet<GLint>(reader);
+		GLint internalFormat = UGet<GLint>(reader);
+		GLsizei width = UGet<GLsizei>(reader);
+		GLsizei height = UGet<GLsizei>(reader);
+		GLint border = UGet<GLint>(reader);
+		GLenum format = UGet<GLenum>(reader);
+		GLenum type = UGet<GLenum>(reader);
+		const void* data = UGetPointer(reader);
+		REPLAY_TIMED(call, glTexImage2D(target, level, internalFormat, width, height, border, format, type, data));
+		break;
+	}
+	case TRACE_TEX_IMAGE_3D: {
+		GLenum target = UGet<GLenum>(reader);
+		GLint level = UGet<GLint>(reader);
+		GLint internalFormat = UGet<GLint>(reader);
+		GLsizei width = UGet<GLsizei>(reader);
+		GLsizei height = UGet<GLsizei>(reader);
+		GLsizei depth = UGet<GLsizei>(reader);
+		GLint border = UGet<GLint>(reader);
+		GLenum format = UGet<GLenum>(reader);
+		GLenum type = UGet<GLenum>(reader);
+		const void* data = UGetPointer(reader);
+		REPLAY_TIMED(call, glTexImage3D(target, level, internalFormat, width, height, depth, border, format, type, data));
+		break;
+	}
+	case TRACE_TEX_PARAMETERI: {
+		GLenum target = UGet<GLenum>(reader);
+		GLenum pname = UGet<GLenum>(reader);
+		GLint param = UGet<GLint>(reader);
+		REPLAY_TIMED(call, glTexParameteri(target, pname, param));
+		break;
+	}
+	case TRACE_UNIFORM_1F: {
+		GLint location = ULocation(UGet<GLint>(reader));
+		GLfloat v0 = UGet<GLfloat>(reader);
+		REPLAY_TIMED(call, glUniform1f(location, v0));
+		break;
+	}
+	case TRACE_UNIFORM_1I: {
+		GLint location = ULocation(UGet<GLint>(reader));
+		GLint v0 = UGet<GLint>(reader);
+		REPLAY_TIMED(call, glUniform1i(location, v0));
+		break;
+	}
+	case TRACE_UNIFORM_1UI: {
+		GLint location = ULocation(UGet<GLint>(reader));
+		GLuint v0 = UGet<GLuint>(reader);
+		REPLAY_TIMED(call, glUniform1ui(location, v0));
+		break;
+	}
+	case TRACE_UNIFORM_1UIV: {
+		GLint location = ULocation(UGet<GLint>(reader));
+		GLsizei count = max(UGet<GLsizei>(reader), 0);
+		const GLuint* value = (const GLuint*)UGetBytes(reader, count * sizeof(GLuint));
+		REPLAY_TIMED(call, glUniform1uiv(location, count, value));
+		break;
+	}
+	case TRACE_UNIFORM_2F: {
+		GLint location = ULocation(UGet<GLint>(reader));
+		GLfloat v0 = UGet<GLfloat>(reader);
+		GLfloat v1 = UGet<GLfloat>(reader);
+		REPLAY_TIMED(call, glUniform2f(location, v0, v1));
+		break;
+	}
+	case TRACE_UNIFORM_2I: {
+		GLint location = ULocation(UGet<GLint>(reader));
+		GLint v0 = UGet<GLint>(reader);
+		GLint v1 = UGet<GLint>(reader);
+		REPLAY_TIMED(call, glUniform2i(location, v0, v1));
+		break;
+	}
+	case TRACE_UNIFORM_2IV: {
+		GLint location = ULocation(UGet<GLint>(reader));
+		GLsizei count = max(UGet<GLsizei>(reader), 0);
+		const GLint* value = (const GLint*)UGetBytes(reader, count * 2 * sizeof(GLint));
+		REPLAY_TIMED(call, glUniform2iv(location, count, value));
+		break;
+	}
+	case TRACE_UNIFORM_3F: {
+		GLint location = ULocation(UGet<GLint>(reader));
+		GLfloat v0 = UGet<GLfloat>(reader);
+		GLfloat v1 = UGet<GLfloat>(reader);
+		GLfloat v2 = UGet<GLfloat>(reader);
+		REPLAY_TIMED(call, glUniform3f(location, v0, v1, v2));
+		break;
+	}
+	case TRACE_UNIFORM_3FV: {
+		GLint location = ULocation(UGet<GLint>(reader));
+		GLsizei count = max(UGet<GLsizei>(reader), 0);
+		const GLfloat* value = (const GLfloat*)UGetBytes(reader, count * 3 * sizeof(GLfloat));
+		REPLAY_TIMED(call, glUniform3fv(location, count, value));
+		break;
+	}
+	case TRACE_UNIFORM_BLOCK_BINDING: {
+		GLuint captured = UGet<GLuint>(reader);
+		GLuint capturedIndex = UGet<GLuint>(reader);
+		GLuint blockBinding = UGet<GLuint>(reader);
+		map<pair<GLuint, GLuint>, GLuint>::const_iterator index = blockIndices.find(make_pair(captured, capturedIndex));
+		GLuint blockIndex = index != blockIndices.end() ? index->second : capturedIndex;
+		GLuint program = UName(programs, captured);
+		REPLAY_TIMED(call, glUniformBlockBinding(program, blockIndex, blockBinding));
+		break;
+	}
+	case TRACE_UNIFORM_MATRIX_4FV: {
+		GLint location = ULocation(UGet<GLint>(reader));
+		GLsizei count = max(UGet<GLsizei>(reader), 0);
+		GLboolean transpose = UGet<GLboolean>(reader);
+		const GLfloat* value = (const GLfloat*)UGetBytes(reader, count * 16 * sizeof(GLfloat));
+		REPLAY_TIMED(call, glUniformMatrix4fv(location, count, transpose, value));
+		break;
+	}
+	case TRACE_UNMAP_BUFFER: {
+		GLenum target = UGet<GLenum>(reader);
+		const unsigned char* written = NULL;
+		size_t size = 0;
+		if (UGet<unsigned char>(reader) == TRACE_POINTER_DATA) {
+			size = (size_t)UGet<unsigned long long>(reader);
+			written = UGetBytes(reader, size);
+		}
+
+		// The writes the program made through the mapping, copied in before the unmap as they were
+		void* pointer = mappedBuffers[target];
+		if (written != NULL && pointer != NULL) {
+			memcpy(pointer, written, size);
+		}
+		mappedBuffers.erase(target);
+		REPLAY_TIMED(call, glUnmapBuffer(target));
+		break;
+	}
+	case TRACE_USE_PROGRAM: {
+		currentProgram = UGet<GLuint>(reader);
+		GLuint program = UName(programs, currentProgram);
+		REPLAY_TIMED(call, glUseProgram(program));
+		break;
+	}
+	case TRACE_VERTEX_ATTRIB_DIVISOR: {
+		GLuint index = UGet<GLuint>(reader);
+		GLuint divisor = UGet<GLuint>(reader);
+		REPLAY_TIMED(call, glVertexAttribDivisor(index, divisor));
+		break;
+	}
+	case TRACE_VERTEX_ATTRIB_I_POINTER: {
+		GLuint index = UGet<GLuint>(reader);
+		GLint size = UGet<GLint>(reader);
+		GLenum type = UGet<GLenum>(reader);
+		GLsizei stride = UGet<GLsizei>(reader);
+		const void* pointer = UGetOffset(reader);
+		REPLAY_TIMED(call, glVertexAttribIPointer(index, size, type, stride, pointer));
+		break;
+	}
+	case TRACE_VERTEX_ATTRIB_POINTER: {
+		GLuint index = UGet<GLuint>(reader);
+		GLint size = UGet<GLint>(reader);
+		GLenum type = UGet<GLenum>(reader);
+		GLboolean normalized = UGet<GLboolean>(reader);
+		GLsizei stride = UGet<GLsizei>(reader);
+		const void* pointer = UGetOffset(reader);
+		REPLAY_TIMED(call, glVertexAttribPointer(index, size, type, normalized, stride, pointer));
+		break;
+	}
+	case TRACE_VIEWPORT: {
+		GLint x = UGet<GLint>(reader);
+		GLint y = UGet<GLint>(reader);
+		GLsizei width = UGet<GLsizei>(reader);
+		GLsizei height = UGet<GLsizei>(reader);
+		REPLAY_TIMED(call, glViewport(x, y, width, height));
+		break;
+	}
+	case TRACE_VIEWPORT_ARRAYV: {
+		GLuint first = UGet<GLuint>(reader);
+		GLsizei count = max(UGet<GLsizei>(reader), 0);
+		const GLfloat* v = (const GLfloat*)UGetBytes(reader, count * 4 * sizeof(GLfloat));
+		REPLAY_TIMED(call, glViewportArrayv(first, count, v));
+		break;
+	}
+	default:
+		return false;
+	}
+	return !reader.failed;
+
+}
+
+
+// Replays records up to and including the next marker and returns it, TRACE_END on a damaged trace
+static TraceCall UReplayToMarker(TraceReader& reader) {
+
+	while (true) {
+		TraceCall call = (TraceCall)UGet<unsigned char>(reader);
+		if (reader.failed) {
+			std::cerr << "Trace ends without an end record\n";
+			return TRACE_END;
+		}
+		if (call == TRACE_END || call == TRACE_SETUP_END || call == TRACE_FRAME) {
+			return call;
+		}
+		if (!UReplayCall(reader, call)) {
+			std::cerr << "Damaged trace: bad " << UTraceCallName(call) << " record\n";
+			reader.failed = true;
+			return TRACE_END;
+		}
+	}
+
+}
+
+
+// Call types by time spent, busiest first
+static void UPrintCallTable(const char* title, const CallStats* table) {
+
+	vector<int> calls;
+	long long total = 0;
+	for (int call = 0; call < TRACE_CALL_COUNT; call++) {
+		if (table[call].count > 0) {
+			calls.push_back(call);
+			total += table[call].nanoseconds;
+		}
+	}
+	sort(calls.begin(), calls.end(), [&](int a, int b) { return table[a].nanoseconds > table[b].nanoseconds; });
+
+	ostringstream report;
+	report << fixed << "\n" << title << "\n" << left << setw(32) << "call" << right << setw(10) << "count" << setw(12) << "total ms"
+		<< setw(12) << "avg us" << setw(8) << "share" << "\n";
+	for (size_t i = 0; i < calls.size(); i++) {
+		const CallStats& entry = table[calls[i]];
+		report << left << setw(32) << UTraceCallName(calls[i]) << right << setw(10) << entry.count
+			<< setw(12) << setprecision(3) << entry.nanoseconds / 1e6
+			<< setw(12) << setprecision(2) << entry.nanoseconds / 1e3 / entry.count
+			<< setw(7) << setprecision(1) << (total > 0 ? 100.0 * entry.nanoseconds / total : 0.0) << "%\n";
+	}
+	std::cout << report.str();
+
+}
+
+
+int main(int argc, char* argv[]) {
+
+	glutInit(&argc, argv);
+
+	string path;
+	int loops = 1;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+			loops = max(1, atoi(argv[++i]));
+		}
+		else {
+			path = argv[i];
+		}
+	}
+	if (path.empty()) {
+		std::cerr << "Usage: TraceReplay <trace> [--loops <count>]\n";
+		return -1;
+	}
+
+	ifstream file(path.c_str(), ios::binary);
+	vector<unsigned char> trace((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	TraceHeader header;
+	if (trace.size() < sizeof(header)) {
+		std::cerr << "Could not read trace " << path << "\n";
+		return -1;
+	}
+	memcpy(&header, trace.data(), sizeof(header));
+	if (header.magic != TRACE_MAGIC || header.version != TRACE_VERSION) {
+		std::cerr << path << " is not a version " << TRACE_VERSION << " GL trace\n";
+		return -1;
+	}
+
+	// A hidden window only to hold the context and a default framebuffer of the traced size
+	glutInitDisplayMode(GLUT_DEPTH | GLUT_DOUBLE | GLUT_RGBA);
+	glutInitWindowSize(header.width, header.height);
+	glutCreateWindow("Trace Replay");
+	glutHideWindow();
+	glewExperimental = GL_TRUE;
+	if (glewInit() != GLEW_OK) {
+		std::cout << "Failed to initialize GLEW" << std::endl;
+		return -1;
+	}
+	clockOverhead = UClockOverhead();
+
+	TraceReader reader = { trace.data() + sizeof(header), trace.data() + trace.size(), false };
+
+	// Setup once, finished before the frames start so its uploads do not land in the first frame
+	stats = setupStats;
+	long long setupStart = UNowNs();
+	TraceCall marker = UReplayToMarker(reader);
+	glFinish();
+	double setupMs = (UNowNs() - setupStart) / 1e6;
+
+	stats = frameStats;
+	vector<double> frameMs;
+	const unsigned char* framesStart = reader.at;
+	for (int loop = 0; loop < loops && marker == TRACE_SETUP_END && !reader.failed; loop++) {
+		reader.at = framesStart;
+		long long frameStart = UNowNs();
+		while (UReplayToMarker(reader) == TRACE_FRAME) {
+			REPLAY_TIMED(TRACE_FRAME, glFinish());
+			long long now = UNowNs();
+			frameMs.push_back((now - frameStart) / 1e6);
+			frameStart = now;
+		}
+	}
+	if (reader.failed) {
+		return -1;
+	}
+
+	ostringstream report;
+	report << fixed << setprecision(2) << "Trace " << path << ": " << header.width << "x" << header.height << ", "
+		<< header.frames << " frames, replayed " << loops << (loops == 1 ? " time" : " times") << "\n"
+		<< "setup        " << setupMs << " ms\n";
+	if (!frameMs.empty()) {
+		double sum = 0.0;
+		for (size_t i = 0; i < frameMs.size(); i++) {
+			sum += frameMs[i];
+		}
+		report << "frames       " << frameMs.size() << "\n"
+			<< "min_ms       " << *min_element(frameMs.begin(), frameMs.end()) << "\n"
+			<< "avg_ms       " << sum / frameMs.size() << "\n"
+			<< "max_ms       " << *max_element(frameMs.begin(), frameMs.end()) << "\n";
+	}
+	std::cout << report.str();
+	UPrintCallTable("Setup calls", setupStats);
+	UPrintCallTable("Frame calls", frameStats);
+	return 0;
+
+}
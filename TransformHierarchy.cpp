@@ -0,0 +1,198 @@
+/*
+*	Title:	Final Project / TransformHierarchy.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Transform hierarchy update. Dirty nodes are visited in slot
+*	order, each one recomputes its whole subtree in a single forward sweep
+*	(parents are always earlier in the sweep than their children), and dirty
+*	nodes inside a subtree already swept are skipped. Once its root is done
+*	the subtrees of a node's children share nothing, so a large subtree
+*	sweeps its children's subtrees in parallel slices, recursing into a
+*	child that is large itself.
+*/
+
+#include <algorithm>
+
+#include "FrameArena.h"
+#include "TaskScheduler.h"
+#include "TransformHierarchy.h"
+
+using namespace std; // standard namespace
+
+#define TRANSFORM_PARALLEL_MIN 4096		// slots below which a subtree is swept on one thread
+
+
+// Moves each slot's value to newSlot[slot] in one of the per slot arrays
+template <typename T>
+static void UPermuteSlots(vector<T>& values, const vector<int>& newSlot) {
+
+	vector<T> moved(values.size());
+	for (size_t slot = 0; slot < values.size(); slot++) {
+		moved[newSlot[slot]] = values[slot];
+	}
+	values.swap(moved);
+
+}
+
+
+// Puts the slots back in depth-first order after adds that broke it. Every node was appended after
+// its parent and its earlier siblings, so one pass in slot order can place each node right after
+// them, children keeping the order they were added in.
+static void UReorderSlots(TransformHierarchy& hierarchy) {
+
+	int count = (int)hierarchy.parent.size();
+	vector<int> newSlot(count);
+	vector<int> nextChild(count); // where the next child of each slot goes
+	int nextRoot = 0;
+	for (int slot = 0; slot < count; slot++) {
+		int parentSlot = hierarchy.parent[slot];
+		int& next = (parentSlot == TRANSFORM_NO_PARENT) ? nextRoot : nextChild[parentSlot];
+		newSlot[slot] = next;
+		next += hierarchy.subtreeSize[slot];
+		nextChild[slot] = newSlot[slot] + 1;
+	}
+
+	for (int slot = 0; slot < count; slot++) {
+		int parentSlot = hierarchy.parent[slot];
+		hierarchy.parent[slot] = (parentSlot == TRANSFORM_NO_PARENT) ? TRANSFORM_NO_PARENT : newSlot[parentSlot];
+	}
+	UPermuteSlots(hierarchy.parent, newSlot);
+	UPermuteSlots(hierarchy.subtreeSize, newSlot);
+	UPermuteSlots(hierarchy.local, newSlot);
+	UPermuteSlots(hierarchy.world, newSlot);
+	UPermuteSlots(hierarchy.dirty, newSlot);
+	UPermuteSlots(hierarchy.slotNode, newSlot);
+	for (size_t node = 0; node < hierarchy.nodeSlot.size(); node++) {
+		hierarchy.nodeSlot[node] = newSlot[hierarchy.nodeSlot[node]];
+	}
+	hierarchy.outOfOrder = false;
+
+}
+
+
+TransformNode UTransformAdd(TransformHierarchy& hierarchy, TransformNode parent, const glm::mat4& local) {
+
+	// Appended, which only keeps the parent's subtree contiguous when that subtree ends the arrays.
+	// Otherwise the next update puts every slot back in order in one pass.
+	int parentSlot = (parent == TRANSFORM_NO_PARENT) ? TRANSFORM_NO_PARENT : hierarchy.nodeSlot[parent];
+	int slot = (int)hierarchy.parent.size();
+	if (parentSlot != TRANSFORM_NO_PARENT && parentSlot + hierarchy.subtreeSize[parentSlot] != slot) {
+		hierarchy.outOfOrder = true;
+	}
+	for (int ancestor = parentSlot; ancestor != TRANSFORM_NO_PARENT; ancestor = hierarchy.parent[ancestor]) {
+		hierarchy.subtreeSize[ancestor]++;
+	}
+
+	TransformNode node = (TransformNode)hierarchy.nodeSlot.size();
+	hierarchy.nodeSlot.push_back(slot);
+	hierarchy.parent.push_back(parentSlot);
+	hierarchy.subtreeSize.push_back(1);
+	hierarchy.local.push_back(local);
+	hierarchy.world.push_back(local);
+	hierarchy.dirty.push_back(1);
+	hierarchy.slotNode.push_back(node);
+	hierarchy.dirtyNodes.push_back(node);
+	return node;
+
+}
+
+
+void UTransformSetLocal(TransformHierarchy& hierarchy, TransformNode node, const glm::mat4& local) {
+
+	int slot = hierarchy.nodeSlot[node];
+	hierarchy.local[slot] = local;
+	if (!hierarchy.dirty[slot]) {
+		hierarchy.dirty[slot] = 1;
+		hierarchy.dirtyNodes.push_back(node);
+	}
+
+}
+
+
+const glm::mat4& UTransformLocal(const TransformHierarchy& hierarchy, TransformNode node) {
+
+	return hierarchy.local[hierarchy.nodeSlot[node]];
+
+}
+
+
+const glm::mat4& UTransformWorld(const TransformHierarchy& hierarchy, TransformNode node) {
+
+	return hierarchy.world[hierarchy.nodeSlot[node]];
+
+}
+
+
+glm::vec3 UTransformWorldPosition(const TransformHierarchy& hierarchy, TransformNode node) {
+
+	return glm::vec3(hierarchy.world[hierarchy.nodeSlot[node]][3]);
+
+}
+
+
+// Recomputes the subtree at first, writing the node of each slot to changed[slot - first]
+static void USweepSubtree(TransformHierarchy& hierarchy, int first, TransformNode* changed) {
+
+	int end = first + hierarchy.subtreeSize[first];
+	int sequentialEnd = (end - first < TRANSFORM_PARALLEL_MIN) ? end : first + 1;
+	for (int slot = first; slot < sequentialEnd; slot++) {
+		int parentSlot = hierarchy.parent[slot];
+		hierarchy.world[slot] = (parentSlot == TRANSFORM_NO_PARENT) ? hierarchy.local[slot] : hierarchy.world[parentSlot] * hierarchy.local[slot];
+		hierarchy.dirty[slot] = 0;
+		changed[slot - first] = hierarchy.slotNode[slot];
+	}
+	if (sequentialEnd == end) {
+		return;
+	}
+
+	// Slices of children hold about TRANSFORM_PARALLEL_MIN slots between them
+	FrameVector<int> children;
+	for (int child = first + 1; child < end; child += hierarchy.subtreeSize[child]) {
+		children.push_back(child);
+	}
+	size_t minSlice = max<size_t>(1, (size_t)TRANSFORM_PARALLEL_MIN * children.size() / (end - first));
+	UTaskParallelFor(children.size(), minSlice, [&](size_t begin, size_t last) {
+		for (size_t c = begin; c < last; c++) {
+			USweepSubtree(hierarchy, children[c], changed + (children[c] - first));
+		}
+	});
+
+}
+
+
+int UTransformUpdate(TransformHierarchy& hierarchy) {
+
+	hierarchy.changed.clear();
+	if (hierarchy.dirtyNodes.empty()) {
+		return 0;
+	}
+	if (hierarchy.outOfOrder) {
+		UReorderSlots(hierarchy);
+	}
+
+	FrameVector<int> dirtySlots; // scratch for this call, off the heap
+	dirtySlots.reserve(hierarchy.dirtyNodes.size());
+	for (size_t i = 0; i < hierarchy.dirtyNodes.size(); i++) {
+		dirtySlots.push_back(hierarchy.nodeSlot[hierarchy.dirtyNodes[i]]);
+	}
+	sort(dirtySlots.begin(), dirtySlots.end());
+
+	int recomputed = 0;
+	int sweptEnd = 0; // one past the last slot already recomputed
+	for (size_t i = 0; i < dirtySlots.size(); i++) {
+		int first = dirtySlots[i];
+		if (first < sweptEnd) {
+			continue; // inside a subtree this pass already swept
+		}
+
+		sweptEnd = first + hierarchy.subtreeSize[first];
+		size_t changedBase = hierarchy.changed.size();
+		hierarchy.changed.resize(changedBase + (sweptEnd - first));
+		USweepSubtree(hierarchy, first, &hierarchy.changed[changedBase]);
+		recomputed += sweptEnd - first;
+	}
+
+	hierarchy.dirtyNodes.clear();
+	return recomputed;
+
+}
@@ -0,0 +1,57 @@
+/*
+*	Title:	Final Project / TransformHierarchy.h
+*	Date:	October 19, 2026
+*
+*	Description: Parent / child transform hierarchy. Nodes are stored as
+*	parallel arrays in depth-first order, so every parent comes before its
+*	children and a node's subtree is the run of slots starting at its own.
+*	New nodes are appended, and the first update after adds that broke that
+*	order restores it in a single pass.
+*	Changing a node's local transform only marks it dirty, UTransformUpdate
+*	then recomputes the local-to-world matrices of the dirty subtrees and
+*	nothing else, so the cost of a frame follows what moved, not scene size.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+typedef int TransformNode;		// stable handle, survives nodes being added around it
+#define TRANSFORM_NO_PARENT -1
+
+struct TransformHierarchy {
+	TransformHierarchy(void) : outOfOrder(false) {}
+
+	// Per slot, in depth-first order once updated
+	std::vector<int> parent;				// parent slot, TRANSFORM_NO_PARENT for roots
+	std::vector<int> subtreeSize;			// slots in the subtree, counting the node itself
+	std::vector<glm::mat4> local;			// transform relative to the parent
+	std::vector<glm::mat4> world;			// local-to-world, valid after UTransformUpdate
+	std::vector<unsigned char> dirty;		// local changed since the last update
+	std::vector<TransformNode> slotNode;	// node stored in each slot
+
+	std::vector<int> nodeSlot;				// slot of each node
+	std::vector<TransformNode> dirtyNodes;	// nodes marked dirty since the last update
+	std::vector<TransformNode> changed;		// nodes whose world matrix the last update rewrote
+	bool outOfOrder;						// a node was added outside the end of its parent's subtree
+};
+
+// Adds a node under parent, or as a root with TRANSFORM_NO_PARENT, after the parent's other
+// children. Constant time; the next update reorders the slots once for any number of adds.
+TransformNode UTransformAdd(TransformHierarchy& hierarchy, TransformNode parent, const glm::mat4& local);
+
+// Replaces a node's transform relative to its parent, the node and its subtree update next pass
+void UTransformSetLocal(TransformHierarchy& hierarchy, TransformNode node, const glm::mat4& local);
+
+const glm::mat4& UTransformLocal(const TransformHierarchy& hierarchy, TransformNode node);
+
+// Local-to-world matrix as of the last UTransformUpdate
+const glm::mat4& UTransformWorld(const TransformHierarchy& hierarchy, TransformNode node);
+
+// World position of the node's origin as of the last UTransformUpdate
+glm::vec3 UTransformWorldPosition(const TransformHierarchy& hierarchy, TransformNode node);
+
+// Recomputes the world matrices of every dirty subtree, returns the number of nodes recomputed
+int UTransformUpdate(TransformHierarchy& hierarchy);
@@ -0,0 +1,247 @@
+/*
+*	Title:	Final Project / VertexPulling.cpp
+*	Date:	October 19, 2026
+*
+*	Description: Shape buffers and the pulling vertex shader. Box corners are
+*	picked from the shape's low and high ends rather than interpolated, so
+*	they hold exactly the floats the hand-built vertices do. Flat normals are
+*	worked out per triangle from its three corners and turned away from the
+*	shape's center, which holds for any convex shape whatever the winding.
+*/
+
+#include <cstring>
+#include <iostream>
+
+#include "VertexPulling.h"
+#include "GlState.h"
+#include "GpuResources.h"
+#include "GlTrace.h"
+
+using namespace std; // standard namespace
+
+#define PULL_SHAPE_BINDING 0		// must match the Shapes block of the pulling shader
+#define PULL_TRANSFORM_BINDING 1	// must match the Transforms block
+
+static bool pulling = false;
+static GLuint shapeBuffer = 0;
+static GLuint transformBuffer = 0;
+static GLuint vertexArray = 0;				// no attributes, draws still need one bound
+static GLsizei shapeCount = 0;
+
+
+// The Shape struct, kinds and normals must match Shape, ShapeKind and ShapeNormals in Geometry.h
+static const char* pullVertexShaderSource = 1 + R"GLSL(
+	#version 430 core
+	out vec3 Normal;
+	out vec3 FragmentPos;
+	out vec2 mobileTextureCoordinate;
+	flat out uint materialID;
+	flat out int viewIndex;
+
+	struct Shape {
+		vec3 low;
+		uint kind;
+		vec3 high;
+		uint material;
+	};
+
+	layout(std430, binding = 0) readonly buffer Shapes {
+		Shape shapes[];
+	};
+
+	layout(std430, binding = 1) readonly buffer Transforms {
+		mat4 transforms[];
+	};
+
+	uniform mat4 model;
+	uniform mat4 views[VIEW_MAX];
+	uniform mat4 projections[VIEW_MAX];
+	uniform int viewCount;
+	uniform int viewFirst;
+
+	const int shapeVertices = 36;			// PULL_SHAPE_VERTICES
+	const uint SHAPE_PYRAMID = 1u;
+	const uint SHAPE_NORMALS_ENDS = 1u;
+	const uint SHAPE_NORMALS_TILTED = 2u;
+
+	// Box corners numbered as the hand-built meshes do, front face first, and their texture coordinates
+	const bvec3 boxCorners[8] = bvec3[8](
+		bvec3(false, false, true), bvec3(true, false, true), bvec3(true, true, true), bvec3(false, true, true),
+		bvec3(false, false, false), bvec3(false, true, false), bvec3(true, false, false), bvec3(true, true, false));
+	const vec2 boxCoordinates[8] = vec2[8](
+		vec2(0.0f, 0.0f), vec2(1.0f, 0.0f), vec2(1.0f, 1.0f), vec2(0.0f, 1.0f),
+		vec2(1.0f, 0.0f), vec2(1.0f, 1.0f), vec2(0.0f, 0.0f), vec2(0.0f, 1.0f));
+	const int boxIndices[36] = int[36](
+		0, 1, 2,	2, 3, 0,	3, 0, 4,	4, 5, 3,	5, 4, 6,	6, 7, 5,
+		6, 7, 2,	2, 1, 6,	3, 2, 7,	7, 5, 3,	0, 1, 6,	6, 4, 0);
+
+	// Pyramid base corners around from the front left as x and z ends, then the apex as corner 4.
+	// Four sides, then the base in two triangles.
+	const bvec2 pyramidBase[4] = bvec2[4](bvec2(false, true), bvec2(true, true), bvec2(true, false), bvec2(false, false));
+	const int pyramidIndices[18] = int[18](
+		0, 1, 4,	1, 2, 4,	2, 3, 4,	3, 0, 4,	0, 3, 2,	2, 1, 0);
+	const vec2 sideCoordinates[3] = vec2[3](vec2(0.0f, 0.0f), vec2(1.0f, 0.0f), vec2(0.5f, 1.0f));
+
+	vec3 UCorner(Shape shape, bool pyramid, int corner) {
+		if (!pyramid) {
+			return mix(shape.low, shape.high, boxCorners[corner]);
+		}
+		vec3 center = (shape.low + shape.high) * 0.5f;
+		if (corner == 4) {
+			return vec3(center.x, shape.high.y, center.z);
+		}
+		bvec2 end = pyramidBase[corner];
+		return vec3(end.x ? shape.high.x : shape.low.x, shape.low.y, end.y ? shape.high.z : shape.low.z);
+	}
+
+	void main() {
+		Shape shape = shapes[gl_VertexID / shapeVertices];
+		int vertex = gl_VertexID % shapeVertices;
+		bool pyramid = (shape.kind & 0xFFu) == SHAPE_PYRAMID;
+		uint normals = shape.kind >> 8;
+
+		// A pyramid is done after 18 vertices, the rest are clipped away
+		if (pyramid && vertex >= 18) {
+			gl_Position = vec4(0.0f);
+			return;
+		}
+
+		int corner = pyramid ? pyramidIndices[vertex] : boxIndices[vertex];
+		vec3 position = UCorner(shape, pyramid, corner);
+		vec2 coordinate;
+		if (!pyramid) {
+			coordinate = boxCoordinates[corner];
+		}
+		else if (vertex < 12) {
+			coordinate = sideCoordinates[vertex % 3];
+		}
+		else {
+			coordinate = vec2(pyramidBase[corner]);
+		}
+
+		vec3 normal;
+		if (normals == SHAPE_NORMALS_ENDS) {
+			normal = vec3(0.0f, 0.0f, boxCorners[corner].z ? 1.0f : -1.0f);
+		}
+		else if (normals == SHAPE_NORMALS_TILTED) {
+			normal = vec3(0.0f, 1.0f, 1.0f);
+		}
+		else {
+			int first = vertex - vertex % 3;
+			vec3 a = UCorner(shape, pyramid, pyramid ? pyramidIndices[first] : boxIndices[first]);
+			vec3 b = UCorner(shape, pyramid, pyramid ? pyramidIndices[first + 1] : boxIndices[first + 1]);
+			vec3 c = UCorner(shape, pyramid, pyramid ? pyramidIndices[first + 2] : boxIndices[first + 2]);
+			normal = normalize(cross(b - a, c - a));
+			if (dot(normal, a + b + c - 1.5f * (shape.low + shape.high)) < 0.0f) {
+				normal = -normal;
+			}
+		}
+
+		viewIndex = viewFirst + gl_InstanceID % viewCount;
+		mat4 world = model * transforms[gl_InstanceID / viewCount];
+		gl_Position = projections[viewIndex] * views[viewIndex] * world * vec4(position, 1.0f);
+		FragmentPos = vec3(world * vec4(position, 1.0f));
+		Normal = mat3(transpose(inverse(world))) * normal;
+		mobileTextureCoordinate = vec2(coordinate.x, 1.0f - coordinate.y);
+		materialID = shape.material;
+	#ifdef VIEW_INSTANCED
+		gl_ViewportIndex = viewIndex;
+	#endif
+	}
+)GLSL";
+
+
+bool UParsePullOptions(int argc, char* argv[], PullOptions& options) {
+
+	options.enabled = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--vertex-pulling") == 0) {
+			options.enabled = true;
+		}
+	}
+	return true;
+
+}
+
+
+bool UPullInit(const PullOptions& options) {
+
+	if (!options.enabled) {
+		return false;
+	}
+
+	// GL 4.3 only promises storage blocks to compute and fragment shaders
+	GLint vertexBlocks = 0;
+	if (GLEW_VERSION_4_3) {
+		glGetIntegerv(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &vertexBlocks);
+	}
+	if (vertexBlocks < 2) {
+		std::cerr << "Vertex pulling needs GL 4.3 storage buffers in the vertex shader, drawing the tables from vertex buffers instead\n";
+		return false;
+	}
+
+	shapeBuffer = UGpuGenBuffer("pull shapes");
+	transformBuffer = UGpuGenBuffer("pull transforms");
+	vertexArray = UGpuGenVertexArray("pull vertex array");
+	pulling = true;
+	return true;
+
+}
+
+
+const char* UPullVertexShaderSource(void) {
+
+	return pullVertexShaderSource;
+
+}
+
+
+void UPullSetShapes(const vector<Shape>& shapes) {
+
+	if (!pulling) {
+		return;
+	}
+	UStateBindBuffer(GL_SHADER_STORAGE_BUFFER, shapeBuffer);
+	UGpuBufferData(GL_SHADER_STORAGE_BUFFER, shapeBuffer, shapes.size() * sizeof(Shape), shapes.data(), GL_STATIC_DRAW);
+	UStateBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	shapeCount = (GLsizei)shapes.size();
+
+}
+
+
+void UPullSetInstances(const vector<glm::mat4>& transforms) {
+
+	if (!pulling) {
+		return;
+	}
+	UStateBindBuffer(GL_SHADER_STORAGE_BUFFER, transformBuffer);
+	UGpuBufferData(GL_SHADER_STORAGE_BUFFER, transformBuffer, transforms.size() * sizeof(glm::mat4), transforms.data(), GL_STATIC_DRAW);
+	UStateBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+}
+
+
+void UPullDraw(GLsizei instanceCount) {
+
+	if (!pulling || shapeCount == 0) {
+		return;
+	}
+	UStateBindVertexArray(vertexArray);
+	UStateBindBufferBase(GL_SHADER_STORAGE_BUFFER, PULL_SHAPE_BINDING, shapeBuffer);
+	UStateBindBufferBase(GL_SHADER_STORAGE_BUFFER, PULL_TRANSFORM_BINDING, transformBuffer);
+	glDrawArraysInstanced(GL_TRIANGLES, 0, shapeCount * PULL_SHAPE_VERTICES, instanceCount);
+
+}
+
+
+void UPullShutdown(void) {
+
+	UGpuDeleteBuffer(shapeBuffer);
+	UGpuDeleteBuffer(transformBuffer);
+	UGpuDeleteVertexArray(vertexArray);
+	shapeBuffer = transformBuffer = vertexArray = 0;
+	shapeCount = 0;
+	pulling = false;
+
+}
@@ -0,0 +1,58 @@
+/*
+*	Title:	Final Project / VertexPulling.h
+*	Date:	October 19, 2026
+*
+*	Description: Programmable vertex pulling. The tables are drawn with no
+*	vertex attributes at all: the vertex shader reads its shape (see Shape in
+*	Geometry.h) and its table's transform from storage buffers and builds the
+*	position, normal and texture coordinate of each corner from gl_VertexID.
+*	A box is one 32 byte record instead of 8 vertices of 32 bytes and 36
+*	indices, and a table is one matrix instead of a leg and a top instance.
+*	The corners come out in the hand-built meshes' triangle order with the
+*	same floats, so the image is that of the meshes drawn without shared
+*	vertices; an indexed draw may round a few texture lookups differently
+*	on some drivers. Needs GL 4.3 storage buffers in the
+*	vertex shader; without them UPullInit returns false and the caller keeps
+*	drawing from vertex buffers.
+*
+*	The shader writes what the object vertex shader writes and takes the
+*	same model and view uniforms, so it links with the object fragment shader.
+*
+*	Command line:
+*		--vertex-pulling			build the tables in the vertex shader from their shapes
+*/
+
+#pragma once
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "Geometry.h"
+
+#define PULL_SHAPE_VERTICES 36		// vertices drawn per shape, a pyramid needs the first 18
+
+struct PullOptions {
+	bool enabled;
+};
+
+// Reads the vertex pulling options out of the command line, returns false on a malformed argument
+bool UParsePullOptions(int argc, char* argv[], PullOptions& options);
+
+// Creates the storage buffers, false when pulling is off or the context cannot run it
+bool UPullInit(const PullOptions& options);
+
+// Vertex shader of the pulling path, to be passed through UViewShaderSource
+const char* UPullVertexShaderSource(void);
+
+// Uploads the shapes every instance draws, in draw order
+void UPullSetShapes(const std::vector<Shape>& shapes);
+
+// Uploads one transform per instance, applied after the model uniform
+void UPullSetInstances(const std::vector<glm::mat4>& transforms);
+
+// Draws every shape instanceCount times with the pulling program in use. Instances fan out to
+// the views like the other draws, instance i reads transform i / viewCount.
+void UPullDraw(GLsizei instanceCount);
+
+void UPullShutdown(void);